@@ -92,6 +92,24 @@ namespace PelcoD {
 		throw std::logic_error("The method is not implemented!");
 	}
 
+	/// Gets pan and tilt position.
+	/// \details Gets pan and tilt values in steps.
+	/// \return Pan and tilt position.
+	/// \throw std::logic_error by default.
+	Position AbstractPelcoDDevice::getPosition() const {
+		throw std::logic_error("The method is not implemented!");
+	}
+
+	/// Sets pan and tilt position.
+	/// \details Sets pan and tilt values in steps.
+	/// \param[in]	panSteps	Pan steps.
+	/// \param[in]	tiltSteps	Tilt steps.
+	/// \throw std::logic_error by default.
+	void AbstractPelcoDDevice::setPosition(std::uint16_t panSteps,
+	                                       std::uint16_t tiltSteps) {
+		throw std::logic_error("The method is not implemented!");
+	}
+
 	/// Gets device temperature.
 	/// \details Gets device temperature value.
 	/// \return Device temperature.
@@ -107,4 +125,60 @@ namespace PelcoD {
 	double AbstractPelcoDDevice::getVoltage() const {
 		throw std::logic_error("The method is not implemented!");
 	}
+
+	/// Starts continuous motion.
+	/// \details Starts pan, tilt, zoom and focus motion with
+	/// the given speeds.
+	/// \param[in]	motion	Motion.
+	/// \throw std::logic_error by default.
+	void AbstractPelcoDDevice::move(const Motion& motion) {
+		throw std::logic_error("The method is not implemented!");
+	}
+
+	/// Stops motion.
+	/// \details Stops pan, tilt, zoom and focus motion.
+	/// \throw std::logic_error by default.
+	void AbstractPelcoDDevice::stop() {
+		throw std::logic_error("The method is not implemented!");
+	}
+
+	/// Stores the current position as a preset.
+	/// \details Stores the current position under the preset number.
+	/// \param[in]	preset	Preset number.
+	/// \throw std::logic_error by default.
+	void AbstractPelcoDDevice::setPreset(std::uint8_t preset) {
+		throw std::logic_error("The method is not implemented!");
+	}
+
+	/// Clears a preset.
+	/// \details Removes the position stored under the preset number.
+	/// \param[in]	preset	Preset number.
+	/// \throw std::logic_error by default.
+	void AbstractPelcoDDevice::clearPreset(std::uint8_t preset) {
+		throw std::logic_error("The method is not implemented!");
+	}
+
+	/// Moves to a preset.
+	/// \details Moves to the position stored under the preset number.
+	/// \param[in]	preset	Preset number.
+	/// \throw std::logic_error by default.
+	void AbstractPelcoDDevice::goToPreset(std::uint8_t preset) {
+		throw std::logic_error("The method is not implemented!");
+	}
+
+	/// Sets zoom speed.
+	/// \details Sets speed of continuous zoom.
+	/// \param[in]	speed	Zoom speed.
+	/// \throw std::logic_error by default.
+	void AbstractPelcoDDevice::setZoomSpeed(std::uint8_t speed) {
+		throw std::logic_error("The method is not implemented!");
+	}
+
+	/// Sets focus speed.
+	/// \details Sets speed of continuous focus.
+	/// \param[in]	speed	Focus speed.
+	/// \throw std::logic_error by default.
+	void AbstractPelcoDDevice::setFocusSpeed(std::uint8_t speed) {
+		throw std::logic_error("The method is not implemented!");
+	}
 }
@@ -14,6 +14,33 @@
 /// Contains classes and functions that provide Pelco-D protocol implementation.
 namespace PelcoD {
 
+	/// Pan and tilt position.
+	struct Position {
+
+		/// Pan steps.
+		std::uint16_t panSteps;
+
+		/// Tilt steps.
+		std::uint16_t tiltSteps;
+	};
+
+	/// Continuous motion.
+	/// \details Zero speeds stop the respective axes.
+	struct Motion {
+
+		/// Pan speed from -63 to 63, positive to the right.
+		std::int8_t panSpeed;
+
+		/// Tilt speed from -63 to 63, positive up.
+		std::int8_t tiltSpeed;
+
+		/// Zoom direction, positive in.
+		std::int8_t zoom;
+
+		/// Focus direction, positive far.
+		std::int8_t focus;
+	};
+
 	/// Class that provides abstract Pelco-D device implementation.
 	class SHARED_API AbstractPelcoDDevice {
 	public:
@@ -73,6 +100,18 @@ namespace PelcoD {
 		/// \throw std::logic_error by default.
 		virtual void setTiltSteps(std::uint16_t steps);
 
+		/// Gets pan and tilt position.
+		/// \return Pan and tilt position.
+		/// \throw std::logic_error by default.
+		virtual Position getPosition() const;
+
+		/// Sets pan and tilt position.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		/// \throw std::logic_error by default.
+		virtual void setPosition(std::uint16_t panSteps,
+		                         std::uint16_t tiltSteps);
+
 		/// Gets device temperature.
 		/// \return Device temperature.
 		/// \throw std::logic_error by default.
@@ -82,6 +121,40 @@ namespace PelcoD {
 		/// \return Device voltage.
 		/// \throw std::logic_error by default.
 		virtual double getVoltage() const;
+
+		/// Starts continuous motion.
+		/// \param[in]	motion	Motion.
+		/// \throw std::logic_error by default.
+		virtual void move(const Motion& motion);
+
+		/// Stops motion.
+		/// \throw std::logic_error by default.
+		virtual void stop();
+
+		/// Stores the current position as a preset.
+		/// \param[in]	preset	Preset number.
+		/// \throw std::logic_error by default.
+		virtual void setPreset(std::uint8_t preset);
+
+		/// Clears a preset.
+		/// \param[in]	preset	Preset number.
+		/// \throw std::logic_error by default.
+		virtual void clearPreset(std::uint8_t preset);
+
+		/// Moves to a preset.
+		/// \param[in]	preset	Preset number.
+		/// \throw std::logic_error by default.
+		virtual void goToPreset(std::uint8_t preset);
+
+		/// Sets zoom speed.
+		/// \param[in]	speed	Zoom speed.
+		/// \throw std::logic_error by default.
+		virtual void setZoomSpeed(std::uint8_t speed);
+
+		/// Sets focus speed.
+		/// \param[in]	speed	Focus speed.
+		/// \throw std::logic_error by default.
+		virtual void setFocusSpeed(std::uint8_t speed);
 	};
 }
 
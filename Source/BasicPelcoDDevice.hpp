@@ -0,0 +1,523 @@
+/// \file BasicPelcoDDevice.hpp
+/// \brief Contains classes and functions declarations and definitions that
+/// provide basic Pelco-D device implementation.
+/// \bug No known bugs.
+
+#ifndef BASIC_PELCOD_DEVICE_HPP
+#define BASIC_PELCOD_DEVICE_HPP
+
+#include "AbstractPelcoDDevice.hpp"
+#include "PelcoDECodec.hpp"
+#include "PelcoDProtocol.hpp"
+
+#include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides basic Pelco-D device implementation.
+	/// \details The device is bound to its transport and protocol at compile
+	/// time, so that encoding, exchange and decoding of a request may be
+	/// inlined. Methods report errors with error codes instead of exceptions.
+	/// Methods of features that the protocol lacks do not compile.
+	///
+	/// The transport must provide the method
+	/// \code
+	/// boost::system::error_code exchange(const Codec::Frame& request,
+	///                                    std::uint8_t response,
+	///                                    std::uint16_t& value) noexcept;
+	/// \endcode
+	/// that sends the request and, unless the expected response command is
+	/// zero, receives the response value.
+	template <typename Transport, typename Protocol = PelcoDEProtocol>
+	class BasicPelcoDDevice {
+	public:
+
+		/// Transport type.
+		using TransportType = Transport;
+
+		/// Protocol type.
+		using ProtocolType = Protocol;
+
+	public:
+
+		/// Constructor.
+		/// \param[in]	address		Device address.
+		/// \param[in]	arguments	Transport constructor arguments.
+		template <typename... Arguments>
+		explicit BasicPelcoDDevice(std::uint8_t address,
+		                           Arguments&&... arguments)
+			: transport_(std::forward<Arguments>(arguments)...),
+			  address_(address) {
+		}
+
+	public:
+
+		/// Gets pan steps.
+		/// \param[out]	steps	Pan steps.
+		/// \return Error code.
+		boost::system::error_code getPanSteps(std::uint16_t& steps) noexcept {
+			static_assert(Protocol::HAS_POSITION,
+			              "The protocol has no position queries!");
+			return exchange(Protocol::getPanSteps(), 0, steps);
+		}
+
+		/// Gets pan maximum number of steps.
+		/// \param[out]	steps	Pan maximum number of steps.
+		/// \return Error code.
+		boost::system::error_code getPanMaxSteps(
+			std::uint16_t& steps) noexcept {
+
+			static_assert(Protocol::HAS_MAX_STEPS,
+			              "The protocol has no range queries!");
+			return exchange(Protocol::getPanMaxSteps(), 0, steps);
+		}
+
+		/// Sets pan steps.
+		/// \param[in]	steps	Pan steps.
+		/// \return Error code.
+		boost::system::error_code setPanSteps(std::uint16_t steps) noexcept {
+			std::uint16_t value;
+			return exchange(Protocol::setPanSteps(), steps, value);
+		}
+
+		/// Gets tilt steps.
+		/// \param[out]	steps	Tilt steps.
+		/// \return Error code.
+		boost::system::error_code getTiltSteps(std::uint16_t& steps) noexcept {
+			static_assert(Protocol::HAS_POSITION,
+			              "The protocol has no position queries!");
+			return exchange(Protocol::getTiltSteps(), 0, steps);
+		}
+
+		/// Gets tilt maximum number of steps.
+		/// \param[out]	steps	Tilt maximum number of steps.
+		/// \return Error code.
+		boost::system::error_code getTiltMaxSteps(
+			std::uint16_t& steps) noexcept {
+
+			static_assert(Protocol::HAS_MAX_STEPS,
+			              "The protocol has no range queries!");
+			return exchange(Protocol::getTiltMaxSteps(), 0, steps);
+		}
+
+		/// Sets tilt steps.
+		/// \param[in]	steps	Tilt steps.
+		/// \return Error code.
+		boost::system::error_code setTiltSteps(std::uint16_t steps) noexcept {
+			std::uint16_t value;
+			return exchange(Protocol::setTiltSteps(), steps, value);
+		}
+
+		/// Gets pan and tilt position.
+		/// \param[out]	position	Pan and tilt position.
+		/// \return Error code.
+		boost::system::error_code getPosition(Position& position) noexcept {
+			auto error = getPanSteps(position.panSteps);
+			return error ? error : getTiltSteps(position.tiltSteps);
+		}
+
+		/// Sets pan and tilt position.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		/// \return Error code.
+		boost::system::error_code setPosition(std::uint16_t panSteps,
+		                                      std::uint16_t tiltSteps) noexcept {
+			auto error = setPanSteps(panSteps);
+			return error ? error : setTiltSteps(tiltSteps);
+		}
+
+		/// Gets device temperature.
+		/// \param[out]	temperature	Device temperature.
+		/// \return Error code.
+		boost::system::error_code getTemperature(
+			std::int16_t& temperature) noexcept {
+
+			static_assert(Protocol::HAS_TEMPERATURE,
+			              "The protocol has no temperature queries!");
+
+			std::uint16_t value = 0;
+			auto error = exchange(Protocol::getTemperature(), 0, value);
+			temperature = static_cast<std::int16_t>(value);
+			return error;
+		}
+
+		/// Gets device voltage.
+		/// \param[out]	voltage	Device voltage.
+		/// \return Error code.
+		boost::system::error_code getVoltage(double& voltage) noexcept {
+			static_assert(Protocol::HAS_VOLTAGE,
+			              "The protocol has no voltage queries!");
+
+			std::uint16_t value = 0;
+			auto error = exchange(Protocol::getVoltage(), 0, value);
+			voltage = value / 100.0;
+			return error;
+		}
+
+		/// Gets device address.
+		/// \return Device address.
+		std::uint8_t getAddress() const noexcept {
+			return address_;
+		}
+
+		/// Gets transport.
+		/// \return Transport.
+		Transport& getTransport() noexcept {
+			return transport_;
+		}
+
+	private:
+
+		/// Exchanges a command.
+		/// \param[in]	command	Command.
+		/// \param[in]	value	Request value.
+		/// \param[out]	result	Response value.
+		/// \return Error code.
+		boost::system::error_code exchange(const Command& command,
+		                                   std::uint16_t value,
+		                                   std::uint16_t& result) noexcept {
+			return transport_.exchange(
+				Codec::createFrame(address_, command.request, value),
+				command.response, result);
+		}
+
+	private:
+
+		/// Transport.
+		Transport transport_;
+
+		/// Device address.
+		std::uint8_t address_;
+	};
+
+	/// Class that provides Pelco-D device adapter implementation.
+	/// \details Exposes a basic device through the abstract device interface
+	/// for code that selects devices at run time. Errors are thrown as
+	/// boost::system::system_error, methods of features that the protocol
+	/// lacks throw std::logic_error. Calls are serialized, since the
+	/// transport of a basic device is used by one thread at a time.
+	template <typename Device>
+	class PelcoDDeviceAdapter : public AbstractPelcoDDevice {
+	public:
+
+		/// Constructor.
+		/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+		/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+		/// \param[in]	arguments		Device constructor arguments.
+		/// \throw std::invalid_argument if a maximum number of degrees is
+		/// zero.
+		template <typename... Arguments>
+		PelcoDDeviceAdapter(std::uint16_t maxPanDegrees,
+		                    std::uint16_t maxTiltDegrees,
+		                    Arguments&&... arguments)
+			: device_(std::forward<Arguments>(arguments)...),
+			  maxPanDegrees_(maxPanDegrees),
+			  maxTiltDegrees_(maxTiltDegrees),
+			  panStepsPerDegree_(0),
+			  tiltStepsPerDegree_(0) {
+
+			if (maxPanDegrees_ == 0 || maxTiltDegrees_ == 0) {
+				throw std::invalid_argument("The degrees are out of range!");
+			}
+		}
+
+	public:
+
+		/// Gets pan degrees.
+		/// \return Pan degrees.
+		std::uint16_t getPanDegrees() const override {
+			calibrate(HasMaxSteps());
+			return getPanSteps() / panStepsPerDegree_;
+		}
+
+		/// Sets pan degrees.
+		/// \param[in]	degrees	Pan degrees.
+		void setPanDegrees(std::uint16_t degrees) override {
+			calibrate(HasMaxSteps());
+			degrees %= 360;
+			setPanSteps(degrees * panStepsPerDegree_);
+		}
+
+		/// Gets tilt degrees.
+		/// \return Tilt degrees.
+		std::uint16_t getTiltDegrees() const override {
+			calibrate(HasMaxSteps());
+			return getTiltSteps() / tiltStepsPerDegree_;
+		}
+
+		/// Sets tilt degrees.
+		/// \param[in]	degrees	Tilt degrees.
+		void setTiltDegrees(std::uint16_t degrees) override {
+			calibrate(HasMaxSteps());
+			degrees %= 135;
+			setTiltSteps(degrees * tiltStepsPerDegree_);
+		}
+
+		/// Gets pan steps.
+		/// \return Pan steps.
+		std::uint16_t getPanSteps() const override {
+			return getPanSteps(HasPosition());
+		}
+
+		/// Gets pan maximum number of steps.
+		/// \return Pan maximum number of steps.
+		std::uint16_t getPanMaxSteps() const override {
+			return getPanMaxSteps(HasMaxSteps());
+		}
+
+		/// Sets pan steps.
+		/// \param[in]	steps	Pan steps.
+		void setPanSteps(std::uint16_t steps) override {
+			std::lock_guard<std::mutex> lock(mutex_);
+			check(device_.setPanSteps(steps));
+		}
+
+		/// Gets tilt steps.
+		/// \return Tilt steps.
+		std::uint16_t getTiltSteps() const override {
+			return getTiltSteps(HasPosition());
+		}
+
+		/// Gets tilt maximum number of steps.
+		/// \return Tilt maximum number of steps.
+		std::uint16_t getTiltMaxSteps() const override {
+			return getTiltMaxSteps(HasMaxSteps());
+		}
+
+		/// Sets tilt steps.
+		/// \param[in]	steps	Tilt steps.
+		void setTiltSteps(std::uint16_t steps) override {
+			std::lock_guard<std::mutex> lock(mutex_);
+			check(device_.setTiltSteps(steps));
+		}
+
+		/// Gets pan and tilt position.
+		/// \return Pan and tilt position.
+		Position getPosition() const override {
+			return getPosition(HasPosition());
+		}
+
+		/// Sets pan and tilt position.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		void setPosition(std::uint16_t panSteps,
+		                 std::uint16_t tiltSteps) override {
+			std::lock_guard<std::mutex> lock(mutex_);
+			check(device_.setPosition(panSteps, tiltSteps));
+		}
+
+		/// Gets device temperature.
+		/// \return Device temperature.
+		std::int16_t getTemperature() const override {
+			return getTemperature(HasTemperature());
+		}
+
+		/// Gets device voltage.
+		/// \return Device voltage.
+		double getVoltage() const override {
+			return getVoltage(HasVoltage());
+		}
+
+	public:
+
+		/// Gets adapted device.
+		/// \return Device.
+		Device& getDevice() noexcept {
+			return device_;
+		}
+
+	private:
+
+		/// Protocol of the device.
+		using Protocol = typename Device::ProtocolType;
+
+		/// Whether the protocol has position queries.
+		using HasPosition = std::integral_constant<bool, Protocol::HAS_POSITION>;
+
+		/// Whether the protocol has range queries.
+		using HasMaxSteps = std::integral_constant<bool, Protocol::HAS_MAX_STEPS>;
+
+		/// Whether the protocol has temperature queries.
+		using HasTemperature =
+			std::integral_constant<bool, Protocol::HAS_TEMPERATURE>;
+
+		/// Whether the protocol has voltage queries.
+		using HasVoltage = std::integral_constant<bool, Protocol::HAS_VOLTAGE>;
+
+		/// Throws an error.
+		/// \param[in]	error	Error code.
+		/// \throw boost::system::system_error if the error code is set.
+		static void check(const boost::system::error_code& error) {
+			if (error) {
+				throw boost::system::system_error(error);
+			}
+		}
+
+		/// Calibrates the device.
+		/// \details Obtains pan and tilt maximum number of steps unless the
+		/// device is already calibrated.
+		/// \throw std::runtime_error if a maximum number of steps is less
+		/// than the maximum number of degrees.
+		void calibrate(std::true_type) const {
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			if (panStepsPerDegree_ != 0 && tiltStepsPerDegree_ != 0) {
+				return;
+			}
+
+			std::uint16_t panMaxSteps = 0;
+			std::uint16_t tiltMaxSteps = 0;
+
+			check(device_.getPanMaxSteps(panMaxSteps));
+			check(device_.getTiltMaxSteps(tiltMaxSteps));
+
+			if (panMaxSteps < maxPanDegrees_ || tiltMaxSteps < maxTiltDegrees_) {
+				throw std::runtime_error("The calibration is invalid!");
+			}
+
+			panStepsPerDegree_ = panMaxSteps / maxPanDegrees_;
+			tiltStepsPerDegree_ = tiltMaxSteps / maxTiltDegrees_;
+		}
+
+		/// Calibrates the device.
+		/// \throw std::logic_error since the protocol has no range queries.
+		void calibrate(std::false_type) const {
+			throw std::logic_error("The method is not implemented!");
+		}
+
+		/// Gets pan steps.
+		/// \return Pan steps.
+		std::uint16_t getPanSteps(std::true_type) const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::uint16_t steps = 0;
+			check(device_.getPanSteps(steps));
+			return steps;
+		}
+
+		/// Gets pan steps.
+		/// \return Pan steps.
+		std::uint16_t getPanSteps(std::false_type) const {
+			return AbstractPelcoDDevice::getPanSteps();
+		}
+
+		/// Gets pan maximum number of steps.
+		/// \return Pan maximum number of steps.
+		std::uint16_t getPanMaxSteps(std::true_type) const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::uint16_t steps = 0;
+			check(device_.getPanMaxSteps(steps));
+			return steps;
+		}
+
+		/// Gets pan maximum number of steps.
+		/// \return Pan maximum number of steps.
+		std::uint16_t getPanMaxSteps(std::false_type) const {
+			return AbstractPelcoDDevice::getPanMaxSteps();
+		}
+
+		/// Gets tilt steps.
+		/// \return Tilt steps.
+		std::uint16_t getTiltSteps(std::true_type) const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::uint16_t steps = 0;
+			check(device_.getTiltSteps(steps));
+			return steps;
+		}
+
+		/// Gets tilt steps.
+		/// \return Tilt steps.
+		std::uint16_t getTiltSteps(std::false_type) const {
+			return AbstractPelcoDDevice::getTiltSteps();
+		}
+
+		/// Gets tilt maximum number of steps.
+		/// \return Tilt maximum number of steps.
+		std::uint16_t getTiltMaxSteps(std::true_type) const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::uint16_t steps = 0;
+			check(device_.getTiltMaxSteps(steps));
+			return steps;
+		}
+
+		/// Gets tilt maximum number of steps.
+		/// \return Tilt maximum number of steps.
+		std::uint16_t getTiltMaxSteps(std::false_type) const {
+			return AbstractPelcoDDevice::getTiltMaxSteps();
+		}
+
+		/// Gets pan and tilt position.
+		/// \return Pan and tilt position.
+		Position getPosition(std::true_type) const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			Position position {};
+			check(device_.getPosition(position));
+			return position;
+		}
+
+		/// Gets pan and tilt position.
+		/// \return Pan and tilt position.
+		Position getPosition(std::false_type) const {
+			return AbstractPelcoDDevice::getPosition();
+		}
+
+		/// Gets device temperature.
+		/// \return Device temperature.
+		std::int16_t getTemperature(std::true_type) const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::int16_t temperature = 0;
+			check(device_.getTemperature(temperature));
+			return temperature;
+		}
+
+		/// Gets device temperature.
+		/// \return Device temperature.
+		std::int16_t getTemperature(std::false_type) const {
+			return AbstractPelcoDDevice::getTemperature();
+		}
+
+		/// Gets device voltage.
+		/// \return Device voltage.
+		double getVoltage(std::true_type) const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			double voltage = 0;
+			check(device_.getVoltage(voltage));
+			return voltage;
+		}
+
+		/// Gets device voltage.
+		/// \return Device voltage.
+		double getVoltage(std::false_type) const {
+			return AbstractPelcoDDevice::getVoltage();
+		}
+
+	private:
+
+		/// Adapted device.
+		mutable Device device_;
+
+		/// Pan maximum number of degrees.
+		std::uint16_t maxPanDegrees_;
+
+		/// Tilt maximum number of degrees.
+		std::uint16_t maxTiltDegrees_;
+
+		/// Number of pan steps per degree of rotation.
+		mutable std::uint16_t panStepsPerDegree_;
+
+		/// Number of tilt steps per degree of rotation.
+		mutable std::uint16_t tiltStepsPerDegree_;
+
+		/// Mutex that serializes calls.
+		mutable std::mutex mutex_;
+	};
+}
+
+#endif
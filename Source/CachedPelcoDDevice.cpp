@@ -0,0 +1,341 @@
+/// \file CachedPelcoDDevice.cpp
+/// \brief Contains classes and functions definitions that provide cached
+/// Pelco-D device implementation.
+/// \bug No known bugs.
+
+#include "CachedPelcoDDevice.hpp"
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Constructor.
+	/// \details Initializes the policy with default values.
+	CachePolicy::CachePolicy() noexcept
+		: position(100),
+		  temperature(5000),
+		  voltage(5000) {
+	}
+
+	/// Constructor.
+	/// \details Initializes entry fields.
+	template <typename T>
+	CachedPelcoDDevice::Entry<T>::Entry()
+		: value(),
+		  valid(false),
+		  generation(0) {
+	}
+
+	/// Constructor.
+	/// \details Initializes object fields.
+	/// \param[in]	device	Wrapped device, it must outlive the object and
+	/// allow concurrent calls if the object is used by many threads.
+	/// \param[in]	policy	Cache policy.
+	CachedPelcoDDevice::CachedPelcoDDevice(AbstractPelcoDDevice& device,
+	                                       const CachePolicy& policy)
+		: device_(device),
+		  policy_(policy) {
+	}
+
+	/// Destructor.
+	/// \details Defaulted default destructor.
+	CachedPelcoDDevice::~CachedPelcoDDevice() = default;
+
+	/// Gets pan degrees.
+	/// \details Gets pan value in degrees, fresh for the position time.
+	/// \return Pan degrees.
+	std::uint16_t CachedPelcoDDevice::getPanDegrees() const {
+		return load(panDegrees_, policy_.position,
+		            [this]() { return device_.getPanDegrees(); });
+	}
+
+	/// Sets pan degrees.
+	/// \details Sets pan value in degrees and discards cached pan values.
+	/// \param[in]	degrees	Pan degrees.
+	void CachedPelcoDDevice::setPanDegrees(std::uint16_t degrees) {
+		update([this, degrees]() { device_.setPanDegrees(degrees); },
+		       true, false);
+	}
+
+	/// Gets tilt degrees.
+	/// \details Gets tilt value in degrees, fresh for the position time.
+	/// \return Tilt degrees.
+	std::uint16_t CachedPelcoDDevice::getTiltDegrees() const {
+		return load(tiltDegrees_, policy_.position,
+		            [this]() { return device_.getTiltDegrees(); });
+	}
+
+	/// Sets tilt degrees.
+	/// \details Sets tilt value in degrees and discards cached tilt values.
+	/// \param[in]	degrees	Tilt degrees.
+	void CachedPelcoDDevice::setTiltDegrees(std::uint16_t degrees) {
+		update([this, degrees]() { device_.setTiltDegrees(degrees); },
+		       false, true);
+	}
+
+	/// Gets pan steps.
+	/// \details Gets pan value in steps, fresh for the position time.
+	/// \return Pan steps.
+	std::uint16_t CachedPelcoDDevice::getPanSteps() const {
+		return load(panSteps_, policy_.position,
+		            [this]() { return device_.getPanSteps(); });
+	}
+
+	/// Gets pan maximum number of steps.
+	/// \details Gets pan maximum value in steps, which never changes.
+	/// \return Pan maximum number of steps.
+	std::uint16_t CachedPelcoDDevice::getPanMaxSteps() const {
+		return load(panMaxSteps_, std::chrono::milliseconds::max(),
+		            [this]() { return device_.getPanMaxSteps(); });
+	}
+
+	/// Sets pan steps.
+	/// \details Sets pan value in steps and discards cached pan values.
+	/// \param[in]	steps	Pan steps.
+	void CachedPelcoDDevice::setPanSteps(std::uint16_t steps) {
+		update([this, steps]() { device_.setPanSteps(steps); }, true, false);
+	}
+
+	/// Gets tilt steps.
+	/// \details Gets tilt value in steps, fresh for the position time.
+	/// \return Tilt steps.
+	std::uint16_t CachedPelcoDDevice::getTiltSteps() const {
+		return load(tiltSteps_, policy_.position,
+		            [this]() { return device_.getTiltSteps(); });
+	}
+
+	/// Gets tilt maximum number of steps.
+	/// \details Gets tilt maximum value in steps, which never changes.
+	/// \return Tilt maximum number of steps.
+	std::uint16_t CachedPelcoDDevice::getTiltMaxSteps() const {
+		return load(tiltMaxSteps_, std::chrono::milliseconds::max(),
+		            [this]() { return device_.getTiltMaxSteps(); });
+	}
+
+	/// Sets tilt steps.
+	/// \details Sets tilt value in steps and discards cached tilt values.
+	/// \param[in]	steps	Tilt steps.
+	void CachedPelcoDDevice::setTiltSteps(std::uint16_t steps) {
+		update([this, steps]() { device_.setTiltSteps(steps); }, false, true);
+	}
+
+	/// Gets pan and tilt position.
+	/// \details Gets pan and tilt values in steps, fresh for the position
+	/// time.
+	/// \return Pan and tilt position.
+	Position CachedPelcoDDevice::getPosition() const {
+		return load(position_, policy_.position,
+		            [this]() { return device_.getPosition(); });
+	}
+
+	/// Sets pan and tilt position.
+	/// \details Sets pan and tilt values in steps and discards cached pan and
+	/// tilt values.
+	/// \param[in]	panSteps	Pan steps.
+	/// \param[in]	tiltSteps	Tilt steps.
+	void CachedPelcoDDevice::setPosition(std::uint16_t panSteps,
+	                                     std::uint16_t tiltSteps) {
+		update([this, panSteps, tiltSteps]() {
+			device_.setPosition(panSteps, tiltSteps);
+		}, true, true);
+	}
+
+	/// Gets device temperature.
+	/// \details Gets device temperature value, fresh for the temperature time.
+	/// \return Device temperature.
+	std::int16_t CachedPelcoDDevice::getTemperature() const {
+		return load(temperature_, policy_.temperature,
+		            [this]() { return device_.getTemperature(); });
+	}
+
+	/// Gets device voltage.
+	/// \details Gets device voltage value, fresh for the voltage time.
+	/// \return Device voltage.
+	double CachedPelcoDDevice::getVoltage() const {
+		return load(voltage_, policy_.voltage,
+		            [this]() { return device_.getVoltage(); });
+	}
+
+	/// Starts continuous motion.
+	/// \details Starts continuous motion and discards cached pan and tilt
+	/// values.
+	/// \param[in]	motion	Motion.
+	void CachedPelcoDDevice::move(const Motion& motion) {
+		update([this, &motion]() { device_.move(motion); }, true, true);
+	}
+
+	/// Stops motion.
+	/// \details Stops motion and discards cached pan and tilt values.
+	void CachedPelcoDDevice::stop() {
+		update([this]() { device_.stop(); }, true, true);
+	}
+
+	/// Stores the current position as a preset.
+	/// \details Stores the current position as a preset on the device.
+	/// \param[in]	preset	Preset number.
+	void CachedPelcoDDevice::setPreset(std::uint8_t preset) {
+		device_.setPreset(preset);
+	}
+
+	/// Clears a preset.
+	/// \details Clears a preset on the device.
+	/// \param[in]	preset	Preset number.
+	void CachedPelcoDDevice::clearPreset(std::uint8_t preset) {
+		device_.clearPreset(preset);
+	}
+
+	/// Moves to a preset.
+	/// \details Moves to a preset and discards cached pan and tilt values.
+	/// \param[in]	preset	Preset number.
+	void CachedPelcoDDevice::goToPreset(std::uint8_t preset) {
+		update([this, preset]() { device_.goToPreset(preset); }, true, true);
+	}
+
+	/// Sets zoom speed.
+	/// \details Sets zoom speed of the device.
+	/// \param[in]	speed	Zoom speed.
+	void CachedPelcoDDevice::setZoomSpeed(std::uint8_t speed) {
+		device_.setZoomSpeed(speed);
+	}
+
+	/// Sets focus speed.
+	/// \details Sets focus speed of the device.
+	/// \param[in]	speed	Focus speed.
+	void CachedPelcoDDevice::setFocusSpeed(std::uint8_t speed) {
+		device_.setFocusSpeed(speed);
+	}
+
+	/// Discards all cached values.
+	/// \details Discards all cached values, so that next queries are sent to
+	/// the device.
+	void CachedPelcoDDevice::invalidate() {
+		invalidate(panDegrees_, panSteps_);
+		invalidate(tiltDegrees_, tiltSteps_);
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		temperature_.valid = false;
+		temperature_.pending = std::shared_future<std::int16_t>();
+		++temperature_.generation;
+
+		voltage_.valid = false;
+		voltage_.pending = std::shared_future<double>();
+		++voltage_.generation;
+	}
+
+	/// Gets a cached value or requests it from the device.
+	/// \details Returns the cached value if it is fresh. Otherwise joins the
+	/// request in flight or sends a new one and caches its result, unless the
+	/// value was invalidated meanwhile. The device is called without holding
+	/// the lock.
+	/// \param[in]	entry	Cached value.
+	/// \param[in]	ttl		Time during which the value is fresh.
+	/// \param[in]	request	Request to the device.
+	/// \return Value.
+	template <typename T, typename Request>
+	T CachedPelcoDDevice::load(Entry<T>& entry,
+	                           std::chrono::milliseconds ttl,
+	                           Request request) const {
+
+		std::unique_lock<std::mutex> lock(mutex_);
+
+		auto now = std::chrono::steady_clock::now();
+
+		if (entry.valid && std::chrono::duration_cast<std::chrono::milliseconds>(
+			now - entry.updated) < ttl) {
+			return entry.value;
+		}
+
+		if (entry.pending.valid()) {
+			auto pending = entry.pending;
+			lock.unlock();
+			return pending.get();
+		}
+
+		std::promise<T> promise;
+		auto generation = entry.generation;
+		entry.pending = promise.get_future().share();
+		lock.unlock();
+
+		try {
+			auto value = request();
+
+			lock.lock();
+
+			if (entry.generation == generation) {
+				entry.value = value;
+				entry.updated = now;
+				entry.valid = true;
+				entry.pending = std::shared_future<T>();
+			}
+
+			lock.unlock();
+
+			promise.set_value(value);
+			return value;
+		} catch (...) {
+			lock.lock();
+
+			if (entry.generation == generation) {
+				entry.pending = std::shared_future<T>();
+			}
+
+			lock.unlock();
+
+			promise.set_exception(std::current_exception());
+			throw;
+		}
+	}
+
+	/// Sends a command that changes the position.
+	/// \details Discards cached values of the changed axes before the
+	/// command, so that a failed command does not leave values that it may
+	/// have made stale, and after it, so that values obtained while the
+	/// command was in flight are discarded too.
+	/// \param[in]	command	Command to the device.
+	/// \param[in]	pan		Whether the command changes pan.
+	/// \param[in]	tilt	Whether the command changes tilt.
+	template <typename Command>
+	void CachedPelcoDDevice::update(Command command, bool pan, bool tilt) {
+		auto discard = [this, pan, tilt]() {
+			if (pan) {
+				invalidate(panDegrees_, panSteps_);
+			}
+
+			if (tilt) {
+				invalidate(tiltDegrees_, tiltSteps_);
+			}
+		};
+
+		discard();
+
+		try {
+			command();
+		} catch (...) {
+			discard();
+			throw;
+		}
+
+		discard();
+	}
+
+	/// Discards cached values of an axis and cached position.
+	/// \details Discards cached degrees, steps and position, a request in
+	/// flight is not joined by next queries.
+	/// \param[in]	degrees	Cached degrees.
+	/// \param[in]	steps	Cached steps.
+	void CachedPelcoDDevice::invalidate(Entry<std::uint16_t>& degrees,
+	                                    Entry<std::uint16_t>& steps) {
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		for (auto entry : { &degrees, &steps }) {
+			entry->valid = false;
+			entry->pending = std::shared_future<std::uint16_t>();
+			++entry->generation;
+		}
+
+		position_.valid = false;
+		position_.pending = std::shared_future<Position>();
+		++position_.generation;
+	}
+}
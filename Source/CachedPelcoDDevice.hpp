@@ -0,0 +1,229 @@
+/// \file CachedPelcoDDevice.hpp
+/// \brief Contains classes and functions declarations that provide cached
+/// Pelco-D device implementation.
+/// \bug No known bugs.
+
+#ifndef CACHED_PELCOD_DEVICE_HPP
+#define CACHED_PELCOD_DEVICE_HPP
+
+#include "AbstractPelcoDDevice.hpp"
+
+#include <chrono>
+#include <future>
+#include <mutex>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Cache policy.
+	struct SHARED_API CachePolicy {
+
+		/// Constructor.
+		CachePolicy() noexcept;
+
+		/// Time during which pan and tilt values are fresh.
+		std::chrono::milliseconds position;
+
+		/// Time during which device temperature is fresh.
+		std::chrono::milliseconds temperature;
+
+		/// Time during which device voltage is fresh.
+		std::chrono::milliseconds voltage;
+	};
+
+	/// Class that provides cached Pelco-D device implementation.
+	/// \details Wraps a device and answers queries from values that are still
+	/// fresh. Concurrent identical queries share one request to the device.
+	class SHARED_API CachedPelcoDDevice : public AbstractPelcoDDevice {
+	public:
+
+		/// Constructor.
+		/// \param[in]	device	Wrapped device.
+		/// \param[in]	policy	Cache policy.
+		explicit CachedPelcoDDevice(AbstractPelcoDDevice& device,
+		                            const CachePolicy& policy = CachePolicy());
+
+		/// Destructor.
+		~CachedPelcoDDevice() override;
+
+	public:
+
+		/// Gets pan degrees.
+		/// \return Pan degrees.
+		std::uint16_t getPanDegrees() const override;
+
+		/// Sets pan degrees.
+		/// \param[in]	degrees	Pan degrees.
+		void setPanDegrees(std::uint16_t degrees) override;
+
+		/// Gets tilt degrees.
+		/// \return Tilt degrees.
+		std::uint16_t getTiltDegrees() const override;
+
+		/// Sets tilt degrees.
+		/// \param[in]	degrees	Tilt degrees.
+		void setTiltDegrees(std::uint16_t degrees) override;
+
+		/// Gets pan steps.
+		/// \return Pan steps.
+		std::uint16_t getPanSteps() const override;
+
+		/// Gets pan maximum number of steps.
+		/// \return Pan maximum number of steps.
+		std::uint16_t getPanMaxSteps() const override;
+
+		/// Sets pan steps.
+		/// \param[in]	steps	Pan steps.
+		void setPanSteps(std::uint16_t steps) override;
+
+		/// Gets tilt steps.
+		/// \return Tilt steps.
+		std::uint16_t getTiltSteps() const override;
+
+		/// Gets tilt maximum number of steps.
+		/// \return Tilt maximum number of steps.
+		std::uint16_t getTiltMaxSteps() const override;
+
+		/// Sets tilt steps.
+		/// \param[in]	steps	Tilt steps.
+		void setTiltSteps(std::uint16_t steps) override;
+
+		/// Gets pan and tilt position.
+		/// \return Pan and tilt position.
+		Position getPosition() const override;
+
+		/// Sets pan and tilt position.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		void setPosition(std::uint16_t panSteps,
+		                 std::uint16_t tiltSteps) override;
+
+		/// Gets device temperature.
+		/// \return Device temperature.
+		std::int16_t getTemperature() const override;
+
+		/// Gets device voltage.
+		/// \return Device voltage.
+		double getVoltage() const override;
+
+		/// Starts continuous motion.
+		/// \param[in]	motion	Motion.
+		void move(const Motion& motion) override;
+
+		/// Stops motion.
+		void stop() override;
+
+		/// Stores the current position as a preset.
+		/// \param[in]	preset	Preset number.
+		void setPreset(std::uint8_t preset) override;
+
+		/// Clears a preset.
+		/// \param[in]	preset	Preset number.
+		void clearPreset(std::uint8_t preset) override;
+
+		/// Moves to a preset.
+		/// \param[in]	preset	Preset number.
+		void goToPreset(std::uint8_t preset) override;
+
+		/// Sets zoom speed.
+		/// \param[in]	speed	Zoom speed.
+		void setZoomSpeed(std::uint8_t speed) override;
+
+		/// Sets focus speed.
+		/// \param[in]	speed	Focus speed.
+		void setFocusSpeed(std::uint8_t speed) override;
+
+	public:
+
+		/// Discards all cached values.
+		void invalidate();
+
+	private:
+
+		/// Cached value.
+		template <typename T>
+		struct Entry {
+
+			/// Constructor.
+			Entry();
+
+			/// Value.
+			T value;
+
+			/// Time when the value was obtained.
+			std::chrono::steady_clock::time_point updated;
+
+			/// Whether the value was obtained.
+			bool valid;
+
+			/// Number of times the value was invalidated.
+			std::size_t generation;
+
+			/// Result of the request in flight, if any.
+			std::shared_future<T> pending;
+		};
+
+		/// Gets a cached value or requests it from the device.
+		/// \param[in]	entry	Cached value.
+		/// \param[in]	ttl		Time during which the value is fresh.
+		/// \param[in]	request	Request to the device.
+		/// \return Value.
+		template <typename T, typename Request>
+		T load(Entry<T>& entry,
+		       std::chrono::milliseconds ttl,
+		       Request request) const;
+
+		/// Discards cached values of an axis and cached position.
+		/// \param[in]	degrees	Cached degrees.
+		/// \param[in]	steps	Cached steps.
+		void invalidate(Entry<std::uint16_t>& degrees,
+		                Entry<std::uint16_t>& steps);
+
+		/// Sends a command that changes the position.
+		/// \param[in]	command	Command to the device.
+		/// \param[in]	pan		Whether the command changes pan.
+		/// \param[in]	tilt	Whether the command changes tilt.
+		template <typename Command>
+		void update(Command command, bool pan, bool tilt);
+
+	private:
+
+		/// Wrapped device.
+		AbstractPelcoDDevice& device_;
+
+		/// Cache policy.
+		CachePolicy policy_;
+
+		/// Cached values mutex.
+		mutable std::mutex mutex_;
+
+		/// Pan degrees.
+		mutable Entry<std::uint16_t> panDegrees_;
+
+		/// Tilt degrees.
+		mutable Entry<std::uint16_t> tiltDegrees_;
+
+		/// Pan steps.
+		mutable Entry<std::uint16_t> panSteps_;
+
+		/// Pan maximum number of steps.
+		mutable Entry<std::uint16_t> panMaxSteps_;
+
+		/// Tilt steps.
+		mutable Entry<std::uint16_t> tiltSteps_;
+
+		/// Tilt maximum number of steps.
+		mutable Entry<std::uint16_t> tiltMaxSteps_;
+
+		/// Pan and tilt position.
+		mutable Entry<Position> position_;
+
+		/// Device temperature.
+		mutable Entry<std::int16_t> temperature_;
+
+		/// Device voltage.
+		mutable Entry<double> voltage_;
+	};
+}
+
+#endif
@@ -0,0 +1,128 @@
+/// \file MpscQueue.hpp
+/// \brief Contains classes and functions declarations and definitions that
+/// provide multiple-producer single-consumer queue implementation.
+/// \bug No known bugs.
+
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <utility>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides multiple-producer single-consumer queue
+	/// implementation.
+	/// \details Lock-free intrusive queue after Dmitry Vyukov. Producers push
+	/// with one atomic exchange and never wait for each other or for the
+	/// consumer. A pop may fail while a push is in progress, the value is
+	/// visible once the push returns.
+	template <typename T>
+	class MpscQueue {
+	public:
+
+		/// Constructor.
+		/// \details Initializes the queue with the stub node.
+		MpscQueue()
+			: head_(&stub_),
+			  tail_(&stub_) {
+		}
+
+		/// Destructor.
+		/// \details Destroys values that are not popped.
+		~MpscQueue() {
+			T value;
+			while (pop(value)) { }
+		}
+
+		MpscQueue(const MpscQueue&) = delete;
+		MpscQueue& operator=(const MpscQueue&) = delete;
+
+	public:
+
+		/// Pushes a value.
+		/// \details May be called from any thread.
+		/// \param[in]	value	Value.
+		void push(T value) {
+			push(new Node(std::move(value)));
+		}
+
+		/// Pops a value.
+		/// \details Must be called from one thread at a time.
+		/// \param[out]	value	Value.
+		/// \return True if a value is popped.
+		bool pop(T& value) {
+			auto tail = tail_;
+			auto next = tail->next.load(std::memory_order_acquire);
+
+			if (tail == &stub_) {
+				if (!next) {
+					return false;
+				}
+
+				tail_ = next;
+				tail = next;
+				next = next->next.load(std::memory_order_acquire);
+			}
+
+			if (!next) {
+				if (tail != head_.load(std::memory_order_acquire)) {
+					return false;
+				}
+
+				push(&stub_);
+				next = tail->next.load(std::memory_order_acquire);
+
+				if (!next) {
+					return false;
+				}
+			}
+
+			tail_ = next;
+			value = std::move(tail->value);
+			delete tail;
+			return true;
+		}
+
+	private:
+
+		/// Queue node.
+		struct Node {
+
+			/// Constructor.
+			/// \param[in]	value	Value.
+			explicit Node(T value = T())
+				: value(std::move(value)),
+				  next(nullptr) {
+			}
+
+			/// Value.
+			T value;
+
+			/// Next node.
+			std::atomic<Node*> next;
+		};
+
+		/// Pushes a node.
+		/// \param[in]	node	Node.
+		void push(Node* node) {
+			node->next.store(nullptr, std::memory_order_relaxed);
+			auto previous = head_.exchange(node, std::memory_order_acq_rel);
+			previous->next.store(node, std::memory_order_release);
+		}
+
+	private:
+
+		/// Stub node.
+		Node stub_;
+
+		/// Most recently pushed node.
+		std::atomic<Node*> head_;
+
+		/// Next node to pop.
+		Node* tail_;
+	};
+}
+
+#endif
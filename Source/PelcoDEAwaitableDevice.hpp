@@ -0,0 +1,375 @@
+/// \file PelcoDEAwaitableDevice.hpp
+/// \brief Contains classes and functions declarations and definitions that
+/// provide Pelco-DE awaitable device implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_AWAITABLE_DEVICE_HPP
+#define PELCODE_AWAITABLE_DEVICE_HPP
+
+#include "PelcoDEDeviceUDP.hpp"
+
+#include <boost/asio.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides Pelco-DE awaitable device implementation.
+	/// \details Adapts asynchronous operations of a UDP device to completion
+	/// tokens of Boost.Asio. Where the compiler supports coroutines the
+	/// default token is boost::asio::use_awaitable, so that a sequence of
+	/// operations may be written as a coroutine:
+	/// \code
+	/// auto pan = co_await device.getPanSteps();
+	/// co_await device.setPosition(pan + 100, 0);
+	/// \endcode
+	/// Otherwise the default token is boost::asio::use_future. Failed
+	/// operations throw boost::system::system_error from co_await, or pass
+	/// the error code to completion handlers. Completions are dispatched to
+	/// the executor associated with the handler, so a coroutine resumes on
+	/// the context it was spawned on. Coroutines spawned on the context of
+	/// the device fleet run without any thread switch, and thousands of them
+	/// may share one thread.
+	class PelcoDEAwaitableDevice {
+	public:
+
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+		/// Default completion token.
+		using DefaultToken = boost::asio::use_awaitable_t<>;
+#else
+		/// Default completion token.
+		using DefaultToken = boost::asio::use_future_t<>;
+#endif
+
+	public:
+
+		/// Constructor.
+		/// \param[in]	device	Device, it must outlive operations.
+		explicit PelcoDEAwaitableDevice(PelcoDEDeviceUDP& device) noexcept
+			: device_(device) {
+		}
+
+	public:
+
+		/// Gets device.
+		/// \return Adapted device.
+		PelcoDEDeviceUDP& getDevice() const noexcept {
+			return device_;
+		}
+
+		/// Gets I/O context.
+		/// \return I/O context of the fleet that performs device I/O.
+		boost::asio::io_context& getContext() const noexcept {
+			return device_.getContext();
+		}
+
+		/// Calibrates the device.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto calibrate(CompletionToken&& token = DefaultToken()) const {
+			return initiate<>(std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::Handler handler) {
+					device.asyncCalibrate(std::move(handler));
+				});
+		}
+
+		/// Gets pan degrees.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto getPanDegrees(CompletionToken&& token = DefaultToken()) const {
+			return initiate<std::uint16_t>(
+				std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::ValueHandler<std::uint16_t> handler) {
+					device.asyncGetPanDegrees(std::move(handler));
+				});
+		}
+
+		/// Sets pan degrees.
+		/// \param[in]	degrees	Pan degrees.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto setPanDegrees(std::uint16_t degrees,
+		                   CompletionToken&& token = DefaultToken()) const {
+			return initiate<>(std::forward<CompletionToken>(token),
+				[degrees](PelcoDEDeviceUDP& device,
+				          PelcoDEDeviceUDP::Handler handler) {
+					device.asyncSetPanDegrees(degrees, std::move(handler));
+				});
+		}
+
+		/// Gets tilt degrees.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto getTiltDegrees(CompletionToken&& token = DefaultToken()) const {
+			return initiate<std::uint16_t>(
+				std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::ValueHandler<std::uint16_t> handler) {
+					device.asyncGetTiltDegrees(std::move(handler));
+				});
+		}
+
+		/// Sets tilt degrees.
+		/// \param[in]	degrees	Tilt degrees.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto setTiltDegrees(std::uint16_t degrees,
+		                    CompletionToken&& token = DefaultToken()) const {
+			return initiate<>(std::forward<CompletionToken>(token),
+				[degrees](PelcoDEDeviceUDP& device,
+				          PelcoDEDeviceUDP::Handler handler) {
+					device.asyncSetTiltDegrees(degrees, std::move(handler));
+				});
+		}
+
+		/// Gets pan steps.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto getPanSteps(CompletionToken&& token = DefaultToken()) const {
+			return initiate<std::uint16_t>(
+				std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::ValueHandler<std::uint16_t> handler) {
+					device.asyncGetPanSteps(std::move(handler));
+				});
+		}
+
+		/// Gets pan maximum number of steps.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto getPanMaxSteps(CompletionToken&& token = DefaultToken()) const {
+			return initiate<std::uint16_t>(
+				std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::ValueHandler<std::uint16_t> handler) {
+					device.asyncGetPanMaxSteps(std::move(handler));
+				});
+		}
+
+		/// Sets pan steps.
+		/// \param[in]	steps	Pan steps.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto setPanSteps(std::uint16_t steps,
+		                 CompletionToken&& token = DefaultToken()) const {
+			return initiate<>(std::forward<CompletionToken>(token),
+				[steps](PelcoDEDeviceUDP& device,
+				        PelcoDEDeviceUDP::Handler handler) {
+					device.asyncSetPanSteps(steps, std::move(handler));
+				});
+		}
+
+		/// Gets tilt steps.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto getTiltSteps(CompletionToken&& token = DefaultToken()) const {
+			return initiate<std::uint16_t>(
+				std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::ValueHandler<std::uint16_t> handler) {
+					device.asyncGetTiltSteps(std::move(handler));
+				});
+		}
+
+		/// Gets tilt maximum number of steps.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto getTiltMaxSteps(CompletionToken&& token = DefaultToken()) const {
+			return initiate<std::uint16_t>(
+				std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::ValueHandler<std::uint16_t> handler) {
+					device.asyncGetTiltMaxSteps(std::move(handler));
+				});
+		}
+
+		/// Sets tilt steps.
+		/// \param[in]	steps	Tilt steps.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto setTiltSteps(std::uint16_t steps,
+		                  CompletionToken&& token = DefaultToken()) const {
+			return initiate<>(std::forward<CompletionToken>(token),
+				[steps](PelcoDEDeviceUDP& device,
+				        PelcoDEDeviceUDP::Handler handler) {
+					device.asyncSetTiltSteps(steps, std::move(handler));
+				});
+		}
+
+		/// Gets pan and tilt position.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto getPosition(CompletionToken&& token = DefaultToken()) const {
+			return initiate<Position>(
+				std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::ValueHandler<Position> handler) {
+					device.asyncGetPosition(std::move(handler));
+				});
+		}
+
+		/// Sets pan and tilt position.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		/// \param[in]	token		Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto setPosition(std::uint16_t panSteps,
+		                 std::uint16_t tiltSteps,
+		                 CompletionToken&& token = DefaultToken()) const {
+			return initiate<>(std::forward<CompletionToken>(token),
+				[panSteps, tiltSteps](PelcoDEDeviceUDP& device,
+				                      PelcoDEDeviceUDP::Handler handler) {
+					device.asyncSetPosition(panSteps, tiltSteps,
+					                        std::move(handler));
+				});
+		}
+
+		/// Gets device temperature.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto getTemperature(CompletionToken&& token = DefaultToken()) const {
+			return initiate<std::int16_t>(
+				std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::ValueHandler<std::int16_t> handler) {
+					device.asyncGetTemperature(std::move(handler));
+				});
+		}
+
+		/// Gets device voltage.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto getVoltage(CompletionToken&& token = DefaultToken()) const {
+			return initiate<double>(
+				std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::ValueHandler<double> handler) {
+					device.asyncGetVoltage(std::move(handler));
+				});
+		}
+
+		/// Gets device status.
+		/// \param[in]	token	Completion token.
+		/// \return Result of the completion token.
+		template <typename CompletionToken = DefaultToken>
+		auto getStatus(CompletionToken&& token = DefaultToken()) const {
+			return initiate<PelcoDEDeviceUDP::Status>(
+				std::forward<CompletionToken>(token),
+				[](PelcoDEDeviceUDP& device,
+				   PelcoDEDeviceUDP::ValueHandler<PelcoDEDeviceUDP::Status>
+				       handler) {
+					device.asyncGetStatus(std::move(handler));
+				});
+		}
+
+	private:
+
+		/// Completion handler adapter.
+		/// \details Keeps the completion handler and work of its executor in
+		/// shared state, so that the adapter is copyable as device handlers
+		/// require, and dispatches the completion to the handler executor.
+		template <typename Handler, typename... Values>
+		class Completion {
+		public:
+
+			/// Constructor.
+			/// \param[in]	handler		Completion handler.
+			/// \param[in]	context		I/O context of the device.
+			Completion(Handler handler, boost::asio::io_context& context)
+				: state_(std::make_shared<State>(std::move(handler),
+				                                 context)) {
+			}
+
+			/// Completes the operation.
+			/// \param[in]	error	Error code.
+			/// \param[in]	values	Operation result.
+			void operator()(const boost::system::error_code& error,
+			                Values... values) const {
+				auto state = state_;
+				auto executor = state->work.get_executor();
+
+				boost::asio::dispatch(executor,
+					[state, error, values...]() mutable {
+						auto handler = std::move(state->handler);
+						state->work.reset();
+						std::move(handler)(error, values...);
+					});
+			}
+
+		private:
+
+			/// Executor of the completion handler.
+			using Executor = boost::asio::associated_executor_t<
+				Handler, boost::asio::io_context::executor_type>;
+
+			/// Shared state of the adapter.
+			struct State {
+
+				/// Constructor.
+				/// \param[in]	handler		Completion handler.
+				/// \param[in]	context		I/O context of the device.
+				State(Handler handler, boost::asio::io_context& context)
+					: work(boost::asio::get_associated_executor(
+						  handler, context.get_executor())),
+					  handler(std::move(handler)) {
+				}
+
+				/// Outstanding work of the handler executor.
+				boost::asio::executor_work_guard<Executor> work;
+
+				/// Completion handler.
+				Handler handler;
+			};
+
+			/// Shared state.
+			std::shared_ptr<State> state_;
+		};
+
+		/// Initiates an operation.
+		/// \param[in]	token		Completion token.
+		/// \param[in]	operation	Function that starts the operation with
+		/// a device completion handler.
+		/// \return Result of the completion token.
+		template <typename... Values,
+		          typename CompletionToken,
+		          typename Operation>
+		auto initiate(CompletionToken&& token, Operation operation) const {
+			return boost::asio::async_initiate<CompletionToken,
+				void(boost::system::error_code, Values...)>(
+				[this, operation](auto handler) {
+					using Handler = decltype(handler);
+
+					operation(device_, Completion<Handler, Values...>(
+						std::move(handler), device_.getContext()));
+				},
+				token);
+		}
+
+	private:
+
+		/// Adapted device.
+		PelcoDEDeviceUDP& device_;
+	};
+}
+
+#endif
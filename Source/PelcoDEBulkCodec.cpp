@@ -0,0 +1,377 @@
+/// \file PelcoDEBulkCodec.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// bulk frame decoding.
+/// \bug No known bugs.
+
+#include "PelcoDEBulkCodec.hpp"
+
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define PELCOD_HAS_X86_SIMD
+#endif
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Contains classes and functions that encode and decode Pelco-DE frames.
+	namespace Codec {
+
+		namespace {
+
+			static_assert(sizeof(Frame) == MESSAGE_LENGTH,
+			              "Frames must be packed to decode them in bulk!");
+
+			/// Number of frames decoded by one SSSE3 iteration.
+			/// \details Sixteen frames fill seven 16-byte registers exactly.
+			constexpr std::size_t GROUP_SIZE { 16 };
+
+			/// Number of 16-byte chunks of a group of frames.
+			/// \details A group of 16 frames of 7 bytes is 7 chunks of 16
+			/// bytes.
+			constexpr std::size_t CHUNK_COUNT { MESSAGE_LENGTH };
+
+			/// Byte shuffle masks.
+			/// \details For every frame field and chunk of a group, the mask
+			/// moves the field bytes that the chunk contains to the lanes of
+			/// their frames and zeroes other lanes, so that OR of shuffled
+			/// chunks transposes the group into one register per field.
+			struct ShuffleMasks {
+
+				/// Constructor.
+				/// \details Calculates masks at compile time.
+				constexpr ShuffleMasks()
+					: masks() {
+
+					for (std::size_t field = 0; field < MESSAGE_LENGTH; ++field) {
+						for (std::size_t chunk = 0; chunk < CHUNK_COUNT; ++chunk) {
+							for (std::size_t lane = 0; lane < GROUP_SIZE; ++lane) {
+								auto offset = static_cast<int>(
+									lane * MESSAGE_LENGTH + field) -
+									static_cast<int>(chunk * GROUP_SIZE);
+
+								masks[field][chunk][lane] =
+									offset >= 0 &&
+									offset < static_cast<int>(GROUP_SIZE)
+										? static_cast<std::uint8_t>(offset)
+										: 0x80;
+							}
+						}
+					}
+				}
+
+				/// Masks by field, chunk and lane.
+				std::uint8_t masks[MESSAGE_LENGTH][CHUNK_COUNT][GROUP_SIZE];
+			};
+
+			/// Byte shuffle masks.
+			/// \details Masks shared by SSSE3 and AVX2 code.
+			constexpr ShuffleMasks SHUFFLE_MASKS {};
+
+			/// Decodes frames with portable code.
+			/// \details Decodes frames one by one.
+			/// \param[in]	data	Frame bytes.
+			/// \param[in]	count	Number of frames.
+			/// \param[out]	decoded	Decoded frames.
+			/// \return Number of valid frames.
+			std::size_t decodeScalar(const std::uint8_t* data,
+			                         std::size_t count,
+			                         const DecodedFrames& decoded) noexcept {
+				std::size_t result = 0;
+
+				for (std::size_t i = 0; i < count; ++i) {
+					FrameView frame(data + i * MESSAGE_LENGTH, MESSAGE_LENGTH);
+					auto valid = frame.validate() == FrameError::None;
+
+					decoded.addresses[i] = frame.getAddress();
+					decoded.commands[i] = frame.getCommand();
+					decoded.values[i] = frame.getValue();
+					decoded.valid[i] = valid ? 1 : 0;
+
+					result += valid ? 1 : 0;
+				}
+
+				return result;
+			}
+
+#if defined(PELCOD_HAS_X86_SIMD)
+			/// Decodes frames with SSSE3 code.
+			/// \details Transposes groups of 16 frames with byte shuffles and
+			/// validates them at once. Remaining frames are decoded by
+			/// portable code.
+			/// \param[in]	data	Frame bytes.
+			/// \param[in]	count	Number of frames.
+			/// \param[out]	decoded	Decoded frames.
+			/// \return Number of valid frames.
+			__attribute__((target("ssse3")))
+			std::size_t decodeSsse3(const std::uint8_t* data,
+			                        std::size_t count,
+			                        const DecodedFrames& decoded) noexcept {
+				std::size_t result = 0;
+				std::size_t i = 0;
+
+				const auto synchronization = _mm_set1_epi8(
+					static_cast<char>(SYNCHRONIZATION_VALUE));
+				const auto one = _mm_set1_epi8(1);
+
+				for (; i + GROUP_SIZE <= count; i += GROUP_SIZE) {
+					auto group = data + i * MESSAGE_LENGTH;
+					__m128i chunks[CHUNK_COUNT];
+					__m128i fields[MESSAGE_LENGTH];
+
+					for (std::size_t chunk = 0; chunk < CHUNK_COUNT; ++chunk) {
+						chunks[chunk] = _mm_loadu_si128(
+							reinterpret_cast<const __m128i*>(
+								group + chunk * GROUP_SIZE));
+					}
+
+					for (std::size_t field = 0; field < MESSAGE_LENGTH; ++field) {
+						auto value = _mm_setzero_si128();
+
+						for (std::size_t chunk = 0; chunk < CHUNK_COUNT; ++chunk) {
+							auto mask = _mm_loadu_si128(
+								reinterpret_cast<const __m128i*>(
+									SHUFFLE_MASKS.masks[field][chunk]));
+
+							value = _mm_or_si128(
+								value, _mm_shuffle_epi8(chunks[chunk], mask));
+						}
+
+						fields[field] = value;
+					}
+
+					auto checksum = _mm_add_epi8(
+						_mm_add_epi8(fields[ADDRESS_BYTE_INDEX],
+						             fields[COMMAND1_BYTE_INDEX]),
+						_mm_add_epi8(
+							_mm_add_epi8(fields[COMMAND2_BYTE_INDEX],
+							             fields[VALUE_HIGH_BYTE_INDEX]),
+							fields[VALUE_LOW_BYTE_INDEX]));
+
+					auto valid = _mm_and_si128(
+						_mm_cmpeq_epi8(fields[SYNCHRONIZATION_BYTE_INDEX],
+						               synchronization),
+						_mm_cmpeq_epi8(fields[CHECKSUM_BYTE_INDEX], checksum));
+
+					_mm_storeu_si128(
+						reinterpret_cast<__m128i*>(decoded.addresses + i),
+						fields[ADDRESS_BYTE_INDEX]);
+					_mm_storeu_si128(
+						reinterpret_cast<__m128i*>(decoded.commands + i),
+						fields[COMMAND2_BYTE_INDEX]);
+					_mm_storeu_si128(
+						reinterpret_cast<__m128i*>(decoded.valid + i),
+						_mm_and_si128(valid, one));
+					_mm_storeu_si128(
+						reinterpret_cast<__m128i*>(decoded.values + i),
+						_mm_unpacklo_epi8(fields[VALUE_LOW_BYTE_INDEX],
+						                  fields[VALUE_HIGH_BYTE_INDEX]));
+					_mm_storeu_si128(
+						reinterpret_cast<__m128i*>(decoded.values + i + 8),
+						_mm_unpackhi_epi8(fields[VALUE_LOW_BYTE_INDEX],
+						                  fields[VALUE_HIGH_BYTE_INDEX]));
+
+					result += static_cast<std::size_t>(
+						__builtin_popcount(_mm_movemask_epi8(valid)));
+				}
+
+				DecodedFrames rest {
+					decoded.addresses + i, decoded.commands + i,
+					decoded.values + i, decoded.valid + i
+				};
+
+				return result + decodeScalar(data + i * MESSAGE_LENGTH,
+				                             count - i, rest);
+			}
+
+			/// Decodes frames with AVX2 code.
+			/// \details Transposes two groups of 16 frames at once, one in
+			/// each 128-bit lane, since AVX2 shuffles do not cross lanes.
+			/// Remaining frames are decoded by SSSE3 code.
+			/// \param[in]	data	Frame bytes.
+			/// \param[in]	count	Number of frames.
+			/// \param[out]	decoded	Decoded frames.
+			/// \return Number of valid frames.
+			__attribute__((target("avx2")))
+			std::size_t decodeAvx2(const std::uint8_t* data,
+			                       std::size_t count,
+			                       const DecodedFrames& decoded) noexcept {
+				std::size_t result = 0;
+				std::size_t i = 0;
+
+				const auto synchronization = _mm256_set1_epi8(
+					static_cast<char>(SYNCHRONIZATION_VALUE));
+				const auto one = _mm256_set1_epi8(1);
+
+				for (; i + 2 * GROUP_SIZE <= count; i += 2 * GROUP_SIZE) {
+					auto low = data + i * MESSAGE_LENGTH;
+					auto high = low + GROUP_SIZE * MESSAGE_LENGTH;
+					__m256i chunks[CHUNK_COUNT];
+					__m256i fields[MESSAGE_LENGTH];
+
+					for (std::size_t chunk = 0; chunk < CHUNK_COUNT; ++chunk) {
+						chunks[chunk] = _mm256_inserti128_si256(
+							_mm256_castsi128_si256(_mm_loadu_si128(
+								reinterpret_cast<const __m128i*>(
+									low + chunk * GROUP_SIZE))),
+							_mm_loadu_si128(
+								reinterpret_cast<const __m128i*>(
+									high + chunk * GROUP_SIZE)), 1);
+					}
+
+					for (std::size_t field = 0; field < MESSAGE_LENGTH; ++field) {
+						auto value = _mm256_setzero_si256();
+
+						for (std::size_t chunk = 0; chunk < CHUNK_COUNT; ++chunk) {
+							auto mask = _mm256_broadcastsi128_si256(
+								_mm_loadu_si128(
+									reinterpret_cast<const __m128i*>(
+										SHUFFLE_MASKS.masks[field][chunk])));
+
+							value = _mm256_or_si256(
+								value, _mm256_shuffle_epi8(chunks[chunk], mask));
+						}
+
+						fields[field] = value;
+					}
+
+					auto checksum = _mm256_add_epi8(
+						_mm256_add_epi8(fields[ADDRESS_BYTE_INDEX],
+						                fields[COMMAND1_BYTE_INDEX]),
+						_mm256_add_epi8(
+							_mm256_add_epi8(fields[COMMAND2_BYTE_INDEX],
+							                fields[VALUE_HIGH_BYTE_INDEX]),
+							fields[VALUE_LOW_BYTE_INDEX]));
+
+					auto valid = _mm256_and_si256(
+						_mm256_cmpeq_epi8(fields[SYNCHRONIZATION_BYTE_INDEX],
+						                  synchronization),
+						_mm256_cmpeq_epi8(fields[CHECKSUM_BYTE_INDEX],
+						                  checksum));
+
+					auto valuesLow = _mm256_unpacklo_epi8(
+						fields[VALUE_LOW_BYTE_INDEX],
+						fields[VALUE_HIGH_BYTE_INDEX]);
+					auto valuesHigh = _mm256_unpackhi_epi8(
+						fields[VALUE_LOW_BYTE_INDEX],
+						fields[VALUE_HIGH_BYTE_INDEX]);
+
+					_mm256_storeu_si256(
+						reinterpret_cast<__m256i*>(decoded.addresses + i),
+						fields[ADDRESS_BYTE_INDEX]);
+					_mm256_storeu_si256(
+						reinterpret_cast<__m256i*>(decoded.commands + i),
+						fields[COMMAND2_BYTE_INDEX]);
+					_mm256_storeu_si256(
+						reinterpret_cast<__m256i*>(decoded.valid + i),
+						_mm256_and_si256(valid, one));
+					_mm256_storeu_si256(
+						reinterpret_cast<__m256i*>(decoded.values + i),
+						_mm256_permute2x128_si256(valuesLow, valuesHigh, 0x20));
+					_mm256_storeu_si256(
+						reinterpret_cast<__m256i*>(
+							decoded.values + i + GROUP_SIZE),
+						_mm256_permute2x128_si256(valuesLow, valuesHigh, 0x31));
+
+					result += static_cast<std::size_t>(
+						__builtin_popcount(static_cast<unsigned int>(
+							_mm256_movemask_epi8(valid))));
+				}
+
+				DecodedFrames rest {
+					decoded.addresses + i, decoded.commands + i,
+					decoded.values + i, decoded.valid + i
+				};
+
+				return result + decodeSsse3(data + i * MESSAGE_LENGTH,
+				                            count - i, rest);
+			}
+#endif
+
+			/// Detects the best instruction set supported by the processor.
+			/// \details Queries processor features at run time.
+			/// \return Instruction set.
+			InstructionSet detectInstructionSet() noexcept {
+#if defined(PELCOD_HAS_X86_SIMD)
+				__builtin_cpu_init();
+
+				if (__builtin_cpu_supports("avx2")) {
+					return InstructionSet::AVX2;
+				}
+
+				if (__builtin_cpu_supports("ssse3")) {
+					return InstructionSet::SSSE3;
+				}
+#endif
+				return InstructionSet::Scalar;
+			}
+		}
+
+		/// Gets the best instruction set supported by the processor.
+		/// \details Detects processor features once.
+		/// \return Instruction set.
+		InstructionSet getInstructionSet() noexcept {
+			static const auto set = detectInstructionSet();
+			return set;
+		}
+
+		/// Decodes frames with the best supported instruction set.
+		/// \details Validates synchronization bytes and checksums and
+		/// extracts addresses, commands and values of frames in bulk.
+		/// \param[in]	frames	Frames.
+		/// \param[in]	count	Number of frames.
+		/// \param[out]	decoded	Decoded frames.
+		/// \return Number of valid frames.
+		std::size_t decodeFrames(const Frame* frames,
+		                         std::size_t count,
+		                         const DecodedFrames& decoded) noexcept {
+			auto data = reinterpret_cast<const std::uint8_t*>(frames);
+
+			switch (getInstructionSet()) {
+#if defined(PELCOD_HAS_X86_SIMD)
+			case InstructionSet::AVX2:
+				return decodeAvx2(data, count, decoded);
+			case InstructionSet::SSSE3:
+				return decodeSsse3(data, count, decoded);
+#endif
+			default:
+				return decodeScalar(data, count, decoded);
+			}
+		}
+
+		/// Decodes frames with an instruction set.
+		/// \details Validates synchronization bytes and checksums and
+		/// extracts addresses, commands and values of frames in bulk with the
+		/// instruction set, for example to compare implementations.
+		/// \param[in]	frames	Frames.
+		/// \param[in]	count	Number of frames.
+		/// \param[out]	decoded	Decoded frames.
+		/// \param[in]	set		Instruction set.
+		/// \return Number of valid frames.
+		/// \throw std::invalid_argument if the instruction set is not
+		/// supported.
+		std::size_t decodeFrames(const Frame* frames,
+		                         std::size_t count,
+		                         const DecodedFrames& decoded,
+		                         InstructionSet set) {
+			if (set > getInstructionSet()) {
+				throw std::invalid_argument(
+					"The instruction set is not supported!");
+			}
+
+			auto data = reinterpret_cast<const std::uint8_t*>(frames);
+
+			switch (set) {
+#if defined(PELCOD_HAS_X86_SIMD)
+			case InstructionSet::AVX2:
+				return decodeAvx2(data, count, decoded);
+			case InstructionSet::SSSE3:
+				return decodeSsse3(data, count, decoded);
+#endif
+			default:
+				return decodeScalar(data, count, decoded);
+			}
+		}
+	}
+}
@@ -0,0 +1,78 @@
+/// \file PelcoDEBulkCodec.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE
+/// bulk frame decoding.
+/// \bug No known bugs.
+
+#ifndef PELCODE_BULK_CODEC_HPP
+#define PELCODE_BULK_CODEC_HPP
+
+#include "Export.hpp"
+#include "PelcoDECodec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Contains classes and functions that encode and decode Pelco-DE frames.
+	namespace Codec {
+
+		/// Instruction set used for bulk decoding.
+		enum class InstructionSet {
+
+			/// Portable scalar code.
+			Scalar,
+
+			/// SSSE3 code, 16 frames at a time.
+			SSSE3,
+
+			/// AVX2 code, 32 frames at a time.
+			AVX2
+		};
+
+		/// Decoded frames.
+		/// \details Arrays of decoded fields, one element per frame. Fields
+		/// of invalid frames are decoded as well.
+		struct DecodedFrames {
+
+			/// Device addresses.
+			std::uint8_t* addresses;
+
+			/// Second command bytes.
+			std::uint8_t* commands;
+
+			/// Values.
+			std::uint16_t* values;
+
+			/// Validity flags, 1 if a frame is valid and 0 otherwise.
+			std::uint8_t* valid;
+		};
+
+		/// Gets the best instruction set supported by the processor.
+		/// \return Instruction set.
+		SHARED_API InstructionSet getInstructionSet() noexcept;
+
+		/// Decodes frames with the best supported instruction set.
+		/// \param[in]	frames	Frames.
+		/// \param[in]	count	Number of frames.
+		/// \param[out]	decoded	Decoded frames.
+		/// \return Number of valid frames.
+		SHARED_API std::size_t decodeFrames(const Frame* frames,
+		                                    std::size_t count,
+		                                    const DecodedFrames& decoded) noexcept;
+
+		/// Decodes frames with an instruction set.
+		/// \param[in]	frames	Frames.
+		/// \param[in]	count	Number of frames.
+		/// \param[out]	decoded	Decoded frames.
+		/// \param[in]	set		Instruction set.
+		/// \return Number of valid frames.
+		SHARED_API std::size_t decodeFrames(const Frame* frames,
+		                                    std::size_t count,
+		                                    const DecodedFrames& decoded,
+		                                    InstructionSet set);
+	}
+}
+
+#endif
@@ -0,0 +1,461 @@
+/// \file PelcoDEBusSerial.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// serial bus implementation.
+/// \bug No known bugs.
+
+#include "PelcoDEBusSerial.hpp"
+
+#include <algorithm>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Number of bits that transmit one byte.
+		/// \details A start bit, eight data bits and a stop bit.
+		constexpr unsigned int BITS_PER_BYTE { 10 };
+
+		/// Delay before the first attempt to reopen the serial port.
+		constexpr std::chrono::milliseconds MIN_REOPEN_DELAY { 100 };
+
+		/// Maximum delay between attempts to reopen the serial port.
+		constexpr std::chrono::milliseconds MAX_REOPEN_DELAY { 10000 };
+
+		/// Checks whether a read error is transient.
+		/// \details A transient error leaves the port usable, so that reading
+		/// may go on at once.
+		/// \param[in]	error	Error code.
+		/// \return True if the error is transient.
+		bool isTransient(const boost::system::error_code& error) noexcept {
+			return error == boost::asio::error::interrupted ||
+			       error == boost::asio::error::try_again ||
+			       error == boost::asio::error::would_block;
+		}
+
+		/// Checks whether requests with a command may be coalesced.
+		/// \details A queued request may absorb a later one with the same
+		/// command to the same device if only the result of the later one
+		/// matters, that is for queries and absolute positioning.
+		/// \param[in]	command	Request command.
+		/// \return True if requests may be coalesced.
+		bool isCoalescable(std::uint8_t command) noexcept {
+			switch (command) {
+			case Codec::COMMAND_REQUEST_GET_PAN_STEPS:
+			case Codec::COMMAND_REQUEST_GET_TILT_STEPS:
+			case Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS:
+			case Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS:
+			case Codec::COMMAND_REQUEST_SET_PAN_STEPS:
+			case Codec::COMMAND_REQUEST_SET_TILT_STEPS:
+			case Codec::COMMAND_REQUEST_GET_TEMPERATURE:
+			case Codec::COMMAND_REQUEST_GET_VOLTAGE:
+				return true;
+			default:
+				return false;
+			}
+		}
+	}
+
+	/// Constructor.
+	/// \details Opens the serial port with 8 data bits, no parity, one stop
+	/// bit and no flow control and starts the bus thread.
+	/// \param[in]	device		Serial device name.
+	/// \param[in]	baudRate	Baud rate.
+	/// \throw std::invalid_argument if the baud rate is zero.
+	/// \throw boost::system::system_error if the port cannot be opened.
+	PelcoDEBusSerial::PelcoDEBusSerial(const std::string& device,
+	                                   unsigned int baudRate)
+		: context_(1),
+		  work_(boost::asio::make_work_guard(context_)),
+		  port_(context_),
+		  timer_(context_),
+		  reopenTimer_(context_),
+		  device_(device),
+		  baudRate_(baudRate),
+		  reopenDelay_(MIN_REOPEN_DELAY),
+		  readErrors_(0),
+		  wireTime_(0),
+		  policy_(),
+		  estimator_(policy_),
+		  lastAddress_(0),
+		  buffer_(),
+		  stopped_(false) {
+
+		if (baudRate_ == 0) {
+			throw std::invalid_argument("The baud rate is invalid!");
+		}
+
+		open();
+
+		wireTime_ = std::chrono::microseconds(
+			2 * Codec::MESSAGE_LENGTH * BITS_PER_BYTE * 1000000ull /
+			baudRate_);
+
+		startReceive();
+
+		thread_ = std::thread([this]() {
+			context_.run();
+		});
+	}
+
+	/// Destructor.
+	/// \details Completes queued requests and the request in flight with the
+	/// operation aborted error on the bus thread and waits for the thread to
+	/// finish. Requests submitted before the destructor is called are
+	/// completed as well.
+	PelcoDEBusSerial::~PelcoDEBusSerial() {
+		boost::asio::post(context_, [this]() {
+			shutdown();
+		});
+
+		thread_.join();
+	}
+
+	/// Gets I/O context.
+	/// \details Gets I/O context that is run by the bus thread.
+	/// \return I/O context.
+	boost::asio::io_context& PelcoDEBusSerial::getContext() noexcept {
+		return context_;
+	}
+
+	/// Gets baud rate.
+	/// \details Gets baud rate of the serial port.
+	/// \return Baud rate.
+	unsigned int PelcoDEBusSerial::getBaudRate() const noexcept {
+		return baudRate_;
+	}
+
+	/// Gets number of failed reads of the serial port.
+	/// \details Gets the number of reads that failed since the bus was
+	/// created, each fatal failure makes the bus reopen the port.
+	/// \return Number of failed reads.
+	std::size_t PelcoDEBusSerial::getReadErrorCount() const noexcept {
+		return readErrors_.load(std::memory_order_relaxed);
+	}
+
+	/// Sets retransmission policy.
+	/// \details Sets the policy of requests queued after the call and resets
+	/// response time estimation. Timeouts of the policy are counted from the
+	/// end of the transmission, the time the line takes to carry the request
+	/// and the response at the baud rate is added to them.
+	/// \param[in]	policy	Retransmission policy.
+	void PelcoDEBusSerial::setRetransmissionPolicy(
+		const RetransmissionPolicy& policy) {
+
+		boost::asio::post(context_, [this, policy]() {
+			policy_ = policy;
+			estimator_ = RoundTripEstimator(policy_);
+		});
+	}
+
+	/// Asynchronously performs a request.
+	/// \details Queues a request for the device. If a request with the same
+	/// query or positioning command to the same device is still queued, the
+	/// queued request takes the new value and completes both handlers, so
+	/// that the line is not spent on stale requests. May be called from any
+	/// thread, the handler is invoked from the bus thread.
+	/// \param[in]	address	Device address.
+	/// \param[in]	command	Request command.
+	/// \param[in]	value	Request value.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEBusSerial::asyncRequest(std::uint8_t address,
+	                                    std::uint8_t command,
+	                                    std::uint16_t value,
+	                                    Handler handler) {
+		auto request = std::make_shared<Request>();
+
+		request->address = address;
+		request->message = Codec::createFrame(address, command, value);
+		request->response = Codec::getResponseCommand(command);
+		request->handlers.push_back(std::move(handler));
+		request->retries = 0;
+
+		boost::asio::post(context_, [this, request]() {
+			enqueue(request);
+		});
+	}
+
+	/// Opens the serial port.
+	/// \details Opens the serial port with 8 data bits, no parity, one stop
+	/// bit and no flow control.
+	/// \throw boost::system::system_error if the port cannot be opened.
+	void PelcoDEBusSerial::open() {
+		using boost::asio::serial_port_base;
+
+		port_.open(device_);
+		port_.set_option(serial_port_base::baud_rate(baudRate_));
+		port_.set_option(serial_port_base::character_size(8));
+		port_.set_option(serial_port_base::parity(
+			serial_port_base::parity::none));
+		port_.set_option(serial_port_base::stop_bits(
+			serial_port_base::stop_bits::one));
+		port_.set_option(serial_port_base::flow_control(
+			serial_port_base::flow_control::none));
+	}
+
+	/// Closes the serial port and schedules reopening.
+	/// \details Closes the port and tries to open it again after a delay
+	/// that doubles after every failed attempt up to a limit. Bytes of a
+	/// partially received frame are discarded. Requests are not sent while
+	/// the port is closed, they are retransmitted on timeout until their
+	/// deadline.
+	void PelcoDEBusSerial::reopen() {
+		boost::system::error_code ignored;
+		port_.close(ignored);
+		parser_.reset();
+
+		reopenTimer_.expires_after(reopenDelay_);
+		reopenTimer_.async_wait(
+			[this](const boost::system::error_code& error) {
+				if (error || stopped_) {
+					return;
+				}
+
+				try {
+					open();
+				} catch (const boost::system::system_error&) {
+					reopenDelay_ = std::min(reopenDelay_ * 2,
+					                        MAX_REOPEN_DELAY);
+					reopen();
+					return;
+				}
+
+				reopenDelay_ = MIN_REOPEN_DELAY;
+				startReceive();
+			});
+	}
+
+	/// Queues a request.
+	/// \details Coalesces the request with the last queued request of the
+	/// device if possible and starts the exchange if the line is idle. Only
+	/// the last request is coalesced, so that a request never overtakes
+	/// requests queued before it. Requests queued after the shutdown are
+	/// aborted.
+	/// \param[in]	request	Request.
+	void PelcoDEBusSerial::enqueue(std::shared_ptr<Request> request) {
+		if (stopped_) {
+			request->handlers.front()(boost::asio::error::operation_aborted, 0);
+			return;
+		}
+
+		auto& queue = queues_[request->address];
+		auto command = request->message[Codec::COMMAND2_BYTE_INDEX];
+
+		if (isCoalescable(command) && !queue.empty() &&
+		    queue.back()->message[Codec::COMMAND2_BYTE_INDEX] == command) {
+
+			queue.back()->message = request->message;
+			queue.back()->handlers.push_back(
+				std::move(request->handlers.front()));
+			return;
+		}
+
+		request->deadline =
+			std::chrono::steady_clock::now() + policy_.deadline;
+		queue.push_back(std::move(request));
+
+		if (!current_) {
+			startNext();
+		}
+	}
+
+	/// Starts the exchange of the next request.
+	/// \details Takes the first queued request of the device that follows the
+	/// device of the last exchange in address order. Requests whose deadline
+	/// has passed while queued are completed without being sent.
+	void PelcoDEBusSerial::startNext() {
+		while (!queues_.empty()) {
+			auto queue = queues_.upper_bound(lastAddress_);
+
+			if (queue == queues_.end()) {
+				queue = queues_.begin();
+			}
+
+			auto request = std::move(queue->second.front());
+			queue->second.pop_front();
+			lastAddress_ = queue->first;
+
+			if (queue->second.empty()) {
+				queues_.erase(queue);
+			}
+
+			if (std::chrono::steady_clock::now() < request->deadline) {
+				current_ = std::move(request);
+				send();
+				return;
+			}
+
+			for (const auto& handler : request->handlers) {
+				handler(boost::asio::error::timed_out, 0);
+			}
+		}
+	}
+
+	/// Sends the current request.
+	/// \details Writes the request message and arms the response timer. The
+	/// message is not written while the port is being reopened.
+	void PelcoDEBusSerial::send() {
+		auto request = current_;
+
+		request->sent = std::chrono::steady_clock::now();
+
+		if (port_.is_open()) {
+			boost::asio::async_write(port_,
+				boost::asio::buffer(request->message),
+				[this, request](const boost::system::error_code& error,
+				                std::size_t) {
+					if (error && request == current_) {
+						timer_.cancel();
+						complete(error, 0);
+					}
+				});
+		}
+
+		timer_.expires_at(
+			std::min(request->sent + wireTime_ + estimator_.getTimeout(),
+			         request->deadline));
+		timer_.async_wait(
+			[this, request](const boost::system::error_code& error) {
+				if (!error && request == current_) {
+					handleTimeout();
+				}
+			});
+	}
+
+	/// Starts receiving bytes.
+	/// \details Feeds received bytes to the parser, so that frames split into
+	/// several reads or preceded by line noise are recovered.
+	void PelcoDEBusSerial::startReceive() {
+		port_.async_read_some(boost::asio::buffer(buffer_),
+			[this](const boost::system::error_code& error, std::size_t size) {
+				if (error) {
+					handleReadError(error);
+					return;
+				}
+
+				parser_.parse(buffer_.data(), size,
+					[this](const Codec::FrameView& frame) {
+						handleFrame(frame);
+					});
+
+				startReceive();
+			});
+	}
+
+	/// Handles a failed read.
+	/// \details Counts the failure. Reading goes on at once after a
+	/// transient error, otherwise the port is reopened. Reads aborted by the
+	/// shutdown are ignored.
+	/// \param[in]	error	Error code.
+	void PelcoDEBusSerial::handleReadError(
+		const boost::system::error_code& error) {
+
+		if (stopped_ || error == boost::asio::error::operation_aborted) {
+			return;
+		}
+
+		readErrors_.fetch_add(1, std::memory_order_relaxed);
+
+		if (isTransient(error)) {
+			startReceive();
+		} else {
+			reopen();
+		}
+	}
+
+	/// Handles a frame received from the line.
+	/// \details Completes the current request if the frame is its response.
+	/// Other frames, for example echoes of requests sent by the bus, are
+	/// ignored.
+	/// \param[in]	frame	Frame.
+	void PelcoDEBusSerial::handleFrame(const Codec::FrameView& frame) {
+		if (!current_ ||
+		    frame.getAddress() != current_->address ||
+		    frame.getCommand() != current_->response) {
+			return;
+		}
+
+		if (current_->retries == 0) {
+			auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - current_->sent);
+
+			estimator_.addSample(elapsed > wireTime_
+				? elapsed - wireTime_
+				: std::chrono::microseconds(0));
+		}
+
+		timer_.cancel();
+		complete(boost::system::error_code(), frame.getValue());
+	}
+
+	/// Handles a response timeout.
+	/// \details Retransmits the current request with a backed off timeout or
+	/// completes it with the timed out error if the deadline has passed or
+	/// the number of retransmissions is exhausted.
+	void PelcoDEBusSerial::handleTimeout() {
+		if (std::chrono::steady_clock::now() >= current_->deadline ||
+		    current_->retries >= policy_.maxRetries) {
+
+			complete(boost::asio::error::timed_out, 0);
+			return;
+		}
+
+		++current_->retries;
+		estimator_.backoff();
+		send();
+	}
+
+	/// Completes the current request.
+	/// \details Invokes the handlers of the request and starts the next
+	/// exchange.
+	/// \param[in]	error	Error code.
+	/// \param[in]	value	Response value.
+	void PelcoDEBusSerial::complete(const boost::system::error_code& error,
+	                                std::uint16_t value) {
+		auto request = std::move(current_);
+		current_.reset();
+
+		for (const auto& handler : request->handlers) {
+			handler(error, value);
+		}
+
+		startNext();
+	}
+
+	/// Aborts requests and stops the bus.
+	/// \details Completes the request in flight and queued requests with
+	/// the operation aborted error, closes the port and releases the work
+	/// guard, so that the bus thread finishes once pending handlers have
+	/// run.
+	void PelcoDEBusSerial::shutdown() {
+		stopped_ = true;
+
+		boost::system::error_code ignored;
+		timer_.cancel();
+		reopenTimer_.cancel();
+		port_.close(ignored);
+
+		std::vector<std::shared_ptr<Request>> requests;
+
+		if (current_) {
+			requests.push_back(std::move(current_));
+			current_.reset();
+		}
+
+		for (auto& queue : queues_) {
+			for (auto& request : queue.second) {
+				requests.push_back(std::move(request));
+			}
+		}
+
+		queues_.clear();
+
+		for (const auto& request : requests) {
+			for (const auto& handler : request->handlers) {
+				handler(boost::asio::error::operation_aborted, 0);
+			}
+		}
+
+		work_.reset();
+	}
+}
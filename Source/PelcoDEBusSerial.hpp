@@ -0,0 +1,214 @@
+/// \file PelcoDEBusSerial.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE
+/// serial bus implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_BUS_SERIAL_HPP
+#define PELCODE_BUS_SERIAL_HPP
+
+#include "Export.hpp"
+#include "PelcoDECodec.hpp"
+#include "PelcoDEStreamParser.hpp"
+#include "RoundTripEstimator.hpp"
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides serial Pelco-DE bus implementation.
+	/// \details A bus drives one serial line, for example an RS-485 line with
+	/// many devices, from its own thread. The line is half-duplex, so the bus
+	/// performs one exchange at a time and starts the next one as soon as a
+	/// response arrives. Devices take turns in address order, so that a busy
+	/// device cannot starve others.
+	class SHARED_API PelcoDEBusSerial {
+	public:
+
+		/// Completion handler of a request.
+		using Handler = std::function<void(const boost::system::error_code&,
+		                                   std::uint16_t)>;
+
+	public:
+
+		/// Constructor.
+		/// \param[in]	device		Serial device name.
+		/// \param[in]	baudRate	Baud rate.
+		explicit PelcoDEBusSerial(const std::string& device,
+		                          unsigned int baudRate = 9600);
+
+		/// Destructor.
+		~PelcoDEBusSerial();
+
+		PelcoDEBusSerial(const PelcoDEBusSerial&) = delete;
+		PelcoDEBusSerial& operator=(const PelcoDEBusSerial&) = delete;
+
+	public:
+
+		/// Gets I/O context.
+		/// \return I/O context that performs bus I/O.
+		boost::asio::io_context& getContext() noexcept;
+
+		/// Gets baud rate.
+		/// \return Baud rate.
+		unsigned int getBaudRate() const noexcept;
+
+		/// Gets number of failed reads of the serial port.
+		/// \return Number of failed reads.
+		std::size_t getReadErrorCount() const noexcept;
+
+		/// Sets retransmission policy.
+		/// \param[in]	policy	Retransmission policy.
+		void setRetransmissionPolicy(const RetransmissionPolicy& policy);
+
+		/// Asynchronously performs a request.
+		/// \param[in]	address	Device address.
+		/// \param[in]	command	Request command.
+		/// \param[in]	value	Request value.
+		/// \param[in]	handler	Completion handler.
+		void asyncRequest(std::uint8_t address,
+		                  std::uint8_t command,
+		                  std::uint16_t value,
+		                  Handler handler);
+
+	private:
+
+		/// Pelco-DE request.
+		struct Request {
+
+			/// Device address.
+			std::uint8_t address;
+
+			/// Request message.
+			Codec::Frame message;
+
+			/// Expected response command.
+			std::uint8_t response;
+
+			/// Completion handlers of coalesced requests.
+			std::vector<Handler> handlers;
+
+			/// Time of the last transmission.
+			std::chrono::steady_clock::time_point sent;
+
+			/// Time limit of the request.
+			std::chrono::steady_clock::time_point deadline;
+
+			/// Number of retransmissions.
+			std::size_t retries;
+		};
+
+		/// Opens the serial port.
+		void open();
+
+		/// Closes the serial port and schedules reopening.
+		void reopen();
+
+		/// Queues a request.
+		/// \param[in]	request	Request.
+		void enqueue(std::shared_ptr<Request> request);
+
+		/// Starts the exchange of the next request.
+		void startNext();
+
+		/// Sends the current request.
+		void send();
+
+		/// Starts receiving bytes.
+		void startReceive();
+
+		/// Handles a failed read.
+		/// \param[in]	error	Error code.
+		void handleReadError(const boost::system::error_code& error);
+
+		/// Handles a frame received from the line.
+		/// \param[in]	frame	Frame.
+		void handleFrame(const Codec::FrameView& frame);
+
+		/// Handles a response timeout.
+		void handleTimeout();
+
+		/// Completes the current request.
+		/// \param[in]	error	Error code.
+		/// \param[in]	value	Response value.
+		void complete(const boost::system::error_code& error,
+		              std::uint16_t value);
+
+		/// Aborts requests and stops the bus.
+		void shutdown();
+
+	private:
+
+		/// I/O context.
+		boost::asio::io_context context_;
+
+		/// Work guard that keeps the I/O context running.
+		boost::asio::executor_work_guard<
+			boost::asio::io_context::executor_type> work_;
+
+		/// Serial port.
+		boost::asio::serial_port port_;
+
+		/// Response timer.
+		boost::asio::steady_timer timer_;
+
+		/// Timer of reopening the serial port.
+		boost::asio::steady_timer reopenTimer_;
+
+		/// Serial device name.
+		std::string device_;
+
+		/// Baud rate.
+		unsigned int baudRate_;
+
+		/// Delay before the next attempt to reopen the serial port.
+		std::chrono::milliseconds reopenDelay_;
+
+		/// Number of failed reads of the serial port.
+		std::atomic<std::size_t> readErrors_;
+
+		/// Time to transmit a request and its response.
+		std::chrono::microseconds wireTime_;
+
+		/// Retransmission policy.
+		RetransmissionPolicy policy_;
+
+		/// Response time estimator.
+		RoundTripEstimator estimator_;
+
+		/// Queued requests by device address.
+		std::map<std::uint8_t, std::deque<std::shared_ptr<Request>>> queues_;
+
+		/// Address of the device of the last started request.
+		std::uint8_t lastAddress_;
+
+		/// Request being exchanged, if any.
+		std::shared_ptr<Request> current_;
+
+		/// Received bytes.
+		std::array<std::uint8_t, 64> buffer_;
+
+		/// Parser of received bytes.
+		PelcoDEStreamParser parser_;
+
+		/// Whether the bus is shut down.
+		bool stopped_;
+
+		/// Thread that runs the I/O context.
+		std::thread thread_;
+	};
+}
+
+#endif
@@ -0,0 +1,144 @@
+/// \file PelcoDECalibrationCache.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// calibration cache implementation.
+/// \bug No known bugs.
+
+#include "PelcoDECalibrationCache.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Constructor.
+	/// \details Reads calibrations from the cache file. A missing file is
+	/// treated as an empty cache, malformed lines and lines with a zero
+	/// maximum number of steps are skipped. Each line
+	/// contains IP address, port, device address, pan and tilt maximum number
+	/// of steps.
+	/// \param[in]	path	Cache file path.
+	PelcoDECalibrationCache::PelcoDECalibrationCache(const std::string& path)
+		: path_(path) {
+
+		std::ifstream file(path_);
+		std::string line;
+
+		while (std::getline(file, line)) {
+			std::istringstream stream(line);
+			std::string ip;
+			std::uint32_t port, address, panMaxSteps, tiltMaxSteps;
+
+			stream >> ip >> port >> address >> panMaxSteps >> tiltMaxSteps;
+
+			if (!stream || port > 0xFFFF || address > 0xFF
+				|| panMaxSteps == 0 || panMaxSteps > 0xFFFF
+				|| tiltMaxSteps == 0 || tiltMaxSteps > 0xFFFF) {
+				continue;
+			}
+
+			Calibration calibration;
+			calibration.panMaxSteps = static_cast<std::uint16_t>(panMaxSteps);
+			calibration.tiltMaxSteps = static_cast<std::uint16_t>(tiltMaxSteps);
+
+			calibrations_[Key(ip, port, address)] = calibration;
+		}
+	}
+
+	/// Finds a device calibration.
+	/// \details Finds a calibration by device endpoint and address.
+	/// \param[in]	endpoint	Device endpoint.
+	/// \param[in]	address		Device address.
+	/// \param[out]	calibration	Device calibration.
+	/// \return True if the calibration is found.
+	bool PelcoDECalibrationCache::find(
+		const boost::asio::ip::udp::endpoint& endpoint,
+		std::uint8_t address,
+		Calibration& calibration) const {
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		auto iterator = calibrations_.find(createKey(endpoint, address));
+
+		if (iterator == calibrations_.end()) {
+			return false;
+		}
+
+		calibration = iterator->second;
+		return true;
+	}
+
+	/// Inserts or replaces a device calibration.
+	/// \details Inserts a calibration in memory, the cache file is updated
+	/// by the save method.
+	/// \param[in]	endpoint	Device endpoint.
+	/// \param[in]	address		Device address.
+	/// \param[in]	calibration	Device calibration.
+	/// \throw std::invalid_argument if a maximum number of steps is zero.
+	void PelcoDECalibrationCache::insert(
+		const boost::asio::ip::udp::endpoint& endpoint,
+		std::uint8_t address,
+		const Calibration& calibration) {
+
+		if (calibration.panMaxSteps == 0 || calibration.tiltMaxSteps == 0) {
+			throw std::invalid_argument("The calibration is invalid!");
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		calibrations_[createKey(endpoint, address)] = calibration;
+	}
+
+	/// Removes all calibrations.
+	/// \details Removes all calibrations in memory, the cache file is updated
+	/// by the save method.
+	void PelcoDECalibrationCache::clear() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		calibrations_.clear();
+	}
+
+	/// Writes calibrations to the cache file.
+	/// \details Writes calibrations to a temporary file and renames it over
+	/// the cache file, so that the cache file is never left partially
+	/// written.
+	/// \throw std::runtime_error if the file cannot be written.
+	void PelcoDECalibrationCache::save() const {
+		auto temporary = path_ + ".tmp";
+
+		{
+			std::ofstream file(temporary, std::ios::trunc);
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			for (const auto& calibration : calibrations_) {
+				file << std::get<0>(calibration.first) << ' '
+				     << std::get<1>(calibration.first) << ' '
+				     << std::get<2>(calibration.first) << ' '
+				     << calibration.second.panMaxSteps << ' '
+				     << calibration.second.tiltMaxSteps << '\n';
+			}
+
+			file.flush();
+
+			if (!file) {
+				throw std::runtime_error("The cache file cannot be written!");
+			}
+		}
+
+		if (std::rename(temporary.c_str(), path_.c_str()) != 0) {
+			throw std::runtime_error("The cache file cannot be written!");
+		}
+	}
+
+	/// Creates a device key.
+	/// \details Creates a key from IP address, port and device address.
+	/// \param[in]	endpoint	Device endpoint.
+	/// \param[in]	address		Device address.
+	/// \return Device key.
+	PelcoDECalibrationCache::Key PelcoDECalibrationCache::createKey(
+		const boost::asio::ip::udp::endpoint& endpoint,
+		std::uint8_t address) {
+
+		return Key(endpoint.address().to_string(), endpoint.port(), address);
+	}
+}
@@ -0,0 +1,92 @@
+/// \file PelcoDECalibrationCache.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE
+/// calibration cache implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_CALIBRATION_CACHE_HPP
+#define PELCODE_CALIBRATION_CACHE_HPP
+
+#include "Export.hpp"
+
+#include <boost/asio.hpp>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Device calibration.
+	struct Calibration {
+
+		/// Pan maximum number of steps.
+		std::uint16_t panMaxSteps;
+
+		/// Tilt maximum number of steps.
+		std::uint16_t tiltMaxSteps;
+	};
+
+	/// Class that provides Pelco-DE calibration cache implementation.
+	/// \details Keeps calibrations of devices by endpoint and address in a
+	/// file, so that devices are not probed again after a restart.
+	class SHARED_API PelcoDECalibrationCache {
+	public:
+
+		/// Constructor.
+		/// \param[in]	path	Cache file path.
+		explicit PelcoDECalibrationCache(const std::string& path);
+
+	public:
+
+		/// Finds a device calibration.
+		/// \param[in]	endpoint	Device endpoint.
+		/// \param[in]	address		Device address.
+		/// \param[out]	calibration	Device calibration.
+		/// \return True if the calibration is found.
+		bool find(const boost::asio::ip::udp::endpoint& endpoint,
+		          std::uint8_t address,
+		          Calibration& calibration) const;
+
+		/// Inserts or replaces a device calibration.
+		/// \param[in]	endpoint	Device endpoint.
+		/// \param[in]	address		Device address.
+		/// \param[in]	calibration	Device calibration.
+		void insert(const boost::asio::ip::udp::endpoint& endpoint,
+		            std::uint8_t address,
+		            const Calibration& calibration);
+
+		/// Removes all calibrations.
+		void clear();
+
+		/// Writes calibrations to the cache file.
+		void save() const;
+
+	private:
+
+		/// Device key.
+		using Key = std::tuple<std::string, std::uint16_t, std::uint16_t>;
+
+		/// Creates a device key.
+		/// \param[in]	endpoint	Device endpoint.
+		/// \param[in]	address		Device address.
+		/// \return Device key.
+		static Key createKey(const boost::asio::ip::udp::endpoint& endpoint,
+		                     std::uint8_t address);
+
+	private:
+
+		/// Cache file path.
+		std::string path_;
+
+		/// Device calibrations.
+		std::map<Key, Calibration> calibrations_;
+
+		/// Device calibrations mutex.
+		mutable std::mutex mutex_;
+	};
+}
+
+#endif
@@ -0,0 +1,304 @@
+/// \file PelcoDECaptureLog.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// capture log implementation.
+/// \bug No known bugs.
+
+#include "PelcoDECaptureLog.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Capture file signature.
+		constexpr char MAGIC[] { 'P', 'D', 'E', 'C', 'A', 'P', 'T', 'R' };
+
+		/// Capture file format version.
+		constexpr std::uint32_t VERSION { 1 };
+
+		/// Size of the capture file header.
+		/// \details The header holds the signature, the format version, the
+		/// record size, the capacity and the wall clock time of the capture
+		/// start in nanoseconds since the epoch. Numbers are stored in host
+		/// byte order.
+		constexpr std::size_t HEADER_SIZE { 64 };
+
+		/// Offset of the format version in the header.
+		constexpr std::size_t VERSION_OFFSET { 8 };
+
+		/// Offset of the record size in the header.
+		constexpr std::size_t RECORD_SIZE_OFFSET { 12 };
+
+		/// Offset of the capacity in the header.
+		constexpr std::size_t CAPACITY_OFFSET { 16 };
+
+		/// Offset of the capture start time in the header.
+		constexpr std::size_t START_OFFSET { 24 };
+
+		/// Size of a record.
+		constexpr std::size_t RECORD_SIZE { 40 };
+
+		/// Offset of the time in nanoseconds since the capture start.
+		constexpr std::size_t TIME_OFFSET { 0 };
+
+		/// Offset of the endpoint address, IPv4 addresses are mapped to IPv6.
+		constexpr std::size_t ADDRESS_OFFSET { 8 };
+
+		/// Offset of the endpoint port.
+		constexpr std::size_t PORT_OFFSET { 24 };
+
+		/// Offset of the direction.
+		constexpr std::size_t DIRECTION_OFFSET { 26 };
+
+		/// Offset of the flag that is set when the record is complete.
+		constexpr std::size_t COMMITTED_OFFSET { 27 };
+
+		/// Offset of the frame.
+		constexpr std::size_t FRAME_OFFSET { 28 };
+
+		static_assert(FRAME_OFFSET + std::tuple_size<Codec::Frame>::value <=
+		              RECORD_SIZE, "The record layout is broken!");
+
+		/// Writes a number in host byte order.
+		/// \param[out]	data	Destination.
+		/// \param[in]	value	Number.
+		template <typename T>
+		void store(char* data, T value) noexcept {
+			std::memcpy(data, &value, sizeof(value));
+		}
+
+		/// Reads a number in host byte order.
+		/// \param[in]	data	Source.
+		/// \return Number.
+		template <typename T>
+		T load(const char* data) noexcept {
+			T value;
+			std::memcpy(&value, data, sizeof(value));
+			return value;
+		}
+	}
+
+	/// Constructor.
+	/// \details Creates or truncates the capture file, sizes it for the
+	/// capacity and maps it into memory. Unused space is not allocated on
+	/// file systems that support sparse files.
+	/// \param[in]	path		Capture file path.
+	/// \param[in]	capacity	Maximum number of records.
+	/// \throw std::invalid_argument if the capacity is zero or too large.
+	/// \throw std::runtime_error if the file cannot be written.
+	PelcoDECaptureLog::PelcoDECaptureLog(const std::string& path,
+	                                     std::size_t capacity)
+		: capacity_(capacity),
+		  start_(std::chrono::steady_clock::now()),
+		  next_(0),
+		  dropped_(0) {
+
+		if (capacity_ == 0) {
+			throw std::invalid_argument("The capacity is zero!");
+		}
+
+		if (capacity_ > static_cast<std::uint64_t>(
+			std::numeric_limits<std::streamoff>::max() - HEADER_SIZE) /
+			RECORD_SIZE) {
+
+			throw std::invalid_argument("The capacity is too large!");
+		}
+
+		try {
+			{
+				std::filebuf file;
+
+				if (!file.open(path, std::ios::out | std::ios::trunc |
+				                     std::ios::binary)) {
+					throw std::runtime_error(
+						"The capture file cannot be written!");
+				}
+
+				file.pubseekoff(static_cast<std::streamoff>(
+					HEADER_SIZE + capacity_ * RECORD_SIZE - 1), std::ios::beg);
+				file.sputc(0);
+			}
+
+			mapping_ = boost::interprocess::file_mapping(
+				path.c_str(), boost::interprocess::read_write);
+			region_ = boost::interprocess::mapped_region(
+				mapping_, boost::interprocess::read_write);
+		} catch (const boost::interprocess::interprocess_exception&) {
+			throw std::runtime_error("The capture file cannot be written!");
+		}
+
+		auto header = static_cast<char*>(region_.get_address());
+
+		std::memcpy(header, MAGIC, sizeof(MAGIC));
+		store(header + VERSION_OFFSET, VERSION);
+		store(header + RECORD_SIZE_OFFSET,
+		      static_cast<std::uint32_t>(RECORD_SIZE));
+		store(header + CAPACITY_OFFSET, static_cast<std::uint64_t>(capacity_));
+		store(header + START_OFFSET, static_cast<std::int64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count()));
+	}
+
+	/// Destructor.
+	/// \details Writes records to the file. Fleets must stop capturing
+	/// before the log is destroyed.
+	PelcoDECaptureLog::~PelcoDECaptureLog() {
+		region_.flush(0, 0, false);
+	}
+
+	/// Records a frame.
+	/// \details Reserves the next record and fills it in place. The record
+	/// is marked complete last, so that a reader of a log left by a crashed
+	/// process skips records that were reserved but not filled. The method
+	/// may be called from any thread.
+	/// \param[in]	direction	Frame direction.
+	/// \param[in]	endpoint	Device endpoint.
+	/// \param[in]	frame		Frame.
+	/// \param[in]	time		Time of the transfer.
+	void PelcoDECaptureLog::record(
+		Direction direction,
+		const boost::asio::ip::udp::endpoint& endpoint,
+		const Codec::Frame& frame,
+		std::chrono::steady_clock::time_point time) noexcept {
+
+		auto index = next_.fetch_add(1, std::memory_order_relaxed);
+
+		if (index >= capacity_) {
+			dropped_.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		auto data = static_cast<char*>(region_.get_address()) +
+		            HEADER_SIZE + index * RECORD_SIZE;
+
+		auto address = endpoint.address().is_v4()
+			? boost::asio::ip::make_address_v6(
+				boost::asio::ip::v4_mapped, endpoint.address().to_v4())
+			: endpoint.address().to_v6();
+
+		auto bytes = address.to_bytes();
+
+		store(data + TIME_OFFSET, static_cast<std::int64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+				time - start_).count()));
+		std::memcpy(data + ADDRESS_OFFSET, bytes.data(), bytes.size());
+		store(data + PORT_OFFSET, endpoint.port());
+		store(data + DIRECTION_OFFSET, static_cast<std::uint8_t>(direction));
+		std::memcpy(data + FRAME_OFFSET, frame.data(), frame.size());
+
+		std::atomic_thread_fence(std::memory_order_release);
+		store(data + COMMITTED_OFFSET, static_cast<std::uint8_t>(1));
+	}
+
+	/// Gets number of records.
+	/// \details Gets number of records reserved so far, records may still
+	/// be filled by other threads.
+	/// \return Number of written records.
+	std::size_t PelcoDECaptureLog::getCount() const noexcept {
+		return std::min(next_.load(std::memory_order_relaxed), capacity_);
+	}
+
+	/// Gets number of dropped records.
+	/// \details Gets number of frames that were not recorded because the
+	/// log is full.
+	/// \return Number of records dropped because the log is full.
+	std::size_t PelcoDECaptureLog::getDropped() const noexcept {
+		return dropped_.load(std::memory_order_relaxed);
+	}
+
+	/// Gets maximum number of records.
+	/// \details Gets number of records the file is sized for.
+	/// \return Maximum number of records.
+	std::size_t PelcoDECaptureLog::getCapacity() const noexcept {
+		return capacity_;
+	}
+
+	/// Writes records to the file.
+	/// \details Waits until mapped pages are written to the file. The system
+	/// writes them on its own otherwise, also if the process crashes.
+	/// \throw std::runtime_error if the file cannot be written.
+	void PelcoDECaptureLog::flush() {
+		if (!region_.flush(0, 0, false)) {
+			throw std::runtime_error("The capture file cannot be written!");
+		}
+	}
+
+	/// Reads a capture file.
+	/// \details Reads complete records of all slots the file is sized for.
+	/// Threads reserve records in order but may complete them out of order,
+	/// so records that are incomplete, because a thread was still filling
+	/// them or the process crashed, are skipped rather than ending the
+	/// log.
+	/// \param[in]	path	Capture file path.
+	/// \return Records in the order they were written.
+	/// \throw std::runtime_error if the file cannot be read or is invalid.
+	std::vector<PelcoDECaptureLog::Record> PelcoDECaptureLog::read(
+		const std::string& path) {
+
+		boost::interprocess::mapped_region region;
+
+		try {
+			boost::interprocess::file_mapping mapping(
+				path.c_str(), boost::interprocess::read_only);
+			region = boost::interprocess::mapped_region(
+				mapping, boost::interprocess::read_only);
+		} catch (const boost::interprocess::interprocess_exception&) {
+			throw std::runtime_error("The capture file cannot be read!");
+		}
+
+		auto header = static_cast<const char*>(region.get_address());
+		auto size = region.get_size();
+
+		if (size < HEADER_SIZE ||
+		    std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0 ||
+		    load<std::uint32_t>(header + VERSION_OFFSET) != VERSION ||
+		    load<std::uint32_t>(header + RECORD_SIZE_OFFSET) != RECORD_SIZE) {
+
+			throw std::runtime_error("The capture file is invalid!");
+		}
+
+		auto capacity = std::min<std::uint64_t>(
+			load<std::uint64_t>(header + CAPACITY_OFFSET),
+			(size - HEADER_SIZE) / RECORD_SIZE);
+
+		std::vector<Record> records;
+
+		for (std::uint64_t i = 0; i < capacity; ++i) {
+			auto data = header + HEADER_SIZE + i * RECORD_SIZE;
+
+			if (load<std::uint8_t>(data + COMMITTED_OFFSET) == 0) {
+				continue;
+			}
+
+			boost::asio::ip::address_v6::bytes_type bytes;
+			std::memcpy(bytes.data(), data + ADDRESS_OFFSET, bytes.size());
+
+			boost::asio::ip::address_v6 address(bytes);
+
+			Record record;
+
+			record.time = std::chrono::nanoseconds(
+				load<std::int64_t>(data + TIME_OFFSET));
+			record.direction = static_cast<Direction>(
+				load<std::uint8_t>(data + DIRECTION_OFFSET));
+			record.endpoint = boost::asio::ip::udp::endpoint(
+				address.is_v4_mapped()
+					? boost::asio::ip::address(boost::asio::ip::make_address_v4(
+						boost::asio::ip::v4_mapped, address))
+					: boost::asio::ip::address(address),
+				load<std::uint16_t>(data + PORT_OFFSET));
+			std::memcpy(record.frame.data(), data + FRAME_OFFSET,
+			            record.frame.size());
+
+			records.push_back(record);
+		}
+
+		return records;
+	}
+}
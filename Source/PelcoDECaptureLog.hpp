@@ -0,0 +1,129 @@
+/// \file PelcoDECaptureLog.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE
+/// capture log implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_CAPTURE_LOG_HPP
+#define PELCODE_CAPTURE_LOG_HPP
+
+#include "Export.hpp"
+#include "PelcoDECodec.hpp"
+
+#include <boost/asio.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides Pelco-DE capture log implementation.
+	/// \details Records frames sent and received by fleets in an append-only
+	/// binary file mapped into memory. Records have a fixed size and are
+	/// written without locks or system calls, so that capturing does not
+	/// slow down the I/O it observes. The file is sized for a fixed number of
+	/// records, records beyond it are dropped and counted.
+	class SHARED_API PelcoDECaptureLog {
+	public:
+
+		/// Frame direction.
+		enum class Direction : std::uint8_t {
+
+			/// Frame sent to a device.
+			Sent = 1,
+
+			/// Frame received from a device.
+			Received = 2
+		};
+
+		/// Captured frame.
+		struct Record {
+
+			/// Time since the capture start.
+			std::chrono::nanoseconds time;
+
+			/// Frame direction.
+			Direction direction;
+
+			/// Destination endpoint of a sent frame or sender endpoint of a
+			/// received one.
+			boost::asio::ip::udp::endpoint endpoint;
+
+			/// Frame.
+			Codec::Frame frame;
+		};
+
+	public:
+
+		/// Constructor.
+		/// \param[in]	path		Capture file path.
+		/// \param[in]	capacity	Maximum number of records.
+		explicit PelcoDECaptureLog(const std::string& path,
+		                           std::size_t capacity = 1024 * 1024);
+
+		/// Destructor.
+		~PelcoDECaptureLog();
+
+		PelcoDECaptureLog(const PelcoDECaptureLog&) = delete;
+		PelcoDECaptureLog& operator=(const PelcoDECaptureLog&) = delete;
+
+	public:
+
+		/// Records a frame.
+		/// \param[in]	direction	Frame direction.
+		/// \param[in]	endpoint	Device endpoint.
+		/// \param[in]	frame		Frame.
+		/// \param[in]	time		Time of the transfer.
+		void record(Direction direction,
+		            const boost::asio::ip::udp::endpoint& endpoint,
+		            const Codec::Frame& frame,
+		            std::chrono::steady_clock::time_point time) noexcept;
+
+		/// Gets number of records.
+		/// \return Number of written records.
+		std::size_t getCount() const noexcept;
+
+		/// Gets number of dropped records.
+		/// \return Number of records dropped because the log is full.
+		std::size_t getDropped() const noexcept;
+
+		/// Gets maximum number of records.
+		/// \return Maximum number of records.
+		std::size_t getCapacity() const noexcept;
+
+		/// Writes records to the file.
+		void flush();
+
+		/// Reads a capture file.
+		/// \param[in]	path	Capture file path.
+		/// \return Records in the order they were written.
+		static std::vector<Record> read(const std::string& path);
+
+	private:
+
+		/// Maximum number of records.
+		std::size_t capacity_;
+
+		/// Capture file mapping.
+		boost::interprocess::file_mapping mapping_;
+
+		/// Mapped capture file.
+		boost::interprocess::mapped_region region_;
+
+		/// Time of the capture start.
+		std::chrono::steady_clock::time_point start_;
+
+		/// Index of the next record.
+		std::atomic<std::size_t> next_;
+
+		/// Number of dropped records.
+		std::atomic<std::size_t> dropped_;
+	};
+}
+
+#endif
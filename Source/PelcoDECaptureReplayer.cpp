@@ -0,0 +1,293 @@
+/// \file PelcoDECaptureReplayer.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// capture replayer implementation.
+/// \bug No known bugs.
+
+#include "PelcoDECaptureReplayer.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Message batch size.
+		/// \details Maximum number of frames sent before received responses
+		/// are handled.
+		constexpr std::size_t BATCH_SIZE { 64 };
+
+		/// Socket buffer size.
+		/// \details Requested size of the receive buffer in bytes, so that
+		/// responses to fast replays are not dropped. The system may limit
+		/// it.
+		constexpr int SOCKET_BUFFER_SIZE { 4 * 1024 * 1024 };
+
+		/// Selects records of a direction.
+		/// \param[in]	records		Records.
+		/// \param[in]	direction	Frame direction.
+		/// \return Records of the direction.
+		std::vector<const PelcoDECaptureLog::Record*> select(
+			const std::vector<PelcoDECaptureLog::Record>& records,
+			PelcoDECaptureLog::Direction direction) {
+
+			std::vector<const PelcoDECaptureLog::Record*> selected;
+
+			for (auto& record : records) {
+				if (record.direction == direction) {
+					selected.push_back(&record);
+				}
+			}
+
+			return selected;
+		}
+	}
+
+	/// Constructor.
+	/// \details Initializes object fields, records are replayed at their
+	/// original speed.
+	/// \param[in]	records	Captured frames.
+	PelcoDECaptureReplayer::PelcoDECaptureReplayer(
+		std::vector<PelcoDECaptureLog::Record> records)
+		: records_(std::move(records)),
+		  speed_(1.0) {
+
+		std::stable_sort(records_.begin(), records_.end(),
+			[](const PelcoDECaptureLog::Record& left,
+			   const PelcoDECaptureLog::Record& right) {
+				return left.time < right.time;
+			});
+	}
+
+	/// Constructor.
+	/// \details Reads records of a capture file.
+	/// \param[in]	path	Capture file path.
+	/// \throw std::runtime_error if the file cannot be read or is invalid.
+	PelcoDECaptureReplayer::PelcoDECaptureReplayer(const std::string& path)
+		: PelcoDECaptureReplayer(PelcoDECaptureLog::read(path)) {
+	}
+
+	/// Sets replay speed.
+	/// \details Intervals between frames are divided by the speed factor.
+	/// \param[in]	speed	Speed factor, zero to replay as fast as possible.
+	/// \throw std::invalid_argument if the speed is negative.
+	void PelcoDECaptureReplayer::setSpeed(double speed) {
+		if (!(speed >= 0)) {
+			throw std::invalid_argument("The speed is negative!");
+		}
+
+		speed_ = speed;
+	}
+
+	/// Gets replay speed.
+	/// \details Gets the factor intervals between frames are divided by.
+	/// \return Speed factor, zero to replay as fast as possible.
+	double PelcoDECaptureReplayer::getSpeed() const noexcept {
+		return speed_;
+	}
+
+	/// Gets captured frames.
+	/// \details Gets records in the order of their capture time.
+	/// \return Captured frames.
+	const std::vector<PelcoDECaptureLog::Record>&
+	PelcoDECaptureReplayer::getRecords() const noexcept {
+		return records_;
+	}
+
+	/// Replays sent frames against a responder.
+	/// \details Sends captured requests to the responder from one socket and
+	/// counts datagrams of the frame size it sends back, whether or not they
+	/// match the requests. Responses that arrive within the linger time after
+	/// the last frame are counted as well.
+	/// \param[in]	responder	Responder endpoint.
+	/// \param[in]	linger		Time to wait for late responses.
+	/// \return Replay statistics.
+	/// \throw boost::system::system_error on failure.
+	PelcoDECaptureReplayer::Statistics PelcoDECaptureReplayer::replay(
+		const boost::asio::ip::udp::endpoint& responder,
+		std::chrono::milliseconds linger) const {
+
+		Statistics statistics { 0, 0, std::chrono::microseconds(0),
+		                        std::chrono::microseconds(0) };
+
+		auto frames = select(records_, PelcoDECaptureLog::Direction::Sent);
+
+		if (frames.empty()) {
+			return statistics;
+		}
+
+		boost::asio::io_context context;
+		boost::asio::ip::udp::socket socket(
+			context, boost::asio::ip::udp::endpoint(responder.protocol(), 0));
+		boost::asio::steady_timer timer(context);
+
+		boost::system::error_code ignored;
+		socket.set_option(boost::asio::socket_base::receive_buffer_size(
+			SOCKET_BUFFER_SIZE), ignored);
+
+		Codec::Frame response;
+		boost::asio::ip::udp::endpoint sender;
+
+		std::function<void()> receive = [&]() {
+			socket.async_receive_from(boost::asio::buffer(response), sender,
+				[&](const boost::system::error_code& error, std::size_t size) {
+					if (error == boost::asio::error::operation_aborted) {
+						return;
+					}
+
+					if (!error && size == response.size()) {
+						++statistics.responses;
+					}
+
+					receive();
+				});
+		};
+
+		auto origin = frames.front()->time;
+		auto start = std::chrono::steady_clock::now();
+		auto last = start;
+		std::size_t next = 0;
+
+		std::function<void()> send = [&]() {
+			for (std::size_t i = 0; i < BATCH_SIZE && next < frames.size();
+			     ++i) {
+
+				auto now = std::chrono::steady_clock::now();
+				auto due = getDue(start, origin, *frames[next]);
+
+				if (due > now) {
+					timer.expires_at(due);
+					timer.async_wait(
+						[&](const boost::system::error_code& error) {
+							if (!error) {
+								send();
+							}
+						});
+
+					return;
+				}
+
+				if (speed_ > 0) {
+					statistics.lag = std::max(statistics.lag,
+						std::chrono::duration_cast<std::chrono::microseconds>(
+							now - due));
+				}
+
+				socket.send_to(boost::asio::buffer(frames[next]->frame),
+				               responder);
+
+				last = now;
+				++statistics.frames;
+				++next;
+			}
+
+			if (next < frames.size()) {
+				boost::asio::post(context, send);
+				return;
+			}
+
+			timer.expires_after(linger);
+			timer.async_wait([&](const boost::system::error_code&) {
+				socket.close(ignored);
+			});
+		};
+
+		receive();
+		boost::asio::post(context, send);
+		context.run();
+
+		statistics.duration =
+			std::chrono::duration_cast<std::chrono::microseconds>(last - start);
+
+		return statistics;
+	}
+
+	/// Replays received frames into a fleet.
+	/// \details Delivers captured responses to devices of the fleet as if
+	/// they were received from their original senders, so that devices must
+	/// be attached with the captured endpoints and addresses to handle them.
+	/// The fleet must be run by another thread. Waits until all frames are
+	/// handled.
+	/// \param[in]	fleet	Fleet.
+	/// \return Replay statistics, without responses.
+	/// \throw std::logic_error if called from the fleet thread.
+	PelcoDECaptureReplayer::Statistics PelcoDECaptureReplayer::replay(
+		PelcoDEFleetUDP& fleet) const {
+
+		if (fleet.getContext().get_executor().running_in_this_thread()) {
+			throw std::logic_error("The method is called from the fleet thread!");
+		}
+
+		Statistics statistics { 0, 0, std::chrono::microseconds(0),
+		                        std::chrono::microseconds(0) };
+
+		auto frames = select(records_, PelcoDECaptureLog::Direction::Received);
+
+		if (frames.empty()) {
+			return statistics;
+		}
+
+		auto origin = frames.front()->time;
+		auto start = std::chrono::steady_clock::now();
+		auto last = start;
+
+		for (auto frame : frames) {
+			if (speed_ > 0) {
+				auto due = getDue(start, origin, *frame);
+				std::this_thread::sleep_until(due);
+
+				last = std::chrono::steady_clock::now();
+				statistics.lag = std::max(statistics.lag,
+					std::chrono::duration_cast<std::chrono::microseconds>(
+						last - due));
+			}
+
+			boost::asio::post(fleet.getContext(), [&fleet, frame]() {
+				fleet.deliver(frame->frame, frame->endpoint);
+			});
+
+			++statistics.frames;
+		}
+
+		auto promise = std::make_shared<std::promise<void>>();
+		boost::asio::post(fleet.getContext(),
+		                  [promise]() { promise->set_value(); });
+		promise->get_future().wait();
+
+		if (speed_ == 0) {
+			last = std::chrono::steady_clock::now();
+		}
+
+		statistics.duration =
+			std::chrono::duration_cast<std::chrono::microseconds>(last - start);
+
+		return statistics;
+	}
+
+	/// Gets the time a record is due.
+	/// \details Scales the interval between the record and the first
+	/// replayed record by the speed factor. Every record is due at once if
+	/// records are replayed as fast as possible.
+	/// \param[in]	start	Time of the replay start.
+	/// \param[in]	origin	Capture time of the first replayed record.
+	/// \param[in]	record	Record.
+	/// \return Time the record is due.
+	std::chrono::steady_clock::time_point PelcoDECaptureReplayer::getDue(
+		std::chrono::steady_clock::time_point start,
+		std::chrono::nanoseconds origin,
+		const PelcoDECaptureLog::Record& record) const noexcept {
+
+		if (speed_ == 0) {
+			return start;
+		}
+
+		return start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::duration<double, std::nano>(
+				static_cast<double>((record.time - origin).count()) / speed_));
+	}
+}
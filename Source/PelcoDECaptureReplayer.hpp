@@ -0,0 +1,109 @@
+/// \file PelcoDECaptureReplayer.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE
+/// capture replayer implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_CAPTURE_REPLAYER_HPP
+#define PELCODE_CAPTURE_REPLAYER_HPP
+
+#include "Export.hpp"
+#include "PelcoDECaptureLog.hpp"
+#include "PelcoDEFleetUDP.hpp"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides Pelco-DE capture replayer implementation.
+	/// \details Plays captured frames back with their original timing scaled
+	/// by a speed factor, or as fast as possible. Sent frames are replayed
+	/// against a responder, received frames are replayed into a fleet as if
+	/// they arrived from the network.
+	class SHARED_API PelcoDECaptureReplayer {
+	public:
+
+		/// Replay statistics.
+		struct Statistics {
+
+			/// Number of replayed frames.
+			std::uint64_t frames;
+
+			/// Number of responses of the responder.
+			std::uint64_t responses;
+
+			/// Time from the first to the last replayed frame.
+			std::chrono::microseconds duration;
+
+			/// Maximum delay of a frame after its scheduled time.
+			std::chrono::microseconds lag;
+		};
+
+	public:
+
+		/// Constructor.
+		/// \param[in]	records	Captured frames.
+		explicit PelcoDECaptureReplayer(
+			std::vector<PelcoDECaptureLog::Record> records);
+
+		/// Constructor.
+		/// \param[in]	path	Capture file path.
+		explicit PelcoDECaptureReplayer(const std::string& path);
+
+	public:
+
+		/// Sets replay speed.
+		/// \param[in]	speed	Speed factor, zero to replay as fast as
+		/// possible.
+		void setSpeed(double speed);
+
+		/// Gets replay speed.
+		/// \return Speed factor, zero to replay as fast as possible.
+		double getSpeed() const noexcept;
+
+		/// Gets captured frames.
+		/// \return Captured frames.
+		const std::vector<PelcoDECaptureLog::Record>&
+		getRecords() const noexcept;
+
+		/// Replays sent frames against a responder.
+		/// \param[in]	responder	Responder endpoint.
+		/// \param[in]	linger		Time to wait for late responses.
+		/// \return Replay statistics.
+		Statistics replay(const boost::asio::ip::udp::endpoint& responder,
+		                  std::chrono::milliseconds linger =
+		                  	std::chrono::milliseconds(100)) const;
+
+		/// Replays received frames into a fleet.
+		/// \param[in]	fleet	Fleet.
+		/// \return Replay statistics.
+		Statistics replay(PelcoDEFleetUDP& fleet) const;
+
+	private:
+
+		/// Gets the time a record is due.
+		/// \param[in]	start	Time of the replay start.
+		/// \param[in]	origin	Capture time of the first replayed record.
+		/// \param[in]	record	Record.
+		/// \return Time the record is due.
+		std::chrono::steady_clock::time_point getDue(
+			std::chrono::steady_clock::time_point start,
+			std::chrono::nanoseconds origin,
+			const PelcoDECaptureLog::Record& record) const noexcept;
+
+	private:
+
+		/// Captured frames.
+		std::vector<PelcoDECaptureLog::Record> records_;
+
+		/// Speed factor.
+		double speed_;
+	};
+}
+
+#endif
@@ -0,0 +1,589 @@
+/// \file PelcoDECodec.hpp
+/// \brief Contains classes and functions declarations and definitions that
+/// provide Pelco-DE frame codec implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_CODEC_HPP
+#define PELCODE_CODEC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Contains classes and functions that encode and decode Pelco-DE frames.
+	/// \details Everything is header-only, allocation-free and usable in
+	/// constant expressions, so that every transport shares one hot path.
+	namespace Codec {
+
+		/// Pelco-DE request command to get pan steps.
+		/// \details Request command value to obtain pan value in steps.
+		constexpr std::uint8_t COMMAND_REQUEST_GET_PAN_STEPS { 0x51 };
+
+		/// Pelco-DE request command to get tilt steps.
+		/// \details Request command value to obtain tilt value in steps.
+		constexpr std::uint8_t COMMAND_REQUEST_GET_TILT_STEPS { 0x53 };
+
+		/// Pelco-DE request command to get pan maximum number of steps.
+		/// \details Request command value to obtain pan maximum value in
+		/// steps.
+		constexpr std::uint8_t COMMAND_REQUEST_GET_PAN_MAX_STEPS { 0x55 };
+
+		/// Pelco-DE request command to get tilt maximum number of steps.
+		/// \details Request command value to obtain tilt maximum value in
+		/// steps.
+		constexpr std::uint8_t COMMAND_REQUEST_GET_TILT_MAX_STEPS { 0x57 };
+
+		/// Pelco-DE response command to get pan steps.
+		/// \details Response command value to obtain pan value in steps.
+		constexpr std::uint8_t COMMAND_RESPONSE_GET_PAN_STEPS { 0x61 };
+
+		/// Pelco-DE response command to get tilt steps.
+		/// \details Response command value to obtain tilt value in steps.
+		constexpr std::uint8_t COMMAND_RESPONSE_GET_TILT_STEPS { 0x63 };
+
+		/// Pelco-DE response command to get pan maximum number of steps.
+		/// \details Response command value to obtain pan maximum value in
+		/// steps.
+		constexpr std::uint8_t COMMAND_RESPONSE_GET_PAN_MAX_STEPS { 0x65 };
+
+		/// Pelco-DE response command to get tilt maximum number of steps.
+		/// \details Response command value to obtain tilt maximum value in
+		/// steps.
+		constexpr std::uint8_t COMMAND_RESPONSE_GET_TILT_MAX_STEPS { 0x67 };
+
+		/// Pelco-DE request command to set pan steps.
+		/// \details Request command value to set pan value in steps.
+		constexpr std::uint8_t COMMAND_REQUEST_SET_PAN_STEPS { 0x71 };
+
+		/// Pelco-DE request command to set tilt steps.
+		/// \details Request command value to set tilt value in steps.
+		constexpr std::uint8_t COMMAND_REQUEST_SET_TILT_STEPS { 0x73 };
+
+		/// Pelco-DE response command to set pan steps.
+		/// \details Response command value to set pan value in steps.
+		constexpr std::uint8_t COMMAND_RESPONSE_SET_PAN_STEPS { 0x7C };
+
+		/// Pelco-DE response command to set tilt steps.
+		/// \details Response command value to set tilt value in steps.
+		constexpr std::uint8_t COMMAND_RESPONSE_SET_TILT_STEPS { 0x7C };
+
+		/// Pelco-DE request command to get temperature.
+		/// \details Request command value to obtain temperature value.
+		constexpr std::uint8_t COMMAND_REQUEST_GET_TEMPERATURE { 0x91 };
+
+		/// Pelco-DE request command to get voltage.
+		/// \details Request command value to obtain voltage value.
+		constexpr std::uint8_t COMMAND_REQUEST_GET_VOLTAGE { 0x9B };
+
+		/// Pelco-DE response command to get temperature.
+		/// \details Response command value to obtain temperature value.
+		constexpr std::uint8_t COMMAND_RESPONSE_GET_TEMPERATURE { 0xA1 };
+
+		/// Pelco-DE response command to get voltage.
+		/// \details Response command value to obtain voltage value.
+		constexpr std::uint8_t COMMAND_RESPONSE_GET_VOLTAGE { 0xAB };
+
+		/// Standard Pelco-D command bytes.
+		struct StandardCommand {
+
+			/// First command byte.
+			std::uint8_t command1;
+
+			/// Second command byte.
+			std::uint8_t command2;
+		};
+
+		/// Standard Pelco-D operation.
+		/// \details Operations index the standard command table. Motion
+		/// operations are bits that may be combined in one frame.
+		enum class StandardOperation : std::size_t {
+
+			/// Pan right, first data byte is pan speed.
+			PanRight,
+
+			/// Pan left, first data byte is pan speed.
+			PanLeft,
+
+			/// Tilt up, second data byte is tilt speed.
+			TiltUp,
+
+			/// Tilt down, second data byte is tilt speed.
+			TiltDown,
+
+			/// Zoom in.
+			ZoomTele,
+
+			/// Zoom out.
+			ZoomWide,
+
+			/// Focus far.
+			FocusFar,
+
+			/// Focus near.
+			FocusNear,
+
+			/// Store the current position as a preset, second data byte is
+			/// the preset number.
+			SetPreset,
+
+			/// Clear a preset, second data byte is the preset number.
+			ClearPreset,
+
+			/// Move to a preset, second data byte is the preset number.
+			GoToPreset,
+
+			/// Set zoom speed, second data byte is the speed from 0 to 3.
+			SetZoomSpeed,
+
+			/// Set focus speed, second data byte is the speed from 0 to 3.
+			SetFocusSpeed
+		};
+
+		/// Standard command table.
+		/// \details Command bytes of standard operations in the order of
+		/// the operation enumeration.
+		constexpr StandardCommand STANDARD_COMMANDS[] {
+			{ 0x00, 0x02 },
+			{ 0x00, 0x04 },
+			{ 0x00, 0x08 },
+			{ 0x00, 0x10 },
+			{ 0x00, 0x20 },
+			{ 0x00, 0x40 },
+			{ 0x00, 0x80 },
+			{ 0x01, 0x00 },
+			{ 0x00, 0x03 },
+			{ 0x00, 0x05 },
+			{ 0x00, 0x07 },
+			{ 0x00, 0x25 },
+			{ 0x00, 0x27 }
+		};
+
+		/// Maximum pan and tilt speed of standard motion.
+		constexpr std::uint8_t MAX_MOTION_SPEED { 0x3F };
+
+		/// Maximum zoom and focus speed.
+		constexpr std::uint8_t MAX_LENS_SPEED { 0x03 };
+
+		/// Synchronization value.
+		/// \details Pelco-DE protocol synchronization value.
+		constexpr std::uint8_t SYNCHRONIZATION_VALUE { 0xFF };
+
+		/// Broadcast address.
+		/// \details Address of requests to all devices that receive them.
+		/// Every device responds with its own address.
+		constexpr std::uint8_t ADDRESS_BROADCAST { 0xFF };
+
+		/// Message length.
+		/// \details Pelco-DE fixed message length in bytes.
+		constexpr std::size_t MESSAGE_LENGTH { 7 };
+
+		/// Synchronization byte index.
+		/// \details The index in the byte array of the message in which the
+		/// synchronization value is stored.
+		constexpr std::size_t SYNCHRONIZATION_BYTE_INDEX { 0 };
+
+		/// Device address byte index.
+		/// \details The index in the byte array of the message in which the
+		/// device logical address is stored.
+		constexpr std::size_t ADDRESS_BYTE_INDEX { 1 };
+
+		/// First command byte index.
+		/// \details The index in the byte array of the message in which the
+		/// first command is stored.
+		constexpr std::size_t COMMAND1_BYTE_INDEX { 2 };
+
+		/// Second command byte index.
+		/// \details The index in the byte array of the message in which the
+		/// second command is stored.
+		constexpr std::size_t COMMAND2_BYTE_INDEX { 3 };
+
+		/// Value high byte index.
+		/// \details The index in the byte array of the message in which the
+		/// value high byte is stored.
+		constexpr std::size_t VALUE_HIGH_BYTE_INDEX { 4 };
+
+		/// Value low byte index.
+		/// \details The index in the byte array of the message in which the
+		/// value low byte is stored.
+		constexpr std::size_t VALUE_LOW_BYTE_INDEX { 5 };
+
+		/// Checksum byte index.
+		/// \details The index in the byte array of the message in which the
+		/// checksum is stored.
+		constexpr std::size_t CHECKSUM_BYTE_INDEX { 6 };
+
+		/// Pelco-DE frame.
+		using Frame = std::array<std::uint8_t, MESSAGE_LENGTH>;
+
+		/// Frame validation result.
+		enum class FrameError {
+
+			/// The frame is valid.
+			None,
+
+			/// The frame length is not the message length.
+			Length,
+
+			/// The synchronization value is wrong.
+			Synchronization,
+
+			/// The checksum is wrong.
+			Checksum,
+
+			/// The command is not a known response command.
+			Command
+		};
+
+		/// Calculates the checksum of Pelco-DE frame fields.
+		/// \details Calculates the sum of address, commands and value bytes
+		/// modulo 256.
+		/// \param[in]	address		Device address.
+		/// \param[in]	command1	First command byte.
+		/// \param[in]	command2	Second command byte.
+		/// \param[in]	valueHigh	Value high byte.
+		/// \param[in]	valueLow	Value low byte.
+		/// \return Checksum.
+		constexpr std::uint8_t calculateChecksum(
+			std::uint8_t address,
+			std::uint8_t command1,
+			std::uint8_t command2,
+			std::uint8_t valueHigh,
+			std::uint8_t valueLow) noexcept {
+
+			return static_cast<std::uint8_t>(
+				(address + command1 + command2 + valueHigh + valueLow) % 0x100);
+		}
+
+		/// Calculates the checksum of a Pelco-DE frame.
+		/// \details Calculates the checksum of frame fields in place.
+		/// \param[in]	data	Frame bytes, at least the message length.
+		/// \return Checksum.
+		constexpr std::uint8_t calculateChecksum(
+			const std::uint8_t* data) noexcept {
+
+			return calculateChecksum(data[ADDRESS_BYTE_INDEX],
+			                         data[COMMAND1_BYTE_INDEX],
+			                         data[COMMAND2_BYTE_INDEX],
+			                         data[VALUE_HIGH_BYTE_INDEX],
+			                         data[VALUE_LOW_BYTE_INDEX]);
+		}
+
+		/// Creates a Pelco-DE frame.
+		/// \details Creates a Pelco-DE frame based on address, command and
+		/// value.
+		/// \param[in]	address	Device address.
+		/// \param[in]	command	Command.
+		/// \param[in]	value	Value.
+		/// \return Pelco-DE frame.
+		constexpr Frame createFrame(std::uint8_t address,
+		                            std::uint8_t command,
+		                            std::uint16_t value = 0) noexcept {
+			auto valueHigh = static_cast<std::uint8_t>(value >> 8u);
+			auto valueLow = static_cast<std::uint8_t>(value & 0xFFu);
+
+			return Frame {{
+				SYNCHRONIZATION_VALUE,
+				address,
+				0x00,
+				command,
+				valueHigh,
+				valueLow,
+				calculateChecksum(address, 0x00, command, valueHigh, valueLow)
+			}};
+		}
+
+		/// Creates a Pelco-D frame from command and data bytes.
+		/// \details Creates a frame of any command, for example a standard
+		/// one.
+		/// \param[in]	address		Device address.
+		/// \param[in]	command1	First command byte.
+		/// \param[in]	command2	Second command byte.
+		/// \param[in]	data1		First data byte.
+		/// \param[in]	data2		Second data byte.
+		/// \return Pelco-D frame.
+		constexpr Frame createFrame(std::uint8_t address,
+		                            std::uint8_t command1,
+		                            std::uint8_t command2,
+		                            std::uint8_t data1,
+		                            std::uint8_t data2) noexcept {
+			return Frame {{
+				SYNCHRONIZATION_VALUE,
+				address,
+				command1,
+				command2,
+				data1,
+				data2,
+				calculateChecksum(address, command1, command2, data1, data2)
+			}};
+		}
+
+		/// Gets command bytes of a standard operation.
+		/// \details Looks the operation up in the standard command table.
+		/// \param[in]	operation	Standard operation.
+		/// \return Command bytes.
+		constexpr StandardCommand getStandardCommand(
+			StandardOperation operation) noexcept {
+
+			return STANDARD_COMMANDS[static_cast<std::size_t>(operation)];
+		}
+
+		/// Creates a standard Pelco-D frame.
+		/// \details Creates a frame of a standard operation from the command
+		/// table.
+		/// \param[in]	address		Device address.
+		/// \param[in]	operation	Standard operation.
+		/// \param[in]	data1		First data byte.
+		/// \param[in]	data2		Second data byte.
+		/// \return Pelco-D frame.
+		constexpr Frame createStandardFrame(std::uint8_t address,
+		                                    StandardOperation operation,
+		                                    std::uint8_t data1 = 0,
+		                                    std::uint8_t data2 = 0) noexcept {
+			return createFrame(address,
+			                   getStandardCommand(operation).command1,
+			                   getStandardCommand(operation).command2,
+			                   data1, data2);
+		}
+
+		/// Gets the data byte of a motion speed.
+		/// \details Gets the magnitude of the speed limited to the maximum
+		/// motion speed.
+		/// \param[in]	speed	Signed speed.
+		/// \return Speed data byte.
+		constexpr std::uint8_t getMotionSpeed(int speed) noexcept {
+			return static_cast<std::uint8_t>(
+				(speed < 0 ? -speed : speed) < MAX_MOTION_SPEED
+					? (speed < 0 ? -speed : speed)
+					: MAX_MOTION_SPEED);
+		}
+
+		/// Creates a standard Pelco-D motion frame.
+		/// \details Combines motion operations of the signs of the speeds in
+		/// one frame, a zero speed stops the axis. Pan and tilt speeds are
+		/// limited to the maximum motion speed. A frame with all speeds zero
+		/// stops the device.
+		/// \param[in]	address		Device address.
+		/// \param[in]	panSpeed	Pan speed, positive to the right.
+		/// \param[in]	tiltSpeed	Tilt speed, positive up.
+		/// \param[in]	zoom		Zoom direction, positive in.
+		/// \param[in]	focus		Focus direction, positive far.
+		/// \return Pelco-D frame.
+		constexpr Frame createMotionFrame(std::uint8_t address,
+		                                  int panSpeed,
+		                                  int tiltSpeed,
+		                                  int zoom = 0,
+		                                  int focus = 0) noexcept {
+			StandardOperation operations[] {
+				panSpeed > 0 ? StandardOperation::PanRight
+				             : StandardOperation::PanLeft,
+				tiltSpeed > 0 ? StandardOperation::TiltUp
+				              : StandardOperation::TiltDown,
+				zoom > 0 ? StandardOperation::ZoomTele
+				         : StandardOperation::ZoomWide,
+				focus > 0 ? StandardOperation::FocusFar
+				          : StandardOperation::FocusNear
+			};
+
+			int speeds[] { panSpeed, tiltSpeed, zoom, focus };
+
+			std::uint8_t command1 = 0;
+			std::uint8_t command2 = 0;
+
+			for (std::size_t i = 0; i < 4; ++i) {
+				if (speeds[i] != 0) {
+					command1 |= getStandardCommand(operations[i]).command1;
+					command2 |= getStandardCommand(operations[i]).command2;
+				}
+			}
+
+			return createFrame(address, command1, command2,
+			                   getMotionSpeed(panSpeed),
+			                   getMotionSpeed(tiltSpeed));
+		}
+
+		/// Pelco-DE frame built at compile time.
+		/// \details Frames of fixed queries to devices with known addresses
+		/// need no work at run time.
+		template <std::uint8_t Address,
+		          std::uint8_t Command,
+		          std::uint16_t Value = 0>
+		constexpr Frame FIXED_FRAME = createFrame(Address, Command, Value);
+
+		/// Gets the response command of a Pelco-DE request command.
+		/// \details Gets the command of the response that the device sends
+		/// to a request. Unknown commands are returned unchanged.
+		/// \param[in]	command	Request command.
+		/// \return Response command.
+		constexpr std::uint8_t getResponseCommand(
+			std::uint8_t command) noexcept {
+
+			switch (command) {
+			case COMMAND_REQUEST_GET_PAN_STEPS:
+				return COMMAND_RESPONSE_GET_PAN_STEPS;
+			case COMMAND_REQUEST_GET_TILT_STEPS:
+				return COMMAND_RESPONSE_GET_TILT_STEPS;
+			case COMMAND_REQUEST_GET_PAN_MAX_STEPS:
+				return COMMAND_RESPONSE_GET_PAN_MAX_STEPS;
+			case COMMAND_REQUEST_GET_TILT_MAX_STEPS:
+				return COMMAND_RESPONSE_GET_TILT_MAX_STEPS;
+			case COMMAND_REQUEST_SET_PAN_STEPS:
+				return COMMAND_RESPONSE_SET_PAN_STEPS;
+			case COMMAND_REQUEST_SET_TILT_STEPS:
+				return COMMAND_RESPONSE_SET_TILT_STEPS;
+			case COMMAND_REQUEST_GET_TEMPERATURE:
+				return COMMAND_RESPONSE_GET_TEMPERATURE;
+			case COMMAND_REQUEST_GET_VOLTAGE:
+				return COMMAND_RESPONSE_GET_VOLTAGE;
+			default:
+				return command;
+			}
+		}
+
+		/// Checks whether a command is a response command.
+		/// \details Checks the command against known response commands.
+		/// \param[in]	command	Command.
+		/// \return True if the command is a response command.
+		constexpr bool isResponseCommand(std::uint8_t command) noexcept {
+			switch (command) {
+			case COMMAND_RESPONSE_GET_PAN_STEPS:
+			case COMMAND_RESPONSE_GET_TILT_STEPS:
+			case COMMAND_RESPONSE_GET_PAN_MAX_STEPS:
+			case COMMAND_RESPONSE_GET_TILT_MAX_STEPS:
+			case COMMAND_RESPONSE_SET_PAN_STEPS:
+			case COMMAND_RESPONSE_GET_TEMPERATURE:
+			case COMMAND_RESPONSE_GET_VOLTAGE:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		/// Class that provides Pelco-DE frame view implementation.
+		/// \details A non-owning view of received bytes that decodes frame
+		/// fields in place. The bytes must outlive the view.
+		class FrameView {
+		public:
+
+			/// Constructor.
+			/// \param[in]	data	Frame bytes.
+			/// \param[in]	size	Number of frame bytes.
+			constexpr FrameView(const std::uint8_t* data,
+			                    std::size_t size) noexcept
+				: data_(data),
+				  size_(size) {
+			}
+
+			/// Constructor.
+			/// \param[in]	frame	Frame.
+			constexpr FrameView(const Frame& frame) noexcept
+				: data_(&frame[0]),
+				  size_(frame.size()) {
+			}
+
+		public:
+
+			/// Validates the frame.
+			/// \details Checks the length, the synchronization value and the
+			/// checksum.
+			/// \return Validation result.
+			constexpr FrameError validate() const noexcept {
+				if (size_ != MESSAGE_LENGTH) {
+					return FrameError::Length;
+				}
+
+				if (data_[SYNCHRONIZATION_BYTE_INDEX] !=
+				    SYNCHRONIZATION_VALUE) {
+					return FrameError::Synchronization;
+				}
+
+				if (data_[CHECKSUM_BYTE_INDEX] != calculateChecksum(data_)) {
+					return FrameError::Checksum;
+				}
+
+				return FrameError::None;
+			}
+
+			/// Validates the frame as a response.
+			/// \details Checks the length, the synchronization value, the
+			/// checksum and that the command is a response command.
+			/// \return Validation result.
+			constexpr FrameError validateResponse() const noexcept {
+				auto error = validate();
+
+				if (error == FrameError::None &&
+				    !isResponseCommand(data_[COMMAND2_BYTE_INDEX])) {
+					return FrameError::Command;
+				}
+
+				return error;
+			}
+
+			/// Gets device address.
+			/// \return Device address.
+			constexpr std::uint8_t getAddress() const noexcept {
+				return data_[ADDRESS_BYTE_INDEX];
+			}
+
+			/// Gets first command byte.
+			/// \return First command byte.
+			constexpr std::uint8_t getCommand1() const noexcept {
+				return data_[COMMAND1_BYTE_INDEX];
+			}
+
+			/// Gets command.
+			/// \return Second command byte.
+			constexpr std::uint8_t getCommand() const noexcept {
+				return data_[COMMAND2_BYTE_INDEX];
+			}
+
+			/// Gets value.
+			/// \details Combines value high and low bytes.
+			/// \return Value.
+			constexpr std::uint16_t getValue() const noexcept {
+				return static_cast<std::uint16_t>(
+					(data_[VALUE_HIGH_BYTE_INDEX] << 8u) |
+						data_[VALUE_LOW_BYTE_INDEX]);
+			}
+
+			/// Gets frame bytes.
+			/// \return Frame bytes.
+			constexpr const std::uint8_t* data() const noexcept {
+				return data_;
+			}
+
+			/// Gets number of frame bytes.
+			/// \return Number of frame bytes.
+			constexpr std::size_t size() const noexcept {
+				return size_;
+			}
+
+		private:
+
+			/// Frame bytes.
+			const std::uint8_t* data_;
+
+			/// Number of frame bytes.
+			std::size_t size_;
+		};
+
+		static_assert(
+			FrameView(FIXED_FRAME<0x01, COMMAND_REQUEST_GET_PAN_STEPS>)
+				.validateResponse() == FrameError::Command,
+			"The frame codec is broken!");
+
+		static_assert(
+			sizeof(STANDARD_COMMANDS) / sizeof(STANDARD_COMMANDS[0]) ==
+				static_cast<std::size_t>(StandardOperation::SetFocusSpeed) + 1,
+			"The standard command table is incomplete!");
+
+		static_assert(
+			FrameView(createMotionFrame(0x01, -80, 0x10))
+				.getCommand() == 0x0C,
+			"The frame codec is broken!");
+	}
+}
+
+#endif
@@ -0,0 +1,220 @@
+/// \file PelcoDEDeviceSerial.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// serial device implementation.
+/// \bug No known bugs.
+
+#include "PelcoDEDeviceSerial.hpp"
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Constructor.
+	/// \details Initializes object fields. The device is calibrated on first
+	/// use of a method that works with degrees.
+	/// \param[in]	bus				Bus that performs device I/O, it must
+	/// outlive the device.
+	/// \param[in]	address			Device address.
+	/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+	/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+	PelcoDEDeviceSerial::PelcoDEDeviceSerial(PelcoDEBusSerial& bus,
+	                                         std::uint8_t address,
+	                                         std::uint16_t maxPanDegrees,
+	                                         std::uint16_t maxTiltDegrees)
+		: bus_(bus),
+		  address_(address),
+		  stepCalibration_(maxPanDegrees, maxTiltDegrees) {
+	}
+
+	/// Destructor.
+	/// \details Destroys the object.
+	PelcoDEDeviceSerial::~PelcoDEDeviceSerial() = default;
+
+	/// Gets pan degrees.
+	/// \details Gets pan value in degrees.
+	/// \return Pan degrees.
+	std::uint16_t PelcoDEDeviceSerial::getPanDegrees() const {
+		calibrate();
+		return getPanSteps() / stepCalibration_.getPanStepsPerDegree();
+	}
+
+	/// Sets pan degrees.
+	/// \details Sets pan value in degrees.
+	/// \param[in]	degrees	Pan degrees.
+	void PelcoDEDeviceSerial::setPanDegrees(std::uint16_t degrees) {
+		calibrate();
+		degrees %= 360;
+		setPanSteps(degrees * stepCalibration_.getPanStepsPerDegree());
+	}
+
+	/// Gets tilt degrees.
+	/// \details Gets tilt value in degrees.
+	/// \return Tilt degrees.
+	std::uint16_t PelcoDEDeviceSerial::getTiltDegrees() const {
+		calibrate();
+		return getTiltSteps() / stepCalibration_.getTiltStepsPerDegree();
+	}
+
+	/// Sets tilt degrees.
+	/// \details Sets tilt value in degrees.
+	/// \param[in]	degrees	Tilt degrees.
+	void PelcoDEDeviceSerial::setTiltDegrees(std::uint16_t degrees) {
+		calibrate();
+		degrees %= 135;
+		setTiltSteps(degrees * stepCalibration_.getTiltStepsPerDegree());
+	}
+
+	/// Gets pan steps.
+	/// \details Gets pan value in steps.
+	/// \return Pan steps.
+	std::uint16_t PelcoDEDeviceSerial::getPanSteps() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_PAN_STEPS));
+	}
+
+	/// Gets pan maximum number of steps.
+	/// \details Gets pan maximum value in steps.
+	/// \return Pan maximum number of steps.
+	std::uint16_t PelcoDEDeviceSerial::getPanMaxSteps() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS));
+	}
+
+	/// Sets pan steps.
+	/// \details Sets pan value in steps.
+	/// \param[in]	steps	Pan steps.
+	void PelcoDEDeviceSerial::setPanSteps(std::uint16_t steps) {
+		wait(requestAsync(Codec::COMMAND_REQUEST_SET_PAN_STEPS, steps));
+	}
+
+	/// Gets tilt steps.
+	/// \details Gets tilt value in steps.
+	/// \return Tilt steps.
+	std::uint16_t PelcoDEDeviceSerial::getTiltSteps() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_TILT_STEPS));
+	}
+
+	/// Gets tilt maximum number of steps.
+	/// \details Gets tilt maximum value in steps.
+	/// \return Tilt maximum number of steps.
+	std::uint16_t PelcoDEDeviceSerial::getTiltMaxSteps() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS));
+	}
+
+	/// Sets tilt steps.
+	/// \details Sets tilt value in steps.
+	/// \param[in]	steps	Tilt steps.
+	void PelcoDEDeviceSerial::setTiltSteps(std::uint16_t steps) {
+		wait(requestAsync(Codec::COMMAND_REQUEST_SET_TILT_STEPS, steps));
+	}
+
+	/// Gets pan and tilt position.
+	/// \details Queues pan and tilt requests at once, so that the bus sends
+	/// them without waiting for the caller in between.
+	/// \return Pan and tilt position.
+	Position PelcoDEDeviceSerial::getPosition() const {
+		auto pan = requestAsync(Codec::COMMAND_REQUEST_GET_PAN_STEPS);
+		auto tilt = requestAsync(Codec::COMMAND_REQUEST_GET_TILT_STEPS);
+
+		Position position;
+		position.panSteps = wait(std::move(pan));
+		position.tiltSteps = wait(std::move(tilt));
+		return position;
+	}
+
+	/// Sets pan and tilt position.
+	/// \details Queues pan and tilt requests at once, so that the bus sends
+	/// them without waiting for the caller in between. The bus exchanges one
+	/// request at a time, so the shared acknowledgement of both requests is
+	/// not ambiguous.
+	/// \param[in]	panSteps	Pan steps.
+	/// \param[in]	tiltSteps	Tilt steps.
+	void PelcoDEDeviceSerial::setPosition(std::uint16_t panSteps,
+	                                      std::uint16_t tiltSteps) {
+		auto pan = requestAsync(Codec::COMMAND_REQUEST_SET_PAN_STEPS,
+		                        panSteps);
+		auto tilt = requestAsync(Codec::COMMAND_REQUEST_SET_TILT_STEPS,
+		                         tiltSteps);
+
+		wait(std::move(pan));
+		wait(std::move(tilt));
+	}
+
+	/// Gets device temperature.
+	/// \details Gets device temperature value.
+	/// \return Device temperature.
+	std::int16_t PelcoDEDeviceSerial::getTemperature() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_TEMPERATURE));
+	}
+
+	/// Gets device voltage.
+	/// \details Gets device voltage value.
+	/// \return Device voltage.
+	double PelcoDEDeviceSerial::getVoltage() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_VOLTAGE)) / 100.0;
+	}
+
+	/// Gets device address.
+	/// \details Gets address of the device on the bus.
+	/// \return Device address.
+	std::uint8_t PelcoDEDeviceSerial::getAddress() const noexcept {
+		return address_;
+	}
+
+	/// Calibrates the device.
+	/// \details Obtains pan and tilt maximum number of steps unless the
+	/// device is already calibrated. Concurrent calls share one calibration.
+	/// A calibration with fewer steps than degrees of an axis is rejected,
+	/// as it would give zero steps per degree.
+	/// \throw std::runtime_error if the calibration is not plausible.
+	void PelcoDEDeviceSerial::calibrate() const {
+		stepCalibration_.calibrate([this]() {
+			auto pan = requestAsync(Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS);
+			auto tilt = requestAsync(Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS);
+
+			Calibration calibration;
+			calibration.panMaxSteps = wait(std::move(pan));
+			calibration.tiltMaxSteps = wait(std::move(tilt));
+
+			return calibration;
+		});
+	}
+
+	/// Queues a request.
+	/// \details Queues a request on the bus with a handler that fulfills a
+	/// promise.
+	/// \param[in]	command	Request command.
+	/// \param[in]	value	Request value.
+	/// \return Future response value.
+	/// \throw std::logic_error if called from the bus thread.
+	std::future<std::uint16_t> PelcoDEDeviceSerial::requestAsync(
+		std::uint8_t command, std::uint16_t value) const {
+
+		if (bus_.getContext().get_executor().running_in_this_thread()) {
+			throw std::logic_error("The method is called from the bus thread!");
+		}
+
+		auto promise = std::make_shared<std::promise<std::uint16_t>>();
+
+		bus_.asyncRequest(address_, command, value,
+			[promise](const boost::system::error_code& error,
+			          std::uint16_t value) {
+				if (error) {
+					promise->set_exception(std::make_exception_ptr(
+						boost::system::system_error(error)));
+				} else {
+					promise->set_value(value);
+				}
+			});
+
+		return promise->get_future();
+	}
+
+	/// Waits for a request to complete.
+	/// \details Blocks until the bus thread completes the request.
+	/// \param[in]	future	Future response value.
+	/// \return Response value.
+	/// \throw boost::system::system_error on failure.
+	std::uint16_t PelcoDEDeviceSerial::wait(
+		std::future<std::uint16_t> future) const {
+
+		return future.get();
+	}
+}
@@ -0,0 +1,135 @@
+/// \file PelcoDEDeviceSerial.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE
+/// serial device implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_DEVICE_SERIAL_HPP
+#define PELCODE_DEVICE_SERIAL_HPP
+
+#include "AbstractPelcoDDevice.hpp"
+#include "PelcoDEBusSerial.hpp"
+#include "StepCalibration.hpp"
+
+#include <cstdint>
+#include <future>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides serial Pelco-DE device implementation.
+	/// \details A device is one address on a serial bus, many devices share
+	/// the bus and its line.
+	class SHARED_API PelcoDEDeviceSerial : public AbstractPelcoDDevice {
+	public:
+
+		/// Constructor.
+		/// \param[in]	bus				Bus that performs device I/O, it must
+		/// outlive the device.
+		/// \param[in]	address			Device address.
+		/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+		/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+		PelcoDEDeviceSerial(PelcoDEBusSerial& bus,
+		                    std::uint8_t address,
+		                    std::uint16_t maxPanDegrees = 360,
+		                    std::uint16_t maxTiltDegrees = 135);
+
+		/// Destructor.
+		~PelcoDEDeviceSerial() override;
+
+	public:
+
+		/// Gets pan degrees.
+		/// \return Pan degrees.
+		std::uint16_t getPanDegrees() const override;
+
+		/// Sets pan degrees.
+		/// \param[in]	degrees	Pan degrees.
+		void setPanDegrees(std::uint16_t degrees) override;
+
+		/// Gets tilt degrees.
+		/// \return Tilt degrees.
+		std::uint16_t getTiltDegrees() const override;
+
+		/// Sets tilt degrees.
+		/// \param[in]	degrees	Tilt degrees.
+		void setTiltDegrees(std::uint16_t degrees) override;
+
+		/// Gets pan steps.
+		/// \return Pan steps.
+		std::uint16_t getPanSteps() const override;
+
+		/// Gets pan maximum number of steps.
+		/// \return Pan maximum number of steps.
+		std::uint16_t getPanMaxSteps() const override;
+
+		/// Sets pan steps.
+		/// \param[in]	steps	Pan steps.
+		void setPanSteps(std::uint16_t steps) override;
+
+		/// Gets tilt steps.
+		/// \return Tilt steps.
+		std::uint16_t getTiltSteps() const override;
+
+		/// Gets tilt maximum number of steps.
+		/// \return Tilt maximum number of steps.
+		std::uint16_t getTiltMaxSteps() const override;
+
+		/// Sets tilt steps.
+		/// \param[in]	steps	Tilt steps.
+		void setTiltSteps(std::uint16_t steps) override;
+
+		/// Gets pan and tilt position.
+		/// \return Pan and tilt position.
+		Position getPosition() const override;
+
+		/// Sets pan and tilt position.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		void setPosition(std::uint16_t panSteps,
+		                 std::uint16_t tiltSteps) override;
+
+		/// Gets device temperature.
+		/// \return Device temperature.
+		std::int16_t getTemperature() const override;
+
+		/// Gets device voltage.
+		/// \return Device voltage.
+		double getVoltage() const override;
+
+	public:
+
+		/// Gets device address.
+		/// \return Device address.
+		std::uint8_t getAddress() const noexcept;
+
+		/// Calibrates the device.
+		void calibrate() const;
+
+	private:
+
+		/// Queues a request.
+		/// \param[in]	command	Request command.
+		/// \param[in]	value	Request value.
+		/// \return Future response value.
+		std::future<std::uint16_t> requestAsync(std::uint8_t command,
+		                                        std::uint16_t value = 0) const;
+
+		/// Waits for a request to complete.
+		/// \param[in]	future	Future response value.
+		/// \return Response value.
+		std::uint16_t wait(std::future<std::uint16_t> future) const;
+
+	private:
+
+		/// Bus that performs device I/O.
+		PelcoDEBusSerial& bus_;
+
+		/// Device address.
+		std::uint8_t address_;
+
+		/// Conversion between steps and degrees.
+		mutable StepCalibration stepCalibration_;
+	};
+}
+
+#endif
@@ -0,0 +1,648 @@
+/// \file PelcoDEDeviceTCP.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE TCP
+/// device implementation.
+/// \bug No known bugs.
+
+#include "PelcoDEDeviceTCP.hpp"
+
+#include <algorithm>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Number of consecutive response timeouts that break a connection.
+		/// \details A single late response may be caused by a busy device,
+		/// so the connection is kept until responses are missed repeatedly.
+		constexpr std::size_t MAX_MISSED_RESPONSES { 3 };
+	}
+
+	/// Constructor.
+	/// \details Initializes the policy with default values.
+	ReconnectPolicy::ReconnectPolicy() noexcept
+		: minDelay(100),
+		  maxDelay(10000) {
+	}
+
+	/// Constructor.
+	/// \details Initializes request fields.
+	/// \param[in]	context	I/O context.
+	PelcoDEDeviceTCP::Request::Request(boost::asio::io_context& context)
+		: message(),
+		  response(0),
+		  timer(context) {
+	}
+
+	/// Constructor.
+	/// \details Initializes object fields and starts connecting from the
+	/// device thread. The device is calibrated on first use of a method that
+	/// works with degrees.
+	/// \param[in]	ip 				IP address or host name.
+	/// \param[in]	port 			Port.
+	/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+	/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+	/// \param[in]	address			Device address.
+	PelcoDEDeviceTCP::PelcoDEDeviceTCP(const std::string& ip,
+	                                   std::uint16_t port,
+	                                   std::uint16_t maxPanDegrees,
+	                                   std::uint16_t maxTiltDegrees,
+	                                   std::uint8_t address)
+		: context_(1),
+		  work_(boost::asio::make_work_guard(context_)),
+		  resolver_(context_),
+		  socket_(context_),
+		  reconnectTimer_(context_),
+		  watchdog_(context_),
+		  ip_(ip),
+		  port_(port),
+		  address_(address),
+		  stepCalibration_(maxPanDegrees, maxTiltDegrees),
+		  policy_(),
+		  estimator_(policy_),
+		  reconnectPolicy_(),
+		  reconnectDelay_(reconnectPolicy_.minDelay),
+		  connected_(false),
+		  connection_(0),
+		  missed_(0),
+		  stopped_(false),
+		  buffer_() {
+
+		boost::asio::post(context_, [this]() {
+			connect();
+		});
+
+		thread_ = std::thread([this]() {
+			context_.run();
+		});
+	}
+
+	/// Destructor.
+	/// \details Completes waiting requests and requests in flight with the
+	/// operation aborted error on the device thread and waits for the thread
+	/// to finish.
+	PelcoDEDeviceTCP::~PelcoDEDeviceTCP() {
+		boost::asio::post(context_, [this]() {
+			shutdown();
+		});
+
+		thread_.join();
+	}
+
+	/// Gets pan degrees.
+	/// \details Gets pan value in degrees.
+	/// \return Pan degrees.
+	std::uint16_t PelcoDEDeviceTCP::getPanDegrees() const {
+		calibrate();
+		return getPanSteps() / stepCalibration_.getPanStepsPerDegree();
+	}
+
+	/// Sets pan degrees.
+	/// \details Sets pan value in degrees.
+	/// \param[in]	degrees	Pan degrees.
+	void PelcoDEDeviceTCP::setPanDegrees(std::uint16_t degrees) {
+		calibrate();
+		degrees %= 360;
+		setPanSteps(degrees * stepCalibration_.getPanStepsPerDegree());
+	}
+
+	/// Gets tilt degrees.
+	/// \details Gets tilt value in degrees.
+	/// \return Tilt degrees.
+	std::uint16_t PelcoDEDeviceTCP::getTiltDegrees() const {
+		calibrate();
+		return getTiltSteps() / stepCalibration_.getTiltStepsPerDegree();
+	}
+
+	/// Sets tilt degrees.
+	/// \details Sets tilt value in degrees.
+	/// \param[in]	degrees	Tilt degrees.
+	void PelcoDEDeviceTCP::setTiltDegrees(std::uint16_t degrees) {
+		calibrate();
+		degrees %= 135;
+		setTiltSteps(degrees * stepCalibration_.getTiltStepsPerDegree());
+	}
+
+	/// Gets pan steps.
+	/// \details Gets pan value in steps.
+	/// \return Pan steps.
+	std::uint16_t PelcoDEDeviceTCP::getPanSteps() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_PAN_STEPS));
+	}
+
+	/// Gets pan maximum number of steps.
+	/// \details Gets pan maximum value in steps.
+	/// \return Pan maximum number of steps.
+	std::uint16_t PelcoDEDeviceTCP::getPanMaxSteps() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS));
+	}
+
+	/// Sets pan steps.
+	/// \details Sets pan value in steps.
+	/// \param[in]	steps	Pan steps.
+	void PelcoDEDeviceTCP::setPanSteps(std::uint16_t steps) {
+		wait(requestAsync(Codec::COMMAND_REQUEST_SET_PAN_STEPS, steps));
+	}
+
+	/// Gets tilt steps.
+	/// \details Gets tilt value in steps.
+	/// \return Tilt steps.
+	std::uint16_t PelcoDEDeviceTCP::getTiltSteps() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_TILT_STEPS));
+	}
+
+	/// Gets tilt maximum number of steps.
+	/// \details Gets tilt maximum value in steps.
+	/// \return Tilt maximum number of steps.
+	std::uint16_t PelcoDEDeviceTCP::getTiltMaxSteps() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS));
+	}
+
+	/// Sets tilt steps.
+	/// \details Sets tilt value in steps.
+	/// \param[in]	steps	Tilt steps.
+	void PelcoDEDeviceTCP::setTiltSteps(std::uint16_t steps) {
+		wait(requestAsync(Codec::COMMAND_REQUEST_SET_TILT_STEPS, steps));
+	}
+
+	/// Gets pan and tilt position.
+	/// \details Gets pan and tilt values in steps with requests that are in
+	/// flight at the same time.
+	/// \return Pan and tilt position.
+	Position PelcoDEDeviceTCP::getPosition() const {
+		auto pan = requestAsync(Codec::COMMAND_REQUEST_GET_PAN_STEPS);
+		auto tilt = requestAsync(Codec::COMMAND_REQUEST_GET_TILT_STEPS);
+
+		Position position;
+		position.panSteps = wait(std::move(pan));
+		position.tiltSteps = wait(std::move(tilt));
+		return position;
+	}
+
+	/// Sets pan and tilt position.
+	/// \details Sets pan and tilt values in steps with requests that are sent
+	/// back to back, so that both axes start moving at the same time. Both
+	/// requests are acknowledged with the same response command, which is
+	/// not ambiguous, as the connection delivers acknowledgements in order
+	/// and a broken connection sends both requests again.
+	/// \param[in]	panSteps	Pan steps.
+	/// \param[in]	tiltSteps	Tilt steps.
+	void PelcoDEDeviceTCP::setPosition(std::uint16_t panSteps,
+	                                   std::uint16_t tiltSteps) {
+		auto pan = requestAsync(Codec::COMMAND_REQUEST_SET_PAN_STEPS,
+		                        panSteps);
+		auto tilt = requestAsync(Codec::COMMAND_REQUEST_SET_TILT_STEPS,
+		                         tiltSteps);
+
+		wait(std::move(pan));
+		wait(std::move(tilt));
+	}
+
+	/// Gets device temperature.
+	/// \details Gets device temperature value.
+	/// \return Device temperature.
+	std::int16_t PelcoDEDeviceTCP::getTemperature() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_TEMPERATURE));
+	}
+
+	/// Gets device voltage.
+	/// \details Gets device voltage value.
+	/// \return Device voltage.
+	double PelcoDEDeviceTCP::getVoltage() const {
+		return wait(requestAsync(Codec::COMMAND_REQUEST_GET_VOLTAGE)) / 100.0;
+	}
+
+	/// Calibrates the device.
+	/// \details Obtains pan and tilt maximum number of steps unless the
+	/// device is already calibrated. Concurrent calls share one calibration.
+	/// A calibration with fewer steps than degrees of an axis is rejected,
+	/// as it would give zero steps per degree.
+	/// \throw std::runtime_error if the calibration is not plausible.
+	void PelcoDEDeviceTCP::calibrate() const {
+		stepCalibration_.calibrate([this]() {
+			auto pan = requestAsync(Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS);
+			auto tilt = requestAsync(Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS);
+
+			Calibration calibration;
+			calibration.panMaxSteps = wait(std::move(pan));
+			calibration.tiltMaxSteps = wait(std::move(tilt));
+
+			return calibration;
+		});
+	}
+
+	/// Checks whether the connection is established.
+	/// \details Requests made while the connection is not established wait
+	/// for it until their deadline.
+	/// \return True if the connection is established.
+	bool PelcoDEDeviceTCP::isConnected() const noexcept {
+		return connected_;
+	}
+
+	/// Sets retransmission policy.
+	/// \details Sets the policy of requests queued after the call and resets
+	/// round-trip time estimation. TCP does not lose messages, so requests
+	/// that repeatedly get no response within the retransmission timeout mean
+	/// a broken connection, the device reconnects and sends them again.
+	/// \param[in]	policy	Retransmission policy.
+	void PelcoDEDeviceTCP::setRetransmissionPolicy(
+		const RetransmissionPolicy& policy) {
+
+		boost::asio::post(context_, [this, policy]() {
+			policy_ = policy;
+			estimator_ = RoundTripEstimator(policy_);
+		});
+	}
+
+	/// Sets reconnection policy.
+	/// \details Sets the policy of reconnection attempts made after the call.
+	/// \param[in]	policy	Reconnection policy.
+	void PelcoDEDeviceTCP::setReconnectPolicy(const ReconnectPolicy& policy) {
+		boost::asio::post(context_, [this, policy]() {
+			reconnectPolicy_ = policy;
+			reconnectDelay_ = reconnectPolicy_.minDelay;
+		});
+	}
+
+	/// Gets I/O context.
+	/// \details Gets I/O context that is run by the device thread.
+	/// \return I/O context.
+	boost::asio::io_context& PelcoDEDeviceTCP::getContext() noexcept {
+		return context_;
+	}
+
+	/// Asynchronously performs a request.
+	/// \details Sends the request if the connection is established, otherwise
+	/// queues it until the connection is established. May be called from any
+	/// thread, the handler is invoked from the device thread. Requests made
+	/// while the device is destroyed are aborted.
+	/// \param[in]	command	Request command.
+	/// \param[in]	value	Request value.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceTCP::asyncRequest(std::uint8_t command,
+	                                    std::uint16_t value,
+	                                    Handler handler) const {
+		auto request = std::make_shared<Request>(context_);
+
+		request->message = Codec::createFrame(address_, command, value);
+		request->response = Codec::getResponseCommand(command);
+		request->handler = std::move(handler);
+
+		boost::asio::post(context_, [this, request]() {
+			if (stopped_) {
+				request->handler(boost::asio::error::operation_aborted, 0);
+				return;
+			}
+
+			request->timer.expires_after(policy_.deadline);
+			request->timer.async_wait(
+				[this, request](const boost::system::error_code& error) {
+					if (!error) {
+						completeRequest(request,
+						                boost::asio::error::timed_out, 0);
+					}
+				});
+
+			send(request);
+		});
+	}
+
+	/// Queues a request.
+	/// \details Queues a request with a handler that fulfills a promise.
+	/// \param[in]	command	Request command.
+	/// \param[in]	value	Request value.
+	/// \return Future response value.
+	/// \throw std::logic_error if called from the device thread.
+	std::future<std::uint16_t> PelcoDEDeviceTCP::requestAsync(
+		std::uint8_t command, std::uint16_t value) const {
+
+		if (context_.get_executor().running_in_this_thread()) {
+			throw std::logic_error(
+				"The method is called from the device thread!");
+		}
+
+		auto promise = std::make_shared<std::promise<std::uint16_t>>();
+
+		asyncRequest(command, value,
+			[promise](const boost::system::error_code& error,
+			          std::uint16_t value) {
+				if (error) {
+					promise->set_exception(std::make_exception_ptr(
+						boost::system::system_error(error)));
+				} else {
+					promise->set_value(value);
+				}
+			});
+
+		return promise->get_future();
+	}
+
+	/// Waits for a request to complete.
+	/// \details Blocks until the device thread completes the request.
+	/// \param[in]	future	Future response value.
+	/// \return Response value.
+	/// \throw boost::system::system_error on failure.
+	std::uint16_t PelcoDEDeviceTCP::wait(
+		std::future<std::uint16_t> future) const {
+
+		return future.get();
+	}
+
+	/// Starts connecting.
+	/// \details Resolves the host name on every attempt, so that a changed
+	/// address is picked up. Once connected, disables Nagle's algorithm so
+	/// that every request leaves at once and sends waiting requests.
+	void PelcoDEDeviceTCP::connect() const {
+		auto connection = ++connection_;
+
+		resolver_.async_resolve(ip_, std::to_string(port_),
+			[this, connection](
+				const boost::system::error_code& error,
+				const boost::asio::ip::tcp::resolver::results_type& results) {
+
+				if (connection != connection_) {
+					return;
+				}
+
+				if (error) {
+					disconnect();
+					return;
+				}
+
+				boost::asio::async_connect(socket_, results,
+					[this, connection](const boost::system::error_code& error,
+					                   const boost::asio::ip::tcp::endpoint&) {
+						if (connection != connection_) {
+							return;
+						}
+
+						if (error) {
+							disconnect();
+							return;
+						}
+
+						boost::system::error_code ignored;
+						socket_.set_option(
+							boost::asio::ip::tcp::no_delay(true), ignored);
+						socket_.set_option(
+							boost::asio::socket_base::keep_alive(true), ignored);
+
+						connected_ = true;
+						reconnectDelay_ = reconnectPolicy_.minDelay;
+						missed_ = 0;
+						parser_.reset();
+						startReceive();
+
+						std::deque<std::shared_ptr<Request>> waiting;
+						waiting.swap(waiting_);
+
+						for (const auto& request : waiting) {
+							send(request);
+						}
+					});
+			});
+	}
+
+	/// Closes the connection and schedules reconnection.
+	/// \details Returns requests in flight to the front of the waiting queue,
+	/// so that they are sent again in order on the next connection. The delay
+	/// before the next attempt doubles up to the policy limit.
+	void PelcoDEDeviceTCP::disconnect() const {
+		++connection_;
+		connected_ = false;
+
+		boost::system::error_code ignored;
+		socket_.close(ignored);
+		watchdog_.cancel();
+		outgoing_.clear();
+		writing_.clear();
+
+		waiting_.insert(waiting_.begin(), requests_.begin(), requests_.end());
+		requests_.clear();
+
+		reconnectTimer_.expires_after(reconnectDelay_);
+		reconnectTimer_.async_wait(
+			[this](const boost::system::error_code& error) {
+				if (!error) {
+					connect();
+				}
+			});
+
+		reconnectDelay_ = std::min(reconnectDelay_ * 2,
+		                           reconnectPolicy_.maxDelay);
+	}
+
+	/// Sends a request.
+	/// \details Queues the request message for writing, messages queued while
+	/// a write is in progress leave together in the next write.
+	/// \param[in]	request	Request.
+	void PelcoDEDeviceTCP::send(const std::shared_ptr<Request>& request) const {
+		if (!connected_) {
+			waiting_.push_back(request);
+			return;
+		}
+
+		request->sent = std::chrono::steady_clock::now();
+		requests_.push_back(request);
+		outgoing_.insert(outgoing_.end(), request->message.begin(),
+		                 request->message.end());
+
+		if (requests_.size() == 1) {
+			startWatchdog();
+		}
+
+		if (writing_.empty()) {
+			flush();
+		}
+	}
+
+	/// Writes queued bytes.
+	/// \details Writes all queued bytes with one operation.
+	void PelcoDEDeviceTCP::flush() const {
+		auto connection = connection_;
+
+		writing_.swap(outgoing_);
+
+		boost::asio::async_write(socket_, boost::asio::buffer(writing_),
+			[this, connection](const boost::system::error_code& error,
+			                   std::size_t) {
+				if (connection != connection_) {
+					return;
+				}
+
+				writing_.clear();
+
+				if (error) {
+					disconnect();
+				} else if (!outgoing_.empty()) {
+					flush();
+				}
+			});
+	}
+
+	/// Starts receiving bytes.
+	/// \details Feeds received bytes to the parser, since the stream does not
+	/// preserve message boundaries.
+	void PelcoDEDeviceTCP::startReceive() const {
+		auto connection = connection_;
+
+		socket_.async_read_some(boost::asio::buffer(buffer_),
+			[this, connection](const boost::system::error_code& error,
+			                   std::size_t size) {
+				if (connection != connection_) {
+					return;
+				}
+
+				if (error) {
+					disconnect();
+					return;
+				}
+
+				parser_.parse(buffer_.data(), size,
+					[this](const Codec::FrameView& frame) {
+						handleFrame(frame);
+					});
+
+				startReceive();
+			});
+	}
+
+	/// Arms the response timer for the oldest request in flight.
+	/// \details The timer expires one retransmission timeout after the oldest
+	/// request was sent.
+	void PelcoDEDeviceTCP::startWatchdog() const {
+		if (requests_.empty()) {
+			watchdog_.cancel();
+			return;
+		}
+
+		auto request = requests_.front();
+		armWatchdog(request, request->sent + estimator_.getTimeout());
+	}
+
+	/// Waits for the response of the oldest request in flight.
+	/// \details Every expiry without a response backs off the retransmission
+	/// timeout and counts a missed response. The timer is armed again for the
+	/// same request until responses are missed several times in a row, then
+	/// the connection is considered broken.
+	/// \param[in]	request	Oldest request in flight.
+	/// \param[in]	expiry	Expiry time.
+	void PelcoDEDeviceTCP::armWatchdog(
+		const std::shared_ptr<Request>& request,
+		std::chrono::steady_clock::time_point expiry) const {
+
+		auto connection = connection_;
+
+		watchdog_.expires_at(expiry);
+		watchdog_.async_wait(
+			[this, connection, request](const boost::system::error_code& error) {
+				if (error || connection != connection_ ||
+				    requests_.empty() || requests_.front() != request) {
+					return;
+				}
+
+				estimator_.backoff();
+
+				if (++missed_ >= MAX_MISSED_RESPONSES) {
+					disconnect();
+					return;
+				}
+
+				armWatchdog(request, std::chrono::steady_clock::now() +
+				                     estimator_.getTimeout());
+			});
+	}
+
+	/// Handles a frame received from the device.
+	/// \details Validates the frame and completes the oldest request that
+	/// expects its response command. Invalid and unexpected frames are
+	/// discarded.
+	/// \param[in]	frame	Frame.
+	void PelcoDEDeviceTCP::handleFrame(const Codec::FrameView& frame) const {
+		if (frame.validateResponse() != Codec::FrameError::None ||
+		    frame.getAddress() != address_) {
+			return;
+		}
+
+		auto iterator = std::find_if(
+			requests_.begin(), requests_.end(),
+			[&frame](const std::shared_ptr<Request>& request) {
+				return request->response == frame.getCommand();
+			});
+
+		if (iterator == requests_.end()) {
+			return;
+		}
+
+		missed_ = 0;
+		estimator_.addSample(
+			std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - (*iterator)->sent));
+
+		completeRequest(*iterator, boost::system::error_code(),
+		                frame.getValue());
+	}
+
+	/// Completes a request.
+	/// \details Removes the request from the queues and invokes the
+	/// completion handler. Requests that are already completed are ignored.
+	/// \param[in]	request	Request.
+	/// \param[in]	error	Error code.
+	/// \param[in]	value	Response value.
+	void PelcoDEDeviceTCP::completeRequest(
+		std::shared_ptr<Request> request,
+		const boost::system::error_code& error,
+		std::uint16_t value) const {
+
+		auto iterator = std::find(requests_.begin(), requests_.end(), request);
+
+		if (iterator != requests_.end()) {
+			auto oldest = iterator == requests_.begin();
+			requests_.erase(iterator);
+
+			if (oldest) {
+				startWatchdog();
+			}
+		} else {
+			iterator = std::find(waiting_.begin(), waiting_.end(), request);
+
+			if (iterator == waiting_.end()) {
+				return;
+			}
+
+			waiting_.erase(iterator);
+		}
+
+		request->timer.cancel();
+		request->handler(error, value);
+	}
+
+	/// Aborts requests and stops the device.
+	/// \details Completes waiting requests and requests in flight with the
+	/// operation aborted error, closes the connection and releases the work
+	/// guard, so that the device thread finishes once pending handlers have
+	/// run.
+	void PelcoDEDeviceTCP::shutdown() const {
+		stopped_ = true;
+		connected_ = false;
+		++connection_;
+
+		boost::system::error_code ignored;
+		resolver_.cancel();
+		socket_.close(ignored);
+		reconnectTimer_.cancel();
+		watchdog_.cancel();
+
+		std::deque<std::shared_ptr<Request>> requests;
+		requests.swap(requests_);
+		requests.insert(requests.end(), waiting_.begin(), waiting_.end());
+		waiting_.clear();
+
+		for (const auto& request : requests) {
+			request->timer.cancel();
+			request->handler(boost::asio::error::operation_aborted, 0);
+		}
+
+		work_.reset();
+	}
+}
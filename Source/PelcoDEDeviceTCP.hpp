@@ -0,0 +1,320 @@
+/// \file PelcoDEDeviceTCP.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE TCP
+/// device implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_DEVICE_TCP_HPP
+#define PELCODE_DEVICE_TCP_HPP
+
+#include "AbstractPelcoDDevice.hpp"
+#include "PelcoDECodec.hpp"
+#include "PelcoDEStreamParser.hpp"
+#include "RoundTripEstimator.hpp"
+#include "StepCalibration.hpp"
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Reconnection policy.
+	struct SHARED_API ReconnectPolicy {
+
+		/// Constructor.
+		ReconnectPolicy() noexcept;
+
+		/// Delay before the first reconnection attempt.
+		std::chrono::milliseconds minDelay;
+
+		/// Upper bound of the delay between reconnection attempts.
+		std::chrono::milliseconds maxDelay;
+	};
+
+	/// Class that provides TCP Pelco-DE device implementation.
+	/// \details The device keeps one persistent connection from its own
+	/// thread and reconnects with exponential backoff when it is lost.
+	/// Requests are pipelined on the connection and wait for it while it is
+	/// being established.
+	class SHARED_API PelcoDEDeviceTCP : public AbstractPelcoDDevice {
+	public:
+
+		/// Completion handler of a request.
+		using Handler = std::function<void(const boost::system::error_code&,
+		                                   std::uint16_t)>;
+
+	public:
+
+		/// Constructor.
+		/// \param[in]	ip 				IP address or host name.
+		/// \param[in]	port 			Port.
+		/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+		/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+		/// \param[in]	address			Device address.
+		PelcoDEDeviceTCP(const std::string& ip,
+		                 std::uint16_t port,
+		                 std::uint16_t maxPanDegrees = 360,
+		                 std::uint16_t maxTiltDegrees = 135,
+		                 std::uint8_t address = 0x01);
+
+		/// Destructor.
+		~PelcoDEDeviceTCP() override;
+
+	public:
+
+		/// Gets pan degrees.
+		/// \return Pan degrees.
+		std::uint16_t getPanDegrees() const override;
+
+		/// Sets pan degrees.
+		/// \param[in]	degrees	Pan degrees.
+		void setPanDegrees(std::uint16_t degrees) override;
+
+		/// Gets tilt degrees.
+		/// \return Tilt degrees.
+		std::uint16_t getTiltDegrees() const override;
+
+		/// Sets tilt degrees.
+		/// \param[in]	degrees	Tilt degrees.
+		void setTiltDegrees(std::uint16_t degrees) override;
+
+		/// Gets pan steps.
+		/// \return Pan steps.
+		std::uint16_t getPanSteps() const override;
+
+		/// Gets pan maximum number of steps.
+		/// \return Pan maximum number of steps.
+		std::uint16_t getPanMaxSteps() const override;
+
+		/// Sets pan steps.
+		/// \param[in]	steps	Pan steps.
+		void setPanSteps(std::uint16_t steps) override;
+
+		/// Gets tilt steps.
+		/// \return Tilt steps.
+		std::uint16_t getTiltSteps() const override;
+
+		/// Gets tilt maximum number of steps.
+		/// \return Tilt maximum number of steps.
+		std::uint16_t getTiltMaxSteps() const override;
+
+		/// Sets tilt steps.
+		/// \param[in]	steps	Tilt steps.
+		void setTiltSteps(std::uint16_t steps) override;
+
+		/// Gets pan and tilt position.
+		/// \return Pan and tilt position.
+		Position getPosition() const override;
+
+		/// Sets pan and tilt position.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		void setPosition(std::uint16_t panSteps,
+		                 std::uint16_t tiltSteps) override;
+
+		/// Gets device temperature.
+		/// \return Device temperature.
+		std::int16_t getTemperature() const override;
+
+		/// Gets device voltage.
+		/// \return Device voltage.
+		double getVoltage() const override;
+
+	public:
+
+		/// Calibrates the device.
+		void calibrate() const;
+
+		/// Checks whether the connection is established.
+		/// \return True if the connection is established.
+		bool isConnected() const noexcept;
+
+		/// Sets retransmission policy.
+		/// \param[in]	policy	Retransmission policy.
+		void setRetransmissionPolicy(const RetransmissionPolicy& policy);
+
+		/// Sets reconnection policy.
+		/// \param[in]	policy	Reconnection policy.
+		void setReconnectPolicy(const ReconnectPolicy& policy);
+
+		/// Gets I/O context.
+		/// \return I/O context that performs device I/O.
+		boost::asio::io_context& getContext() noexcept;
+
+		/// Asynchronously performs a request.
+		/// \param[in]	command	Request command.
+		/// \param[in]	value	Request value.
+		/// \param[in]	handler	Completion handler.
+		void asyncRequest(std::uint8_t command,
+		                  std::uint16_t value,
+		                  Handler handler) const;
+
+	private:
+
+		/// Pelco-DE request.
+		struct Request {
+
+			/// Constructor.
+			/// \param[in]	context	I/O context.
+			explicit Request(boost::asio::io_context& context);
+
+			/// Request message.
+			Codec::Frame message;
+
+			/// Expected response command.
+			std::uint8_t response;
+
+			/// Completion handler.
+			Handler handler;
+
+			/// Deadline timer.
+			boost::asio::steady_timer timer;
+
+			/// Time of the last transmission.
+			std::chrono::steady_clock::time_point sent;
+		};
+
+		/// Queues a request.
+		/// \param[in]	command	Request command.
+		/// \param[in]	value	Request value.
+		/// \return Future response value.
+		std::future<std::uint16_t> requestAsync(std::uint8_t command,
+		                                        std::uint16_t value = 0) const;
+
+		/// Waits for a request to complete.
+		/// \param[in]	future	Future response value.
+		/// \return Response value.
+		std::uint16_t wait(std::future<std::uint16_t> future) const;
+
+		/// Starts connecting.
+		void connect() const;
+
+		/// Closes the connection and schedules reconnection.
+		void disconnect() const;
+
+		/// Sends a request.
+		/// \param[in]	request	Request.
+		void send(const std::shared_ptr<Request>& request) const;
+
+		/// Writes queued bytes.
+		void flush() const;
+
+		/// Starts receiving bytes.
+		void startReceive() const;
+
+		/// Arms the response timer for the oldest request in flight.
+		void startWatchdog() const;
+
+		/// Waits for the response of the oldest request in flight.
+		/// \param[in]	request	Oldest request in flight.
+		/// \param[in]	expiry	Expiry time.
+		void armWatchdog(const std::shared_ptr<Request>& request,
+		                 std::chrono::steady_clock::time_point expiry) const;
+
+		/// Handles a frame received from the device.
+		/// \param[in]	frame	Frame.
+		void handleFrame(const Codec::FrameView& frame) const;
+
+		/// Completes a request.
+		/// \param[in]	request	Request.
+		/// \param[in]	error	Error code.
+		/// \param[in]	value	Response value.
+		void completeRequest(std::shared_ptr<Request> request,
+		                     const boost::system::error_code& error,
+		                     std::uint16_t value) const;
+
+		/// Aborts requests and stops the device.
+		void shutdown() const;
+
+	private:
+
+		/// I/O context.
+		mutable boost::asio::io_context context_;
+
+		/// Work guard that keeps the I/O context running.
+		mutable boost::asio::executor_work_guard<
+			boost::asio::io_context::executor_type> work_;
+
+		/// Host name resolver.
+		mutable boost::asio::ip::tcp::resolver resolver_;
+
+		/// TCP socket.
+		mutable boost::asio::ip::tcp::socket socket_;
+
+		/// Reconnection timer.
+		mutable boost::asio::steady_timer reconnectTimer_;
+
+		/// Response timer of the oldest request in flight.
+		mutable boost::asio::steady_timer watchdog_;
+
+		/// IP address or host name.
+		std::string ip_;
+
+		/// Port.
+		std::uint16_t port_;
+
+		/// Device address.
+		std::uint8_t address_;
+
+		/// Conversion between steps and degrees.
+		mutable StepCalibration stepCalibration_;
+
+		/// Retransmission policy.
+		RetransmissionPolicy policy_;
+
+		/// Round-trip time estimator.
+		mutable RoundTripEstimator estimator_;
+
+		/// Reconnection policy.
+		ReconnectPolicy reconnectPolicy_;
+
+		/// Delay before the next reconnection attempt.
+		mutable std::chrono::milliseconds reconnectDelay_;
+
+		/// Whether the connection is established.
+		mutable std::atomic<bool> connected_;
+
+		/// Number of the current connection, it tells stale completions.
+		mutable std::size_t connection_;
+
+		/// Number of consecutive response timeouts.
+		mutable std::size_t missed_;
+
+		/// Whether the device is shut down.
+		mutable bool stopped_;
+
+		/// Requests waiting for the connection.
+		mutable std::deque<std::shared_ptr<Request>> waiting_;
+
+		/// Requests in flight in the order they were sent.
+		mutable std::deque<std::shared_ptr<Request>> requests_;
+
+		/// Bytes queued for writing.
+		mutable std::vector<std::uint8_t> outgoing_;
+
+		/// Bytes being written.
+		mutable std::vector<std::uint8_t> writing_;
+
+		/// Received bytes.
+		mutable std::array<std::uint8_t, 256> buffer_;
+
+		/// Parser of received bytes.
+		mutable PelcoDEStreamParser parser_;
+
+		/// Thread that runs the I/O context.
+		std::thread thread_;
+	};
+}
+
+#endif
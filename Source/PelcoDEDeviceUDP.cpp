@@ -4,322 +4,1505 @@
 /// \bug No known bugs.
 
 #include "PelcoDEDeviceUDP.hpp"
+#include "PelcoDECodec.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
 
 /// Contains classes and functions that provide Pelco-D protocol implementation.
 namespace PelcoD {
 
 	namespace {
 
-		/// Pelco-DE request command to get pan steps.
-		/// \details Request command value to obtain pan value in steps.
-		constexpr std::uint8_t COMMAND_REQUEST_GET_PAN_STEPS { 0x51 };
-
-		/// Pelco-DE request command to get tilt steps.
-		/// \details Request command value to obtain tilt value in steps.
-		constexpr std::uint8_t COMMAND_REQUEST_GET_TILT_STEPS { 0x53 };
-
-		/// Pelco-DE request command to get pan maximum number of steps.
-		/// \details Request command value to obtain pan maximum value in steps.
-		constexpr std::uint8_t COMMAND_REQUEST_GET_PAN_MAX_STEPS { 0x55 };
-
-		/// Pelco-DE request command to get tilt maximum number of steps.
-		/// \details Request command value to obtain tilt maximum value in steps.
-		constexpr std::uint8_t COMMAND_REQUEST_GET_TILT_MAX_STEPS { 0x57 };
-
-		/// Pelco-DE responce command to get pan steps.
-		/// \details Responce command value to obtain pan value in steps.
-		constexpr std::uint8_t COMMAND_RESPONCE_GET_PAN_STEPS { 0x61 };
-
-		/// Pelco-DE responce command to get tilt steps.
-		/// \details Responce command value to obtain tilt value in steps.
-		constexpr std::uint8_t COMMAND_RESPONCE_GET_TILT_STEPS { 0x63 };
-
-		/// Pelco-DE responce command to get pan maximum number of steps.
-		/// \details Responce command value to obtain pan maximum value in steps.
-		constexpr std::uint8_t COMMAND_RESPONCE_GET_PAN_MAX_STEPS { 0x65 };
-
-		/// Pelco-DE responce command to get tilt maximum number of steps.
-		/// \details Responce command value to obtain tilt maximum value in steps.
-		constexpr std::uint8_t COMMAND_RESPONCE_GET_TILT_MAX_STEPS { 0x67 };
-
-		/// Pelco-DE request command to set pan steps.
-		/// \details Request command value to set pan value in steps.
-		constexpr std::uint8_t COMMAND_REQUEST_SET_PAN_STEPS { 0x71 };
-
-		/// Pelco-DE request command to set tilt steps.
-		/// \details Request command value to set tilt value in steps.
-		constexpr std::uint8_t COMMAND_REQUEST_SET_TILT_STEPS { 0x73 };
-
-		/// Pelco-DE responce command to set pan steps.
-		/// \details Responce command value to set pan value in steps.
-		constexpr std::uint8_t COMMAND_RESPONCE_SET_PAN_STEPS { 0x7C };
-
-		/// Pelco-DE responce command to set tilt steps.
-		/// \details Responce command value to set tilt value in steps.
-		constexpr std::uint8_t COMMAND_RESPONCE_SET_TILT_STEPS { 0x7C };
-
-		/// Pelco-DE request command to get temperature.
-		/// \details Request command value to obtain temperature value.
-		constexpr std::uint8_t COMMAND_REQUEST_GET_TEMPERATURE { 0x91 };
-
-		/// Pelco-DE request command to get voltage.
-		/// \details Request command value to obtain voltage value.
-		constexpr std::uint8_t COMMAND_REQUEST_GET_VOLTAGE { 0x9B };
-
-		/// Pelco-DE responce command to get temperature.
-		/// \details Responce command value to obtain temperature value.
-		constexpr std::uint8_t COMMAND_RESPONCE_GET_TEMPERATURE { 0xA1 };
-
-		/// Pelco-DE responce command to get voltage.
-		/// \details Responce command value to obtain voltage value.
-		constexpr std::uint8_t COMMAND_RESPONCE_GET_VOLTAGE { 0xAB };
-
-		/// Synchronization value.
-		/// \details Pelco-DE protocol synchronization value.
-		constexpr std::uint8_t SYNCHRONIZATION_VALUE { 0xFF };
-
-		/// Device address.
-		/// \details Pelco-DE device logical address.
-		constexpr std::uint8_t ADDRESS_VALUE { 0x01 };
-
-		/// Message length.
-		/// \details Pelco-DE fixed message length in bytes.
-		constexpr std::size_t MESSAGE_LENGTH { 7 };
-
-		/// Device address byte index.
-		/// \details The index in the byte array of the message in which the
-		/// device logical address is stored.
-		constexpr std::size_t ADDRESS_BYTE_INDEX { 1 };
-
-		/// First command byte index.
-		/// \details The index in the byte array of the message in which the
-		/// first command is stored.
-		constexpr std::size_t COMMAND1_BYTE_INDEX { 2 };
-
-		/// Second command byte index.
-		/// \details The index in the byte array of the message in which the
-		/// second command is stored.
-		constexpr std::size_t COMMAND2_BYTE_INDEX { 3 };
-
-		/// Value high byte index.
-		/// \details The index in the byte array of the message in which the
-		/// value high byte is stored.
-		constexpr std::size_t VALUE_HIGH_BYTE_INDEX { 4 };
-
-		/// Value low byte index.
-		/// \details The index in the byte array of the message in which the
-		/// value low byte is stored.
-		constexpr std::size_t VALUE_LOW_BYTE_INDEX { 5 };
-
-		/// Checksum byte index.
-		/// \details The index in the byte array of the message in which the
-		/// checksum is stored.
-		constexpr std::size_t CHECKSUM_BYTE_INDEX { 6 };
-
-		/// Calculates the checksum of a Pelco-DE message.
-		/// \details Calculates the sum of all fields in a Pelco-DE message.
-		/// \param[in]	message	Pelco-DE message.
-		void calculateChecksum(std::array<std::uint8_t,
-		                                  MESSAGE_LENGTH>& message) noexcept {
-
-			message[CHECKSUM_BYTE_INDEX] = (
-				message[ADDRESS_BYTE_INDEX] +
-					message[COMMAND1_BYTE_INDEX] +
-					message[COMMAND2_BYTE_INDEX] +
-					message[VALUE_HIGH_BYTE_INDEX] +
-					message[VALUE_LOW_BYTE_INDEX]) % 0x100;
-		}
-
-		/// Creates a Pelco-DE message.
-		/// \details Creates a Pelco-DE message based on command and value.
-		/// \return Pelco-DE message.
-		std::array<std::uint8_t,
-		           MESSAGE_LENGTH> createMessage(std::uint8_t command,
-		                                         std::uint16_t value = 0) noexcept {
-
-			std::uint8_t valueHighByte = value >> 8u;
-			std::uint8_t valueLowByte = value;
-
-			std::array<std::uint8_t, MESSAGE_LENGTH> message = {
-				SYNCHRONIZATION_VALUE,
-				ADDRESS_VALUE,
-				0x00,
-				command,
-				valueHighByte,
-				valueLowByte,
-				0x00
+		/// Creates a handler that fulfills a promise.
+		/// \details Creates a completion handler that stores the value or the
+		/// error of an operation in a shared promise.
+		/// \param[in]	promise	Shared promise.
+		/// \return Completion handler.
+		template <typename T>
+		PelcoDEDeviceUDP::ValueHandler<T> createPromiseHandler(
+			const std::shared_ptr<std::promise<T>>& promise) {
+
+			return [promise](const boost::system::error_code& error, T value) {
+				if (error) {
+					promise->set_exception(std::make_exception_ptr(
+						boost::system::system_error(error)));
+				} else {
+					promise->set_value(value);
+				}
 			};
-
-			calculateChecksum(message);
-
-			return message;
 		}
 
-		/// Sends a Pelco-DE message through a socket.
-		/// \details Sends a Pelco-DE message over a UDP socket with the
-		/// specified endpoint.
-		/// \param[in]	message		Pelco-DE message.
-		/// \param[in]	endpoint	Network endpoint.
-		/// \param[in]	socket		UDP socket.
-		void sendMessage(const std::array<std::uint8_t,
-		                                  MESSAGE_LENGTH>& message,
-		                 const boost::asio::ip::udp::endpoint& endpoint,
-		                 boost::asio::ip::udp::socket& socket) {
-
-			socket.send_to(boost::asio::buffer(message), endpoint);
+		/// Creates a handler that fulfills a promise.
+		/// \details Creates a completion handler that stores the completion or
+		/// the error of an operation in a shared promise.
+		/// \param[in]	promise	Shared promise.
+		/// \return Completion handler.
+		PelcoDEDeviceUDP::Handler createPromiseHandler(
+			const std::shared_ptr<std::promise<void>>& promise) {
+
+			return [promise](const boost::system::error_code& error) {
+				if (error) {
+					promise->set_exception(std::make_exception_ptr(
+						boost::system::system_error(error)));
+				} else {
+					promise->set_value();
+				}
+			};
 		}
+	}
 
-		/// Receives a Pelco-DE message through a socket.
-		/// \details Receives a Pelco-DE message through a UDP socket.
-		/// \param[in]	socket	UDP socket.
-		/// \return Pelco-DE value.
-		std::uint16_t receiveMessage(boost::asio::ip::udp::socket& socket) {
-			std::array<std::uint8_t, MESSAGE_LENGTH> message { };
-			boost::asio::ip::udp::endpoint endpoint;
-
-			socket.receive_from(boost::asio::buffer(message), endpoint);
-
-			return
-				(static_cast<std::uint16_t>(message[VALUE_HIGH_BYTE_INDEX])
-					<< 8u) + message[VALUE_LOW_BYTE_INDEX];
-		}
+	/// Constructor.
+	/// \details Initializes request fields.
+	/// \param[in]	context	I/O context.
+	PelcoDEDeviceUDP::Request::Request(boost::asio::io_context& context)
+		: messages(),
+		  count(0),
+		  pending(0),
+		  response(0),
+		  timer(context),
+		  retries(0),
+		  completed(false) {
 	}
 
 	/// Constructor.
-	/// \details Initializes object fields.
+	/// \details Initializes object fields. The device performs its I/O
+	/// through a fleet of its own, which is run by an internal thread, so that
+	/// asynchronous operations complete without help of the caller. The device
+	/// is calibrated on first use of degrees.
 	/// \param[in]	ip 				IP address.
 	/// \param[in]	port 			Port.
 	/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
 	/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+	/// \param[in]	address			Device address.
 	PelcoDEDeviceUDP::PelcoDEDeviceUDP(const std::string& ip,
 	                                   std::uint16_t port,
 	                                   std::uint16_t maxPanDegrees,
-	                                   std::uint16_t maxTiltDegrees)
-		: panStepsPerDegree_(0),
-		  tiltStepsPerDegree_(0),
-		  socket_(context_),
-		  resolver_(context_) {
-
-		endpoint_ = *resolver_.resolve(boost::asio::ip::udp::v4(),
-		                               ip, std::to_string(port)).begin();
+	                                   std::uint16_t maxTiltDegrees,
+	                                   std::uint8_t address)
+		: stepCalibration_(maxPanDegrees, maxTiltDegrees),
+		  calibrationCache_(nullptr),
+		  ownFleet_(new PelcoDEFleetUDP()),
+		  fleet_(ownFleet_.get()),
+		  endpoint_(resolve(ip, port)),
+		  address_(address),
+		  socket_(0),
+		  estimator_(policy_),
+		  draining_(false),
+		  requestCount_(0) {
+
+		socket_ = getFleet().attach(*this, endpoint_, address_);
+
+		auto fleet = ownFleet_.get();
+		thread_ = std::thread([fleet]() { fleet->run(); });
+	}
 
-		socket_.open(boost::asio::ip::udp::v4());
+	/// Constructor.
+	/// \details Initializes object fields. The device performs its I/O
+	/// through the fleet, which must be run by another thread and must
+	/// outlive the device. The device is calibrated on first use of degrees.
+	/// \param[in]	fleet			Fleet that performs device I/O.
+	/// \param[in]	ip 				IP address.
+	/// \param[in]	port 			Port.
+	/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+	/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+	/// \param[in]	address			Device address.
+	PelcoDEDeviceUDP::PelcoDEDeviceUDP(PelcoDEFleetUDP& fleet,
+	                                   const std::string& ip,
+	                                   std::uint16_t port,
+	                                   std::uint16_t maxPanDegrees,
+	                                   std::uint16_t maxTiltDegrees,
+	                                   std::uint8_t address)
+		: PelcoDEDeviceUDP(fleet, resolve(ip, port),
+		                   maxPanDegrees, maxTiltDegrees, address) {
+	}
 
-		panStepsPerDegree_ = getPanMaxSteps() / maxPanDegrees;
-		tiltStepsPerDegree_ = getTiltMaxSteps() / maxTiltDegrees;
+	/// Constructor.
+	/// \details Initializes object fields. The device performs its I/O
+	/// through the fleet, which must be run by another thread and must
+	/// outlive the device. The device is calibrated on first use of degrees.
+	/// \param[in]	fleet			Fleet that performs device I/O.
+	/// \param[in]	endpoint		Device endpoint.
+	/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+	/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+	/// \param[in]	address			Device address.
+	PelcoDEDeviceUDP::PelcoDEDeviceUDP(
+		PelcoDEFleetUDP& fleet,
+		const boost::asio::ip::udp::endpoint& endpoint,
+		std::uint16_t maxPanDegrees,
+		std::uint16_t maxTiltDegrees,
+		std::uint8_t address)
+		: stepCalibration_(maxPanDegrees, maxTiltDegrees),
+		  calibrationCache_(nullptr),
+		  fleet_(&fleet),
+		  endpoint_(endpoint),
+		  address_(address),
+		  socket_(0),
+		  estimator_(policy_),
+		  draining_(false),
+		  requestCount_(0) {
+
+		socket_ = getFleet().attach(*this, endpoint_, address_);
 	}
 
 	/// Destructor.
-	/// \details Defaulted default destructor.
-	PelcoDEDeviceUDP::~PelcoDEDeviceUDP() = default;
+	/// \details Aborts operations in flight and detaches the device on the
+	/// fleet thread, and waits until it is done, so that no handler of the
+	/// fleet uses the device afterwards. The thread of the own fleet, if any,
+	/// is stopped.
+	PelcoDEDeviceUDP::~PelcoDEDeviceUDP() {
+		getFleet().synchronize([this]() { shutdown(); });
+
+		if (thread_.joinable()) {
+			ownFleet_->stop();
+			thread_.join();
+		}
+	}
+
+	/// Resolves a device endpoint.
+	/// \details Numeric IP addresses are parsed without the resolver, host
+	/// names are resolved to IPv4 addresses.
+	/// \param[in]	ip 		IP address or host name.
+	/// \param[in]	port 	Port.
+	/// \return Device endpoint.
+	/// \throw boost::system::system_error if the name cannot be resolved.
+	boost::asio::ip::udp::endpoint PelcoDEDeviceUDP::resolve(
+		const std::string& ip, std::uint16_t port) {
+
+		boost::system::error_code error;
+		auto address = boost::asio::ip::make_address(ip, error);
+
+		if (!error) {
+			return boost::asio::ip::udp::endpoint(address, port);
+		}
+
+		boost::asio::io_context context;
+		boost::asio::ip::udp::resolver resolver(context);
+
+		return *resolver.resolve(boost::asio::ip::udp::v4(),
+		                         ip, std::to_string(port)).begin();
+	}
+
+	/// Gets fleet.
+	/// \details Gets the fleet that performs device I/O at the moment.
+	/// \return Fleet that performs device I/O.
+	PelcoDEFleetUDP& PelcoDEDeviceUDP::getFleet() const noexcept {
+		return *fleet_.load(std::memory_order_acquire);
+	}
+
+	/// Runs a function on the fleet thread.
+	/// \details Posts a function to the I/O context of the fleet. If the
+	/// device is migrated meanwhile, the function is posted again to the
+	/// context of the new fleet, so that device state is only accessed by the
+	/// thread of its current fleet.
+	/// \param[in]	function	Function.
+	void PelcoDEDeviceUDP::execute(std::function<void()> function) const {
+		boost::asio::post(getFleet().getContext(), [this, function]() {
+			auto executor = getFleet().getContext().get_executor();
+
+			if (!executor.running_in_this_thread()) {
+				execute(function);
+				return;
+			}
+
+			function();
+		});
+	}
+
+	/// Moves the device to another fleet if it is idle.
+	/// \details Attaches the device to the fleet and detaches it from the
+	/// current one unless requests or a calibration are in flight. Must be
+	/// called from the thread of the current fleet.
+	/// \param[in]	fleet	Fleet.
+	/// \return True if the device is moved.
+	bool PelcoDEDeviceUDP::migrate(PelcoDEFleetUDP& fleet) {
+		if (!requests_.empty() || !deferred_.empty() ||
+		    !calibrationHandlers_.empty()) {
+			return false;
+		}
+
+		auto socket = fleet.attach(*this, endpoint_, address_);
+		getFleet().detach(endpoint_, address_);
+
+		socket_ = socket;
+		fleet_.store(&fleet, std::memory_order_release);
+
+		return true;
+	}
+
+	/// Aborts operations in flight and detaches the device.
+	/// \details Completes deferred requests, requests in flight, submitted
+	/// requests and calibration handlers with the operation aborted error and detaches the
+	/// device from the fleet. Requests submitted from now on are not started.
+	/// Must be called from the fleet thread or while no thread runs it.
+	void PelcoDEDeviceUDP::shutdown() const {
+		draining_ = true;
+
+		for (;;) {
+			std::shared_ptr<Request> request;
+
+			if (!deferred_.empty()) {
+				request = deferred_.front();
+				deferred_.pop_front();
+				request->completed = true;
+				request->handler(boost::asio::error::operation_aborted, 0);
+			} else if (!requests_.empty()) {
+				completeRequest(requests_.front(),
+				                boost::asio::error::operation_aborted, 0);
+			} else if (submissions_.pop(request)) {
+				request->completed = true;
+				request->handler(boost::asio::error::operation_aborted, 0);
+			} else {
+				break;
+			}
+		}
+
+		std::vector<Handler> handlers;
+		handlers.swap(calibrationHandlers_);
+
+		for (const auto& handler : handlers) {
+			handler(boost::asio::error::operation_aborted);
+		}
+
+		getFleet().detach(endpoint_, address_);
+	}
+
+	/// Completes the calibration.
+	/// \details Calculates the number of steps per degree of rotation, stores
+	/// the calibration in the cache and invokes waiting handlers. A
+	/// calibration that is not plausible fails with the bad message error
+	/// and is neither used nor stored. The method is called from the I/O
+	/// context.
+	/// \param[in]	result		Error code.
+	/// \param[in]	calibration	Device calibration.
+	void PelcoDEDeviceUDP::completeCalibration(
+		const boost::system::error_code& result,
+		const Calibration& calibration) const {
+
+		auto error = result;
+
+		if (!error && !stepCalibration_.apply(calibration)) {
+			error = boost::system::errc::make_error_code(
+				boost::system::errc::bad_message);
+		}
+
+		if (!error) {
+			if (calibrationCache_) {
+				calibrationCache_->insert(endpoint_, address_, calibration);
+			}
+		}
+
+		std::vector<Handler> handlers;
+		handlers.swap(calibrationHandlers_);
+
+		for (const auto& handler : handlers) {
+			handler(error);
+		}
+	}
 
 	/// Gets pan degrees.
 	/// \details Gets pan value in degrees.
 	/// \return Pan degrees.
 	std::uint16_t PelcoDEDeviceUDP::getPanDegrees() const {
-		return getPanSteps() / panStepsPerDegree_;
+		calibrate();
+		return getPanSteps() / stepCalibration_.getPanStepsPerDegree();
 	}
 
 	/// Sets pan degrees.
 	/// \details Sets pan value in degrees.
 	/// \param[in]	degrees	Pan degrees.
 	void PelcoDEDeviceUDP::setPanDegrees(std::uint16_t degrees) {
+		calibrate();
 		degrees %= 360;
-		setPanSteps(degrees * panStepsPerDegree_);
+		setPanSteps(degrees * stepCalibration_.getPanStepsPerDegree());
 	}
 
 	/// Gets tilt degrees.
 	/// \details Gets tilt value in degrees.
 	/// \return Tilt degrees.
 	std::uint16_t PelcoDEDeviceUDP::getTiltDegrees() const {
-		return getTiltSteps() / tiltStepsPerDegree_;
+		calibrate();
+		return getTiltSteps() / stepCalibration_.getTiltStepsPerDegree();
 	}
 
 	/// Sets tilt degrees.
 	/// \details Sets tilt value in degrees.
 	/// \param[in]	degrees	Tilt degrees.
 	void PelcoDEDeviceUDP::setTiltDegrees(std::uint16_t degrees) {
+		calibrate();
 		degrees %= 135;
-		setTiltSteps(degrees * tiltStepsPerDegree_);
+		setTiltSteps(degrees * stepCalibration_.getTiltStepsPerDegree());
 	}
 
 	/// Gets pan steps.
 	/// \details Gets pan value in steps.
 	/// \return Pan steps.
 	std::uint16_t PelcoDEDeviceUDP::getPanSteps() const {
-		sendMessage(createMessage(COMMAND_REQUEST_GET_PAN_STEPS),
-		            endpoint_, socket_);
-
-		return receiveMessage(socket_);
+		return request(Codec::COMMAND_REQUEST_GET_PAN_STEPS);
 	}
 
 	/// Gets pan maximum number of steps.
 	/// \details Gets pan maximum value in steps.
 	/// \return Pan maximum number of steps.
 	std::uint16_t PelcoDEDeviceUDP::getPanMaxSteps() const {
-		sendMessage(createMessage(COMMAND_REQUEST_GET_PAN_MAX_STEPS),
-		            endpoint_, socket_);
-
-		return receiveMessage(socket_);
+		return request(Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS);
 	}
 
 	/// Sets pan steps.
 	/// \details Sets pan value in steps.
 	/// \param[in]	steps	Pan steps.
 	void PelcoDEDeviceUDP::setPanSteps(std::uint16_t steps) {
-		sendMessage(createMessage(COMMAND_REQUEST_SET_PAN_STEPS, steps),
-		            endpoint_, socket_);
-
-		receiveMessage(socket_);
+		request(Codec::COMMAND_REQUEST_SET_PAN_STEPS, steps);
 	}
 
 	/// Gets tilt steps.
 	/// \details Gets tilt value in steps.
 	/// \return Tilt steps.
 	std::uint16_t PelcoDEDeviceUDP::getTiltSteps() const {
-		sendMessage(createMessage(COMMAND_REQUEST_GET_TILT_STEPS),
-		            endpoint_, socket_);
-
-		return receiveMessage(socket_);
+		return request(Codec::COMMAND_REQUEST_GET_TILT_STEPS);
 	}
 
 	/// Gets tilt maximum number of steps.
 	/// \details Gets tilt maximum value in steps.
 	/// \return Tilt maximum number of steps.
 	std::uint16_t PelcoDEDeviceUDP::getTiltMaxSteps() const {
-		sendMessage(createMessage(COMMAND_REQUEST_GET_TILT_MAX_STEPS),
-		            endpoint_, socket_);
-
-		return receiveMessage(socket_);
+		return request(Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS);
 	}
 
 	/// Sets tilt steps.
 	/// \details Sets tilt value in steps.
 	/// \param[in]	steps	Tilt steps.
 	void PelcoDEDeviceUDP::setTiltSteps(std::uint16_t steps) {
-		sendMessage(createMessage(COMMAND_REQUEST_SET_TILT_STEPS, steps),
-		            endpoint_, socket_);
+		request(Codec::COMMAND_REQUEST_SET_TILT_STEPS, steps);
+	}
+
+	/// Gets pan and tilt position.
+	/// \details Gets pan and tilt values in steps with requests that are in
+	/// flight at the same time.
+	/// \return Pan and tilt position.
+	Position PelcoDEDeviceUDP::getPosition() const {
+		return wait(getPositionAsync());
+	}
 
-		receiveMessage(socket_);
+	/// Sets pan and tilt position.
+	/// \details Sets pan and tilt values in steps. The tilt request is sent
+	/// once the pan request is acknowledged, as both are acknowledged with the
+	/// same response command.
+	/// \param[in]	panSteps	Pan steps.
+	/// \param[in]	tiltSteps	Tilt steps.
+	void PelcoDEDeviceUDP::setPosition(std::uint16_t panSteps,
+	                                   std::uint16_t tiltSteps) {
+		wait(setPositionAsync(panSteps, tiltSteps));
 	}
 
 	/// Gets device temperature.
 	/// \details Gets device temperature value.
 	/// \return Device temperature.
 	std::int16_t PelcoDEDeviceUDP::getTemperature() const {
-		sendMessage(createMessage(COMMAND_REQUEST_GET_TEMPERATURE),
-		            endpoint_, socket_);
-
-		return receiveMessage(socket_);
+		return request(Codec::COMMAND_REQUEST_GET_TEMPERATURE);
 	}
 
 	/// Gets device voltage.
 	/// \details Gets device voltage value.
 	/// \return Device voltage.
 	double PelcoDEDeviceUDP::getVoltage() const {
-		sendMessage(createMessage(COMMAND_REQUEST_GET_VOLTAGE),
-		            endpoint_, socket_);
+		return request(Codec::COMMAND_REQUEST_GET_VOLTAGE) / 100.0;
+	}
+
+	/// Starts continuous motion.
+	/// \details Sends one standard frame that starts or stops pan, tilt, zoom
+	/// and focus at once. The device does not respond, the method returns
+	/// when the frame is sent.
+	/// \param[in]	motion	Motion.
+	/// \throw std::invalid_argument if a speed is out of range.
+	void PelcoDEDeviceUDP::move(const Motion& motion) {
+		if (motion.panSpeed > Codec::MAX_MOTION_SPEED ||
+		    motion.panSpeed < -Codec::MAX_MOTION_SPEED ||
+		    motion.tiltSpeed > Codec::MAX_MOTION_SPEED ||
+		    motion.tiltSpeed < -Codec::MAX_MOTION_SPEED) {
+
+			throw std::invalid_argument("The speed is out of range!");
+		}
+
+		command(Codec::createMotionFrame(address_,
+		                                 motion.panSpeed,
+		                                 motion.tiltSpeed,
+		                                 motion.zoom,
+		                                 motion.focus));
+	}
+
+	/// Stops motion.
+	/// \details Sends a standard frame without motion bits.
+	void PelcoDEDeviceUDP::stop() {
+		command(Codec::createMotionFrame(address_, 0, 0));
+	}
+
+	/// Stores the current position as a preset.
+	/// \details Sends a standard set preset frame.
+	/// \param[in]	preset	Preset number.
+	/// \throw std::invalid_argument if the preset number is zero.
+	void PelcoDEDeviceUDP::setPreset(std::uint8_t preset) {
+		if (preset == 0) {
+			throw std::invalid_argument("The preset is invalid!");
+		}
+
+		command(Codec::createStandardFrame(
+			address_, Codec::StandardOperation::SetPreset, 0, preset));
+	}
+
+	/// Clears a preset.
+	/// \details Sends a standard clear preset frame.
+	/// \param[in]	preset	Preset number.
+	/// \throw std::invalid_argument if the preset number is zero.
+	void PelcoDEDeviceUDP::clearPreset(std::uint8_t preset) {
+		if (preset == 0) {
+			throw std::invalid_argument("The preset is invalid!");
+		}
+
+		command(Codec::createStandardFrame(
+			address_, Codec::StandardOperation::ClearPreset, 0, preset));
+	}
+
+	/// Moves to a preset.
+	/// \details Sends one standard go to preset frame, the device moves to the
+	/// stored position on its own. The method returns when the frame is sent,
+	/// not when the device arrives.
+	/// \param[in]	preset	Preset number.
+	/// \throw std::invalid_argument if the preset number is zero.
+	void PelcoDEDeviceUDP::goToPreset(std::uint8_t preset) {
+		if (preset == 0) {
+			throw std::invalid_argument("The preset is invalid!");
+		}
+
+		command(Codec::createStandardFrame(
+			address_, Codec::StandardOperation::GoToPreset, 0, preset));
+	}
+
+	/// Sets zoom speed.
+	/// \details Sends a standard set zoom speed frame.
+	/// \param[in]	speed	Zoom speed from 0 to 3.
+	/// \throw std::invalid_argument if the speed is out of range.
+	void PelcoDEDeviceUDP::setZoomSpeed(std::uint8_t speed) {
+		if (speed > Codec::MAX_LENS_SPEED) {
+			throw std::invalid_argument("The speed is out of range!");
+		}
+
+		command(Codec::createStandardFrame(
+			address_, Codec::StandardOperation::SetZoomSpeed, 0, speed));
+	}
+
+	/// Sets focus speed.
+	/// \details Sends a standard set focus speed frame.
+	/// \param[in]	speed	Focus speed from 0 to 3.
+	/// \throw std::invalid_argument if the speed is out of range.
+	void PelcoDEDeviceUDP::setFocusSpeed(std::uint8_t speed) {
+		if (speed > Codec::MAX_LENS_SPEED) {
+			throw std::invalid_argument("The speed is out of range!");
+		}
+
+		command(Codec::createStandardFrame(
+			address_, Codec::StandardOperation::SetFocusSpeed, 0, speed));
+	}
+
+	/// Gets device status.
+	/// \details Gets pan steps, tilt steps, temperature and voltage with
+	/// requests that are in flight at the same time.
+	/// \return Device status.
+	PelcoDEDeviceUDP::Status PelcoDEDeviceUDP::getStatus() const {
+		return wait(getStatusAsync());
+	}
+
+	/// Calibrates the device.
+	/// \details Obtains pan and tilt maximum number of steps unless the
+	/// device is already calibrated.
+	void PelcoDEDeviceUDP::calibrate() const {
+		if (!stepCalibration_.isCalibrated()) {
+			wait(calibrateAsync());
+		}
+	}
+
+	/// Sets calibration cache.
+	/// \details Sets the cache that is looked up before the device is probed
+	/// and that receives new calibrations. The cache file is written by the
+	/// owner of the cache.
+	/// \param[in]	cache	Calibration cache, it must outlive the device.
+	void PelcoDEDeviceUDP::setCalibrationCache(PelcoDECalibrationCache& cache) {
+		execute([this, &cache]() {
+			calibrationCache_ = &cache;
+		});
+	}
+
+	/// Sets retransmission policy.
+	/// \details Sets the policy of requests queued after the call and resets
+	/// round-trip time estimation.
+	/// \param[in]	policy	Retransmission policy.
+	void PelcoDEDeviceUDP::setRetransmissionPolicy(
+		const RetransmissionPolicy& policy) {
+
+		execute([this, policy]() {
+			policy_ = policy;
+			estimator_ = RoundTripEstimator(policy_);
+		});
+	}
+
+	/// Gets I/O context.
+	/// \details Gets I/O context of the fleet that completes asynchronous
+	/// operations. The context is run by the internal thread if the device
+	/// owns its fleet, otherwise by the thread that runs the fleet.
+	/// \return I/O context.
+	boost::asio::io_context& PelcoDEDeviceUDP::getContext() noexcept {
+		return getFleet().getContext();
+	}
+
+	/// Gets device metrics.
+	/// \details Takes a snapshot of request counters and latency. It may be
+	/// called from any thread. Metrics are zero if they are compiled out.
+	/// \return Device metrics snapshot.
+	DeviceMetricsSnapshot PelcoDEDeviceUDP::getMetrics() const {
+		return metrics_.getSnapshot();
+	}
+
+	/// Asynchronously calibrates the device.
+	/// \details Takes the calibration from the cache if it is there,
+	/// otherwise sends pan and tilt maximum number of steps requests at once.
+	/// Concurrent calls share one calibration, a failed calibration is
+	/// retried by the next call.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncCalibrate(Handler handler) const {
+		execute([this, handler]() {
+			if (stepCalibration_.isCalibrated()) {
+				handler(boost::system::error_code());
+				return;
+			}
+
+			calibrationHandlers_.push_back(handler);
+
+			if (calibrationHandlers_.size() > 1) {
+				return;
+			}
+
+			Calibration calibration;
+
+			if (calibrationCache_ &&
+			    calibrationCache_->find(endpoint_, address_, calibration) &&
+			    stepCalibration_.isPlausible(calibration)) {
+				completeCalibration(boost::system::error_code(), calibration);
+				return;
+			}
+
+			struct State {
+				Calibration calibration;
+				std::size_t remaining;
+				boost::system::error_code error;
+			};
+
+			auto state = std::make_shared<State>();
+			state->calibration = Calibration();
+			state->remaining = 2;
+
+			auto complete = [this, state](
+				const boost::system::error_code& error) {
+
+				if (error && !state->error) {
+					state->error = error;
+				}
+
+				if (--state->remaining == 0) {
+					completeCalibration(state->error, state->calibration);
+				}
+			};
+
+			asyncGetPanMaxSteps(
+				[state, complete](const boost::system::error_code& error,
+				                  std::uint16_t value) {
+					state->calibration.panMaxSteps = value;
+					complete(error);
+				});
+
+			asyncGetTiltMaxSteps(
+				[state, complete](const boost::system::error_code& error,
+				                  std::uint16_t value) {
+					state->calibration.tiltMaxSteps = value;
+					complete(error);
+				});
+		});
+	}
+
+	/// Asynchronously gets pan degrees.
+	/// \details Asynchronously gets pan value in degrees.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncGetPanDegrees(
+		ValueHandler<std::uint16_t> handler) const {
+
+		asyncCalibrate([this, handler](const boost::system::error_code& error) {
+			if (error) {
+				handler(error, 0);
+				return;
+			}
+
+			asyncGetPanSteps(
+				[this, handler](const boost::system::error_code& error,
+				                std::uint16_t steps) {
+					handler(error, error ? 0 : steps /
+						stepCalibration_.getPanStepsPerDegree());
+				});
+		});
+	}
+
+	/// Asynchronously sets pan degrees.
+	/// \details Asynchronously sets pan value in degrees.
+	/// \param[in]	degrees	Pan degrees.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncSetPanDegrees(std::uint16_t degrees,
+	                                          Handler handler) {
+		degrees %= 360;
+
+		asyncCalibrate(
+			[this, degrees, handler](const boost::system::error_code& error) {
+				if (error) {
+					handler(error);
+					return;
+				}
+
+				asyncSetPanSteps(
+					degrees * stepCalibration_.getPanStepsPerDegree(), handler);
+			});
+	}
+
+	/// Asynchronously gets tilt degrees.
+	/// \details Asynchronously gets tilt value in degrees.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncGetTiltDegrees(
+		ValueHandler<std::uint16_t> handler) const {
+
+		asyncCalibrate([this, handler](const boost::system::error_code& error) {
+			if (error) {
+				handler(error, 0);
+				return;
+			}
+
+			asyncGetTiltSteps(
+				[this, handler](const boost::system::error_code& error,
+				                std::uint16_t steps) {
+					handler(error, error ? 0 : steps /
+						stepCalibration_.getTiltStepsPerDegree());
+				});
+		});
+	}
+
+	/// Asynchronously sets tilt degrees.
+	/// \details Asynchronously sets tilt value in degrees.
+	/// \param[in]	degrees	Tilt degrees.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncSetTiltDegrees(std::uint16_t degrees,
+	                                           Handler handler) {
+		degrees %= 135;
+
+		asyncCalibrate(
+			[this, degrees, handler](const boost::system::error_code& error) {
+				if (error) {
+					handler(error);
+					return;
+				}
+
+				asyncSetTiltSteps(
+					degrees * stepCalibration_.getTiltStepsPerDegree(), handler);
+			});
+	}
+
+	/// Asynchronously gets pan steps.
+	/// \details Asynchronously gets pan value in steps.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncGetPanSteps(
+		ValueHandler<std::uint16_t> handler) const {
+
+		asyncRequest(Codec::COMMAND_REQUEST_GET_PAN_STEPS, 0, std::move(handler));
+	}
+
+	/// Asynchronously gets pan maximum number of steps.
+	/// \details Asynchronously gets pan maximum value in steps.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncGetPanMaxSteps(
+		ValueHandler<std::uint16_t> handler) const {
+
+		asyncRequest(Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS, 0, std::move(handler));
+	}
+
+	/// Asynchronously sets pan steps.
+	/// \details Asynchronously sets pan value in steps.
+	/// \param[in]	steps	Pan steps.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncSetPanSteps(std::uint16_t steps,
+	                                        Handler handler) {
+		asyncRequest(Codec::COMMAND_REQUEST_SET_PAN_STEPS, steps,
+		             [handler](const boost::system::error_code& error,
+		                       std::uint16_t) {
+			             handler(error);
+		             });
+	}
+
+	/// Asynchronously gets tilt steps.
+	/// \details Asynchronously gets tilt value in steps.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncGetTiltSteps(
+		ValueHandler<std::uint16_t> handler) const {
+
+		asyncRequest(Codec::COMMAND_REQUEST_GET_TILT_STEPS, 0, std::move(handler));
+	}
+
+	/// Asynchronously gets tilt maximum number of steps.
+	/// \details Asynchronously gets tilt maximum value in steps.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncGetTiltMaxSteps(
+		ValueHandler<std::uint16_t> handler) const {
+
+		asyncRequest(Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS, 0, std::move(handler));
+	}
+
+	/// Asynchronously sets tilt steps.
+	/// \details Asynchronously sets tilt value in steps.
+	/// \param[in]	steps	Tilt steps.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncSetTiltSteps(std::uint16_t steps,
+	                                         Handler handler) {
+		asyncRequest(Codec::COMMAND_REQUEST_SET_TILT_STEPS, steps,
+		             [handler](const boost::system::error_code& error,
+		                       std::uint16_t) {
+			             handler(error);
+		             });
+	}
+
+	/// Asynchronously gets pan and tilt position.
+	/// \details Sends pan steps and tilt steps requests at once and completes
+	/// when both responses are received. The first error, if any, is
+	/// reported.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncGetPosition(
+		ValueHandler<Position> handler) const {
+
+		struct State {
+			Position position;
+			std::size_t remaining;
+			boost::system::error_code error;
+			ValueHandler<Position> handler;
+		};
+
+		auto state = std::make_shared<State>();
+		state->position = Position();
+		state->remaining = 2;
+		state->handler = std::move(handler);
+
+		auto complete = [state](const boost::system::error_code& error) {
+			if (error && !state->error) {
+				state->error = error;
+			}
+
+			if (--state->remaining == 0) {
+				state->handler(state->error, state->position);
+			}
+		};
+
+		asyncGetPanSteps(
+			[state, complete](const boost::system::error_code& error,
+			                  std::uint16_t value) {
+				state->position.panSteps = value;
+				complete(error);
+			});
+
+		asyncGetTiltSteps(
+			[state, complete](const boost::system::error_code& error,
+			                  std::uint16_t value) {
+				state->position.tiltSteps = value;
+				complete(error);
+			});
+	}
+
+	/// Asynchronously sets pan and tilt position.
+	/// \details Sends pan steps and tilt steps messages together as one
+	/// exchange that completes when both acknowledgements are received. Both
+	/// messages are acknowledged with the same response command, so on
+	/// timeout both are sent again, which is safe since absolute steps may be
+	/// set twice.
+	/// \param[in]	panSteps	Pan steps.
+	/// \param[in]	tiltSteps	Tilt steps.
+	/// \param[in]	handler		Completion handler.
+	void PelcoDEDeviceUDP::asyncSetPosition(std::uint16_t panSteps,
+	                                        std::uint16_t tiltSteps,
+	                                        Handler handler) {
+		const Part parts[] {
+			{ Codec::COMMAND_REQUEST_SET_PAN_STEPS, panSteps },
+			{ Codec::COMMAND_REQUEST_SET_TILT_STEPS, tiltSteps }
+		};
+
+		submit(createRequest(parts, 2,
+			[handler](const boost::system::error_code& error, std::uint16_t) {
+				handler(error);
+			}));
+	}
+
+	/// Asynchronously gets device temperature.
+	/// \details Asynchronously gets device temperature value.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncGetTemperature(
+		ValueHandler<std::int16_t> handler) const {
+
+		asyncRequest(Codec::COMMAND_REQUEST_GET_TEMPERATURE, 0,
+		             [handler](const boost::system::error_code& error,
+		                       std::uint16_t value) {
+			             handler(error, static_cast<std::int16_t>(value));
+		             });
+	}
+
+	/// Asynchronously gets device voltage.
+	/// \details Asynchronously gets device voltage value.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncGetVoltage(ValueHandler<double> handler) const {
+		asyncRequest(Codec::COMMAND_REQUEST_GET_VOLTAGE, 0,
+		             [handler](const boost::system::error_code& error,
+		                       std::uint16_t value) {
+			             handler(error, value / 100.0);
+		             });
+	}
+
+	/// Asynchronously gets device status.
+	/// \details Sends pan steps, tilt steps, temperature and voltage requests
+	/// at once and completes when all responses are received. The first
+	/// error, if any, is reported.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncGetStatus(
+		ValueHandler<Status> handler) const {
+
+		struct State {
+			Status status;
+			std::size_t remaining;
+			boost::system::error_code error;
+			ValueHandler<Status> handler;
+		};
+
+		auto state = std::make_shared<State>();
+		state->status = Status();
+		state->remaining = 4;
+		state->handler = std::move(handler);
+
+		auto complete = [state](const boost::system::error_code& error) {
+			if (error && !state->error) {
+				state->error = error;
+			}
+
+			if (--state->remaining == 0) {
+				state->handler(state->error, state->status);
+			}
+		};
+
+		asyncGetPanSteps(
+			[state, complete](const boost::system::error_code& error,
+			                  std::uint16_t value) {
+				state->status.panSteps = value;
+				complete(error);
+			});
+
+		asyncGetTiltSteps(
+			[state, complete](const boost::system::error_code& error,
+			                  std::uint16_t value) {
+				state->status.tiltSteps = value;
+				complete(error);
+			});
+
+		asyncGetTemperature(
+			[state, complete](const boost::system::error_code& error,
+			                  std::int16_t value) {
+				state->status.temperature = value;
+				complete(error);
+			});
+
+		asyncGetVoltage(
+			[state, complete](const boost::system::error_code& error,
+			                  double value) {
+				state->status.voltage = value;
+				complete(error);
+			});
+	}
+
+	/// Calibrates the device without blocking.
+	/// \details Calibrates the device without blocking.
+	/// \return Future completion.
+	std::future<void> PelcoDEDeviceUDP::calibrateAsync() const {
+		auto promise = std::make_shared<std::promise<void>>();
+		asyncCalibrate(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Gets pan degrees without blocking.
+	/// \details Gets pan value in degrees without blocking.
+	/// \return Future pan degrees.
+	std::future<std::uint16_t> PelcoDEDeviceUDP::getPanDegreesAsync() const {
+		auto promise = std::make_shared<std::promise<std::uint16_t>>();
+		asyncGetPanDegrees(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Sets pan degrees without blocking.
+	/// \details Sets pan value in degrees without blocking.
+	/// \param[in]	degrees	Pan degrees.
+	/// \return Future completion.
+	std::future<void> PelcoDEDeviceUDP::setPanDegreesAsync(
+		std::uint16_t degrees) {
+
+		auto promise = std::make_shared<std::promise<void>>();
+		asyncSetPanDegrees(degrees, createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Gets tilt degrees without blocking.
+	/// \details Gets tilt value in degrees without blocking.
+	/// \return Future tilt degrees.
+	std::future<std::uint16_t> PelcoDEDeviceUDP::getTiltDegreesAsync() const {
+		auto promise = std::make_shared<std::promise<std::uint16_t>>();
+		asyncGetTiltDegrees(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Sets tilt degrees without blocking.
+	/// \details Sets tilt value in degrees without blocking.
+	/// \param[in]	degrees	Tilt degrees.
+	/// \return Future completion.
+	std::future<void> PelcoDEDeviceUDP::setTiltDegreesAsync(
+		std::uint16_t degrees) {
+
+		auto promise = std::make_shared<std::promise<void>>();
+		asyncSetTiltDegrees(degrees, createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Gets pan steps without blocking.
+	/// \details Gets pan value in steps without blocking.
+	/// \return Future pan steps.
+	std::future<std::uint16_t> PelcoDEDeviceUDP::getPanStepsAsync() const {
+		auto promise = std::make_shared<std::promise<std::uint16_t>>();
+		asyncGetPanSteps(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Gets pan maximum number of steps without blocking.
+	/// \details Gets pan maximum value in steps without blocking.
+	/// \return Future pan maximum number of steps.
+	std::future<std::uint16_t> PelcoDEDeviceUDP::getPanMaxStepsAsync() const {
+		auto promise = std::make_shared<std::promise<std::uint16_t>>();
+		asyncGetPanMaxSteps(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Sets pan steps without blocking.
+	/// \details Sets pan value in steps without blocking.
+	/// \param[in]	steps	Pan steps.
+	/// \return Future completion.
+	std::future<void> PelcoDEDeviceUDP::setPanStepsAsync(std::uint16_t steps) {
+		auto promise = std::make_shared<std::promise<void>>();
+		asyncSetPanSteps(steps, createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Gets tilt steps without blocking.
+	/// \details Gets tilt value in steps without blocking.
+	/// \return Future tilt steps.
+	std::future<std::uint16_t> PelcoDEDeviceUDP::getTiltStepsAsync() const {
+		auto promise = std::make_shared<std::promise<std::uint16_t>>();
+		asyncGetTiltSteps(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Gets tilt maximum number of steps without blocking.
+	/// \details Gets tilt maximum value in steps without blocking.
+	/// \return Future tilt maximum number of steps.
+	std::future<std::uint16_t> PelcoDEDeviceUDP::getTiltMaxStepsAsync() const {
+		auto promise = std::make_shared<std::promise<std::uint16_t>>();
+		asyncGetTiltMaxSteps(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Sets tilt steps without blocking.
+	/// \details Sets tilt value in steps without blocking.
+	/// \param[in]	steps	Tilt steps.
+	/// \return Future completion.
+	std::future<void> PelcoDEDeviceUDP::setTiltStepsAsync(std::uint16_t steps) {
+		auto promise = std::make_shared<std::promise<void>>();
+		asyncSetTiltSteps(steps, createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Gets pan and tilt position without blocking.
+	/// \details Gets pan and tilt values in steps without blocking.
+	/// \return Future pan and tilt position.
+	std::future<Position> PelcoDEDeviceUDP::getPositionAsync() const {
+		auto promise = std::make_shared<std::promise<Position>>();
+		asyncGetPosition(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Sets pan and tilt position without blocking.
+	/// \details Sets pan and tilt values in steps without blocking.
+	/// \param[in]	panSteps	Pan steps.
+	/// \param[in]	tiltSteps	Tilt steps.
+	/// \return Future completion.
+	std::future<void> PelcoDEDeviceUDP::setPositionAsync(
+		std::uint16_t panSteps, std::uint16_t tiltSteps) {
+
+		auto promise = std::make_shared<std::promise<void>>();
+		asyncSetPosition(panSteps, tiltSteps, createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Gets device temperature without blocking.
+	/// \details Gets device temperature value without blocking.
+	/// \return Future device temperature.
+	std::future<std::int16_t> PelcoDEDeviceUDP::getTemperatureAsync() const {
+		auto promise = std::make_shared<std::promise<std::int16_t>>();
+		asyncGetTemperature(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Gets device voltage without blocking.
+	/// \details Gets device voltage value without blocking.
+	/// \return Future device voltage.
+	std::future<double> PelcoDEDeviceUDP::getVoltageAsync() const {
+		auto promise = std::make_shared<std::promise<double>>();
+		asyncGetVoltage(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Gets device status without blocking.
+	/// \details Gets pan steps, tilt steps, temperature and voltage without
+	/// blocking.
+	/// \return Future device status.
+	std::future<PelcoDEDeviceUDP::Status>
+	PelcoDEDeviceUDP::getStatusAsync() const {
+		auto promise = std::make_shared<std::promise<Status>>();
+		asyncGetStatus(createPromiseHandler(promise));
+		return promise->get_future();
+	}
+
+	/// Creates a request exchange.
+	/// \details Creates a request whose messages are sent together and
+	/// acknowledged with the same response command. The exchange completes
+	/// with the value of the last response.
+	/// \param[in]	parts	Request commands and values.
+	/// \param[in]	count	Number of request commands.
+	/// \param[in]	handler	Completion handler.
+	/// \return Request.
+	/// \throw std::invalid_argument if the commands cannot form an exchange.
+	std::shared_ptr<PelcoDEDeviceUDP::Request> PelcoDEDeviceUDP::createRequest(
+		const Part* parts,
+		std::size_t count,
+		ValueHandler<std::uint16_t> handler) const {
+
+		auto request = std::make_shared<Request>(getFleet().getContext());
+
+		if (count == 0 || count > request->messages.size()) {
+			throw std::invalid_argument("The exchange is invalid!");
+		}
+
+		request->response = Codec::getResponseCommand(parts[0].command);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			if (Codec::getResponseCommand(parts[i].command) !=
+			    request->response) {
+				throw std::invalid_argument("The exchange is invalid!");
+			}
+
+			request->messages[i] = Codec::createFrame(
+				address_, parts[i].command, parts[i].value);
+		}
+
+		request->count = count;
+		request->handler = std::move(handler);
+		return request;
+	}
+
+	/// Queues a request.
+	/// \details Creates a request of one command and queues it.
+	/// \param[in]	command	Request command.
+	/// \param[in]	value	Request value.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncRequest(
+		std::uint8_t command,
+		std::uint16_t value,
+		ValueHandler<std::uint16_t> handler) const {
+
+		const Part part { command, value };
+		submit(createRequest(&part, 1, std::move(handler)));
+	}
+
+	/// Queues a created request.
+	/// \details Pushes a request to the lock-free submission queue, which is
+	/// drained by the I/O context. The request is sent at once.
+	/// Many requests may be in flight, each response is delivered to the
+	/// oldest request that expects its response command. A request fails with
+	/// the timed out error if no response arrives before its deadline.
+	/// \param[in]	request	Request.
+	void PelcoDEDeviceUDP::submit(std::shared_ptr<Request> request) const {
+		submissions_.push(std::move(request));
+
+		if (!draining_.exchange(true)) {
+			execute([this]() { drain(); });
+		}
+	}
+
+	/// Starts exchanges of submitted requests.
+	/// \details Pops all submitted requests and sends them. A request
+	/// submitted after the draining flag is cleared is either popped here or
+	/// schedules the next drain. A request created for the fleet the device
+	/// was migrated from is recreated for the current fleet.
+	void PelcoDEDeviceUDP::drain() const {
+		draining_ = false;
+
+		auto& context = getFleet().getContext();
+		std::shared_ptr<Request> request;
+
+		while (submissions_.pop(request)) {
+			++requestCount_;
+			PELCOD_METRICS(metrics_.requests.fetch_add(
+				1, std::memory_order_relaxed));
+
+			if (&request->timer.get_executor().context() != &context) {
+				auto migrated = std::make_shared<Request>(context);
+				migrated->messages = request->messages;
+				migrated->count = request->count;
+				migrated->response = request->response;
+				migrated->handler = std::move(request->handler);
+				request = std::move(migrated);
+			}
+
+			request->started = std::chrono::steady_clock::now();
+			request->deadline = request->started + policy_.deadline;
+
+			if (isAmbiguous(request, deferred_.size())) {
+				deferred_.push_back(request);
+				continue;
+			}
+
+			requests_.push_back(request);
+			startRequest(request);
+		}
+	}
+
+	/// Checks whether the response to a request sent by a group can be
+	/// correlated.
+	/// \details A group request cannot be deferred, since the group sends it
+	/// to every device at once, so it is registered only if its response is
+	/// not ambiguous. Must be called from the fleet thread.
+	/// \param[in]	request	Request.
+	/// \return True if the request can be registered at once.
+	bool PelcoDEDeviceUDP::canExpectResponse(
+		const std::shared_ptr<Request>& request) const {
+
+		return !isAmbiguous(request, deferred_.size());
+	}
+
+	/// Waits for the response to a request sent by a group.
+	/// \details Registers a request that a group has sent or is about to
+	/// send in one datagram to several devices, so that the response of the
+	/// device is correlated, and arms its timer. Retransmissions are sent to
+	/// the device alone. The request must be accepted by canExpectResponse()
+	/// first. Must be called from the fleet thread.
+	/// \param[in]	request	Request.
+	void PelcoDEDeviceUDP::expectResponse(
+		const std::shared_ptr<Request>& request) const {
+
+		request->started = std::chrono::steady_clock::now();
+		request->sent = request->started;
+		request->deadline = request->started + policy_.deadline;
+		request->pending = request->count;
+
+		++requestCount_;
+		PELCOD_METRICS(metrics_.requests.fetch_add(
+			1, std::memory_order_relaxed));
+
+		requests_.push_back(request);
+		startTimer(request);
+	}
+
+	/// Sends a command that has no response.
+	/// \details Standard commands are not acknowledged by the device, so the
+	/// command completes when the message is sent and is neither retransmitted
+	/// nor matched with received messages.
+	/// \param[in]	message	Command message.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEDeviceUDP::asyncCommand(const Message& message,
+	                                    Handler handler) const {
+		auto shared = std::make_shared<Message>(message);
+
+		execute([this, shared, handler]() {
+			auto complete = [shared, handler](
+				const boost::system::error_code& error) {
+
+				handler(error);
+			};
+
+			getFleet().send(socket_, *shared, endpoint_, complete);
+		});
+	}
+
+	/// Sends a command that has no response and waits for the sending.
+	/// \details Sends a command and waits until the message is sent.
+	/// \param[in]	message	Command message.
+	/// \throw std::logic_error if called from the fleet thread.
+	/// \throw boost::system::system_error on failure.
+	void PelcoDEDeviceUDP::command(const Message& message) const {
+		auto promise = std::make_shared<std::promise<void>>();
+		asyncCommand(message, createPromiseHandler(promise));
+		wait(promise->get_future());
+	}
+
+	/// Performs a request and waits for its completion.
+	/// \details Queues a request and waits for its completion.
+	/// \param[in]	command	Request command.
+	/// \param[in]	value	Request value.
+	/// \return Response value.
+	/// \throw std::logic_error if called from the fleet thread.
+	/// \throw boost::system::system_error on failure.
+	std::uint16_t PelcoDEDeviceUDP::request(std::uint8_t command,
+	                                        std::uint16_t value) const {
+		auto promise = std::make_shared<std::promise<std::uint16_t>>();
+		asyncRequest(command, value, createPromiseHandler(promise));
+		return wait(promise->get_future());
+	}
+
+	/// Waits for an operation to complete.
+	/// \details The operation is completed by the fleet thread, which is the
+	/// internal thread if the device owns its fleet.
+	/// \param[in]	future	Future operation result.
+	/// \return Operation result.
+	/// \throw std::logic_error if called from the fleet thread.
+	/// \throw boost::system::system_error on failure.
+	template <typename T>
+	T PelcoDEDeviceUDP::wait(std::future<T> future) const {
+		if (getFleet().getContext().get_executor().running_in_this_thread()) {
+			throw std::logic_error("The method is called from the fleet thread!");
+		}
+
+		return future.get();
+	}
+
+	/// Checks whether the response to a request would be ambiguous.
+	/// \details Responses are matched to requests by their command, and some
+	/// commands share a response command, for example pan and tilt set
+	/// commands. If such requests were in flight together, the response to
+	/// one of them would complete the other, so that a lost message would go
+	/// unnoticed. A request also waits behind deferred requests that expect
+	/// the same response, so that it cannot overtake and starve them.
+	/// \param[in]	request	Request.
+	/// \param[in]	ahead	Number of deferred requests queued before the
+	/// request.
+	/// \return True if a request in flight expects the same response to
+	/// other commands or a deferred request ahead expects the same
+	/// response.
+	bool PelcoDEDeviceUDP::isAmbiguous(
+		const std::shared_ptr<Request>& request,
+		std::size_t ahead) const {
+
+		auto conflicts = [&request](const std::shared_ptr<Request>& other) {
+			if (other->response != request->response) {
+				return false;
+			}
+
+			if (other->count != request->count) {
+				return true;
+			}
+
+			for (std::size_t i = 0; i < request->count; ++i) {
+				if (other->messages[i][Codec::COMMAND2_BYTE_INDEX] !=
+				    request->messages[i][Codec::COMMAND2_BYTE_INDEX]) {
+					return true;
+				}
+			}
+
+			return false;
+		};
+
+		auto response = request->response;
+
+		return std::any_of(requests_.begin(), requests_.end(), conflicts) ||
+		       std::any_of(deferred_.begin(), deferred_.begin() +
+		                   static_cast<std::ptrdiff_t>(ahead),
+		                   [response](const std::shared_ptr<Request>& other) {
+			                   return other->response == response;
+		                   });
+	}
+
+	/// Starts deferred requests that are no longer ambiguous.
+	/// \details Starts deferred requests in order once the requests they
+	/// were held back by are completed. The deadline of a deferred request
+	/// runs from its submission.
+	void PelcoDEDeviceUDP::resume() const {
+		for (std::size_t i = 0; i < deferred_.size();) {
+			if (isAmbiguous(deferred_[i], i)) {
+				++i;
+				continue;
+			}
+
+			auto request = deferred_[i];
+			deferred_.erase(deferred_.begin() + static_cast<std::ptrdiff_t>(i));
+
+			requests_.push_back(request);
+			startRequest(request);
+		}
+	}
+
+	/// Starts the exchange of a request.
+	/// \details Sends all request messages together and waits for the
+	/// retransmission timeout, the response messages are delivered by the
+	/// fleet. Responses received before are no longer counted, since the
+	/// exchange expects a response to every message sent now.
+	/// \param[in]	request	Request.
+	void PelcoDEDeviceUDP::startRequest(
+		const std::shared_ptr<Request>& request) const {
+
+		request->sent = std::chrono::steady_clock::now();
+		request->pending = request->count;
+
+		for (std::size_t i = 0; i < request->count; ++i) {
+			getFleet().send(socket_, request->messages[i], endpoint_,
+				[this, request](const boost::system::error_code& error) {
+					if (error && !request->completed) {
+						completeRequest(request, error, 0);
+					}
+				});
+		}
+
+		startTimer(request);
+	}
+
+	/// Arms the retransmission timer of a sent request.
+	/// \details Waits for the retransmission timeout, but not past the
+	/// request deadline.
+	/// \param[in]	request	Request.
+	void PelcoDEDeviceUDP::startTimer(
+		const std::shared_ptr<Request>& request) const {
+
+		request->timer.expires_at(
+			std::min(request->sent + estimator_.getTimeout(),
+			         request->deadline));
+
+		request->timer.async_wait(
+			[this, request](const boost::system::error_code& error) {
+				if (!error && !request->completed) {
+					handleTimeout(request);
+				}
+			});
+	}
+
+	/// Handles a request timeout.
+	/// \details Retransmits the request with doubled timeout, or fails it
+	/// with the timed out error if the deadline has passed or the number of
+	/// retransmissions is exhausted. Requests in flight that time out
+	/// together double the timeout once.
+	/// \param[in]	request	Request.
+	void PelcoDEDeviceUDP::handleTimeout(
+		const std::shared_ptr<Request>& request) const {
+
+		if (std::find(requests_.begin(), requests_.end(), request) ==
+		    requests_.end()) {
+			return;
+		}
+
+		if (std::chrono::steady_clock::now() >= request->deadline ||
+		    request->retries >= policy_.maxRetries) {
+			completeRequest(request, boost::asio::error::timed_out, 0);
+			return;
+		}
+
+		++request->retries;
+		PELCOD_METRICS(metrics_.retransmissions.fetch_add(
+			1, std::memory_order_relaxed));
+		estimator_.backoff(request->sent);
+		startRequest(request);
+	}
+
+	/// Handles a message received from the device.
+	/// \details Validates the message and counts it against the oldest
+	/// request that expects its response command, which completes once every
+	/// message of the exchange is acknowledged. Invalid and unexpected
+	/// messages are discarded. Round-trip time is sampled only from requests
+	/// that were not retransmitted, since their responses are unambiguous.
+	/// \param[in]	message	Received message.
+	void PelcoDEDeviceUDP::handleMessage(const Message& message) const {
+		Codec::FrameView frame(message);
+
+		if (frame.validateResponse() != Codec::FrameError::None) {
+			PELCOD_METRICS(metrics_.invalid.fetch_add(
+				1, std::memory_order_relaxed));
+			return;
+		}
+
+		auto iterator = std::find_if(
+			requests_.begin(), requests_.end(),
+			[&frame](const std::shared_ptr<Request>& request) {
+				return request->response == frame.getCommand();
+			});
+
+		if (iterator == requests_.end()) {
+			PELCOD_METRICS(metrics_.unexpected.fetch_add(
+				1, std::memory_order_relaxed));
+			return;
+		}
+
+		if (--(*iterator)->pending != 0) {
+			return;
+		}
+
+		if ((*iterator)->retries == 0) {
+			estimator_.addSample(
+				std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - (*iterator)->sent));
+		}
+
+		completeRequest(*iterator, boost::system::error_code(),
+		                frame.getValue());
+	}
+
+	/// Completes a request.
+	/// \details Removes the request from the queue, starts deferred requests
+	/// it held back and invokes the completion handler. Requests that are
+	/// already completed are ignored.
+	/// \param[in]	request	Request.
+	/// \param[in]	error	Error code.
+	/// \param[in]	value	Response value.
+	void PelcoDEDeviceUDP::completeRequest(
+		std::shared_ptr<Request> request,
+		const boost::system::error_code& error,
+		std::uint16_t value) const {
+
+		auto iterator = std::find(requests_.begin(), requests_.end(), request);
+
+		if (iterator == requests_.end()) {
+			return;
+		}
+
+		requests_.erase(iterator);
+		request->timer.cancel();
+		request->completed = true;
+
+		if (!deferred_.empty()) {
+			resume();
+		}
+
+#if defined(PELCOD_ENABLE_METRICS)
+		if (!error) {
+			auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - request->started);
+
+			metrics_.responses.fetch_add(1, std::memory_order_relaxed);
+			metrics_.latency.record(latency);
+			getFleet().metrics_.record(
+				request->messages[0][Codec::COMMAND2_BYTE_INDEX], latency);
+		} else if (error == boost::asio::error::timed_out) {
+			metrics_.timeouts.fetch_add(1, std::memory_order_relaxed);
+		} else {
+			metrics_.errors.fetch_add(1, std::memory_order_relaxed);
+		}
+#endif
 
-		return receiveMessage(socket_) / 100.0;
+		request->handler(error, value);
 	}
 }
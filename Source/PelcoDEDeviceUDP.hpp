@@ -7,14 +7,55 @@
 #define PELCODE_DEVICE_UDP_HPP
 
 #include "AbstractPelcoDDevice.hpp"
+#include "MpscQueue.hpp"
+#include "PelcoDECodec.hpp"
+#include "PelcoDECalibrationCache.hpp"
+#include "PelcoDEFleetUDP.hpp"
+#include "PelcoDEMetrics.hpp"
+#include "RoundTripEstimator.hpp"
+#include "StepCalibration.hpp"
 
 #include <boost/asio.hpp>
 
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+
 /// Contains classes and functions that provide Pelco-D protocol implementation.
 namespace PelcoD {
 
 	/// Class that provides UDP Pelco-DE device implementation.
 	class SHARED_API PelcoDEDeviceUDP : public AbstractPelcoDDevice {
+	public:
+
+		/// Completion handler of an operation that returns a value.
+		template <typename T>
+		using ValueHandler =
+			std::function<void(const boost::system::error_code&, T)>;
+
+		/// Completion handler of an operation that returns no value.
+		using Handler = std::function<void(const boost::system::error_code&)>;
+
+		/// Device status.
+		struct Status {
+
+			/// Pan steps.
+			std::uint16_t panSteps;
+
+			/// Tilt steps.
+			std::uint16_t tiltSteps;
+
+			/// Device temperature.
+			std::int16_t temperature;
+
+			/// Device voltage.
+			double voltage;
+		};
+
 	public:
 
 		/// Constructor.
@@ -22,10 +63,38 @@ namespace PelcoD {
 		/// \param[in]	port 			Port.
 		/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
 		/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+		/// \param[in]	address			Device address.
 		PelcoDEDeviceUDP(const std::string& ip,
 		                 std::uint16_t port,
 		                 std::uint16_t maxPanDegrees = 360,
-		                 std::uint16_t maxTiltDegrees = 135);
+		                 std::uint16_t maxTiltDegrees = 135,
+		                 std::uint8_t address = 0x01);
+
+		/// Constructor.
+		/// \param[in]	fleet			Fleet that performs device I/O.
+		/// \param[in]	ip 				IP address.
+		/// \param[in]	port 			Port.
+		/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+		/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+		/// \param[in]	address			Device address.
+		PelcoDEDeviceUDP(PelcoDEFleetUDP& fleet,
+		                 const std::string& ip,
+		                 std::uint16_t port,
+		                 std::uint16_t maxPanDegrees = 360,
+		                 std::uint16_t maxTiltDegrees = 135,
+		                 std::uint8_t address = 0x01);
+
+		/// Constructor.
+		/// \param[in]	fleet			Fleet that performs device I/O.
+		/// \param[in]	endpoint		Device endpoint.
+		/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+		/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+		/// \param[in]	address			Device address.
+		PelcoDEDeviceUDP(PelcoDEFleetUDP& fleet,
+		                 const boost::asio::ip::udp::endpoint& endpoint,
+		                 std::uint16_t maxPanDegrees = 360,
+		                 std::uint16_t maxTiltDegrees = 135,
+		                 std::uint8_t address = 0x01);
 
 		/// Destructor.
 		~PelcoDEDeviceUDP() override;
@@ -72,6 +141,16 @@ namespace PelcoD {
 		/// \param[in]	steps	Tilt steps.
 		void setTiltSteps(std::uint16_t steps) override;
 
+		/// Gets pan and tilt position.
+		/// \return Pan and tilt position.
+		Position getPosition() const override;
+
+		/// Sets pan and tilt position.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		void setPosition(std::uint16_t panSteps,
+		                 std::uint16_t tiltSteps) override;
+
 		/// Gets device temperature.
 		/// \return Device temperature.
 		std::int16_t getTemperature() const override;
@@ -80,25 +159,442 @@ namespace PelcoD {
 		/// \return Device voltage.
 		double getVoltage() const override;
 
+		/// Starts continuous motion.
+		/// \param[in]	motion	Motion.
+		void move(const Motion& motion) override;
+
+		/// Stops motion.
+		void stop() override;
+
+		/// Stores the current position as a preset.
+		/// \param[in]	preset	Preset number.
+		void setPreset(std::uint8_t preset) override;
+
+		/// Clears a preset.
+		/// \param[in]	preset	Preset number.
+		void clearPreset(std::uint8_t preset) override;
+
+		/// Moves to a preset.
+		/// \param[in]	preset	Preset number.
+		void goToPreset(std::uint8_t preset) override;
+
+		/// Sets zoom speed.
+		/// \param[in]	speed	Zoom speed.
+		void setZoomSpeed(std::uint8_t speed) override;
+
+		/// Sets focus speed.
+		/// \param[in]	speed	Focus speed.
+		void setFocusSpeed(std::uint8_t speed) override;
+
+	public:
+
+		/// Gets device status.
+		/// \return Device status.
+		Status getStatus() const;
+
+		/// Resolves a device endpoint.
+		/// \param[in]	ip 		IP address or host name.
+		/// \param[in]	port 	Port.
+		/// \return Device endpoint.
+		static boost::asio::ip::udp::endpoint resolve(const std::string& ip,
+		                                              std::uint16_t port);
+
+		/// Calibrates the device.
+		void calibrate() const;
+
+		/// Sets calibration cache.
+		/// \param[in]	cache	Calibration cache, it must outlive the device.
+		void setCalibrationCache(PelcoDECalibrationCache& cache);
+
+		/// Sets retransmission policy.
+		/// \param[in]	policy	Retransmission policy.
+		void setRetransmissionPolicy(const RetransmissionPolicy& policy);
+
+		/// Gets I/O context.
+		/// \return I/O context of the fleet that performs device I/O.
+		boost::asio::io_context& getContext() noexcept;
+
+		/// Gets device metrics.
+		/// \return Device metrics snapshot.
+		DeviceMetricsSnapshot getMetrics() const;
+
+		/// Asynchronously calibrates the device.
+		/// \param[in]	handler	Completion handler.
+		void asyncCalibrate(Handler handler) const;
+
+		/// Asynchronously gets pan degrees.
+		/// \param[in]	handler	Completion handler.
+		void asyncGetPanDegrees(ValueHandler<std::uint16_t> handler) const;
+
+		/// Asynchronously sets pan degrees.
+		/// \param[in]	degrees	Pan degrees.
+		/// \param[in]	handler	Completion handler.
+		void asyncSetPanDegrees(std::uint16_t degrees, Handler handler);
+
+		/// Asynchronously gets tilt degrees.
+		/// \param[in]	handler	Completion handler.
+		void asyncGetTiltDegrees(ValueHandler<std::uint16_t> handler) const;
+
+		/// Asynchronously sets tilt degrees.
+		/// \param[in]	degrees	Tilt degrees.
+		/// \param[in]	handler	Completion handler.
+		void asyncSetTiltDegrees(std::uint16_t degrees, Handler handler);
+
+		/// Asynchronously gets pan steps.
+		/// \param[in]	handler	Completion handler.
+		void asyncGetPanSteps(ValueHandler<std::uint16_t> handler) const;
+
+		/// Asynchronously gets pan maximum number of steps.
+		/// \param[in]	handler	Completion handler.
+		void asyncGetPanMaxSteps(ValueHandler<std::uint16_t> handler) const;
+
+		/// Asynchronously sets pan steps.
+		/// \param[in]	steps	Pan steps.
+		/// \param[in]	handler	Completion handler.
+		void asyncSetPanSteps(std::uint16_t steps, Handler handler);
+
+		/// Asynchronously gets tilt steps.
+		/// \param[in]	handler	Completion handler.
+		void asyncGetTiltSteps(ValueHandler<std::uint16_t> handler) const;
+
+		/// Asynchronously gets tilt maximum number of steps.
+		/// \param[in]	handler	Completion handler.
+		void asyncGetTiltMaxSteps(ValueHandler<std::uint16_t> handler) const;
+
+		/// Asynchronously sets tilt steps.
+		/// \param[in]	steps	Tilt steps.
+		/// \param[in]	handler	Completion handler.
+		void asyncSetTiltSteps(std::uint16_t steps, Handler handler);
+
+		/// Asynchronously gets pan and tilt position.
+		/// \param[in]	handler	Completion handler.
+		void asyncGetPosition(ValueHandler<Position> handler) const;
+
+		/// Asynchronously sets pan and tilt position.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		/// \param[in]	handler		Completion handler.
+		void asyncSetPosition(std::uint16_t panSteps,
+		                      std::uint16_t tiltSteps,
+		                      Handler handler);
+
+		/// Asynchronously gets device temperature.
+		/// \param[in]	handler	Completion handler.
+		void asyncGetTemperature(ValueHandler<std::int16_t> handler) const;
+
+		/// Asynchronously gets device voltage.
+		/// \param[in]	handler	Completion handler.
+		void asyncGetVoltage(ValueHandler<double> handler) const;
+
+		/// Asynchronously gets device status.
+		/// \param[in]	handler	Completion handler.
+		void asyncGetStatus(ValueHandler<Status> handler) const;
+
+		/// Calibrates the device without blocking.
+		/// \return Future completion.
+		std::future<void> calibrateAsync() const;
+
+		/// Gets pan degrees without blocking.
+		/// \return Future pan degrees.
+		std::future<std::uint16_t> getPanDegreesAsync() const;
+
+		/// Sets pan degrees without blocking.
+		/// \param[in]	degrees	Pan degrees.
+		/// \return Future completion.
+		std::future<void> setPanDegreesAsync(std::uint16_t degrees);
+
+		/// Gets tilt degrees without blocking.
+		/// \return Future tilt degrees.
+		std::future<std::uint16_t> getTiltDegreesAsync() const;
+
+		/// Sets tilt degrees without blocking.
+		/// \param[in]	degrees	Tilt degrees.
+		/// \return Future completion.
+		std::future<void> setTiltDegreesAsync(std::uint16_t degrees);
+
+		/// Gets pan steps without blocking.
+		/// \return Future pan steps.
+		std::future<std::uint16_t> getPanStepsAsync() const;
+
+		/// Gets pan maximum number of steps without blocking.
+		/// \return Future pan maximum number of steps.
+		std::future<std::uint16_t> getPanMaxStepsAsync() const;
+
+		/// Sets pan steps without blocking.
+		/// \param[in]	steps	Pan steps.
+		/// \return Future completion.
+		std::future<void> setPanStepsAsync(std::uint16_t steps);
+
+		/// Gets tilt steps without blocking.
+		/// \return Future tilt steps.
+		std::future<std::uint16_t> getTiltStepsAsync() const;
+
+		/// Gets tilt maximum number of steps without blocking.
+		/// \return Future tilt maximum number of steps.
+		std::future<std::uint16_t> getTiltMaxStepsAsync() const;
+
+		/// Sets tilt steps without blocking.
+		/// \param[in]	steps	Tilt steps.
+		/// \return Future completion.
+		std::future<void> setTiltStepsAsync(std::uint16_t steps);
+
+		/// Gets pan and tilt position without blocking.
+		/// \return Future pan and tilt position.
+		std::future<Position> getPositionAsync() const;
+
+		/// Sets pan and tilt position without blocking.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		/// \return Future completion.
+		std::future<void> setPositionAsync(std::uint16_t panSteps,
+		                                   std::uint16_t tiltSteps);
+
+		/// Gets device temperature without blocking.
+		/// \return Future device temperature.
+		std::future<std::int16_t> getTemperatureAsync() const;
+
+		/// Gets device voltage without blocking.
+		/// \return Future device voltage.
+		std::future<double> getVoltageAsync() const;
+
+		/// Gets device status without blocking.
+		/// \return Future device status.
+		std::future<Status> getStatusAsync() const;
+
 	private:
 
-		/// Number of pan steps per degree of rotation.
-		std::uint16_t panStepsPerDegree_;
+		friend class PelcoDEEngineUDP;
+		friend class PelcoDEFleetUDP;
+		friend class PelcoDEGroupUDP;
+
+		/// Pelco-DE message.
+		using Message = Codec::Frame;
+
+		/// Command of a request exchange.
+		struct Part {
+
+			/// Request command.
+			std::uint8_t command;
+
+			/// Request value.
+			std::uint16_t value;
+		};
+
+		/// Pelco-DE request waiting for a response.
+		struct Request {
+
+			/// Constructor.
+			/// \param[in]	context	I/O context.
+			explicit Request(boost::asio::io_context& context);
+
+			/// Request messages, which are sent together and acknowledged
+			/// with the same response command.
+			std::array<Message, 2> messages;
+
+			/// Number of request messages.
+			std::size_t count;
+
+			/// Number of responses still expected since the last
+			/// transmission.
+			std::size_t pending;
+
+			/// Expected response command.
+			std::uint8_t response;
+
+			/// Completion handler.
+			ValueHandler<std::uint16_t> handler;
+
+			/// Retransmission timer.
+			boost::asio::steady_timer timer;
+
+			/// Time the request was started.
+			std::chrono::steady_clock::time_point started;
+
+			/// Time of the last transmission.
+			std::chrono::steady_clock::time_point sent;
+
+			/// Time limit of the request.
+			std::chrono::steady_clock::time_point deadline;
+
+			/// Number of retransmissions.
+			std::size_t retries;
+
+			/// Whether the request is completed, so that handlers of the
+			/// fleet that outlive the device do not use it.
+			bool completed;
+		};
+
+
+		/// Gets fleet.
+		/// \return Fleet that performs device I/O.
+		PelcoDEFleetUDP& getFleet() const noexcept;
+
+		/// Runs a function on the fleet thread.
+		/// \param[in]	function	Function.
+		void execute(std::function<void()> function) const;
+
+		/// Moves the device to another fleet if it is idle.
+		/// \param[in]	fleet	Fleet.
+		/// \return True if the device is moved.
+		bool migrate(PelcoDEFleetUDP& fleet);
 
-		/// Number of tilt steps per degree of rotation.
-		std::uint16_t tiltStepsPerDegree_;
+		/// Aborts operations in flight and detaches the device.
+		void shutdown() const;
 
-		/// I/O context.
-		boost::asio::io_context context_;
+		/// Completes the calibration.
+		/// \param[in]	error		Error code.
+		/// \param[in]	calibration	Device calibration.
+		void completeCalibration(const boost::system::error_code& error,
+		                         const Calibration& calibration) const;
+
+		/// Creates a request exchange.
+		/// \param[in]	parts	Request commands and values.
+		/// \param[in]	count	Number of request commands.
+		/// \param[in]	handler	Completion handler.
+		/// \return Request.
+		std::shared_ptr<Request> createRequest(
+			const Part* parts,
+			std::size_t count,
+			ValueHandler<std::uint16_t> handler) const;
+
+		/// Queues a request.
+		/// \param[in]	command	Request command.
+		/// \param[in]	value	Request value.
+		/// \param[in]	handler	Completion handler.
+		void asyncRequest(std::uint8_t command,
+		                  std::uint16_t value,
+		                  ValueHandler<std::uint16_t> handler) const;
+
+		/// Queues a created request.
+		/// \param[in]	request	Request.
+		void submit(std::shared_ptr<Request> request) const;
+
+		/// Starts exchanges of submitted requests.
+		void drain() const;
+
+		/// Sends a command that has no response.
+		/// \param[in]	message	Command message.
+		/// \param[in]	handler	Completion handler.
+		void asyncCommand(const Message& message, Handler handler) const;
+
+		/// Sends a command that has no response and waits for the sending.
+		/// \param[in]	message	Command message.
+		void command(const Message& message) const;
+
+		/// Checks whether the response to a request sent by a group can be
+		/// correlated.
+		/// \param[in]	request	Request.
+		/// \return True if the request can be registered at once.
+		bool canExpectResponse(const std::shared_ptr<Request>& request) const;
+
+		/// Waits for the response to a request sent by a group.
+		/// \param[in]	request	Request.
+		void expectResponse(const std::shared_ptr<Request>& request) const;
+
+		/// Performs a request and waits for its completion.
+		/// \param[in]	command	Request command.
+		/// \param[in]	value	Request value.
+		/// \return Response value.
+		std::uint16_t request(std::uint8_t command,
+		                      std::uint16_t value = 0) const;
+
+		/// Waits for an operation to complete.
+		/// \param[in]	future	Future operation result.
+		/// \return Operation result.
+		template <typename T>
+		T wait(std::future<T> future) const;
+
+		/// Checks whether the response to a request would be ambiguous.
+		/// \param[in]	request	Request.
+		/// \param[in]	ahead	Number of deferred requests queued before the
+		/// request.
+		/// \return True if a request in flight expects the same response to
+		/// other commands or a deferred request ahead expects the same
+		/// response.
+		bool isAmbiguous(const std::shared_ptr<Request>& request,
+		                 std::size_t ahead) const;
+
+		/// Starts deferred requests that are no longer ambiguous.
+		void resume() const;
+
+		/// Starts the exchange of a request.
+		/// \param[in]	request	Request.
+		void startRequest(const std::shared_ptr<Request>& request) const;
+
+		/// Arms the retransmission timer of a sent request.
+		/// \param[in]	request	Request.
+		void startTimer(const std::shared_ptr<Request>& request) const;
+
+		/// Handles a request timeout.
+		/// \param[in]	request	Request.
+		void handleTimeout(const std::shared_ptr<Request>& request) const;
+
+		/// Handles a message received from the device.
+		/// \param[in]	message	Received message.
+		void handleMessage(const Message& message) const;
+
+		/// Completes a request.
+		/// \param[in]	request	Request.
+		/// \param[in]	error	Error code.
+		/// \param[in]	value	Response value.
+		void completeRequest(std::shared_ptr<Request> request,
+		                     const boost::system::error_code& error,
+		                     std::uint16_t value) const;
+
+	private:
+
+		/// Conversion between steps and degrees.
+		mutable StepCalibration stepCalibration_;
+
+		/// Handlers waiting for the calibration in progress.
+		mutable std::vector<Handler> calibrationHandlers_;
+
+		/// Calibration cache, if any.
+		PelcoDECalibrationCache* calibrationCache_;
+
+		/// Fleet owned by the device if it is not attached to another fleet.
+		std::unique_ptr<PelcoDEFleetUDP> ownFleet_;
+
+		/// Fleet that performs device I/O, it changes when the device is
+		/// migrated.
+		std::atomic<PelcoDEFleetUDP*> fleet_;
 
 		/// UDP endpoint.
 		boost::asio::ip::udp::endpoint endpoint_;
 
-		/// UDP resolver.
-		boost::asio::ip::udp::resolver resolver_;
+		/// Device address.
+		std::uint8_t address_;
+
+		/// Index of the fleet socket assigned to the device.
+		std::size_t socket_;
+
+		/// Retransmission policy.
+		RetransmissionPolicy policy_;
+
+		/// Round-trip time estimator.
+		mutable RoundTripEstimator estimator_;
+
+		/// Requests submitted by any thread and not yet started.
+		mutable MpscQueue<std::shared_ptr<Request>> submissions_;
+
+		/// Whether submitted requests are scheduled to be started.
+		mutable std::atomic<bool> draining_;
+
+		/// Number of submitted requests.
+		mutable std::atomic<std::size_t> requestCount_;
+
+		/// Requests in flight in the order they were sent.
+		mutable std::deque<std::shared_ptr<Request>> requests_;
+
+		/// Requests held back while a request in flight expects the same
+		/// response to other commands, in submission order.
+		mutable std::deque<std::shared_ptr<Request>> deferred_;
+
+		/// Device metrics.
+		mutable DeviceMetrics metrics_;
 
-		/// UDP socket.
-		mutable boost::asio::ip::udp::socket socket_;
+		/// Thread that runs the own fleet, if any.
+		std::thread thread_;
 	};
 }
 
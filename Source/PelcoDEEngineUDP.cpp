@@ -0,0 +1,421 @@
+/// \file PelcoDEEngineUDP.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE UDP
+/// engine implementation.
+/// \bug No known bugs.
+
+#include "PelcoDEEngineUDP.hpp"
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Mixes bits of a value.
+		/// \details SplitMix64 finalizer, spreads close values over the hash
+		/// ring.
+		/// \param[in]	value	Value.
+		/// \return Mixed value.
+		std::uint64_t mix(std::uint64_t value) {
+			value += 0x9E3779B97F4A7C15ull;
+			value = (value ^ (value >> 30u)) * 0xBF58476D1CE4E5B9ull;
+			value = (value ^ (value >> 27u)) * 0x94D049BB133111EBull;
+			return value ^ (value >> 31u);
+		}
+
+		/// Calculates endpoint hash.
+		/// \details Combines endpoint address and port.
+		/// \param[in]	endpoint	Endpoint.
+		/// \return Endpoint hash.
+		std::uint64_t hash(const boost::asio::ip::udp::endpoint& endpoint) {
+			std::uint64_t value = endpoint.port();
+
+			if (endpoint.address().is_v4()) {
+				value |= static_cast<std::uint64_t>(
+					endpoint.address().to_v4().to_uint()) << 16u;
+			} else {
+				for (auto byte : endpoint.address().to_v6().to_bytes()) {
+					value = mix(value ^ byte);
+				}
+			}
+
+			return mix(value);
+		}
+	}
+
+	/// Constructor.
+	/// \details Creates shards with sockets on ephemeral ports and starts
+	/// their threads.
+	/// \param[in]	shardCount		Number of shards, the number of hardware
+	/// threads if zero.
+	/// \param[in]	virtualNodes	Number of points of a shard on the hash
+	/// ring.
+	PelcoDEEngineUDP::PelcoDEEngineUDP(std::size_t shardCount,
+	                                   std::size_t virtualNodes) {
+		boost::asio::ip::udp::endpoint endpoint(boost::asio::ip::udp::v4(), 0);
+		initialize(shardCount, endpoint, false, virtualNodes);
+	}
+
+	/// Constructor.
+	/// \details Creates shards with sockets bound to the local endpoint and
+	/// starts their threads. With port reuse all shards share the local port,
+	/// and messages that the system delivers to another shard than the one of
+	/// the device are forwarded to it.
+	/// \param[in]	shardCount		Number of shards, the number of hardware
+	/// threads if zero.
+	/// \param[in]	localEndpoint	Local endpoint of shard sockets.
+	/// \param[in]	reusePort		Whether shards share the local port.
+	/// \param[in]	virtualNodes	Number of points of a shard on the hash
+	/// ring.
+	PelcoDEEngineUDP::PelcoDEEngineUDP(
+		std::size_t shardCount,
+		const boost::asio::ip::udp::endpoint& localEndpoint,
+		bool reusePort,
+		std::size_t virtualNodes) {
+
+		initialize(shardCount, localEndpoint, reusePort, virtualNodes);
+	}
+
+	/// Destructor.
+	/// \details Destroys devices on their shard threads, then stops shard
+	/// threads. A shard thread that has not started running yet returns at
+	/// once.
+	PelcoDEEngineUDP::~PelcoDEEngineUDP() {
+		for (auto& device : devices_) {
+			destroy(device.second);
+		}
+
+		devices_.clear();
+
+		for (auto& shard : shards_) {
+			shard->fleet->stop();
+		}
+
+		for (auto& shard : shards_) {
+			if (shard->thread.joinable()) {
+				shard->thread.join();
+			}
+		}
+	}
+
+	/// Adds a device.
+	/// \details Creates a device in the shard of its endpoint on the hash
+	/// ring.
+	/// \param[in]	ip 				IP address.
+	/// \param[in]	port 			Port.
+	/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+	/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+	/// \param[in]	address			Device address.
+	/// \return Device owned by the engine.
+	PelcoDEDeviceUDP& PelcoDEEngineUDP::addDevice(const std::string& ip,
+	                                              std::uint16_t port,
+	                                              std::uint16_t maxPanDegrees,
+	                                              std::uint16_t maxTiltDegrees,
+	                                              std::uint8_t address) {
+
+		auto endpoint = PelcoDEDeviceUDP::resolve(ip, port);
+		auto shard = locate(endpoint);
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		std::unique_ptr<PelcoDEDeviceUDP> device(new PelcoDEDeviceUDP(
+			*shards_[shard]->fleet, endpoint,
+			maxPanDegrees, maxTiltDegrees, address));
+
+		auto& result = *device;
+		devices_[&result] = Device { std::move(device), shard, 0 };
+
+		std::lock_guard<std::mutex> routesLock(routesMutex_);
+		routes_[Route(endpoint, address)] = shard;
+
+		return result;
+	}
+
+	/// Removes a device.
+	/// \details Destroys a device owned by the engine on its shard thread,
+	/// so that it does not race with the shard handling its messages.
+	/// Operations in flight are aborted. Must not be called from the thread
+	/// of another shard.
+	/// \param[in]	device	Device owned by the engine.
+	/// \throw std::invalid_argument if the device is not owned by the engine.
+	void PelcoDEEngineUDP::removeDevice(PelcoDEDeviceUDP& device) {
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		auto iterator = devices_.find(&device);
+
+		if (iterator == devices_.end()) {
+			throw std::invalid_argument(
+				"The device is not owned by the engine!");
+		}
+
+		{
+			std::lock_guard<std::mutex> routesLock(routesMutex_);
+			routes_.erase(Route(device.endpoint_, device.address_));
+		}
+
+		destroy(iterator->second);
+		devices_.erase(iterator);
+	}
+
+	/// Gets number of shards.
+	/// \details Gets number of shards, each run by its own thread.
+	/// \return Number of shards.
+	std::size_t PelcoDEEngineUDP::getShardCount() const noexcept {
+		return shards_.size();
+	}
+
+	/// Gets number of devices of a shard.
+	/// \details Gets number of devices currently attached to the shard.
+	/// \param[in]	shard	Shard index.
+	/// \return Number of devices of the shard.
+	std::size_t PelcoDEEngineUDP::getDeviceCount(std::size_t shard) const {
+		return shards_.at(shard)->fleet->getDeviceCount();
+	}
+
+	/// Gets metrics of all shards.
+	/// \details Merges metrics snapshots of shard fleets. Messages forwarded
+	/// between shards are counted as received by both of them.
+	/// \return Merged fleet metrics snapshot.
+	FleetMetricsSnapshot PelcoDEEngineUDP::getMetrics() const {
+		FleetMetricsSnapshot snapshot;
+
+		for (auto& shard : shards_) {
+			snapshot.merge(shard->fleet->getMetrics());
+		}
+
+		return snapshot;
+	}
+
+	/// Gets metrics of a shard.
+	/// \details Gets metrics snapshot of the shard fleet.
+	/// \param[in]	shard	Shard index.
+	/// \return Fleet metrics snapshot of the shard.
+	FleetMetricsSnapshot PelcoDEEngineUDP::getMetrics(
+		std::size_t shard) const {
+
+		return shards_.at(shard)->fleet->getMetrics();
+	}
+
+	/// Sets capture log of all shards.
+	/// \details Records frames of all shards in one log. It may be called
+	/// from any thread, the log must outlive the engine or be unset first.
+	/// \param[in]	capture	Capture log or null to stop capturing.
+	void PelcoDEEngineUDP::setCapture(PelcoDECaptureLog* capture) noexcept {
+		for (auto& shard : shards_) {
+			shard->fleet->setCapture(capture);
+		}
+	}
+
+	/// Moves devices from loaded shards to less loaded ones.
+	/// \details The load of a shard is the number of requests of its devices
+	/// since the last rebalance. While the most loaded shard exceeds the
+	/// tolerated load, the busiest of its devices whose move narrows the gap
+	/// to the least loaded shard is moved there. Devices with requests in
+	/// flight are skipped. Waits until the moves are done, so it must not be
+	/// called from a shard thread.
+	/// \param[in]	tolerance	Allowed ratio of shard load to mean load.
+	/// \return Number of moved devices.
+	/// \throw std::logic_error if called from a shard thread.
+	std::size_t PelcoDEEngineUDP::rebalance(double tolerance) {
+		for (auto& shard : shards_) {
+			if (shard->fleet->getContext().get_executor()
+				.running_in_this_thread()) {
+				throw std::logic_error(
+					"The method is called from the fleet thread!");
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		std::vector<std::size_t> loads(shards_.size());
+		std::vector<std::vector<std::pair<std::size_t, Device*>>>
+			candidates(shards_.size());
+		std::size_t total = 0;
+
+		for (auto& device : devices_) {
+			auto requests = device.second.device->requestCount_.load();
+			auto load = requests - device.second.requests;
+
+			device.second.requests = requests;
+			loads[device.second.shard] += load;
+			candidates[device.second.shard].emplace_back(load, &device.second);
+			total += load;
+		}
+
+		for (auto& shard : candidates) {
+			std::sort(shard.begin(), shard.end(),
+			          [](const std::pair<std::size_t, Device*>& left,
+			             const std::pair<std::size_t, Device*>& right) {
+				          return left.first > right.first;
+			          });
+		}
+
+		auto limit = tolerance * total / shards_.size();
+		std::size_t moved = 0;
+
+		while (total > 0) {
+			auto hot = static_cast<std::size_t>(
+				std::max_element(loads.begin(), loads.end()) - loads.begin());
+			auto cold = static_cast<std::size_t>(
+				std::min_element(loads.begin(), loads.end()) - loads.begin());
+
+			if (loads[hot] <= limit) {
+				break;
+			}
+
+			auto gap = (loads[hot] - loads[cold]) / 2;
+			auto& devices = candidates[hot];
+
+			auto candidate = std::find_if(
+				devices.begin(), devices.end(),
+				[gap](const std::pair<std::size_t, Device*>& device) {
+					return device.first > 0 && device.first <= gap;
+				});
+
+			if (candidate == devices.end()) {
+				break;
+			}
+
+			auto load = candidate->first;
+			auto device = candidate->second;
+			devices.erase(candidate);
+
+			std::promise<bool> promise;
+			auto future = promise.get_future();
+			auto& fleet = *shards_[cold]->fleet;
+
+			boost::asio::post(
+				shards_[hot]->fleet->getContext(),
+				[device, &fleet, &promise]() {
+					try {
+						promise.set_value(device->device->migrate(fleet));
+					} catch (...) {
+						promise.set_exception(std::current_exception());
+					}
+				});
+
+			if (!future.get()) {
+				continue;
+			}
+
+			device->shard = cold;
+			loads[hot] -= load;
+			loads[cold] += load;
+			candidates[cold].emplace_back(load, device);
+			++moved;
+
+			std::lock_guard<std::mutex> routesLock(routesMutex_);
+			routes_[Route(device->device->endpoint_,
+			              device->device->address_)] = cold;
+		}
+
+		return moved;
+	}
+
+	/// Creates shards and the hash ring and starts shard threads.
+	/// \details Places virtual nodes of every shard on the hash ring, so that
+	/// adding a shard moves only a fair share of endpoints.
+	/// \param[in]	shardCount		Number of shards.
+	/// \param[in]	localEndpoint	Local endpoint of shard sockets.
+	/// \param[in]	reusePort		Whether shards share the local port.
+	/// \param[in]	virtualNodes	Number of points of a shard on the hash
+	/// ring.
+	/// \throw std::invalid_argument if the number of virtual nodes is zero.
+	void PelcoDEEngineUDP::initialize(
+		std::size_t shardCount,
+		const boost::asio::ip::udp::endpoint& localEndpoint,
+		bool reusePort,
+		std::size_t virtualNodes) {
+
+		if (virtualNodes == 0) {
+			throw std::invalid_argument("The number of virtual nodes is zero!");
+		}
+
+		if (shardCount == 0) {
+			shardCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		for (std::size_t i = 0; i < shardCount; ++i) {
+			std::unique_ptr<Shard> shard(new Shard());
+			shard->fleet.reset(new PelcoDEFleetUDP(localEndpoint, reusePort));
+			shard->fleet->forward_ =
+				[this, i](const PelcoDEFleetUDP::Message& message,
+				          const boost::asio::ip::udp::endpoint& sender) {
+					forward(i, message, sender);
+				};
+
+			shards_.push_back(std::move(shard));
+
+			for (std::size_t j = 0; j < virtualNodes; ++j) {
+				ring_[mix((static_cast<std::uint64_t>(i) << 32u) | j)] = i;
+			}
+		}
+
+		for (auto& shard : shards_) {
+			auto fleet = shard->fleet.get();
+			shard->thread = std::thread([fleet]() { fleet->run(); });
+		}
+	}
+
+	/// Destroys a device on its shard thread.
+	/// \details Runs the device destructor on the thread of the shard the
+	/// device is attached to and waits for it, or in the calling thread if
+	/// the shard thread does not run.
+	/// \param[in]	device	Device owned by the engine.
+	void PelcoDEEngineUDP::destroy(Device& device) {
+		shards_[device.shard]->fleet->synchronize(
+			[&device]() { device.device.reset(); });
+	}
+
+	/// Finds the shard of an endpoint on the hash ring.
+	/// \details Finds the first shard point clockwise from the endpoint hash.
+	/// \param[in]	endpoint	Device endpoint.
+	/// \return Shard index.
+	std::size_t PelcoDEEngineUDP::locate(
+		const boost::asio::ip::udp::endpoint& endpoint) const {
+
+		auto iterator = ring_.lower_bound(hash(endpoint));
+
+		if (iterator == ring_.end()) {
+			iterator = ring_.begin();
+		}
+
+		return iterator->second;
+	}
+
+	/// Forwards a message received by a shard that does not own the device.
+	/// \details Posts the message to the shard of the device. Messages of
+	/// unknown devices are discarded.
+	/// \param[in]	shard	Index of the receiving shard.
+	/// \param[in]	message	Message.
+	/// \param[in]	sender	Sender endpoint.
+	void PelcoDEEngineUDP::forward(
+		std::size_t shard,
+		const PelcoDEFleetUDP::Message& message,
+		const boost::asio::ip::udp::endpoint& sender) {
+
+		std::size_t target;
+
+		{
+			std::lock_guard<std::mutex> lock(routesMutex_);
+
+			auto iterator = routes_.find(
+				Route(sender, message[Codec::ADDRESS_BYTE_INDEX]));
+
+			if (iterator == routes_.end() || iterator->second == shard) {
+				return;
+			}
+
+			target = iterator->second;
+		}
+
+		auto fleet = shards_[target]->fleet.get();
+
+		boost::asio::post(fleet->getContext(), [fleet, message, sender]() {
+			fleet->deliver(message, sender);
+		});
+	}
+}
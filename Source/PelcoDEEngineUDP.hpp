@@ -0,0 +1,181 @@
+/// \file PelcoDEEngineUDP.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE UDP
+/// engine implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_ENGINE_UDP_HPP
+#define PELCODE_ENGINE_UDP_HPP
+
+#include "PelcoDEDeviceUDP.hpp"
+#include "PelcoDEFleetUDP.hpp"
+
+#include <boost/asio.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides UDP Pelco-DE engine implementation.
+	/// \details An engine shards devices across fleets, each run by its own
+	/// thread. Devices are assigned to shards by consistent hashing of their
+	/// endpoints and may be moved between shards to balance the load.
+	class SHARED_API PelcoDEEngineUDP {
+	public:
+
+		/// Constructor.
+		/// \param[in]	shardCount		Number of shards, the number of
+		/// hardware threads if zero.
+		/// \param[in]	virtualNodes	Number of points of a shard on the
+		/// hash ring.
+		explicit PelcoDEEngineUDP(std::size_t shardCount = 0,
+		                          std::size_t virtualNodes = 64);
+
+		/// Constructor.
+		/// \param[in]	shardCount		Number of shards, the number of
+		/// hardware threads if zero.
+		/// \param[in]	localEndpoint	Local endpoint of shard sockets.
+		/// \param[in]	reusePort		Whether shards share the local port.
+		/// \param[in]	virtualNodes	Number of points of a shard on the
+		/// hash ring.
+		PelcoDEEngineUDP(std::size_t shardCount,
+		                 const boost::asio::ip::udp::endpoint& localEndpoint,
+		                 bool reusePort,
+		                 std::size_t virtualNodes = 64);
+
+		/// Destructor.
+		~PelcoDEEngineUDP();
+
+	public:
+
+		/// Adds a device.
+		/// \param[in]	ip 				IP address.
+		/// \param[in]	port 			Port.
+		/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+		/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+		/// \param[in]	address			Device address.
+		/// \return Device owned by the engine.
+		PelcoDEDeviceUDP& addDevice(const std::string& ip,
+		                            std::uint16_t port,
+		                            std::uint16_t maxPanDegrees = 360,
+		                            std::uint16_t maxTiltDegrees = 135,
+		                            std::uint8_t address = 0x01);
+
+		/// Removes a device.
+		/// \param[in]	device	Device owned by the engine.
+		void removeDevice(PelcoDEDeviceUDP& device);
+
+		/// Gets number of shards.
+		/// \return Number of shards.
+		std::size_t getShardCount() const noexcept;
+
+		/// Gets number of devices of a shard.
+		/// \param[in]	shard	Shard index.
+		/// \return Number of devices of the shard.
+		std::size_t getDeviceCount(std::size_t shard) const;
+
+		/// Gets metrics of all shards.
+		/// \return Merged fleet metrics snapshot.
+		FleetMetricsSnapshot getMetrics() const;
+
+		/// Gets metrics of a shard.
+		/// \param[in]	shard	Shard index.
+		/// \return Fleet metrics snapshot of the shard.
+		FleetMetricsSnapshot getMetrics(std::size_t shard) const;
+
+		/// Sets capture log of all shards.
+		/// \param[in]	capture	Capture log or null to stop capturing.
+		void setCapture(PelcoDECaptureLog* capture) noexcept;
+
+		/// Moves devices from loaded shards to less loaded ones.
+		/// \param[in]	tolerance	Allowed ratio of shard load to mean load.
+		/// \return Number of moved devices.
+		std::size_t rebalance(double tolerance = 1.25);
+
+	private:
+
+		/// Engine shard.
+		struct Shard {
+
+			/// Fleet that performs I/O of shard devices.
+			std::unique_ptr<PelcoDEFleetUDP> fleet;
+
+			/// Thread that runs the fleet.
+			std::thread thread;
+		};
+
+		/// Device owned by the engine.
+		struct Device {
+
+			/// Device.
+			std::unique_ptr<PelcoDEDeviceUDP> device;
+
+			/// Index of the shard of the device.
+			std::size_t shard;
+
+			/// Number of device requests at the last rebalance.
+			std::size_t requests;
+		};
+
+		/// Device route key.
+		using Route = std::pair<boost::asio::ip::udp::endpoint, std::uint8_t>;
+
+		/// Creates shards and the hash ring and starts shard threads.
+		/// \param[in]	shardCount		Number of shards.
+		/// \param[in]	localEndpoint	Local endpoint of shard sockets.
+		/// \param[in]	reusePort		Whether shards share the local port.
+		/// \param[in]	virtualNodes	Number of points of a shard on the
+		/// hash ring.
+		void initialize(std::size_t shardCount,
+		                const boost::asio::ip::udp::endpoint& localEndpoint,
+		                bool reusePort,
+		                std::size_t virtualNodes);
+
+		/// Destroys a device on its shard thread.
+		/// \param[in]	device	Device owned by the engine.
+		void destroy(Device& device);
+
+		/// Finds the shard of an endpoint on the hash ring.
+		/// \param[in]	endpoint	Device endpoint.
+		/// \return Shard index.
+		std::size_t locate(
+			const boost::asio::ip::udp::endpoint& endpoint) const;
+
+		/// Forwards a message received by a shard that does not own the device.
+		/// \param[in]	shard	Index of the receiving shard.
+		/// \param[in]	message	Message.
+		/// \param[in]	sender	Sender endpoint.
+		void forward(std::size_t shard,
+		             const PelcoDEFleetUDP::Message& message,
+		             const boost::asio::ip::udp::endpoint& sender);
+
+	private:
+
+		/// Shards.
+		std::vector<std::unique_ptr<Shard>> shards_;
+
+		/// Hash ring of shard points.
+		std::map<std::uint64_t, std::size_t> ring_;
+
+		/// Devices owned by the engine.
+		std::unordered_map<PelcoDEDeviceUDP*, Device> devices_;
+
+		/// Devices mutex.
+		mutable std::mutex mutex_;
+
+		/// Shards of devices by endpoint and address.
+		std::map<Route, std::size_t> routes_;
+
+		/// Routes mutex.
+		mutable std::mutex routesMutex_;
+	};
+}
+
+#endif
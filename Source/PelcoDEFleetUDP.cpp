@@ -0,0 +1,675 @@
+/// \file PelcoDEFleetUDP.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE UDP
+/// fleet implementation.
+/// \bug No known bugs.
+
+#include "PelcoDEFleetUDP.hpp"
+#include "PelcoDEDeviceUDP.hpp"
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
+#if defined(__linux__)
+	#include <sys/socket.h>
+	#include <cerrno>
+	#define PELCOD_HAS_MMSG
+#endif
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Message batch size.
+		/// \details Maximum number of messages sent or received by one system
+		/// call.
+		constexpr std::size_t BATCH_SIZE { 64 };
+
+		/// Socket buffer size.
+		/// \details Requested size of socket buffers in bytes, so that bursts
+		/// of responses are not dropped. The system may limit it.
+		constexpr int SOCKET_BUFFER_SIZE { 4 * 1024 * 1024 };
+
+#if defined(SO_REUSEPORT)
+		/// Socket option to share a local port between sockets.
+		using ReusePort = boost::asio::detail::socket_option::boolean<
+			SOL_SOCKET, SO_REUSEPORT>;
+#endif
+	}
+
+	/// Compares keys.
+	/// \details Keys are equal if both endpoints and addresses are equal.
+	/// \param[in]	other	Other key.
+	/// \return True if keys are equal.
+	bool PelcoDEFleetUDP::Key::operator==(const Key& other) const noexcept {
+		return endpoint == other.endpoint && address == other.address;
+	}
+
+	/// Calculates key hash.
+	/// \details Combines endpoint address, port and device address.
+	/// \param[in]	key	Device key.
+	/// \return Key hash.
+	std::size_t PelcoDEFleetUDP::KeyHash::operator()(
+		const Key& key) const noexcept {
+
+		std::size_t hash = key.endpoint.port();
+		hash = (hash << 8u) ^ key.address;
+
+		if (key.endpoint.address().is_v4()) {
+			hash ^= static_cast<std::size_t>(
+				key.endpoint.address().to_v4().to_uint()) << 24u;
+		} else {
+			for (auto byte : key.endpoint.address().to_v6().to_bytes()) {
+				hash = hash * 31 + byte;
+			}
+		}
+
+		return hash;
+	}
+
+	/// Constructor.
+	/// \details Initializes socket fields.
+	/// \param[in]	context	I/O context.
+	PelcoDEFleetUDP::Socket::Socket(boost::asio::io_context& context)
+		: socket(context),
+		  messages(BATCH_SIZE),
+		  senders(BATCH_SIZE),
+		  flushing(false) {
+	}
+
+	/// Constructor.
+	/// \details Opens shared sockets on ephemeral ports.
+	/// \param[in]	socketCount	Number of shared UDP sockets.
+	/// \throw std::invalid_argument if the number of sockets is zero.
+	PelcoDEFleetUDP::PelcoDEFleetUDP(std::size_t socketCount)
+		: detachments_(0),
+		  running_(false),
+		  stopped_(false),
+		  nextSocket_(0),
+		  capture_(nullptr) {
+
+		open(boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), 0),
+		     false, socketCount);
+	}
+
+	/// Constructor.
+	/// \details Opens shared sockets bound to the local endpoint, for devices
+	/// that respond to a fixed port. With port reuse several sockets, also of
+	/// other fleets, may be bound to the same port, and the system spreads
+	/// received messages between them.
+	/// \param[in]	localEndpoint	Local endpoint of shared UDP sockets.
+	/// \param[in]	reusePort		Whether the local port may be shared.
+	/// \param[in]	socketCount		Number of shared UDP sockets.
+	/// \throw std::invalid_argument if the number of sockets is zero or port
+	/// reuse is not supported.
+	PelcoDEFleetUDP::PelcoDEFleetUDP(
+		const boost::asio::ip::udp::endpoint& localEndpoint,
+		bool reusePort,
+		std::size_t socketCount)
+		: detachments_(0),
+		  running_(false),
+		  stopped_(false),
+		  nextSocket_(0),
+		  capture_(nullptr) {
+
+		open(localEndpoint, reusePort, socketCount);
+	}
+
+	/// Destructor.
+	/// \details Defaulted default destructor.
+	PelcoDEFleetUDP::~PelcoDEFleetUDP() = default;
+
+	/// Gets I/O context.
+	/// \details Gets I/O context that performs fleet I/O. The context always
+	/// has pending receive operations, so it runs until it is stopped.
+	/// \return I/O context.
+	boost::asio::io_context& PelcoDEFleetUDP::getContext() noexcept {
+		return context_;
+	}
+
+	/// Gets number of attached devices.
+	/// \details Gets number of devices currently attached to the fleet.
+	/// \return Number of attached devices.
+	std::size_t PelcoDEFleetUDP::getDeviceCount() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return devices_.size();
+	}
+
+	/// Gets fleet metrics.
+	/// \details Takes a snapshot of message counters and latency of
+	/// requests of attached devices per operation. It may be called from any
+	/// thread. Metrics are zero if they are compiled out.
+	/// \return Fleet metrics snapshot.
+	FleetMetricsSnapshot PelcoDEFleetUDP::getMetrics() const {
+		return metrics_.getSnapshot();
+	}
+
+	/// Sets capture log.
+	/// \details Records frames sent and received by the fleet from now on.
+	/// Frames forwarded from other fleets are recorded by the fleet that
+	/// received them. It may be called from any thread, the log must outlive
+	/// the fleet or be unset first.
+	/// \param[in]	capture	Capture log or null to stop capturing.
+	void PelcoDEFleetUDP::setCapture(PelcoDECaptureLog* capture) noexcept {
+		capture_.store(capture, std::memory_order_release);
+	}
+
+	/// Allows or forbids sending to broadcast addresses.
+	/// \details Sets the broadcast option of all shared sockets. Only the
+	/// socket descriptors are changed, so it may be called while the fleet
+	/// runs.
+	/// \param[in]	enabled	Whether broadcasts are allowed.
+	/// \throw boost::system::system_error if the option cannot be set.
+	void PelcoDEFleetUDP::setBroadcast(bool enabled) {
+		for (auto& socket : sockets_) {
+			socket->socket.set_option(
+				boost::asio::socket_base::broadcast(enabled));
+		}
+	}
+
+	/// Runs I/O context until the fleet is stopped.
+	/// \details Runs I/O context in the calling thread. Devices of the fleet
+	/// are not synchronized, so the context must be run by one thread. If the
+	/// fleet was stopped before, it returns at once and may be run again
+	/// afterwards.
+	void PelcoDEFleetUDP::run() {
+		{
+			std::lock_guard<std::mutex> lock(runMutex_);
+
+			if (stopped_) {
+				stopped_ = false;
+				return;
+			}
+
+			context_.restart();
+			running_ = true;
+		}
+
+		context_.run();
+
+		std::lock_guard<std::mutex> lock(runMutex_);
+		running_ = false;
+	}
+
+	/// Stops I/O context.
+	/// \details Stops I/O context, so that the running thread returns. If no
+	/// thread runs the fleet, the next run returns at once, so that a stop
+	/// that races with the start of the fleet thread is not lost.
+	void PelcoDEFleetUDP::stop() {
+		std::lock_guard<std::mutex> lock(runMutex_);
+
+		stopped_ = !running_;
+		context_.stop();
+	}
+
+	/// Opens shared sockets.
+	/// \details Opens shared sockets with large buffers, binds them and
+	/// starts receiving messages.
+	/// \param[in]	localEndpoint	Local endpoint of shared UDP sockets.
+	/// \param[in]	reusePort		Whether the local port may be shared.
+	/// \param[in]	socketCount		Number of shared UDP sockets.
+	/// \throw std::invalid_argument if the number of sockets is zero or port
+	/// reuse is not supported.
+	void PelcoDEFleetUDP::open(
+		const boost::asio::ip::udp::endpoint& localEndpoint,
+		bool reusePort,
+		std::size_t socketCount) {
+
+		if (socketCount == 0) {
+			throw std::invalid_argument("The number of sockets is zero!");
+		}
+
+#if !defined(SO_REUSEPORT)
+		if (reusePort) {
+			throw std::invalid_argument("The port reuse is not supported!");
+		}
+#endif
+
+		for (std::size_t i = 0; i < socketCount; ++i) {
+			sockets_.emplace_back(new Socket(context_));
+			auto& socket = sockets_.back()->socket;
+			boost::system::error_code error;
+
+			socket.open(localEndpoint.protocol());
+			socket.set_option(boost::asio::socket_base::receive_buffer_size(
+				SOCKET_BUFFER_SIZE), error);
+			socket.set_option(boost::asio::socket_base::send_buffer_size(
+				SOCKET_BUFFER_SIZE), error);
+
+#if defined(SO_REUSEPORT)
+			if (reusePort) {
+				socket.set_option(ReusePort(true));
+			}
+#endif
+
+			socket.bind(localEndpoint);
+
+			startReceive(i);
+		}
+	}
+
+	/// Attaches a device.
+	/// \details Registers a device to receive responses sent from the endpoint
+	/// with the address. Sockets are assigned to devices in turn.
+	/// \param[in]	device		Device.
+	/// \param[in]	endpoint	Device endpoint.
+	/// \param[in]	address		Device address.
+	/// \return Index of the socket assigned to the device.
+	/// \throw std::invalid_argument if the device is already attached.
+	std::size_t PelcoDEFleetUDP::attach(
+		PelcoDEDeviceUDP& device,
+		const boost::asio::ip::udp::endpoint& endpoint,
+		std::uint8_t address) {
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (!devices_.emplace(Key { endpoint, address }, &device).second) {
+			throw std::invalid_argument("The device is already attached!");
+		}
+
+		auto socket = nextSocket_;
+		nextSocket_ = (nextSocket_ + 1) % sockets_.size();
+
+		return socket;
+	}
+
+	/// Detaches a device.
+	/// \details Unregisters a device, so that its responses are discarded.
+	/// \param[in]	endpoint	Device endpoint.
+	/// \param[in]	address		Device address.
+	void PelcoDEFleetUDP::detach(const boost::asio::ip::udp::endpoint& endpoint,
+	                             std::uint8_t address) {
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (devices_.erase(Key { endpoint, address }) != 0) {
+			++detachments_;
+		}
+	}
+
+	/// Runs a function on the fleet thread and waits for it.
+	/// \details Posts the function to the I/O context and waits until it is
+	/// done, so that it does not race with handlers of the fleet. The function
+	/// is called at once if called from the fleet thread, and in the calling
+	/// thread if no thread runs the fleet or the fleet thread returns before
+	/// the function is taken. The fleet must not be started meanwhile.
+	/// \param[in]	function	Function.
+	void PelcoDEFleetUDP::synchronize(const std::function<void()>& function) {
+		if (context_.get_executor().running_in_this_thread()) {
+			function();
+			return;
+		}
+
+		auto taken = std::make_shared<bool>(false);
+		auto promise = std::make_shared<std::promise<void>>();
+		auto future = promise->get_future();
+
+		boost::asio::post(context_, [this, taken, promise, &function]() {
+			{
+				std::lock_guard<std::mutex> lock(runMutex_);
+
+				if (*taken) {
+					return;
+				}
+
+				*taken = true;
+			}
+
+			function();
+			promise->set_value();
+		});
+
+		while (future.wait_for(std::chrono::milliseconds(1)) !=
+		       std::future_status::ready) {
+
+			std::unique_lock<std::mutex> lock(runMutex_);
+
+			if (!*taken && !running_) {
+				*taken = true;
+				lock.unlock();
+				function();
+				return;
+			}
+		}
+	}
+
+	/// Sends a message.
+	/// \details Queues a message to be sent to the endpoint through a shared
+	/// socket. Messages queued by handlers that run together are sent in
+	/// batches, with one system call per batch where it is supported.
+	/// \param[in]	socket		Socket index.
+	/// \param[in]	message		Message that must outlive the operation.
+	/// \param[in]	endpoint	Destination endpoint.
+	/// \param[in]	handler		Completion handler.
+	void PelcoDEFleetUDP::send(
+		std::size_t socket,
+		const Message& message,
+		const boost::asio::ip::udp::endpoint& endpoint,
+		std::function<void(const boost::system::error_code&)> handler) {
+
+		auto& shared = *sockets_[socket];
+		shared.outgoing.push_back({ &message, endpoint, std::move(handler) });
+
+		if (!shared.flushing) {
+			shared.flushing = true;
+			boost::asio::post(context_, [this, socket]() { flush(socket); });
+		}
+	}
+
+	/// Sends queued messages of a socket.
+	/// \details Sends queued messages with sendmmsg on Linux and one by one
+	/// elsewhere. If the socket buffer is full, sending resumes when the
+	/// socket becomes writable.
+	/// \param[in]	socket	Socket index.
+	void PelcoDEFleetUDP::flush(std::size_t socket) {
+		auto& shared = *sockets_[socket];
+
+		std::vector<std::pair<std::function<void(
+			const boost::system::error_code&)>,
+			boost::system::error_code>> completed;
+
+		std::size_t sent = 0;
+		bool blocked = false;
+
+		while (sent < shared.outgoing.size() && !blocked) {
+#if defined(PELCOD_HAS_MMSG)
+			mmsghdr headers[BATCH_SIZE] { };
+			iovec vectors[BATCH_SIZE] { };
+
+			auto count = std::min(BATCH_SIZE, shared.outgoing.size() - sent);
+
+			for (std::size_t i = 0; i < count; ++i) {
+				auto& outgoing = shared.outgoing[sent + i];
+
+				vectors[i].iov_base =
+					const_cast<std::uint8_t*>(outgoing.message->data());
+				vectors[i].iov_len = outgoing.message->size();
+
+				headers[i].msg_hdr.msg_name = outgoing.endpoint.data();
+				headers[i].msg_hdr.msg_namelen = outgoing.endpoint.size();
+				headers[i].msg_hdr.msg_iov = &vectors[i];
+				headers[i].msg_hdr.msg_iovlen = 1;
+			}
+
+			auto result = ::sendmmsg(shared.socket.native_handle(), headers,
+			                         static_cast<unsigned int>(count),
+			                         MSG_DONTWAIT);
+
+			if (result < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+
+				if (errno == EAGAIN || errno == EWOULDBLOCK) {
+					blocked = true;
+					continue;
+				}
+
+				completed.emplace_back(
+					std::move(shared.outgoing[sent].handler),
+					boost::system::error_code(
+						errno, boost::system::system_category()));
+				++sent;
+				continue;
+			}
+
+			for (auto i = 0; i < result; ++i, ++sent) {
+				completed.emplace_back(
+					std::move(shared.outgoing[sent].handler),
+					boost::system::error_code());
+			}
+#else
+			auto& outgoing = shared.outgoing[sent];
+			boost::system::error_code error;
+
+			shared.socket.non_blocking(true, error);
+
+			if (!error) {
+				shared.socket.send_to(boost::asio::buffer(*outgoing.message),
+				                      outgoing.endpoint, 0, error);
+			}
+
+			if (error == boost::asio::error::would_block) {
+				blocked = true;
+				continue;
+			}
+
+			completed.emplace_back(std::move(outgoing.handler), error);
+			++sent;
+#endif
+		}
+
+		auto capture = capture_.load(std::memory_order_acquire);
+
+		if (capture) {
+			auto now = std::chrono::steady_clock::now();
+
+			for (std::size_t i = 0; i < sent; ++i) {
+				if (!completed[i].second) {
+					capture->record(PelcoDECaptureLog::Direction::Sent,
+					                shared.outgoing[i].endpoint,
+					                *shared.outgoing[i].message, now);
+				}
+			}
+		}
+
+		shared.outgoing.erase(shared.outgoing.begin(),
+		                      shared.outgoing.begin() + sent);
+
+		PELCOD_METRICS(metrics_.sent.fetch_add(
+			sent, std::memory_order_relaxed));
+
+		if (shared.outgoing.empty()) {
+			shared.flushing = false;
+		} else {
+			shared.socket.async_wait(
+				boost::asio::ip::udp::socket::wait_write,
+				[this, socket](const boost::system::error_code& error) {
+					if (error != boost::asio::error::operation_aborted) {
+						flush(socket);
+					}
+				});
+		}
+
+		for (auto& completion : completed) {
+			completion.first(completion.second);
+		}
+	}
+
+	/// Starts receiving messages on a socket.
+	/// \details Waits until the socket is readable and receives available
+	/// messages until the socket is closed.
+	/// \param[in]	socket	Socket index.
+	void PelcoDEFleetUDP::startReceive(std::size_t socket) {
+#if defined(PELCOD_HAS_MMSG)
+		sockets_[socket]->socket.async_wait(
+			boost::asio::ip::udp::socket::wait_read,
+			[this, socket](const boost::system::error_code& error) {
+				if (error == boost::asio::error::operation_aborted) {
+					return;
+				}
+
+				if (!error) {
+					receive(socket);
+				}
+
+				startReceive(socket);
+			});
+#else
+		auto& shared = *sockets_[socket];
+
+		shared.socket.async_receive_from(
+			boost::asio::buffer(shared.messages.front()),
+			shared.senders.front(),
+			[this, socket](const boost::system::error_code& error,
+			               std::size_t size) {
+				if (error == boost::asio::error::operation_aborted) {
+					return;
+				}
+
+				if (!error && size == std::tuple_size<Message>::value) {
+					dispatch(socket, 1);
+				}
+
+				startReceive(socket);
+			});
+#endif
+	}
+
+	/// Receives available messages on a socket.
+	/// \details Receives messages in batches with recvmmsg until the socket
+	/// has no more messages. Messages of unexpected size are discarded.
+	/// \param[in]	socket	Socket index.
+	void PelcoDEFleetUDP::receive(std::size_t socket) {
+#if defined(PELCOD_HAS_MMSG)
+		auto& shared = *sockets_[socket];
+
+		for (;;) {
+			mmsghdr headers[BATCH_SIZE] { };
+			iovec vectors[BATCH_SIZE] { };
+
+			for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+				vectors[i].iov_base = shared.messages[i].data();
+				vectors[i].iov_len = shared.messages[i].size();
+
+				headers[i].msg_hdr.msg_name = shared.senders[i].data();
+				headers[i].msg_hdr.msg_namelen = static_cast<socklen_t>(
+					shared.senders[i].capacity());
+				headers[i].msg_hdr.msg_iov = &vectors[i];
+				headers[i].msg_hdr.msg_iovlen = 1;
+			}
+
+			auto result = ::recvmmsg(shared.socket.native_handle(), headers,
+			                         BATCH_SIZE, MSG_DONTWAIT, nullptr);
+
+			if (result <= 0) {
+				if (result < 0 && errno == EINTR) {
+					continue;
+				}
+
+				return;
+			}
+
+			std::size_t count = 0;
+
+			for (auto i = 0; i < result; ++i) {
+				if (headers[i].msg_len != shared.messages[i].size() ||
+				    (headers[i].msg_hdr.msg_flags & MSG_TRUNC)) {
+					continue;
+				}
+
+				shared.senders[i].resize(headers[i].msg_hdr.msg_namelen);
+
+				if (count != static_cast<std::size_t>(i)) {
+					shared.messages[count] = shared.messages[i];
+					shared.senders[count] = shared.senders[i];
+				}
+
+				++count;
+			}
+
+			dispatch(socket, count);
+
+			if (static_cast<std::size_t>(result) < BATCH_SIZE) {
+				return;
+			}
+		}
+#else
+		static_cast<void>(socket);
+#endif
+	}
+
+	/// Delivers received messages to devices.
+	/// \details Finds the device of every message by sender endpoint and
+	/// device address and lets it handle the message. Messages of unknown
+	/// devices are passed to the forward handler if it is set, otherwise they
+	/// are discarded. Devices are detached on the fleet thread only, so found
+	/// devices stay alive unless a handler destroys one, in which case the
+	/// remaining devices are found again.
+	/// \param[in]	socket	Socket index.
+	/// \param[in]	count	Number of received messages.
+	void PelcoDEFleetUDP::dispatch(std::size_t socket, std::size_t count) {
+		auto& shared = *sockets_[socket];
+
+		PelcoDEDeviceUDP* devices[BATCH_SIZE] { };
+
+		PELCOD_METRICS(metrics_.received.fetch_add(
+			count, std::memory_order_relaxed));
+
+		auto capture = capture_.load(std::memory_order_acquire);
+
+		if (capture) {
+			auto now = std::chrono::steady_clock::now();
+
+			for (std::size_t i = 0; i < count; ++i) {
+				capture->record(PelcoDECaptureLog::Direction::Received,
+				                shared.senders[i], shared.messages[i], now);
+			}
+		}
+
+		auto find = [this, &shared, &devices, count](std::size_t first) {
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			for (std::size_t i = first; i < count; ++i) {
+				auto iterator = devices_.find(
+					Key { shared.senders[i],
+					      shared.messages[i][Codec::ADDRESS_BYTE_INDEX] });
+
+				devices[i] =
+					iterator != devices_.end() ? iterator->second : nullptr;
+			}
+
+			return detachments_;
+		};
+
+		auto detachments = find(0);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			if (detachments != detachments_) {
+				detachments = find(i);
+			}
+
+			if (devices[i]) {
+				devices[i]->handleMessage(shared.messages[i]);
+			} else if (forward_) {
+				PELCOD_METRICS(metrics_.forwarded.fetch_add(
+					1, std::memory_order_relaxed));
+				forward_(shared.messages[i], shared.senders[i]);
+			} else {
+				PELCOD_METRICS(metrics_.unknown.fetch_add(
+					1, std::memory_order_relaxed));
+			}
+		}
+	}
+
+	/// Delivers a message forwarded by another fleet.
+	/// \details Lets the device of the message handle it. The message is
+	/// discarded if the device is not attached.
+	/// \param[in]	message	Message.
+	/// \param[in]	sender	Sender endpoint.
+	void PelcoDEFleetUDP::deliver(
+		const Message& message,
+		const boost::asio::ip::udp::endpoint& sender) {
+
+		PelcoDEDeviceUDP* device = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			auto iterator = devices_.find(
+				Key { sender, message[Codec::ADDRESS_BYTE_INDEX] });
+
+			if (iterator != devices_.end()) {
+				device = iterator->second;
+			}
+		}
+
+		if (device) {
+			device->handleMessage(message);
+		} else {
+			PELCOD_METRICS(metrics_.unknown.fetch_add(
+				1, std::memory_order_relaxed));
+		}
+	}
+}
@@ -0,0 +1,254 @@
+/// \file PelcoDEFleetUDP.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE UDP
+/// fleet implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_FLEET_UDP_HPP
+#define PELCODE_FLEET_UDP_HPP
+
+#include "Export.hpp"
+#include "PelcoDECaptureLog.hpp"
+#include "PelcoDECodec.hpp"
+#include "PelcoDEMetrics.hpp"
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	class PelcoDEDeviceUDP;
+
+	/// Class that provides UDP Pelco-DE fleet implementation.
+	/// \details A fleet multiplexes many devices over one I/O context and a
+	/// few shared UDP sockets. Responses are delivered to devices by source
+	/// endpoint and device address.
+	class SHARED_API PelcoDEFleetUDP {
+	public:
+
+		/// Constructor.
+		/// \param[in]	socketCount	Number of shared UDP sockets.
+		explicit PelcoDEFleetUDP(std::size_t socketCount = 1);
+
+		/// Constructor.
+		/// \param[in]	localEndpoint	Local endpoint of shared UDP sockets.
+		/// \param[in]	reusePort		Whether the local port may be shared.
+		/// \param[in]	socketCount		Number of shared UDP sockets.
+		PelcoDEFleetUDP(const boost::asio::ip::udp::endpoint& localEndpoint,
+		                bool reusePort,
+		                std::size_t socketCount = 1);
+
+		/// Destructor.
+		~PelcoDEFleetUDP();
+
+	public:
+
+		/// Gets I/O context.
+		/// \return I/O context that performs fleet I/O.
+		boost::asio::io_context& getContext() noexcept;
+
+		/// Gets number of attached devices.
+		/// \return Number of attached devices.
+		std::size_t getDeviceCount() const;
+
+		/// Gets fleet metrics.
+		/// \return Fleet metrics snapshot.
+		FleetMetricsSnapshot getMetrics() const;
+
+		/// Sets capture log.
+		/// \param[in]	capture	Capture log or null to stop capturing.
+		void setCapture(PelcoDECaptureLog* capture) noexcept;
+
+		/// Allows or forbids sending to broadcast addresses.
+		/// \param[in]	enabled	Whether broadcasts are allowed.
+		void setBroadcast(bool enabled);
+
+		/// Runs I/O context until the fleet is stopped.
+		void run();
+
+		/// Stops I/O context.
+		void stop();
+
+	private:
+
+		friend class PelcoDECaptureReplayer;
+		friend class PelcoDEDeviceUDP;
+		friend class PelcoDEEngineUDP;
+		friend class PelcoDEGroupUDP;
+
+		/// Pelco-DE message.
+		using Message = Codec::Frame;
+
+		/// Handler of messages of unknown devices.
+		using ForwardHandler = std::function<void(
+			const Message&, const boost::asio::ip::udp::endpoint&)>;
+
+		/// Device key.
+		struct Key {
+
+			/// Device endpoint.
+			boost::asio::ip::udp::endpoint endpoint;
+
+			/// Device address.
+			std::uint8_t address;
+
+			/// Compares keys.
+			/// \param[in]	other	Other key.
+			/// \return True if keys are equal.
+			bool operator==(const Key& other) const noexcept;
+		};
+
+		/// Device key hash.
+		struct KeyHash {
+
+			/// Calculates key hash.
+			/// \param[in]	key	Device key.
+			/// \return Key hash.
+			std::size_t operator()(const Key& key) const noexcept;
+		};
+
+		/// Message queued for sending.
+		struct Outgoing {
+
+			/// Message that must outlive the operation.
+			const Message* message;
+
+			/// Destination endpoint.
+			boost::asio::ip::udp::endpoint endpoint;
+
+			/// Completion handler.
+			std::function<void(const boost::system::error_code&)> handler;
+		};
+
+		/// Shared socket.
+		struct Socket {
+
+			/// Constructor.
+			/// \param[in]	context	I/O context.
+			explicit Socket(boost::asio::io_context& context);
+
+			/// UDP socket.
+			boost::asio::ip::udp::socket socket;
+
+			/// Received message buffers.
+			std::vector<Message> messages;
+
+			/// Received message sender endpoints.
+			std::vector<boost::asio::ip::udp::endpoint> senders;
+
+			/// Messages queued for sending.
+			std::vector<Outgoing> outgoing;
+
+			/// Whether queued messages are being sent.
+			bool flushing;
+		};
+
+		/// Opens shared sockets.
+		/// \param[in]	localEndpoint	Local endpoint of shared UDP sockets.
+		/// \param[in]	reusePort		Whether the local port may be shared.
+		/// \param[in]	socketCount		Number of shared UDP sockets.
+		void open(const boost::asio::ip::udp::endpoint& localEndpoint,
+		          bool reusePort,
+		          std::size_t socketCount);
+
+		/// Attaches a device.
+		/// \param[in]	device		Device.
+		/// \param[in]	endpoint	Device endpoint.
+		/// \param[in]	address		Device address.
+		/// \return Index of the socket assigned to the device.
+		std::size_t attach(PelcoDEDeviceUDP& device,
+		                   const boost::asio::ip::udp::endpoint& endpoint,
+		                   std::uint8_t address);
+
+		/// Detaches a device.
+		/// \param[in]	endpoint	Device endpoint.
+		/// \param[in]	address		Device address.
+		void detach(const boost::asio::ip::udp::endpoint& endpoint,
+		            std::uint8_t address);
+
+		/// Runs a function on the fleet thread and waits for it.
+		/// \param[in]	function	Function.
+		void synchronize(const std::function<void()>& function);
+
+		/// Sends a message.
+		/// \param[in]	socket		Socket index.
+		/// \param[in]	message		Message that must outlive the operation.
+		/// \param[in]	endpoint	Destination endpoint.
+		/// \param[in]	handler		Completion handler.
+		void send(std::size_t socket,
+		          const Message& message,
+		          const boost::asio::ip::udp::endpoint& endpoint,
+		          std::function<void(const boost::system::error_code&)> handler);
+
+		/// Sends queued messages of a socket.
+		/// \param[in]	socket	Socket index.
+		void flush(std::size_t socket);
+
+		/// Starts receiving messages on a socket.
+		/// \param[in]	socket	Socket index.
+		void startReceive(std::size_t socket);
+
+		/// Receives available messages on a socket.
+		/// \param[in]	socket	Socket index.
+		void receive(std::size_t socket);
+
+		/// Delivers received messages to devices.
+		/// \param[in]	socket	Socket index.
+		/// \param[in]	count	Number of received messages.
+		void dispatch(std::size_t socket, std::size_t count);
+
+		/// Delivers a message forwarded by another fleet.
+		/// \param[in]	message	Message.
+		/// \param[in]	sender	Sender endpoint.
+		void deliver(const Message& message,
+		             const boost::asio::ip::udp::endpoint& sender);
+
+	private:
+
+		/// I/O context.
+		boost::asio::io_context context_;
+
+		/// Shared sockets.
+		std::vector<std::unique_ptr<Socket>> sockets_;
+
+		/// Attached devices.
+		std::unordered_map<Key, PelcoDEDeviceUDP*, KeyHash> devices_;
+
+		/// Attached devices mutex.
+		mutable std::mutex mutex_;
+
+		/// Number of detached devices.
+		std::size_t detachments_;
+
+		/// Run state mutex.
+		std::mutex runMutex_;
+
+		/// Whether a thread runs the fleet.
+		bool running_;
+
+		/// Whether the fleet is stopped before it is run.
+		bool stopped_;
+
+		/// Index of the socket assigned to the next attached device.
+		std::size_t nextSocket_;
+
+		/// Handler of messages of unknown devices, if any.
+		ForwardHandler forward_;
+
+		/// Fleet metrics.
+		FleetMetrics metrics_;
+
+		/// Capture log, if any.
+		std::atomic<PelcoDECaptureLog*> capture_;
+	};
+}
+
+#endif
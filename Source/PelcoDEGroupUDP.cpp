@@ -0,0 +1,327 @@
+/// \file PelcoDEGroupUDP.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE UDP
+/// group implementation.
+/// \bug No known bugs.
+
+#include "PelcoDEGroupUDP.hpp"
+#include "PelcoDECodec.hpp"
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Group command in progress.
+		struct Command {
+
+			/// Messages sent to the group, they must outlive sending.
+			std::vector<Codec::Frame> messages;
+
+			/// Report of the command.
+			PelcoDEGroupUDP::Report report;
+
+			/// Number of devices that have not completed the command.
+			std::size_t remaining;
+
+			/// Completion handler.
+			PelcoDEGroupUDP::ReportHandler handler;
+		};
+	}
+
+	/// Constructor.
+	/// \details Initializes object fields and allows broadcasts on the fleet
+	/// socket that sends group commands.
+	/// \param[in]	fleet	Fleet that performs group I/O.
+	/// \param[in]	ip		Broadcast or multicast IP address.
+	/// \param[in]	port	Port.
+	/// \throw boost::system::system_error if the address is invalid or
+	/// broadcasts cannot be allowed.
+	PelcoDEGroupUDP::PelcoDEGroupUDP(PelcoDEFleetUDP& fleet,
+	                                 const std::string& ip,
+	                                 std::uint16_t port)
+		: PelcoDEGroupUDP(fleet, boost::asio::ip::udp::endpoint(
+			boost::asio::ip::make_address(ip), port)) {
+	}
+
+	/// Constructor.
+	/// \details Initializes object fields and allows broadcasts on the fleet
+	/// socket that sends group commands.
+	/// \param[in]	fleet		Fleet that performs group I/O.
+	/// \param[in]	endpoint	Broadcast or multicast endpoint.
+	/// \throw boost::system::system_error if broadcasts cannot be allowed.
+	PelcoDEGroupUDP::PelcoDEGroupUDP(
+		PelcoDEFleetUDP& fleet,
+		const boost::asio::ip::udp::endpoint& endpoint)
+		: fleet_(fleet),
+		  endpoint_(endpoint) {
+
+		fleet_.setBroadcast(true);
+	}
+
+	/// Adds a device.
+	/// \details Devices of the group fleet receive group commands in group
+	/// datagrams, other devices receive them one by one.
+	/// \param[in]	device	Device, it must outlive the group and its
+	/// commands.
+	/// \throw std::invalid_argument if the device is already added.
+	void PelcoDEGroupUDP::addDevice(PelcoDEDeviceUDP& device) {
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (std::find(devices_.begin(), devices_.end(), &device) !=
+		    devices_.end()) {
+			throw std::invalid_argument("The device is already added!");
+		}
+
+		devices_.push_back(&device);
+	}
+
+	/// Removes a device.
+	/// \details Commands in progress still report the device.
+	/// \param[in]	device	Device.
+	void PelcoDEGroupUDP::removeDevice(PelcoDEDeviceUDP& device) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		devices_.erase(std::remove(devices_.begin(), devices_.end(), &device),
+		               devices_.end());
+	}
+
+	/// Gets number of devices.
+	/// \details Gets number of devices added to the group.
+	/// \return Number of devices.
+	std::size_t PelcoDEGroupUDP::getDeviceCount() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return devices_.size();
+	}
+
+	/// Gets group endpoint.
+	/// \details Gets the endpoint group datagrams are sent to.
+	/// \return Broadcast or multicast endpoint.
+	const boost::asio::ip::udp::endpoint&
+	PelcoDEGroupUDP::getEndpoint() const noexcept {
+		return endpoint_;
+	}
+
+	/// Sets pan steps of all devices.
+	/// \details Sends the command and waits for the report. The fleet must be
+	/// run by another thread.
+	/// \param[in]	steps	Pan steps.
+	/// \return Report of the command.
+	/// \throw std::logic_error if called from the fleet thread.
+	PelcoDEGroupUDP::Report PelcoDEGroupUDP::setPanSteps(std::uint16_t steps) {
+		return broadcast({ { Codec::COMMAND_REQUEST_SET_PAN_STEPS, steps } });
+	}
+
+	/// Sets tilt steps of all devices.
+	/// \details Sends the command and waits for the report. The fleet must be
+	/// run by another thread.
+	/// \param[in]	steps	Tilt steps.
+	/// \return Report of the command.
+	/// \throw std::logic_error if called from the fleet thread.
+	PelcoDEGroupUDP::Report PelcoDEGroupUDP::setTiltSteps(std::uint16_t steps) {
+		return broadcast({ { Codec::COMMAND_REQUEST_SET_TILT_STEPS, steps } });
+	}
+
+	/// Sets pan and tilt position of all devices.
+	/// \details Sends the commands and waits for the report. The fleet must be
+	/// run by another thread.
+	/// \param[in]	panSteps	Pan steps.
+	/// \param[in]	tiltSteps	Tilt steps.
+	/// \return Report of the command.
+	/// \throw std::logic_error if called from the fleet thread.
+	PelcoDEGroupUDP::Report PelcoDEGroupUDP::setPosition(
+		std::uint16_t panSteps,
+		std::uint16_t tiltSteps) {
+
+		return broadcast({
+			{ Codec::COMMAND_REQUEST_SET_PAN_STEPS, panSteps },
+			{ Codec::COMMAND_REQUEST_SET_TILT_STEPS, tiltSteps } });
+	}
+
+	/// Asynchronously sets pan steps of all devices.
+	/// \details Sends the command in one datagram. The handler is invoked on
+	/// the fleet thread once every device has acknowledged or failed.
+	/// \param[in]	steps	Pan steps.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEGroupUDP::asyncSetPanSteps(std::uint16_t steps,
+	                                       ReportHandler handler) {
+		asyncBroadcast(getTarget(),
+		               { { Codec::COMMAND_REQUEST_SET_PAN_STEPS, steps } },
+		               std::move(handler));
+	}
+
+	/// Asynchronously sets tilt steps of all devices.
+	/// \details Sends the command in one datagram. The handler is invoked on
+	/// the fleet thread once every device has acknowledged or failed.
+	/// \param[in]	steps	Tilt steps.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEGroupUDP::asyncSetTiltSteps(std::uint16_t steps,
+	                                        ReportHandler handler) {
+		asyncBroadcast(getTarget(),
+		               { { Codec::COMMAND_REQUEST_SET_TILT_STEPS, steps } },
+		               std::move(handler));
+	}
+
+	/// Asynchronously sets pan and tilt position of all devices.
+	/// \details Sends both commands in one pass. Both commands are
+	/// acknowledged with the same response command, so a device succeeds once
+	/// it acknowledges both, and both are sent again to a device that times
+	/// out.
+	/// \param[in]	panSteps	Pan steps.
+	/// \param[in]	tiltSteps	Tilt steps.
+	/// \param[in]	handler		Completion handler.
+	void PelcoDEGroupUDP::asyncSetPosition(std::uint16_t panSteps,
+	                                       std::uint16_t tiltSteps,
+	                                       ReportHandler handler) {
+		asyncBroadcast(getTarget(),
+		               { { Codec::COMMAND_REQUEST_SET_PAN_STEPS, panSteps },
+		                 { Codec::COMMAND_REQUEST_SET_TILT_STEPS, tiltSteps } },
+		               std::move(handler));
+	}
+
+	/// Gets recipients of a group command.
+	/// \details Takes the devices added to the group so far.
+	/// \return Recipients of a group command.
+	PelcoDEGroupUDP::Target PelcoDEGroupUDP::getTarget() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return Target { &fleet_, endpoint_, devices_ };
+	}
+
+	/// Sends a request exchange to all devices and collects
+	/// acknowledgements.
+	/// \details On the fleet thread registers the expected responses of every
+	/// device of the fleet and then sends every request message once to the
+	/// group endpoint with the broadcast address. Responses, timeouts and
+	/// retransmissions are handled by the devices. Devices of other fleets,
+	/// for example after being migrated by an engine, are sent the requests
+	/// one by one. If the responses of a device of the fleet would be
+	/// ambiguous with its requests in flight, every device is sent the
+	/// requests one by one instead, since a broadcast reaches them all.
+	/// \param[in]	target	Recipients.
+	/// \param[in]	parts	Request commands and values.
+	/// \param[in]	handler	Completion handler.
+	void PelcoDEGroupUDP::asyncBroadcast(
+		const Target& target,
+		std::vector<PelcoDEDeviceUDP::Part> parts,
+		ReportHandler handler) {
+
+		auto command = std::make_shared<Command>();
+		command->report.acknowledged = 0;
+		command->remaining = 0;
+		command->handler = std::move(handler);
+
+		for (auto device : target.devices) {
+			command->report.results.push_back({ device, { } });
+		}
+
+		boost::asio::post(target.fleet->getContext(),
+			[target, command, parts]() {
+				command->remaining = command->report.results.size();
+
+				if (command->remaining == 0) {
+					command->handler(command->report);
+					return;
+				}
+
+				auto& context = target.fleet->getContext();
+
+				auto& results = command->report.results;
+
+				std::vector<std::shared_ptr<PelcoDEDeviceUDP::Request>>
+					requests;
+				requests.reserve(results.size());
+
+				bool broadcast = true;
+
+				for (std::size_t i = 0; i < results.size(); ++i) {
+					auto device = results[i].device;
+					bool local = &device->getFleet() == target.fleet;
+
+					PelcoDEDeviceUDP::ValueHandler<std::uint16_t> complete =
+						[command, i](const boost::system::error_code& error,
+						             std::uint16_t) {
+
+							command->report.results[i].error = error;
+
+							if (!error) {
+								++command->report.acknowledged;
+							}
+
+							if (--command->remaining == 0) {
+								command->handler(command->report);
+							}
+						};
+
+					if (!local) {
+						complete = [&context, complete](
+							const boost::system::error_code& error,
+							std::uint16_t value) {
+
+							boost::asio::post(context,
+								[complete, error, value]() {
+									complete(error, value);
+								});
+						};
+					}
+
+					requests.push_back(device->createRequest(
+						parts.data(), parts.size(), std::move(complete)));
+
+					if (local && !device->canExpectResponse(requests.back())) {
+						broadcast = false;
+					}
+				}
+
+				for (std::size_t i = 0; i < results.size(); ++i) {
+					auto device = results[i].device;
+
+					if (broadcast && &device->getFleet() == target.fleet) {
+						device->expectResponse(requests[i]);
+					} else {
+						device->submit(std::move(requests[i]));
+					}
+				}
+
+				if (!broadcast) {
+					return;
+				}
+
+				command->messages.reserve(parts.size());
+
+				for (auto& part : parts) {
+					command->messages.push_back(Codec::createFrame(
+						Codec::ADDRESS_BROADCAST, part.command, part.value));
+
+					target.fleet->send(0, command->messages.back(),
+						target.endpoint,
+						[command](const boost::system::error_code&) { });
+				}
+			});
+	}
+
+	/// Performs a group command and waits for its report.
+	/// \details Sends the requests and waits for the report on a future.
+	/// \param[in]	parts	Request commands and values.
+	/// \return Report of the command.
+	/// \throw std::logic_error if called from the fleet thread.
+	PelcoDEGroupUDP::Report PelcoDEGroupUDP::broadcast(
+		std::vector<PelcoDEDeviceUDP::Part> parts) {
+
+		if (fleet_.getContext().get_executor().running_in_this_thread()) {
+			throw std::logic_error(
+				"The method is called from the fleet thread!");
+		}
+
+		auto promise = std::make_shared<std::promise<Report>>();
+
+		asyncBroadcast(getTarget(), std::move(parts),
+			[promise](const Report& report) {
+				promise->set_value(report);
+			});
+
+		return promise->get_future().get();
+	}
+}
@@ -0,0 +1,177 @@
+/// \file PelcoDEGroupUDP.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE UDP
+/// group implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_GROUP_UDP_HPP
+#define PELCODE_GROUP_UDP_HPP
+
+#include "PelcoDEDeviceUDP.hpp"
+#include "PelcoDEFleetUDP.hpp"
+
+#include <boost/asio.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides UDP Pelco-DE group implementation.
+	/// \details A group sends a command to all its devices in one datagram
+	/// with the broadcast address, to a broadcast or multicast endpoint, or
+	/// to the endpoint that several devices share. Every device acknowledges
+	/// the command on its own, unacknowledged commands are retransmitted to
+	/// the device alone. A command takes the devices of the group when it is
+	/// issued and does not refer to the group afterwards, so the group may be
+	/// destroyed while commands are in progress. The fleet and the devices
+	/// must outlive them.
+	class SHARED_API PelcoDEGroupUDP {
+	public:
+
+		/// Result of a command of a device.
+		struct Result {
+
+			/// Device.
+			PelcoDEDeviceUDP* device;
+
+			/// Error code.
+			boost::system::error_code error;
+		};
+
+		/// Report of a group command.
+		struct Report {
+
+			/// Results of devices.
+			std::vector<Result> results;
+
+			/// Number of devices that acknowledged the command.
+			std::size_t acknowledged;
+		};
+
+		/// Completion handler of a group command.
+		using ReportHandler = std::function<void(const Report&)>;
+
+	public:
+
+		/// Constructor.
+		/// \param[in]	fleet	Fleet that performs group I/O.
+		/// \param[in]	ip		Broadcast or multicast IP address.
+		/// \param[in]	port	Port.
+		PelcoDEGroupUDP(PelcoDEFleetUDP& fleet,
+		                const std::string& ip,
+		                std::uint16_t port);
+
+		/// Constructor.
+		/// \param[in]	fleet		Fleet that performs group I/O.
+		/// \param[in]	endpoint	Broadcast or multicast endpoint.
+		PelcoDEGroupUDP(PelcoDEFleetUDP& fleet,
+		                const boost::asio::ip::udp::endpoint& endpoint);
+
+	public:
+
+		/// Adds a device.
+		/// \param[in]	device	Device, it must outlive the group and its
+		/// commands.
+		void addDevice(PelcoDEDeviceUDP& device);
+
+		/// Removes a device.
+		/// \param[in]	device	Device.
+		void removeDevice(PelcoDEDeviceUDP& device);
+
+		/// Gets number of devices.
+		/// \return Number of devices.
+		std::size_t getDeviceCount() const;
+
+		/// Gets group endpoint.
+		/// \return Broadcast or multicast endpoint.
+		const boost::asio::ip::udp::endpoint& getEndpoint() const noexcept;
+
+		/// Sets pan steps of all devices.
+		/// \param[in]	steps	Pan steps.
+		/// \return Report of the command.
+		Report setPanSteps(std::uint16_t steps);
+
+		/// Sets tilt steps of all devices.
+		/// \param[in]	steps	Tilt steps.
+		/// \return Report of the command.
+		Report setTiltSteps(std::uint16_t steps);
+
+		/// Sets pan and tilt position of all devices.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		/// \return Report of the command.
+		Report setPosition(std::uint16_t panSteps, std::uint16_t tiltSteps);
+
+		/// Asynchronously sets pan steps of all devices.
+		/// \param[in]	steps	Pan steps.
+		/// \param[in]	handler	Completion handler.
+		void asyncSetPanSteps(std::uint16_t steps, ReportHandler handler);
+
+		/// Asynchronously sets tilt steps of all devices.
+		/// \param[in]	steps	Tilt steps.
+		/// \param[in]	handler	Completion handler.
+		void asyncSetTiltSteps(std::uint16_t steps, ReportHandler handler);
+
+		/// Asynchronously sets pan and tilt position of all devices.
+		/// \param[in]	panSteps	Pan steps.
+		/// \param[in]	tiltSteps	Tilt steps.
+		/// \param[in]	handler		Completion handler.
+		void asyncSetPosition(std::uint16_t panSteps,
+		                      std::uint16_t tiltSteps,
+		                      ReportHandler handler);
+
+	private:
+
+		/// Recipients of a group command.
+		struct Target {
+
+			/// Fleet that performs group I/O.
+			PelcoDEFleetUDP* fleet;
+
+			/// Broadcast or multicast endpoint.
+			boost::asio::ip::udp::endpoint endpoint;
+
+			/// Devices of the group.
+			std::vector<PelcoDEDeviceUDP*> devices;
+		};
+
+		/// Gets recipients of a group command.
+		/// \return Recipients of a group command.
+		Target getTarget() const;
+
+		/// Sends a request exchange to all devices and collects
+		/// acknowledgements.
+		/// \param[in]	target	Recipients.
+		/// \param[in]	parts	Request commands and values.
+		/// \param[in]	handler	Completion handler.
+		static void asyncBroadcast(
+			const Target& target,
+			std::vector<PelcoDEDeviceUDP::Part> parts,
+			ReportHandler handler);
+
+		/// Performs a group command and waits for its report.
+		/// \param[in]	parts	Request commands and values.
+		/// \return Report of the command.
+		Report broadcast(std::vector<PelcoDEDeviceUDP::Part> parts);
+
+	private:
+
+		/// Fleet that performs group I/O.
+		PelcoDEFleetUDP& fleet_;
+
+		/// Broadcast or multicast endpoint.
+		boost::asio::ip::udp::endpoint endpoint_;
+
+		/// Devices of the group.
+		std::vector<PelcoDEDeviceUDP*> devices_;
+
+		/// Devices mutex.
+		mutable std::mutex mutex_;
+	};
+}
+
+#endif
@@ -0,0 +1,389 @@
+/// \file PelcoDEMetrics.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// metrics implementation.
+/// \bug No known bugs.
+
+#include "PelcoDEMetrics.hpp"
+#include "PelcoDECodec.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Number of buckets per power of two.
+		constexpr std::size_t SUB_BUCKET_COUNT {
+			std::size_t { 1 } << (LatencyHistogram::SUB_BUCKET_BITS - 1)
+		};
+
+		/// Largest value with a bucket of its own.
+		constexpr std::uint64_t EXACT_LIMIT { SUB_BUCKET_COUNT * 2 };
+
+		/// Largest recorded value in microseconds.
+		/// \details Larger values are recorded to the last bucket.
+		constexpr std::uint64_t MAX_VALUE { 0xFFFFFFFFu };
+
+		/// Operation names.
+		constexpr const char* OPERATION_NAMES[OPERATION_COUNT] {
+			"get_pan_steps",
+			"get_tilt_steps",
+			"get_pan_max_steps",
+			"get_tilt_max_steps",
+			"set_pan_steps",
+			"set_tilt_steps",
+			"get_temperature",
+			"get_voltage",
+			"other"
+		};
+
+		/// Gets the index of the most significant bit of a value.
+		/// \param[in]	value	Nonzero value.
+		/// \return Index of the most significant bit.
+		std::size_t getMostSignificantBit(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+			return 63 - static_cast<std::size_t>(__builtin_clzll(value));
+#else
+			std::size_t bit = 0;
+
+			while (value >>= 1) {
+				++bit;
+			}
+
+			return bit;
+#endif
+		}
+	}
+
+	/// Gets the operation of a request command.
+	/// \details Maps Pelco-DE request commands to operations.
+	/// \param[in]	command	Request command.
+	/// \return Operation.
+	Operation getOperation(std::uint8_t command) noexcept {
+		switch (command) {
+			case Codec::COMMAND_REQUEST_GET_PAN_STEPS:
+				return Operation::GetPanSteps;
+			case Codec::COMMAND_REQUEST_GET_TILT_STEPS:
+				return Operation::GetTiltSteps;
+			case Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS:
+				return Operation::GetPanMaxSteps;
+			case Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS:
+				return Operation::GetTiltMaxSteps;
+			case Codec::COMMAND_REQUEST_SET_PAN_STEPS:
+				return Operation::SetPanSteps;
+			case Codec::COMMAND_REQUEST_SET_TILT_STEPS:
+				return Operation::SetTiltSteps;
+			case Codec::COMMAND_REQUEST_GET_TEMPERATURE:
+				return Operation::GetTemperature;
+			case Codec::COMMAND_REQUEST_GET_VOLTAGE:
+				return Operation::GetVoltage;
+			default:
+				return Operation::Other;
+		}
+	}
+
+	/// Gets the name of an operation.
+	/// \details Names are lowercase with underscores, so that they may be
+	/// used as metric labels.
+	/// \param[in]	operation	Operation.
+	/// \return Operation name.
+	const char* getOperationName(Operation operation) noexcept {
+		auto index = static_cast<std::size_t>(operation);
+		return OPERATION_NAMES[std::min(index, OPERATION_COUNT - 1)];
+	}
+
+	/// Constructor.
+	/// \details Initializes an empty snapshot.
+	HistogramSnapshot::HistogramSnapshot()
+		: counts(LatencyHistogram::BUCKET_COUNT),
+		  count(0),
+		  sum(0) {
+	}
+
+	/// Gets a percentile.
+	/// \details Finds the bucket that contains the value of the rank and
+	/// returns its upper bound, so the result overestimates the percentile by
+	/// less than the bucket width.
+	/// \param[in]	rank	Rank from 0 to 1.
+	/// \return Upper bound of the bucket that contains the percentile, or zero
+	/// if the snapshot is empty.
+	std::chrono::microseconds HistogramSnapshot::getPercentile(
+		double rank) const noexcept {
+
+		if (count == 0) {
+			return std::chrono::microseconds(0);
+		}
+
+		rank = std::min(std::max(rank, 0.0), 1.0);
+
+		auto target = std::max<std::uint64_t>(
+			1, static_cast<std::uint64_t>(std::ceil(rank * count)));
+
+		std::uint64_t total = 0;
+
+		for (std::size_t i = 0; i < counts.size(); ++i) {
+			total += counts[i];
+
+			if (total >= target) {
+				return std::chrono::microseconds(
+					LatencyHistogram::getUpperBound(i));
+			}
+		}
+
+		return std::chrono::microseconds(
+			LatencyHistogram::getUpperBound(counts.size() - 1));
+	}
+
+	/// Gets number of values that do not exceed a bound.
+	/// \details Counts values of buckets whose lower bound does not exceed
+	/// the bound. The bucket that contains the bound is counted whole, so the
+	/// result may include values of that bucket above the bound, which are
+	/// within a sixteenth of the bound. Counting only buckets that end below
+	/// the bound would instead drop the values of that bucket that are at or
+	/// below the bound.
+	/// \param[in]	bound	Bound.
+	/// \return Number of values in buckets that start at or below the
+	/// bound.
+	std::uint64_t HistogramSnapshot::getCountBelow(
+		std::chrono::microseconds bound) const noexcept {
+
+		if (bound.count() < 0) {
+			return 0;
+		}
+
+		auto limit = static_cast<std::uint64_t>(bound.count());
+		std::uint64_t total = 0;
+
+		for (std::size_t i = 0; i < counts.size(); ++i) {
+			if (LatencyHistogram::getLowerBound(i) > limit) {
+				break;
+			}
+
+			total += counts[i];
+		}
+
+		return total;
+	}
+
+	/// Adds values of another snapshot.
+	/// \details Adds bucket counts, number and sum of values.
+	/// \param[in]	other	Other snapshot.
+	void HistogramSnapshot::merge(const HistogramSnapshot& other) noexcept {
+		for (std::size_t i = 0; i < counts.size(); ++i) {
+			counts[i] += other.counts[i];
+		}
+
+		count += other.count;
+		sum += other.sum;
+	}
+
+	/// Constructor.
+	/// \details Initializes an empty histogram.
+	LatencyHistogram::LatencyHistogram() noexcept
+		: count_(0),
+		  sum_(0) {
+
+		for (auto& bucket : counts_) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/// Records a value.
+	/// \details Increments the bucket of the value, number and sum of values.
+	/// Negative values are recorded as zero.
+	/// \param[in]	value	Value.
+	void LatencyHistogram::record(std::chrono::microseconds value) noexcept {
+		auto microseconds = value.count() > 0 ?
+			static_cast<std::uint64_t>(value.count()) : 0;
+
+		counts_[getBucket(microseconds)].fetch_add(
+			1, std::memory_order_relaxed);
+		count_.fetch_add(1, std::memory_order_relaxed);
+		sum_.fetch_add(microseconds, std::memory_order_relaxed);
+	}
+
+	/// Takes a snapshot.
+	/// \details Reads counters without stopping writers, so the snapshot may
+	/// miss values recorded concurrently.
+	/// \return Snapshot.
+	HistogramSnapshot LatencyHistogram::getSnapshot() const {
+		HistogramSnapshot snapshot;
+
+		for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+			snapshot.counts[i] = counts_[i].load(std::memory_order_relaxed);
+		}
+
+		snapshot.count = count_.load(std::memory_order_relaxed);
+		snapshot.sum = sum_.load(std::memory_order_relaxed);
+
+		return snapshot;
+	}
+
+	/// Gets the bucket of a value.
+	/// \details Values below 32 are their own buckets. Larger values are
+	/// bucketed by the position of the most significant bit and the next four
+	/// bits.
+	/// \param[in]	value	Value in microseconds.
+	/// \return Bucket index.
+	std::size_t LatencyHistogram::getBucket(std::uint64_t value) noexcept {
+		if (value < EXACT_LIMIT) {
+			return static_cast<std::size_t>(value);
+		}
+
+		value = std::min(value, MAX_VALUE);
+
+		auto shift = getMostSignificantBit(value) - (SUB_BUCKET_BITS - 1);
+		auto mantissa = static_cast<std::size_t>(value >> shift);
+
+		return EXACT_LIMIT + (shift - 1) * SUB_BUCKET_COUNT +
+			(mantissa - SUB_BUCKET_COUNT);
+	}
+
+	/// Gets the upper bound of a bucket.
+	/// \details Inverts the bucket calculation.
+	/// \param[in]	bucket	Bucket index.
+	/// \return Largest value of the bucket in microseconds.
+	std::uint64_t LatencyHistogram::getUpperBound(std::size_t bucket) noexcept {
+		if (bucket < EXACT_LIMIT) {
+			return bucket;
+		}
+
+		bucket -= EXACT_LIMIT;
+
+		auto shift = bucket / SUB_BUCKET_COUNT + 1;
+		auto mantissa = bucket % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+
+		return ((static_cast<std::uint64_t>(mantissa) + 1) << shift) - 1;
+	}
+
+	/// Gets the lower bound of a bucket.
+	/// \details Follows the upper bound of the previous bucket.
+	/// \param[in]	bucket	Bucket index.
+	/// \return Smallest value of the bucket in microseconds.
+	std::uint64_t LatencyHistogram::getLowerBound(std::size_t bucket) noexcept {
+		return bucket == 0 ? 0 : getUpperBound(bucket - 1) + 1;
+	}
+
+	/// Constructor.
+	/// \details Initializes an empty snapshot.
+	DeviceMetricsSnapshot::DeviceMetricsSnapshot()
+		: requests(0),
+		  responses(0),
+		  timeouts(0),
+		  errors(0),
+		  retransmissions(0),
+		  invalid(0),
+		  unexpected(0) {
+	}
+
+	/// Adds values of another snapshot.
+	/// \details Adds counters and latency histograms.
+	/// \param[in]	other	Other snapshot.
+	void DeviceMetricsSnapshot::merge(
+		const DeviceMetricsSnapshot& other) noexcept {
+
+		requests += other.requests;
+		responses += other.responses;
+		timeouts += other.timeouts;
+		errors += other.errors;
+		retransmissions += other.retransmissions;
+		invalid += other.invalid;
+		unexpected += other.unexpected;
+		latency.merge(other.latency);
+	}
+
+	/// Constructor.
+	/// \details Initializes zero counters.
+	DeviceMetrics::DeviceMetrics() noexcept
+		: requests(0),
+		  responses(0),
+		  timeouts(0),
+		  errors(0),
+		  retransmissions(0),
+		  invalid(0),
+		  unexpected(0) {
+	}
+
+	/// Takes a snapshot.
+	/// \details Reads counters without stopping writers.
+	/// \return Snapshot.
+	DeviceMetricsSnapshot DeviceMetrics::getSnapshot() const {
+		DeviceMetricsSnapshot snapshot;
+
+		snapshot.requests = requests.load(std::memory_order_relaxed);
+		snapshot.responses = responses.load(std::memory_order_relaxed);
+		snapshot.timeouts = timeouts.load(std::memory_order_relaxed);
+		snapshot.errors = errors.load(std::memory_order_relaxed);
+		snapshot.retransmissions =
+			retransmissions.load(std::memory_order_relaxed);
+		snapshot.invalid = invalid.load(std::memory_order_relaxed);
+		snapshot.unexpected = unexpected.load(std::memory_order_relaxed);
+		snapshot.latency = latency.getSnapshot();
+
+		return snapshot;
+	}
+
+	/// Constructor.
+	/// \details Initializes an empty snapshot.
+	FleetMetricsSnapshot::FleetMetricsSnapshot()
+		: sent(0),
+		  received(0),
+		  forwarded(0),
+		  unknown(0) {
+	}
+
+	/// Adds values of another snapshot.
+	/// \details Adds counters and latency histograms.
+	/// \param[in]	other	Other snapshot.
+	void FleetMetricsSnapshot::merge(
+		const FleetMetricsSnapshot& other) noexcept {
+
+		sent += other.sent;
+		received += other.received;
+		forwarded += other.forwarded;
+		unknown += other.unknown;
+
+		for (std::size_t i = 0; i < OPERATION_COUNT; ++i) {
+			operations[i].merge(other.operations[i]);
+		}
+	}
+
+	/// Constructor.
+	/// \details Initializes zero counters.
+	FleetMetrics::FleetMetrics() noexcept
+		: sent(0),
+		  received(0),
+		  forwarded(0),
+		  unknown(0) {
+	}
+
+	/// Records latency of a completed request.
+	/// \details Records latency to the histogram of the request operation.
+	/// \param[in]	command	Request command.
+	/// \param[in]	value	Latency.
+	void FleetMetrics::record(std::uint8_t command,
+	                          std::chrono::microseconds value) noexcept {
+		operations[static_cast<std::size_t>(getOperation(command))]
+			.record(value);
+	}
+
+	/// Takes a snapshot.
+	/// \details Reads counters without stopping writers.
+	/// \return Snapshot.
+	FleetMetricsSnapshot FleetMetrics::getSnapshot() const {
+		FleetMetricsSnapshot snapshot;
+
+		snapshot.sent = sent.load(std::memory_order_relaxed);
+		snapshot.received = received.load(std::memory_order_relaxed);
+		snapshot.forwarded = forwarded.load(std::memory_order_relaxed);
+		snapshot.unknown = unknown.load(std::memory_order_relaxed);
+
+		for (std::size_t i = 0; i < OPERATION_COUNT; ++i) {
+			snapshot.operations[i] = operations[i].getSnapshot();
+		}
+
+		return snapshot;
+	}
+}
@@ -0,0 +1,311 @@
+/// \file PelcoDEMetrics.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE
+/// metrics implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_METRICS_HPP
+#define PELCODE_METRICS_HPP
+
+#include "Export.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Evaluates a metrics recording statement if metrics are enabled.
+/// \details Metrics recording is compiled out unless PELCOD_ENABLE_METRICS
+/// is defined when the library is built. Metrics types and snapshots are
+/// always available, they report zeros if recording is compiled out.
+#if defined(PELCOD_ENABLE_METRICS)
+	#define PELCOD_METRICS(...) __VA_ARGS__
+#else
+	#define PELCOD_METRICS(...)
+#endif
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Operation of a device.
+	enum class Operation : std::size_t {
+
+		/// Pan steps query.
+		GetPanSteps,
+
+		/// Tilt steps query.
+		GetTiltSteps,
+
+		/// Pan maximum number of steps query.
+		GetPanMaxSteps,
+
+		/// Tilt maximum number of steps query.
+		GetTiltMaxSteps,
+
+		/// Pan positioning.
+		SetPanSteps,
+
+		/// Tilt positioning.
+		SetTiltSteps,
+
+		/// Device temperature query.
+		GetTemperature,
+
+		/// Device voltage query.
+		GetVoltage,
+
+		/// Any other request.
+		Other
+	};
+
+	/// Number of operations.
+	constexpr std::size_t OPERATION_COUNT {
+		static_cast<std::size_t>(Operation::Other) + 1
+	};
+
+	/// Gets the operation of a request command.
+	/// \param[in]	command	Request command.
+	/// \return Operation.
+	SHARED_API Operation getOperation(std::uint8_t command) noexcept;
+
+	/// Gets the name of an operation.
+	/// \param[in]	operation	Operation.
+	/// \return Operation name.
+	SHARED_API const char* getOperationName(Operation operation) noexcept;
+
+	/// Latency histogram snapshot.
+	struct SHARED_API HistogramSnapshot {
+
+		/// Constructor.
+		HistogramSnapshot();
+
+		/// Gets a percentile.
+		/// \param[in]	rank	Rank from 0 to 1.
+		/// \return Upper bound of the bucket that contains the percentile.
+		std::chrono::microseconds getPercentile(double rank) const noexcept;
+
+		/// Gets number of values that do not exceed a bound.
+		/// \param[in]	bound	Bound.
+		/// \return Number of values in buckets that start at or below the
+		/// bound.
+		std::uint64_t getCountBelow(
+			std::chrono::microseconds bound) const noexcept;
+
+		/// Adds values of another snapshot.
+		/// \param[in]	other	Other snapshot.
+		void merge(const HistogramSnapshot& other) noexcept;
+
+		/// Number of values per bucket.
+		std::vector<std::uint64_t> counts;
+
+		/// Number of values.
+		std::uint64_t count;
+
+		/// Sum of values in microseconds.
+		std::uint64_t sum;
+	};
+
+	/// Class that provides latency histogram implementation.
+	/// \details Log-linear histogram in the manner of HdrHistogram. Values
+	/// below 32 microseconds have own buckets, every further power of two is
+	/// split into 16 buckets, so that the relative error of a value is below
+	/// 6.25%. Values up to about 71 minutes are distinguished. Recording is a
+	/// few relaxed atomic increments and is safe from any thread.
+	class SHARED_API LatencyHistogram {
+	public:
+
+		/// Number of bits of a value that select a bucket.
+		static constexpr std::size_t SUB_BUCKET_BITS { 5 };
+
+		/// Number of buckets.
+		static constexpr std::size_t BUCKET_COUNT {
+			(32 - SUB_BUCKET_BITS + 2) << (SUB_BUCKET_BITS - 1)
+		};
+
+	public:
+
+		/// Constructor.
+		LatencyHistogram() noexcept;
+
+		LatencyHistogram(const LatencyHistogram&) = delete;
+		LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+	public:
+
+		/// Records a value.
+		/// \param[in]	value	Value.
+		void record(std::chrono::microseconds value) noexcept;
+
+		/// Takes a snapshot.
+		/// \return Snapshot.
+		HistogramSnapshot getSnapshot() const;
+
+		/// Gets the bucket of a value.
+		/// \param[in]	value	Value in microseconds.
+		/// \return Bucket index.
+		static std::size_t getBucket(std::uint64_t value) noexcept;
+
+		/// Gets the upper bound of a bucket.
+		/// \param[in]	bucket	Bucket index.
+		/// \return Largest value of the bucket in microseconds.
+		static std::uint64_t getUpperBound(std::size_t bucket) noexcept;
+
+		/// Gets the lower bound of a bucket.
+		/// \param[in]	bucket	Bucket index.
+		/// \return Smallest value of the bucket in microseconds.
+		static std::uint64_t getLowerBound(std::size_t bucket) noexcept;
+
+	private:
+
+		/// Number of values per bucket.
+		std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> counts_;
+
+		/// Number of values.
+		std::atomic<std::uint64_t> count_;
+
+		/// Sum of values in microseconds.
+		std::atomic<std::uint64_t> sum_;
+	};
+
+	/// Device metrics snapshot.
+	struct SHARED_API DeviceMetricsSnapshot {
+
+		/// Constructor.
+		DeviceMetricsSnapshot();
+
+		/// Adds values of another snapshot.
+		/// \param[in]	other	Other snapshot.
+		void merge(const DeviceMetricsSnapshot& other) noexcept;
+
+		/// Number of submitted requests.
+		std::uint64_t requests;
+
+		/// Number of requests completed with a response.
+		std::uint64_t responses;
+
+		/// Number of requests that timed out.
+		std::uint64_t timeouts;
+
+		/// Number of requests that failed otherwise.
+		std::uint64_t errors;
+
+		/// Number of retransmissions.
+		std::uint64_t retransmissions;
+
+		/// Number of received messages that failed validation, for example
+		/// checksum failures.
+		std::uint64_t invalid;
+
+		/// Number of valid received messages that matched no request.
+		std::uint64_t unexpected;
+
+		/// Latency of completed requests from submission to response.
+		HistogramSnapshot latency;
+	};
+
+	/// Class that provides device metrics implementation.
+	class SHARED_API DeviceMetrics {
+	public:
+
+		/// Constructor.
+		DeviceMetrics() noexcept;
+
+	public:
+
+		/// Takes a snapshot.
+		/// \return Snapshot.
+		DeviceMetricsSnapshot getSnapshot() const;
+
+	public:
+
+		/// Number of submitted requests.
+		std::atomic<std::uint64_t> requests;
+
+		/// Number of requests completed with a response.
+		std::atomic<std::uint64_t> responses;
+
+		/// Number of requests that timed out.
+		std::atomic<std::uint64_t> timeouts;
+
+		/// Number of requests that failed otherwise.
+		std::atomic<std::uint64_t> errors;
+
+		/// Number of retransmissions.
+		std::atomic<std::uint64_t> retransmissions;
+
+		/// Number of received messages that failed validation.
+		std::atomic<std::uint64_t> invalid;
+
+		/// Number of valid received messages that matched no request.
+		std::atomic<std::uint64_t> unexpected;
+
+		/// Latency of completed requests.
+		LatencyHistogram latency;
+	};
+
+	/// Fleet metrics snapshot.
+	struct SHARED_API FleetMetricsSnapshot {
+
+		/// Constructor.
+		FleetMetricsSnapshot();
+
+		/// Adds values of another snapshot.
+		/// \param[in]	other	Other snapshot.
+		void merge(const FleetMetricsSnapshot& other) noexcept;
+
+		/// Number of sent messages.
+		std::uint64_t sent;
+
+		/// Number of received messages.
+		std::uint64_t received;
+
+		/// Number of received messages forwarded to other fleets.
+		std::uint64_t forwarded;
+
+		/// Number of received messages of unknown devices.
+		std::uint64_t unknown;
+
+		/// Latency of completed requests per operation.
+		std::array<HistogramSnapshot, OPERATION_COUNT> operations;
+	};
+
+	/// Class that provides fleet metrics implementation.
+	class SHARED_API FleetMetrics {
+	public:
+
+		/// Constructor.
+		FleetMetrics() noexcept;
+
+	public:
+
+		/// Records latency of a completed request.
+		/// \param[in]	command	Request command.
+		/// \param[in]	value	Latency.
+		void record(std::uint8_t command,
+		            std::chrono::microseconds value) noexcept;
+
+		/// Takes a snapshot.
+		/// \return Snapshot.
+		FleetMetricsSnapshot getSnapshot() const;
+
+	public:
+
+		/// Number of sent messages.
+		std::atomic<std::uint64_t> sent;
+
+		/// Number of received messages.
+		std::atomic<std::uint64_t> received;
+
+		/// Number of received messages forwarded to other fleets.
+		std::atomic<std::uint64_t> forwarded;
+
+		/// Number of received messages of unknown devices.
+		std::atomic<std::uint64_t> unknown;
+
+		/// Latency of completed requests per operation.
+		std::array<LatencyHistogram, OPERATION_COUNT> operations;
+	};
+}
+
+#endif
@@ -0,0 +1,272 @@
+/// \file PelcoDEPrometheusExporter.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// Prometheus exporter implementation.
+/// \bug No known bugs.
+
+#include "PelcoDEPrometheusExporter.hpp"
+
+#include <cstdint>
+#include <locale>
+#include <sstream>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Histogram bucket of the exposition format.
+		struct Bucket {
+
+			/// Bucket bound label.
+			const char* label;
+
+			/// Bucket bound.
+			std::chrono::microseconds bound;
+		};
+
+		/// Histogram buckets.
+		/// \details Bounds cover latencies from loopback exchanges to the
+		/// default request deadline.
+		const Bucket BUCKETS[] {
+			{ "0.0001", std::chrono::microseconds(100) },
+			{ "0.00025", std::chrono::microseconds(250) },
+			{ "0.0005", std::chrono::microseconds(500) },
+			{ "0.001", std::chrono::microseconds(1000) },
+			{ "0.0025", std::chrono::microseconds(2500) },
+			{ "0.005", std::chrono::microseconds(5000) },
+			{ "0.01", std::chrono::microseconds(10000) },
+			{ "0.025", std::chrono::microseconds(25000) },
+			{ "0.05", std::chrono::microseconds(50000) },
+			{ "0.1", std::chrono::microseconds(100000) },
+			{ "0.25", std::chrono::microseconds(250000) },
+			{ "0.5", std::chrono::microseconds(500000) },
+			{ "1", std::chrono::microseconds(1000000) },
+			{ "2.5", std::chrono::microseconds(2500000) },
+			{ "5", std::chrono::microseconds(5000000) }
+		};
+
+		/// Escapes a label value.
+		/// \param[in]	value	Label value.
+		/// \return Escaped label value.
+		std::string escape(const std::string& value) {
+			std::string result;
+			result.reserve(value.size());
+
+			for (auto character : value) {
+				switch (character) {
+					case '\\':
+						result += "\\\\";
+						break;
+					case '"':
+						result += "\\\"";
+						break;
+					case '\n':
+						result += "\\n";
+						break;
+					default:
+						result += character;
+				}
+			}
+
+			return result;
+		}
+
+		/// Writes the header of a metric family.
+		/// \param[in]	stream	Output stream.
+		/// \param[in]	name	Metric name.
+		/// \param[in]	type	Metric type.
+		/// \param[in]	help	Metric description.
+		void writeHeader(std::ostream& stream,
+		                 const char* name,
+		                 const char* type,
+		                 const char* help) {
+
+			stream << "# HELP " << name << ' ' << help << '\n'
+			       << "# TYPE " << name << ' ' << type << '\n';
+		}
+
+		/// Writes a histogram sample.
+		/// \details Bucket counts are approximated from the log-linear
+		/// histogram. A count may include values above its bound, but only
+		/// values of the histogram bucket that contains the bound.
+		/// \param[in]	stream		Output stream.
+		/// \param[in]	name		Metric name.
+		/// \param[in]	labels		Labels without braces.
+		/// \param[in]	histogram	Histogram snapshot.
+		void writeHistogram(std::ostream& stream,
+		                    const char* name,
+		                    const std::string& labels,
+		                    const HistogramSnapshot& histogram) {
+
+			for (auto& bucket : BUCKETS) {
+				stream << name << "_bucket{" << labels << ",le=\""
+				       << bucket.label << "\"} "
+				       << histogram.getCountBelow(bucket.bound) << '\n';
+			}
+
+			stream << name << "_bucket{" << labels << ",le=\"+Inf\"} "
+			       << histogram.count << '\n'
+			       << name << "_sum{" << labels << "} "
+			       << static_cast<double>(histogram.sum) / 1e6 << '\n'
+			       << name << "_count{" << labels << "} "
+			       << histogram.count << '\n';
+		}
+
+		/// Device counter of the exposition format.
+		struct DeviceCounter {
+
+			/// Metric name.
+			const char* name;
+
+			/// Metric description.
+			const char* help;
+
+			/// Counter of device metrics.
+			std::uint64_t DeviceMetricsSnapshot::* counter;
+		};
+
+		/// Device counters.
+		const DeviceCounter DEVICE_COUNTERS[] {
+			{ "pelcod_device_requests_total",
+			  "Number of submitted requests.",
+			  &DeviceMetricsSnapshot::requests },
+			{ "pelcod_device_responses_total",
+			  "Number of requests completed with a response.",
+			  &DeviceMetricsSnapshot::responses },
+			{ "pelcod_device_timeouts_total",
+			  "Number of requests that timed out.",
+			  &DeviceMetricsSnapshot::timeouts },
+			{ "pelcod_device_errors_total",
+			  "Number of requests that failed with other errors.",
+			  &DeviceMetricsSnapshot::errors },
+			{ "pelcod_device_retransmissions_total",
+			  "Number of request retransmissions.",
+			  &DeviceMetricsSnapshot::retransmissions },
+			{ "pelcod_device_invalid_messages_total",
+			  "Number of received messages that failed validation.",
+			  &DeviceMetricsSnapshot::invalid },
+			{ "pelcod_device_unexpected_messages_total",
+			  "Number of received messages that matched no request.",
+			  &DeviceMetricsSnapshot::unexpected }
+		};
+
+		/// Fleet counter of the exposition format.
+		struct FleetCounter {
+
+			/// Metric name.
+			const char* name;
+
+			/// Metric description.
+			const char* help;
+
+			/// Counter of fleet metrics.
+			std::uint64_t FleetMetricsSnapshot::* counter;
+		};
+
+		/// Fleet counters.
+		const FleetCounter FLEET_COUNTERS[] {
+			{ "pelcod_fleet_sent_messages_total",
+			  "Number of sent messages.",
+			  &FleetMetricsSnapshot::sent },
+			{ "pelcod_fleet_received_messages_total",
+			  "Number of received messages.",
+			  &FleetMetricsSnapshot::received },
+			{ "pelcod_fleet_forwarded_messages_total",
+			  "Number of received messages forwarded to other fleets.",
+			  &FleetMetricsSnapshot::forwarded },
+			{ "pelcod_fleet_unknown_messages_total",
+			  "Number of received messages of unknown devices.",
+			  &FleetMetricsSnapshot::unknown }
+		};
+	}
+
+	/// Adds fleet metrics.
+	/// \details Adds a snapshot to be exported with the fleet label.
+	/// \param[in]	fleet		Fleet label.
+	/// \param[in]	snapshot	Fleet metrics snapshot.
+	void PelcoDEPrometheusExporter::addFleet(
+		const std::string& fleet,
+		const FleetMetricsSnapshot& snapshot) {
+
+		fleets_.emplace_back(fleet, snapshot);
+	}
+
+	/// Adds device metrics.
+	/// \details Adds a snapshot to be exported with the device label.
+	/// \param[in]	device		Device label.
+	/// \param[in]	snapshot	Device metrics snapshot.
+	void PelcoDEPrometheusExporter::addDevice(
+		const std::string& device,
+		const DeviceMetricsSnapshot& snapshot) {
+
+		devices_.emplace_back(device, snapshot);
+	}
+
+	/// Removes added metrics.
+	/// \details Removes added snapshots, so that the exporter may be reused
+	/// for the next scrape.
+	void PelcoDEPrometheusExporter::clear() noexcept {
+		fleets_.clear();
+		devices_.clear();
+	}
+
+	/// Formats added metrics.
+	/// \details Writes every metric family once with samples of all added
+	/// snapshots. Families without samples are omitted.
+	/// \return Metrics in the Prometheus text exposition format.
+	std::string PelcoDEPrometheusExporter::toString() const {
+		std::ostringstream stream;
+		stream.imbue(std::locale::classic());
+		stream.precision(15);
+
+		if (!fleets_.empty()) {
+			for (auto& counter : FLEET_COUNTERS) {
+				writeHeader(stream, counter.name, "counter", counter.help);
+
+				for (auto& fleet : fleets_) {
+					stream << counter.name << "{fleet=\""
+					       << escape(fleet.first) << "\"} "
+					       << fleet.second.*counter.counter << '\n';
+				}
+			}
+
+			writeHeader(stream, "pelcod_operation_latency_seconds",
+			            "histogram",
+			            "Latency of completed requests per operation.");
+
+			for (auto& fleet : fleets_) {
+				for (std::size_t i = 0; i < OPERATION_COUNT; ++i) {
+					writeHistogram(
+						stream, "pelcod_operation_latency_seconds",
+						"fleet=\"" + escape(fleet.first) +
+						"\",operation=\"" +
+						getOperationName(static_cast<Operation>(i)) + "\"",
+						fleet.second.operations[i]);
+				}
+			}
+		}
+
+		if (!devices_.empty()) {
+			for (auto& counter : DEVICE_COUNTERS) {
+				writeHeader(stream, counter.name, "counter", counter.help);
+
+				for (auto& device : devices_) {
+					stream << counter.name << "{device=\""
+					       << escape(device.first) << "\"} "
+					       << device.second.*counter.counter << '\n';
+				}
+			}
+
+			writeHeader(stream, "pelcod_device_latency_seconds", "histogram",
+			            "Latency of completed requests.");
+
+			for (auto& device : devices_) {
+				writeHistogram(stream, "pelcod_device_latency_seconds",
+				               "device=\"" + escape(device.first) + "\"",
+				               device.second.latency);
+			}
+		}
+
+		return stream.str();
+	}
+}
@@ -0,0 +1,54 @@
+/// \file PelcoDEPrometheusExporter.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE
+/// Prometheus exporter implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_PROMETHEUS_EXPORTER_HPP
+#define PELCODE_PROMETHEUS_EXPORTER_HPP
+
+#include "Export.hpp"
+#include "PelcoDEMetrics.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides Prometheus exporter implementation.
+	/// \details Collects metrics snapshots and formats them in the Prometheus
+	/// text exposition format. Latencies are exported in seconds.
+	class SHARED_API PelcoDEPrometheusExporter {
+	public:
+
+		/// Adds fleet metrics.
+		/// \param[in]	fleet		Fleet label.
+		/// \param[in]	snapshot	Fleet metrics snapshot.
+		void addFleet(const std::string& fleet,
+		              const FleetMetricsSnapshot& snapshot);
+
+		/// Adds device metrics.
+		/// \param[in]	device		Device label.
+		/// \param[in]	snapshot	Device metrics snapshot.
+		void addDevice(const std::string& device,
+		               const DeviceMetricsSnapshot& snapshot);
+
+		/// Removes added metrics.
+		void clear() noexcept;
+
+		/// Formats added metrics.
+		/// \return Metrics in the Prometheus text exposition format.
+		std::string toString() const;
+
+	private:
+
+		/// Fleet metrics by label.
+		std::vector<std::pair<std::string, FleetMetricsSnapshot>> fleets_;
+
+		/// Device metrics by label.
+		std::vector<std::pair<std::string, DeviceMetricsSnapshot>> devices_;
+	};
+}
+
+#endif
@@ -0,0 +1,154 @@
+/// \file PelcoDEStreamParser.hpp
+/// \brief Contains classes and functions declarations and definitions that
+/// provide Pelco-DE byte stream parser implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_STREAM_PARSER_HPP
+#define PELCODE_STREAM_PARSER_HPP
+
+#include "PelcoDECodec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides Pelco-DE byte stream parser implementation.
+	/// \details Consumes byte chunks of any size and emits valid frames, so
+	/// that frames may be split across chunks or preceded by garbage. The
+	/// parser looks for the synchronization value and, if the frame that
+	/// starts at it is corrupt, resumes looking from the next byte, so that a
+	/// valid frame that overlaps a corrupt one is not lost. Only a partial
+	/// frame is kept between chunks and nothing is allocated.
+	class PelcoDEStreamParser {
+	public:
+
+		/// Constructor.
+		PelcoDEStreamParser() noexcept
+			: pendingSize_(0),
+			  frameCount_(0),
+			  discardedCount_(0) {
+		}
+
+	public:
+
+		/// Parses a byte chunk.
+		/// \details Calls the handler with a Codec::FrameView of every valid
+		/// frame in order. The view is valid only during the call.
+		/// \param[in]	data	Bytes.
+		/// \param[in]	size	Number of bytes.
+		/// \param[in]	handler	Frame handler.
+		template <typename Handler>
+		void parse(const std::uint8_t* data, std::size_t size,
+		           Handler&& handler) {
+			while (pendingSize_ > 0 && size > 0) {
+				auto count = Codec::MESSAGE_LENGTH - pendingSize_;
+				count = count < size ? count : size;
+
+				std::memcpy(pending_ + pendingSize_, data, count);
+				pendingSize_ += count;
+				data += count;
+				size -= count;
+
+				if (pendingSize_ < Codec::MESSAGE_LENGTH) {
+					return;
+				}
+
+				Codec::FrameView frame(pending_, pendingSize_);
+
+				if (frame.validate() == Codec::FrameError::None) {
+					pendingSize_ = 0;
+					++frameCount_;
+					handler(frame);
+				} else {
+					resynchronize();
+				}
+			}
+
+			while (size > 0) {
+				auto sync = static_cast<const std::uint8_t*>(std::memchr(
+					data, Codec::SYNCHRONIZATION_VALUE, size));
+
+				if (!sync) {
+					discardedCount_ += size;
+					return;
+				}
+
+				discardedCount_ += static_cast<std::size_t>(sync - data);
+				size -= static_cast<std::size_t>(sync - data);
+				data = sync;
+
+				if (size < Codec::MESSAGE_LENGTH) {
+					std::memcpy(pending_, data, size);
+					pendingSize_ = size;
+					return;
+				}
+
+				Codec::FrameView frame(data, Codec::MESSAGE_LENGTH);
+
+				if (frame.validate() == Codec::FrameError::None) {
+					data += Codec::MESSAGE_LENGTH;
+					size -= Codec::MESSAGE_LENGTH;
+					++frameCount_;
+					handler(frame);
+				} else {
+					++data;
+					--size;
+					++discardedCount_;
+				}
+			}
+		}
+
+		/// Discards a partial frame.
+		void reset() noexcept {
+			discardedCount_ += pendingSize_;
+			pendingSize_ = 0;
+		}
+
+		/// Gets number of emitted frames.
+		/// \return Number of emitted frames.
+		std::size_t getFrameCount() const noexcept {
+			return frameCount_;
+		}
+
+		/// Gets number of discarded bytes.
+		/// \return Number of bytes that do not belong to valid frames.
+		std::size_t getDiscardedCount() const noexcept {
+			return discardedCount_;
+		}
+
+	private:
+
+		/// Drops the first byte of the corrupt pending frame and keeps bytes
+		/// from the next synchronization value on.
+		void resynchronize() noexcept {
+			auto sync = static_cast<const std::uint8_t*>(std::memchr(
+				pending_ + 1, Codec::SYNCHRONIZATION_VALUE, pendingSize_ - 1));
+			auto skipped = sync
+				? static_cast<std::size_t>(sync - pending_)
+				: pendingSize_;
+
+			std::memmove(pending_, pending_ + skipped, pendingSize_ - skipped);
+			pendingSize_ -= skipped;
+			discardedCount_ += skipped;
+		}
+
+	private:
+
+		/// Bytes of a partial frame.
+		std::uint8_t pending_[Codec::MESSAGE_LENGTH];
+
+		/// Number of bytes of a partial frame.
+		std::size_t pendingSize_;
+
+		/// Number of emitted frames.
+		std::size_t frameCount_;
+
+		/// Number of discarded bytes.
+		std::size_t discardedCount_;
+	};
+}
+
+#endif
@@ -0,0 +1,272 @@
+/// \file PelcoDEStreamingController.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// streaming controller implementation.
+/// \bug No known bugs.
+
+#include "PelcoDEStreamingController.hpp"
+
+#include <algorithm>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Pending target flag.
+		/// \details The flag is set in a target value that is not sent yet.
+		constexpr std::uint32_t PENDING_FLAG { 0x10000 };
+
+		/// Streamed axis.
+		struct Axis {
+
+			/// Constructor.
+			/// \param[in]	context	I/O context.
+			/// \param[in]	send	Sends a target to the device.
+			Axis(boost::asio::io_context& context,
+			     std::function<void(std::uint16_t,
+			                        PelcoDEDeviceUDP::Handler)> send)
+				: target(0),
+				  scheduled(false),
+				  send(std::move(send)),
+				  timer(context),
+				  waiting(false),
+				  inFlight(false) {
+			}
+
+			/// Newest target combined with the pending flag.
+			std::atomic<std::uint32_t> target;
+
+			/// Whether the axis is scheduled to be served.
+			std::atomic<bool> scheduled;
+
+			/// Sends a target to the device.
+			std::function<void(std::uint16_t, PelcoDEDeviceUDP::Handler)> send;
+
+			/// Rate limiting timer.
+			boost::asio::steady_timer timer;
+
+			/// Whether the rate limiting timer is armed.
+			bool waiting;
+
+			/// Whether a command is in flight.
+			bool inFlight;
+
+			/// Time when the last command was sent.
+			std::chrono::steady_clock::time_point sent;
+		};
+	}
+
+	/// Controller state shared with pending handlers.
+	struct PelcoDEStreamingController::State
+		: std::enable_shared_from_this<State> {
+
+		/// Constructor.
+		/// \param[in]	device		Device.
+		/// \param[in]	minInterval	Minimum interval between commands.
+		State(PelcoDEDeviceUDP& device, std::chrono::microseconds minInterval)
+			: context(device.getContext()),
+			  pan(context, [&device](std::uint16_t steps,
+			                         PelcoDEDeviceUDP::Handler handler) {
+				  device.asyncSetPanSteps(steps, std::move(handler));
+			  }),
+			  tilt(context, [&device](std::uint16_t steps,
+			                          PelcoDEDeviceUDP::Handler handler) {
+				  device.asyncSetTiltSteps(steps, std::move(handler));
+			  }),
+			  minInterval(minInterval),
+			  interval(minInterval.count()),
+			  acknowledgement(0),
+			  dropped(0),
+			  stopped(false) {
+		}
+
+		/// Sets the newest target of an axis.
+		/// \param[in]	axis	Axis.
+		/// \param[in]	steps	Target steps.
+		void setTarget(Axis& axis, std::uint16_t steps) {
+			auto previous = axis.target.exchange(PENDING_FLAG | steps);
+
+			if (previous & PENDING_FLAG) {
+				++dropped;
+			}
+
+			if (!axis.scheduled.exchange(true)) {
+				auto self = shared_from_this();
+				boost::asio::post(context, [self, &axis]() {
+					self->serve(axis);
+				});
+			}
+		}
+
+		/// Sends the newest target of an axis when it is allowed.
+		/// \details Waits for the command in flight and the interval since
+		/// the last command before sending the newest target.
+		/// \param[in]	axis	Axis.
+		void serve(Axis& axis) {
+			axis.scheduled = false;
+
+			if (stopped || axis.inFlight || axis.waiting) {
+				return;
+			}
+
+			auto next = axis.sent + std::chrono::microseconds(interval.load());
+
+			if (std::chrono::steady_clock::now() < next) {
+				auto self = shared_from_this();
+
+				axis.waiting = true;
+				axis.timer.expires_at(next);
+				axis.timer.async_wait(
+					[self, &axis](const boost::system::error_code&) {
+						axis.waiting = false;
+						self->serve(axis);
+					});
+
+				return;
+			}
+
+			auto target = axis.target.exchange(0);
+
+			if (!(target & PENDING_FLAG)) {
+				return;
+			}
+
+			auto self = shared_from_this();
+			auto steps = static_cast<std::uint16_t>(target);
+
+			axis.inFlight = true;
+			axis.sent = std::chrono::steady_clock::now();
+			axis.send(steps, [self, &axis, steps](
+				const boost::system::error_code& error) {
+
+				boost::asio::post(self->context, [self, &axis, steps, error]() {
+					self->acknowledge(axis, steps, error);
+				});
+			});
+		}
+
+		/// Handles a command acknowledgement of an axis.
+		/// \details The acknowledgement is posted to the controller context,
+		/// as the device may complete commands on another fleet thread after
+		/// it is migrated. Adapts the interval to the acknowledgement time
+		/// with a gain of 1/8 and serves the axis again. A failed target is
+		/// sent again unless a newer target has replaced it or the device
+		/// aborted the command.
+		/// \param[in]	axis	Axis.
+		/// \param[in]	steps	Acknowledged target steps.
+		/// \param[in]	error	Error code.
+		void acknowledge(Axis& axis,
+		                 std::uint16_t steps,
+		                 const boost::system::error_code& error) {
+
+			if (!error) {
+				auto sample =
+					std::chrono::duration_cast<std::chrono::microseconds>(
+						std::chrono::steady_clock::now() - axis.sent);
+
+				acknowledgement = acknowledgement.count() == 0
+					? sample
+					: (acknowledgement * 7 + sample) / 8;
+
+				interval = std::max(minInterval, acknowledgement).count();
+			} else if (error != boost::asio::error::operation_aborted) {
+				std::uint32_t expected = 0;
+				axis.target.compare_exchange_strong(expected,
+				                                    PENDING_FLAG | steps);
+			}
+
+			axis.inFlight = false;
+			serve(axis);
+		}
+
+		/// I/O context.
+		boost::asio::io_context& context;
+
+		/// Pan axis.
+		Axis pan;
+
+		/// Tilt axis.
+		Axis tilt;
+
+		/// Minimum interval between commands of an axis.
+		std::chrono::microseconds minInterval;
+
+		/// Interval between commands of an axis in microseconds.
+		std::atomic<std::int64_t> interval;
+
+		/// Smoothed acknowledgement time.
+		std::chrono::microseconds acknowledgement;
+
+		/// Number of superseded targets.
+		std::atomic<std::size_t> dropped;
+
+		/// Whether the controller is destroyed.
+		bool stopped;
+	};
+
+	/// Constructor.
+	/// \details Initializes object fields. Commands are sent by the thread
+	/// that runs the fleet of the device, which is the internal thread of a
+	/// device that owns its fleet, so a device attached to another fleet must
+	/// be attached to a running one.
+	/// \param[in]	device		Device, it must outlive the controller.
+	/// \param[in]	minInterval	Minimum interval between commands of an
+	/// axis.
+	PelcoDEStreamingController::PelcoDEStreamingController(
+		PelcoDEDeviceUDP& device,
+		std::chrono::microseconds minInterval)
+		: state_(std::make_shared<State>(device, minInterval)) {
+	}
+
+	/// Destructor.
+	/// \details Stops sending targets that are not sent yet.
+	PelcoDEStreamingController::~PelcoDEStreamingController() {
+		auto state = state_;
+
+		boost::asio::post(state->context, [state]() {
+			state->stopped = true;
+			state->pan.timer.cancel();
+			state->tilt.timer.cancel();
+		});
+	}
+
+	/// Sets pan target.
+	/// \details Replaces the pan target that is not sent yet. The method may
+	/// be called from any thread.
+	/// \param[in]	steps	Pan steps.
+	void PelcoDEStreamingController::setPanTarget(std::uint16_t steps) {
+		state_->setTarget(state_->pan, steps);
+	}
+
+	/// Sets tilt target.
+	/// \details Replaces the tilt target that is not sent yet. The method may
+	/// be called from any thread.
+	/// \param[in]	steps	Tilt steps.
+	void PelcoDEStreamingController::setTiltTarget(std::uint16_t steps) {
+		state_->setTarget(state_->tilt, steps);
+	}
+
+	/// Checks whether targets are waiting to be sent.
+	/// \details A target is sent when the axis takes it, commands in flight
+	/// are not waited for.
+	/// \return True if a target of an axis is not sent yet.
+	bool PelcoDEStreamingController::hasPendingTargets() const noexcept {
+		return ((state_->pan.target | state_->tilt.target) & PENDING_FLAG) != 0;
+	}
+
+	/// Gets number of superseded targets.
+	/// \details Gets number of targets replaced before being sent.
+	/// \return Number of targets dropped before being sent.
+	std::size_t PelcoDEStreamingController::getDroppedCount() const noexcept {
+		return state_->dropped;
+	}
+
+	/// Gets interval between commands of an axis.
+	/// \details Gets the interval matched to the acknowledgement time of the
+	/// device, but not less than the minimum interval.
+	/// \return Current interval between commands of an axis.
+	std::chrono::microseconds
+	PelcoDEStreamingController::getInterval() const noexcept {
+		return std::chrono::microseconds(state_->interval.load());
+	}
+}
@@ -0,0 +1,71 @@
+/// \file PelcoDEStreamingController.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE
+/// streaming controller implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_STREAMING_CONTROLLER_HPP
+#define PELCODE_STREAMING_CONTROLLER_HPP
+
+#include "PelcoDEDeviceUDP.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides Pelco-DE streaming controller implementation.
+	/// \details Streams pan and tilt targets produced at a high rate, for
+	/// example by a joystick. Only the newest target of each axis is kept,
+	/// superseded targets are dropped. Each axis has at most one command in
+	/// flight, and commands are sent no faster than the device acknowledges
+	/// them. A target that fails is sent again unless a newer one replaces
+	/// it. Commands are sent by the thread that runs the fleet of the device.
+	class SHARED_API PelcoDEStreamingController {
+	public:
+
+		/// Constructor.
+		/// \param[in]	device		Device, it must outlive the controller.
+		/// \param[in]	minInterval	Minimum interval between commands of an
+		/// axis.
+		explicit PelcoDEStreamingController(
+			PelcoDEDeviceUDP& device,
+			std::chrono::microseconds minInterval =
+				std::chrono::milliseconds(10));
+
+		/// Destructor.
+		~PelcoDEStreamingController();
+
+	public:
+
+		/// Sets pan target.
+		/// \param[in]	steps	Pan steps.
+		void setPanTarget(std::uint16_t steps);
+
+		/// Sets tilt target.
+		/// \param[in]	steps	Tilt steps.
+		void setTiltTarget(std::uint16_t steps);
+
+		/// Checks whether targets are waiting to be sent.
+		/// \return True if a target of an axis is not sent yet.
+		bool hasPendingTargets() const noexcept;
+
+		/// Gets number of superseded targets.
+		/// \return Number of targets dropped before being sent.
+		std::size_t getDroppedCount() const noexcept;
+
+		/// Gets interval between commands of an axis.
+		/// \return Current interval between commands of an axis.
+		std::chrono::microseconds getInterval() const noexcept;
+
+	private:
+
+		struct State;
+
+		/// Controller state shared with pending handlers.
+		std::shared_ptr<State> state_;
+	};
+}
+
+#endif
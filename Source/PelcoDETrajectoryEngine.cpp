@@ -0,0 +1,349 @@
+/// \file PelcoDETrajectoryEngine.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// trajectory engine implementation.
+/// \bug No known bugs.
+
+#include "PelcoDETrajectoryEngine.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	namespace {
+
+		/// Tour segment.
+		/// \details Travel from one waypoint to the next followed by the
+		/// dwell at the next waypoint.
+		struct Segment {
+
+			/// Start position.
+			Position from;
+
+			/// End position.
+			Position to;
+
+			/// Time of the segment start since the tour start.
+			std::chrono::microseconds start;
+
+			/// Travel time.
+			std::chrono::microseconds travel;
+
+			/// Dwell time.
+			std::chrono::microseconds dwell;
+		};
+
+		/// Interpolates steps.
+		/// \param[in]	from		Start steps.
+		/// \param[in]	to			End steps.
+		/// \param[in]	elapsed		Elapsed time.
+		/// \param[in]	duration	Travel time.
+		/// \return Steps at the elapsed time.
+		std::uint16_t interpolate(std::uint16_t from,
+		                          std::uint16_t to,
+		                          std::chrono::microseconds elapsed,
+		                          std::chrono::microseconds duration) {
+
+			auto distance = static_cast<std::int64_t>(to) - from;
+
+			return static_cast<std::uint16_t>(
+				from + distance * elapsed.count() / duration.count());
+		}
+	}
+
+	/// Constructor.
+	/// \details Initializes object fields and starts the scheduler thread.
+	/// \param[in]	period	Tick period.
+	/// \throw std::invalid_argument if the period is not positive.
+	PelcoDETrajectoryEngine::PelcoDETrajectoryEngine(
+		std::chrono::microseconds period)
+		: period_(period),
+		  work_(boost::asio::make_work_guard(context_)),
+		  timer_(context_),
+		  armed_(false),
+		  ticks_(0),
+		  overruns_(0) {
+
+		if (period_.count() <= 0) {
+			throw std::invalid_argument("The period is not positive!");
+		}
+
+		thread_ = std::thread([this]() { context_.run(); });
+	}
+
+	/// Destructor.
+	/// \details Stops the scheduler thread. Commands in flight are completed
+	/// by the fleets of the devices.
+	PelcoDETrajectoryEngine::~PelcoDETrajectoryEngine() {
+		work_.reset();
+		context_.stop();
+		thread_.join();
+	}
+
+	/// Starts a trajectory.
+	/// \details Replaces the trajectory the device follows, if any. The
+	/// trajectory is evaluated on the scheduler thread at tick deadlines and
+	/// must not call the engine. Positions are sent by the thread that runs
+	/// the fleet of the device, which is the internal thread of a device that
+	/// owns its fleet, so a device attached to another fleet must be attached
+	/// to a running one. The method may be called from any thread.
+	/// \param[in]	device		Device, it must outlive the engine.
+	/// \param[in]	trajectory	Trajectory.
+	/// \throw std::invalid_argument if the trajectory is empty.
+	void PelcoDETrajectoryEngine::start(PelcoDEDeviceUDP& device,
+	                                    Trajectory trajectory) {
+		if (!trajectory) {
+			throw std::invalid_argument("The trajectory is empty!");
+		}
+
+		Job job;
+		job.trajectory = std::move(trajectory);
+		job.controller.reset(new PelcoDEStreamingController(device, period_));
+		job.started = std::chrono::steady_clock::now();
+		job.position = Position { 0, 0 };
+		job.streamed = false;
+		job.finished = false;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			jobs_[&device] = std::move(job);
+		}
+
+		schedule();
+	}
+
+	/// Starts a tour.
+	/// \details Starts a trajectory that moves linearly between waypoints.
+	/// \param[in]	device		Device, it must outlive the engine.
+	/// \param[in]	waypoints	Tour waypoints.
+	/// \param[in]	loop		Whether the tour is repeated.
+	/// \throw std::invalid_argument if the tour has no waypoints.
+	void PelcoDETrajectoryEngine::startTour(PelcoDEDeviceUDP& device,
+	                                        std::vector<Waypoint> waypoints,
+	                                        bool loop) {
+		start(device, createTour(std::move(waypoints), loop));
+	}
+
+	/// Stops the trajectory of a device.
+	/// \details The device stops at the last position sent to it. The method
+	/// may be called from any thread.
+	/// \param[in]	device	Device.
+	void PelcoDETrajectoryEngine::stop(PelcoDEDeviceUDP& device) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		jobs_.erase(&device);
+	}
+
+	/// Checks whether a device follows a trajectory.
+	/// \details A finished trajectory is removed once its last position is
+	/// sent to the device.
+	/// \param[in]	device	Device.
+	/// \return True if the device follows a trajectory.
+	bool PelcoDETrajectoryEngine::isRunning(PelcoDEDeviceUDP& device) const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return jobs_.count(&device) != 0;
+	}
+
+	/// Gets number of running trajectories.
+	/// \details Gets number of devices that follow a trajectory.
+	/// \return Number of running trajectories.
+	std::size_t PelcoDETrajectoryEngine::getRunningCount() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return jobs_.size();
+	}
+
+	/// Gets tick period.
+	/// \details Gets the interval between tick deadlines.
+	/// \return Tick period.
+	std::chrono::microseconds
+	PelcoDETrajectoryEngine::getPeriod() const noexcept {
+		return period_;
+	}
+
+	/// Gets scheduler statistics.
+	/// \details Jitter is the delay of the scheduler thread after the tick
+	/// deadline, measured before positions are streamed. A tick is overrun if
+	/// the scheduler is late by more than a period, the missed ticks are
+	/// skipped rather than run in a burst.
+	/// \return Scheduler statistics.
+	PelcoDETrajectoryEngine::Statistics
+	PelcoDETrajectoryEngine::getStatistics() const {
+		Statistics statistics;
+
+		statistics.ticks = ticks_.load(std::memory_order_relaxed);
+		statistics.overruns = overruns_.load(std::memory_order_relaxed);
+		statistics.jitter = jitter_.getSnapshot();
+
+		return statistics;
+	}
+
+	/// Creates a tour trajectory.
+	/// \details The tour starts at the first waypoint, and every next
+	/// waypoint is reached in its travel time with constant speed. A repeated
+	/// tour returns to the first waypoint in its travel time. Pan steps are
+	/// interpolated without wrapping around the full turn.
+	/// \param[in]	waypoints	Tour waypoints.
+	/// \param[in]	loop		Whether the tour is repeated.
+	/// \return Trajectory that moves linearly between waypoints.
+	/// \throw std::invalid_argument if the tour has no waypoints.
+	PelcoDETrajectoryEngine::Trajectory PelcoDETrajectoryEngine::createTour(
+		std::vector<Waypoint> waypoints,
+		bool loop) {
+
+		if (waypoints.empty()) {
+			throw std::invalid_argument("The tour has no waypoints!");
+		}
+
+		auto segments = std::make_shared<std::vector<Segment>>();
+		std::chrono::microseconds duration(0);
+
+		auto add = [&segments, &duration](const Waypoint& from,
+		                                  const Waypoint& to,
+		                                  std::chrono::microseconds travel,
+		                                  std::chrono::microseconds dwell) {
+			segments->push_back({ Position { from.panSteps, from.tiltSteps },
+			                      Position { to.panSteps, to.tiltSteps },
+			                      duration, travel, dwell });
+			duration += travel + dwell;
+		};
+
+		add(waypoints.front(), waypoints.front(),
+		    std::chrono::microseconds(0), waypoints.front().dwell);
+
+		for (std::size_t i = 1; i < waypoints.size(); ++i) {
+			add(waypoints[i - 1], waypoints[i],
+			    waypoints[i].travel, waypoints[i].dwell);
+		}
+
+		if (loop) {
+			add(waypoints.back(), waypoints.front(),
+			    waypoints.front().travel, std::chrono::microseconds(0));
+		}
+
+		return [segments, duration, loop](std::chrono::microseconds elapsed,
+		                                  Position& position) {
+			if (elapsed >= duration) {
+				if (!loop || duration.count() == 0) {
+					position = segments->back().to;
+					return false;
+				}
+
+				elapsed %= duration;
+			}
+
+			auto segment = std::upper_bound(
+				segments->begin(), segments->end(), elapsed,
+				[](std::chrono::microseconds time, const Segment& segment) {
+					return time < segment.start;
+				});
+
+			--segment;
+
+			auto offset = elapsed - segment->start;
+
+			if (offset >= segment->travel) {
+				position = segment->to;
+			} else {
+				position.panSteps = interpolate(segment->from.panSteps,
+				                                segment->to.panSteps,
+				                                offset, segment->travel);
+				position.tiltSteps = interpolate(segment->from.tiltSteps,
+				                                 segment->to.tiltSteps,
+				                                 offset, segment->travel);
+			}
+
+			return true;
+		};
+	}
+
+	/// Arms the tick timer if it is idle.
+	/// \details The first tick is scheduled at once, the timer stays idle
+	/// while there are no trajectories.
+	void PelcoDETrajectoryEngine::schedule() {
+		boost::asio::post(context_, [this]() {
+			if (armed_) {
+				return;
+			}
+
+			armed_ = true;
+			deadline_ = std::chrono::steady_clock::now();
+			tick();
+		});
+	}
+
+	/// Streams positions of running trajectories.
+	/// \details Evaluates trajectories at the tick deadline rather than at
+	/// the wake-up time, so that scheduler jitter does not distort motion.
+	/// Only changed positions are streamed. A finished trajectory is kept
+	/// until its last position is sent. The next deadline is the current
+	/// one plus the period, deadlines that have already passed when the
+	/// trajectories are evaluated are skipped and counted as overruns.
+	void PelcoDETrajectoryEngine::tick() {
+		auto now = std::chrono::steady_clock::now();
+
+		jitter_.record(std::chrono::duration_cast<std::chrono::microseconds>(
+			now - deadline_));
+		ticks_.fetch_add(1, std::memory_order_relaxed);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			for (auto iterator = jobs_.begin(); iterator != jobs_.end();) {
+				auto& job = iterator->second;
+
+				if (job.finished) {
+					if (job.controller->hasPendingTargets()) {
+						++iterator;
+					} else {
+						iterator = jobs_.erase(iterator);
+					}
+
+					continue;
+				}
+
+				Position position = job.position;
+
+				job.finished = !job.trajectory(
+					std::chrono::duration_cast<std::chrono::microseconds>(
+						std::max(deadline_, job.started) - job.started),
+					position);
+
+				if (!job.streamed ||
+				    position.panSteps != job.position.panSteps) {
+					job.controller->setPanTarget(position.panSteps);
+				}
+
+				if (!job.streamed ||
+				    position.tiltSteps != job.position.tiltSteps) {
+					job.controller->setTiltTarget(position.tiltSteps);
+				}
+
+				job.position = position;
+				job.streamed = true;
+				++iterator;
+			}
+
+			if (jobs_.empty()) {
+				armed_ = false;
+				return;
+			}
+		}
+
+		deadline_ += period_;
+		now = std::chrono::steady_clock::now();
+
+		if (deadline_ <= now) {
+			auto missed = (now - deadline_) / period_ + 1;
+			overruns_.fetch_add(static_cast<std::uint64_t>(missed),
+			                    std::memory_order_relaxed);
+			deadline_ += period_ * missed;
+		}
+
+		timer_.expires_at(deadline_);
+		timer_.async_wait([this](const boost::system::error_code& error) {
+			if (!error) {
+				tick();
+			}
+		});
+	}
+}
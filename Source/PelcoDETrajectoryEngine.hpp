@@ -0,0 +1,201 @@
+/// \file PelcoDETrajectoryEngine.hpp
+/// \brief Contains classes and functions declarations that provide Pelco-DE
+/// trajectory engine implementation.
+/// \bug No known bugs.
+
+#ifndef PELCODE_TRAJECTORY_ENGINE_HPP
+#define PELCODE_TRAJECTORY_ENGINE_HPP
+
+#include "PelcoDEDeviceUDP.hpp"
+#include "PelcoDEMetrics.hpp"
+#include "PelcoDEStreamingController.hpp"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides Pelco-DE trajectory engine implementation.
+	/// \details Moves many devices along trajectories from one scheduler
+	/// thread. Ticks are scheduled at absolute deadlines of a monotonic
+	/// clock, so that late ticks do not accumulate drift. On every tick the
+	/// position of each trajectory is evaluated and streamed to its device
+	/// through a streaming controller, which drops targets the device cannot
+	/// keep up with. Devices must outlive the engine, and a device attached to
+	/// a fleet must be attached to a running one.
+	class SHARED_API PelcoDETrajectoryEngine {
+	public:
+
+		/// Trajectory.
+		/// \details Gets the position at the time elapsed since the start of
+		/// the trajectory and returns false when the trajectory is finished.
+		using Trajectory = std::function<bool(std::chrono::microseconds,
+		                                      Position&)>;
+
+		/// Tour waypoint.
+		struct Waypoint {
+
+			/// Pan steps.
+			std::uint16_t panSteps;
+
+			/// Tilt steps.
+			std::uint16_t tiltSteps;
+
+			/// Time to travel from the previous waypoint.
+			std::chrono::milliseconds travel;
+
+			/// Time to stay at the waypoint.
+			std::chrono::milliseconds dwell;
+		};
+
+		/// Scheduler statistics.
+		struct Statistics {
+
+			/// Number of ticks.
+			std::uint64_t ticks;
+
+			/// Number of ticks skipped because the scheduler was late.
+			std::uint64_t overruns;
+
+			/// Delay of ticks after their deadlines.
+			HistogramSnapshot jitter;
+		};
+
+	public:
+
+		/// Constructor.
+		/// \param[in]	period	Tick period.
+		explicit PelcoDETrajectoryEngine(
+			std::chrono::microseconds period = std::chrono::milliseconds(20));
+
+		/// Destructor.
+		~PelcoDETrajectoryEngine();
+
+		PelcoDETrajectoryEngine(const PelcoDETrajectoryEngine&) = delete;
+		PelcoDETrajectoryEngine& operator=(
+			const PelcoDETrajectoryEngine&) = delete;
+
+	public:
+
+		/// Starts a trajectory.
+		/// \param[in]	device		Device, it must outlive the engine.
+		/// \param[in]	trajectory	Trajectory.
+		void start(PelcoDEDeviceUDP& device, Trajectory trajectory);
+
+		/// Starts a tour.
+		/// \param[in]	device		Device, it must outlive the engine.
+		/// \param[in]	waypoints	Tour waypoints.
+		/// \param[in]	loop		Whether the tour is repeated.
+		void startTour(PelcoDEDeviceUDP& device,
+		               std::vector<Waypoint> waypoints,
+		               bool loop = true);
+
+		/// Stops the trajectory of a device.
+		/// \param[in]	device	Device.
+		void stop(PelcoDEDeviceUDP& device);
+
+		/// Checks whether a device follows a trajectory.
+		/// \param[in]	device	Device.
+		/// \return True if the device follows a trajectory.
+		bool isRunning(PelcoDEDeviceUDP& device) const;
+
+		/// Gets number of running trajectories.
+		/// \return Number of running trajectories.
+		std::size_t getRunningCount() const;
+
+		/// Gets tick period.
+		/// \return Tick period.
+		std::chrono::microseconds getPeriod() const noexcept;
+
+		/// Gets scheduler statistics.
+		/// \return Scheduler statistics.
+		Statistics getStatistics() const;
+
+		/// Creates a tour trajectory.
+		/// \param[in]	waypoints	Tour waypoints.
+		/// \param[in]	loop		Whether the tour is repeated.
+		/// \return Trajectory that moves linearly between waypoints.
+		static Trajectory createTour(std::vector<Waypoint> waypoints,
+		                             bool loop = true);
+
+	private:
+
+		/// Trajectory of a device.
+		struct Job {
+
+			/// Trajectory.
+			Trajectory trajectory;
+
+			/// Controller that streams positions to the device.
+			std::unique_ptr<PelcoDEStreamingController> controller;
+
+			/// Time when the trajectory was started.
+			std::chrono::steady_clock::time_point started;
+
+			/// Last streamed position.
+			Position position;
+
+			/// Whether a position was streamed.
+			bool streamed;
+
+			/// Whether the trajectory is finished.
+			bool finished;
+		};
+
+		/// Arms the tick timer if it is idle.
+		void schedule();
+
+		/// Streams positions of running trajectories.
+		void tick();
+
+	private:
+
+		/// Tick period.
+		std::chrono::microseconds period_;
+
+		/// Scheduler I/O context.
+		boost::asio::io_context context_;
+
+		/// Work that keeps the scheduler running.
+		boost::asio::executor_work_guard<
+			boost::asio::io_context::executor_type> work_;
+
+		/// Tick timer.
+		boost::asio::steady_timer timer_;
+
+		/// Deadline of the next tick.
+		std::chrono::steady_clock::time_point deadline_;
+
+		/// Whether the tick timer is armed.
+		bool armed_;
+
+		/// Trajectories by device.
+		std::unordered_map<PelcoDEDeviceUDP*, Job> jobs_;
+
+		/// Trajectories mutex.
+		mutable std::mutex mutex_;
+
+		/// Number of ticks.
+		std::atomic<std::uint64_t> ticks_;
+
+		/// Number of skipped ticks.
+		std::atomic<std::uint64_t> overruns_;
+
+		/// Delay of ticks after their deadlines.
+		LatencyHistogram jitter_;
+
+		/// Scheduler thread.
+		std::thread thread_;
+	};
+}
+
+#endif
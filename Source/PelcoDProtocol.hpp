@@ -0,0 +1,144 @@
+/// \file PelcoDProtocol.hpp
+/// \brief Contains classes and functions declarations and definitions that
+/// provide Pelco-D protocol variants.
+/// \bug No known bugs.
+
+#ifndef PELCOD_PROTOCOL_HPP
+#define PELCOD_PROTOCOL_HPP
+
+#include "PelcoDECodec.hpp"
+
+#include <cstdint>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Protocol command.
+	struct Command {
+
+		/// Request command.
+		std::uint8_t request;
+
+		/// Expected response command, zero if the request is not answered.
+		std::uint8_t response;
+	};
+
+	/// Pelco-DE protocol.
+	/// \details Extended protocol with step positioning that is acknowledged,
+	/// position, range, temperature and voltage queries.
+	struct PelcoDEProtocol {
+
+		/// Whether pan and tilt position may be queried.
+		static constexpr bool HAS_POSITION { true };
+
+		/// Whether pan and tilt maximum number of steps may be queried.
+		static constexpr bool HAS_MAX_STEPS { true };
+
+		/// Whether device temperature may be queried.
+		static constexpr bool HAS_TEMPERATURE { true };
+
+		/// Whether device voltage may be queried.
+		static constexpr bool HAS_VOLTAGE { true };
+
+		/// Gets pan steps command.
+		/// \return Command.
+		static constexpr Command getPanSteps() noexcept {
+			return { Codec::COMMAND_REQUEST_GET_PAN_STEPS,
+			         Codec::COMMAND_RESPONSE_GET_PAN_STEPS };
+		}
+
+		/// Gets tilt steps command.
+		/// \return Command.
+		static constexpr Command getTiltSteps() noexcept {
+			return { Codec::COMMAND_REQUEST_GET_TILT_STEPS,
+			         Codec::COMMAND_RESPONSE_GET_TILT_STEPS };
+		}
+
+		/// Gets pan maximum number of steps command.
+		/// \return Command.
+		static constexpr Command getPanMaxSteps() noexcept {
+			return { Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS,
+			         Codec::COMMAND_RESPONSE_GET_PAN_MAX_STEPS };
+		}
+
+		/// Gets tilt maximum number of steps command.
+		/// \return Command.
+		static constexpr Command getTiltMaxSteps() noexcept {
+			return { Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS,
+			         Codec::COMMAND_RESPONSE_GET_TILT_MAX_STEPS };
+		}
+
+		/// Sets pan steps command.
+		/// \return Command.
+		static constexpr Command setPanSteps() noexcept {
+			return { Codec::COMMAND_REQUEST_SET_PAN_STEPS,
+			         Codec::COMMAND_RESPONSE_SET_PAN_STEPS };
+		}
+
+		/// Sets tilt steps command.
+		/// \return Command.
+		static constexpr Command setTiltSteps() noexcept {
+			return { Codec::COMMAND_REQUEST_SET_TILT_STEPS,
+			         Codec::COMMAND_RESPONSE_SET_TILT_STEPS };
+		}
+
+		/// Gets device temperature command.
+		/// \return Command.
+		static constexpr Command getTemperature() noexcept {
+			return { Codec::COMMAND_REQUEST_GET_TEMPERATURE,
+			         Codec::COMMAND_RESPONSE_GET_TEMPERATURE };
+		}
+
+		/// Gets device voltage command.
+		/// \return Command.
+		static constexpr Command getVoltage() noexcept {
+			return { Codec::COMMAND_REQUEST_GET_VOLTAGE,
+			         Codec::COMMAND_RESPONSE_GET_VOLTAGE };
+		}
+	};
+
+	/// Standard Pelco-D protocol.
+	/// \details Standard extended commands. Positions are set and queried in
+	/// hundredths of a degree, set position commands are not acknowledged.
+	/// Range, temperature and voltage are not available.
+	struct PelcoDProtocol {
+
+		/// Whether pan and tilt position may be queried.
+		static constexpr bool HAS_POSITION { true };
+
+		/// Whether pan and tilt maximum number of steps may be queried.
+		static constexpr bool HAS_MAX_STEPS { false };
+
+		/// Whether device temperature may be queried.
+		static constexpr bool HAS_TEMPERATURE { false };
+
+		/// Whether device voltage may be queried.
+		static constexpr bool HAS_VOLTAGE { false };
+
+		/// Gets pan steps command.
+		/// \return Command.
+		static constexpr Command getPanSteps() noexcept {
+			return { 0x51, 0x59 };
+		}
+
+		/// Gets tilt steps command.
+		/// \return Command.
+		static constexpr Command getTiltSteps() noexcept {
+			return { 0x53, 0x5B };
+		}
+
+		/// Sets pan steps command.
+		/// \return Command.
+		static constexpr Command setPanSteps() noexcept {
+			return { 0x4B, 0x00 };
+		}
+
+		/// Sets tilt steps command.
+		/// \return Command.
+		static constexpr Command setTiltSteps() noexcept {
+			return { 0x4D, 0x00 };
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,194 @@
+/// \file PelcoDTransportUDP.hpp
+/// \brief Contains classes and functions declarations and definitions that
+/// provide blocking Pelco-D UDP transport implementation.
+/// \bug No known bugs.
+
+#ifndef PELCOD_TRANSPORT_UDP_HPP
+#define PELCOD_TRANSPORT_UDP_HPP
+
+#include "PelcoDECodec.hpp"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides blocking Pelco-D UDP transport implementation.
+	/// \details Exchanges frames on a connected UDP socket in the calling
+	/// thread, which runs the I/O context of the socket only to wait for
+	/// responses. Errors are reported without exceptions. One thread at a
+	/// time may use the transport.
+	class PelcoDTransportUDP {
+	public:
+
+		/// Constructor.
+		/// \param[in]	endpoint	Device endpoint.
+		/// \param[in]	timeout		Time to wait for a response.
+		/// \param[in]	maxRetries	Maximum number of retransmissions.
+		/// \throw boost::system::system_error if the socket cannot be opened.
+		explicit PelcoDTransportUDP(
+			const boost::asio::ip::udp::endpoint& endpoint,
+			std::chrono::milliseconds timeout = std::chrono::milliseconds(100),
+			std::size_t maxRetries = 3)
+			: context_(),
+			  socket_(context_),
+			  timeout_(timeout),
+			  maxRetries_(maxRetries) {
+
+			socket_.connect(endpoint);
+		}
+
+	public:
+
+		/// Exchanges a request and its response.
+		/// \details Discards responses that arrived late to previous
+		/// requests, sends the request and, if a response is expected,
+		/// waits for a valid frame with the address of the request and the
+		/// response command, retransmitting the request on timeout.
+		/// \param[in]	request		Request frame.
+		/// \param[in]	response	Expected response command, zero if the
+		/// request is not answered.
+		/// \param[out]	value		Response value.
+		/// \return Error code.
+		boost::system::error_code exchange(const Codec::Frame& request,
+		                                   std::uint8_t response,
+		                                   std::uint16_t& value) noexcept {
+			boost::system::error_code error;
+
+			if (discard(error)) {
+				return error;
+			}
+
+			for (std::size_t retry = 0; retry <= maxRetries_; ++retry) {
+				socket_.send(boost::asio::buffer(request), 0, error);
+
+				if (error || response == 0) {
+					return error;
+				}
+
+				if (receive(request[Codec::ADDRESS_BYTE_INDEX], response,
+				            value, error) || error) {
+					return error;
+				}
+			}
+
+			return boost::asio::error::timed_out;
+		}
+
+		/// Gets socket.
+		/// \return UDP socket.
+		boost::asio::ip::udp::socket& getSocket() noexcept {
+			return socket_;
+		}
+
+	private:
+
+		/// Discards received frames.
+		/// \param[out]	error	Error code.
+		/// \return True if an error occurred.
+		bool discard(boost::system::error_code& error) noexcept {
+			while (socket_.available(error) != 0) {
+				socket_.receive(boost::asio::buffer(frame_), 0, error);
+
+				if (error) {
+					return true;
+				}
+			}
+
+			return static_cast<bool>(error);
+		}
+
+		/// Waits until a frame is received.
+		/// \details Runs the I/O context until the socket is readable or the
+		/// timeout expires, a wait that is timed out is cancelled.
+		/// \param[in]	timeout	Time to wait.
+		/// \param[out]	error	Error code.
+		/// \return True if the socket is readable.
+		bool wait(std::chrono::milliseconds timeout,
+		          boost::system::error_code& error) noexcept {
+			auto ready = false;
+
+			socket_.async_wait(
+				boost::asio::ip::udp::socket::wait_read,
+				[&ready, &error](const boost::system::error_code& result) {
+					ready = !result;
+
+					if (result != boost::asio::error::operation_aborted) {
+						error = result;
+					}
+				});
+
+			context_.restart();
+
+			if (context_.run_one_for(timeout) == 0) {
+				socket_.cancel(error);
+				context_.restart();
+				context_.run();
+			}
+
+			return ready;
+		}
+
+		/// Waits for a response.
+		/// \param[in]	address		Device address.
+		/// \param[in]	response	Expected response command.
+		/// \param[out]	value		Response value.
+		/// \param[out]	error		Error code.
+		/// \return True if the response is received.
+		bool receive(std::uint8_t address,
+		             std::uint8_t response,
+		             std::uint16_t& value,
+		             boost::system::error_code& error) noexcept {
+			auto deadline = std::chrono::steady_clock::now() + timeout_;
+
+			for (;;) {
+				auto remaining =
+					std::chrono::duration_cast<std::chrono::milliseconds>(
+						deadline - std::chrono::steady_clock::now());
+
+				if (remaining.count() <= 0 || !wait(remaining, error)) {
+					return false;
+				}
+
+				auto size = socket_.receive(boost::asio::buffer(frame_), 0,
+				                            error);
+
+				if (error) {
+					return false;
+				}
+
+				Codec::FrameView frame(frame_.data(), size);
+
+				if (frame.validate() == Codec::FrameError::None &&
+				    frame.getAddress() == address &&
+				    frame.getCommand() == response) {
+					value = frame.getValue();
+					return true;
+				}
+			}
+		}
+
+	private:
+
+		/// I/O context of the socket.
+		boost::asio::io_context context_;
+
+		/// UDP socket.
+		boost::asio::ip::udp::socket socket_;
+
+		/// Time to wait for a response.
+		std::chrono::milliseconds timeout_;
+
+		/// Maximum number of retransmissions.
+		std::size_t maxRetries_;
+
+		/// Received frame.
+		Codec::Frame frame_;
+	};
+}
+
+#endif
@@ -0,0 +1,116 @@
+/// \file RoundTripEstimator.cpp
+/// \brief Contains classes and functions definitions that provide round-trip
+/// time estimation.
+/// \bug No known bugs.
+
+#include "RoundTripEstimator.hpp"
+
+#include <algorithm>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Constructor.
+	/// \details Initializes the policy with default values.
+	RetransmissionPolicy::RetransmissionPolicy() noexcept
+		: initialTimeout(500),
+		  minTimeout(100),
+		  maxTimeout(2000),
+		  deadline(5000),
+		  maxRetries(3) {
+	}
+
+	/// Constructor.
+	/// \details Initializes object fields.
+	/// \param[in]	policy	Retransmission policy.
+	RoundTripEstimator::RoundTripEstimator(
+		const RetransmissionPolicy& policy) noexcept
+		: minTimeout_(policy.minTimeout),
+		  maxTimeout_(policy.maxTimeout),
+		  smoothedTime_(0),
+		  timeVariation_(0),
+		  timeout_(policy.initialTimeout),
+		  sampled_(false),
+		  backedOff_(std::chrono::steady_clock::time_point::min()) {
+
+		clampTimeout();
+	}
+
+	/// Adds a round-trip time sample.
+	/// \details Updates smoothed round-trip time and its variation with gains
+	/// of 1/8 and 1/4, the timeout is the smoothed time plus four variations.
+	/// \param[in]	sample	Round-trip time of an exchange that was not
+	/// retransmitted.
+	void RoundTripEstimator::addSample(
+		std::chrono::microseconds sample) noexcept {
+
+		if (!sampled_) {
+			smoothedTime_ = sample;
+			timeVariation_ = sample / 2;
+			sampled_ = true;
+		} else {
+			auto difference = smoothedTime_ > sample
+				? smoothedTime_ - sample
+				: sample - smoothedTime_;
+
+			timeVariation_ = (timeVariation_ * 3 + difference) / 4;
+			smoothedTime_ = (smoothedTime_ * 7 + sample) / 8;
+		}
+
+		timeout_ = smoothedTime_ + timeVariation_ * 4;
+		clampTimeout();
+	}
+
+	/// Doubles the retransmission timeout after a timeout.
+	/// \details Backs off exponentially up to the maximum timeout.
+	void RoundTripEstimator::backoff() noexcept {
+		timeout_ *= 2;
+		clampTimeout();
+	}
+
+	/// Doubles the retransmission timeout once per burst of timeouts.
+	/// \details Pipelined requests that time out together, for example when
+	/// the device goes silent, are a single congestion event. Only a request
+	/// sent after the last backoff backs off again, so that the timeout
+	/// doubles once per burst and still grows with every retransmission.
+	/// \param[in]	sent	Time the timed out request was sent.
+	void RoundTripEstimator::backoff(
+		std::chrono::steady_clock::time_point sent) noexcept {
+
+		if (sent < backedOff_) {
+			return;
+		}
+
+		backedOff_ = std::chrono::steady_clock::now();
+		backoff();
+	}
+
+	/// Gets smoothed round-trip time.
+	/// \details Gets smoothed round-trip time, zero before the first sample.
+	/// \return Smoothed round-trip time.
+	std::chrono::microseconds
+	RoundTripEstimator::getSmoothedTime() const noexcept {
+		return smoothedTime_;
+	}
+
+	/// Gets round-trip time variation.
+	/// \details Gets round-trip time variation, zero before the first sample.
+	/// \return Round-trip time variation.
+	std::chrono::microseconds
+	RoundTripEstimator::getTimeVariation() const noexcept {
+		return timeVariation_;
+	}
+
+	/// Gets retransmission timeout.
+	/// \details Gets the time to wait for a response before retransmission.
+	/// \return Retransmission timeout.
+	std::chrono::microseconds RoundTripEstimator::getTimeout() const noexcept {
+		return timeout_;
+	}
+
+	/// Limits the retransmission timeout by the policy bounds.
+	/// \details Clamps the timeout between minimum and maximum timeouts.
+	void RoundTripEstimator::clampTimeout() noexcept {
+		timeout_ = std::min(std::max(timeout_, minTimeout_), maxTimeout_);
+	}
+}
@@ -0,0 +1,105 @@
+/// \file RoundTripEstimator.hpp
+/// \brief Contains classes and functions declarations that provide round-trip
+/// time estimation.
+/// \bug No known bugs.
+
+#ifndef ROUND_TRIP_ESTIMATOR_HPP
+#define ROUND_TRIP_ESTIMATOR_HPP
+
+#include "Export.hpp"
+
+#include <chrono>
+#include <cstddef>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Retransmission policy.
+	struct SHARED_API RetransmissionPolicy {
+
+		/// Constructor.
+		RetransmissionPolicy() noexcept;
+
+		/// Retransmission timeout used before the first round-trip sample.
+		std::chrono::milliseconds initialTimeout;
+
+		/// Minimum retransmission timeout.
+		std::chrono::milliseconds minTimeout;
+
+		/// Maximum retransmission timeout.
+		std::chrono::milliseconds maxTimeout;
+
+		/// Time limit of a whole operation including retransmissions.
+		std::chrono::milliseconds deadline;
+
+		/// Maximum number of retransmissions.
+		std::size_t maxRetries;
+	};
+
+	/// Class that provides round-trip time estimation.
+	/// \details Estimates smoothed round-trip time and its variation to derive
+	/// the retransmission timeout in the way TCP does (RFC 6298).
+	class SHARED_API RoundTripEstimator {
+	public:
+
+		/// Constructor.
+		/// \param[in]	policy	Retransmission policy.
+		explicit RoundTripEstimator(const RetransmissionPolicy& policy) noexcept;
+
+	public:
+
+		/// Adds a round-trip time sample.
+		/// \param[in]	sample	Round-trip time of an exchange that was not
+		/// retransmitted.
+		void addSample(std::chrono::microseconds sample) noexcept;
+
+		/// Doubles the retransmission timeout after a timeout.
+		void backoff() noexcept;
+
+		/// Doubles the retransmission timeout once per burst of timeouts.
+		/// \param[in]	sent	Time the timed out request was sent.
+		void backoff(std::chrono::steady_clock::time_point sent) noexcept;
+
+		/// Gets smoothed round-trip time.
+		/// \return Smoothed round-trip time.
+		std::chrono::microseconds getSmoothedTime() const noexcept;
+
+		/// Gets round-trip time variation.
+		/// \return Round-trip time variation.
+		std::chrono::microseconds getTimeVariation() const noexcept;
+
+		/// Gets retransmission timeout.
+		/// \return Retransmission timeout.
+		std::chrono::microseconds getTimeout() const noexcept;
+
+	private:
+
+		/// Limits the retransmission timeout by the policy bounds.
+		void clampTimeout() noexcept;
+
+	private:
+
+		/// Minimum retransmission timeout.
+		std::chrono::microseconds minTimeout_;
+
+		/// Maximum retransmission timeout.
+		std::chrono::microseconds maxTimeout_;
+
+		/// Smoothed round-trip time.
+		std::chrono::microseconds smoothedTime_;
+
+		/// Round-trip time variation.
+		std::chrono::microseconds timeVariation_;
+
+		/// Retransmission timeout.
+		std::chrono::microseconds timeout_;
+
+		/// Whether a round-trip time sample was added.
+		bool sampled_;
+
+		/// Time of the last backoff of a burst of timeouts.
+		std::chrono::steady_clock::time_point backedOff_;
+	};
+}
+
+#endif
@@ -0,0 +1,103 @@
+/// \file StepCalibration.cpp
+/// \brief Contains classes and functions definitions that provide
+/// conversion between steps and degrees.
+/// \bug No known bugs.
+
+#include "StepCalibration.hpp"
+
+#include <stdexcept>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Constructor.
+	/// \details Initializes object fields, the device is not calibrated.
+	/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+	/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+	StepCalibration::StepCalibration(std::uint16_t maxPanDegrees,
+	                                 std::uint16_t maxTiltDegrees) noexcept
+		: maxPanDegrees_(maxPanDegrees),
+		  maxTiltDegrees_(maxTiltDegrees),
+		  panStepsPerDegree_(0),
+		  tiltStepsPerDegree_(0),
+		  calibrated_(false) {
+	}
+
+	/// Checks whether the device is calibrated.
+	/// \details Numbers of steps per degree may be read once the device is
+	/// calibrated.
+	/// \return True if the device is calibrated.
+	bool StepCalibration::isCalibrated() const noexcept {
+		return calibrated_;
+	}
+
+	/// Checks whether a calibration is plausible.
+	/// \details A calibration with fewer steps than degrees of an axis would
+	/// give zero steps per degree.
+	/// \param[in]	calibration	Device calibration.
+	/// \return True if every axis has at least one step per degree.
+	bool StepCalibration::isPlausible(
+		const Calibration& calibration) const noexcept {
+
+		return maxPanDegrees_ != 0 &&
+		       calibration.panMaxSteps >= maxPanDegrees_ &&
+		       maxTiltDegrees_ != 0 &&
+		       calibration.tiltMaxSteps >= maxTiltDegrees_;
+	}
+
+	/// Applies a calibration.
+	/// \details Calculates the number of steps per degree of rotation unless
+	/// the calibration is not plausible. Must not be called concurrently with
+	/// itself or with the calibrate method.
+	/// \param[in]	calibration	Device calibration.
+	/// \return True if the calibration is plausible and applied.
+	bool StepCalibration::apply(const Calibration& calibration) noexcept {
+		if (!isPlausible(calibration)) {
+			return false;
+		}
+
+		panStepsPerDegree_ = calibration.panMaxSteps / maxPanDegrees_;
+		tiltStepsPerDegree_ = calibration.tiltMaxSteps / maxTiltDegrees_;
+		calibrated_ = true;
+
+		return true;
+	}
+
+	/// Calibrates the device once.
+	/// \details Queries the calibration unless the device is already
+	/// calibrated. Concurrent calls share one query, a failed query is
+	/// repeated by the next call.
+	/// \param[in]	query	Query of the device calibration.
+	/// \throw std::runtime_error if the calibration is not plausible.
+	void StepCalibration::calibrate(const Query& query) {
+		if (calibrated_) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (calibrated_) {
+			return;
+		}
+
+		if (!apply(query())) {
+			throw std::runtime_error("The calibration is invalid!");
+		}
+	}
+
+	/// Gets number of pan steps per degree.
+	/// \details Gets the number of pan steps per degree of rotation of a
+	/// calibrated device.
+	/// \return Number of pan steps per degree of rotation.
+	std::uint16_t StepCalibration::getPanStepsPerDegree() const noexcept {
+		return panStepsPerDegree_;
+	}
+
+	/// Gets number of tilt steps per degree.
+	/// \details Gets the number of tilt steps per degree of rotation of a
+	/// calibrated device.
+	/// \return Number of tilt steps per degree of rotation.
+	std::uint16_t StepCalibration::getTiltStepsPerDegree() const noexcept {
+		return tiltStepsPerDegree_;
+	}
+}
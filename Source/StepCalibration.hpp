@@ -0,0 +1,90 @@
+/// \file StepCalibration.hpp
+/// \brief Contains classes and functions declarations that provide
+/// conversion between steps and degrees.
+/// \bug No known bugs.
+
+#ifndef STEP_CALIBRATION_HPP
+#define STEP_CALIBRATION_HPP
+
+#include "Export.hpp"
+#include "PelcoDECalibrationCache.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+/// Contains classes and functions that provide Pelco-D protocol implementation.
+namespace PelcoD {
+
+	/// Class that provides conversion between steps and degrees.
+	/// \details Keeps the number of steps per degree of rotation derived
+	/// from the maximum number of steps a device reports for each axis.
+	class SHARED_API StepCalibration {
+	public:
+
+		/// Calibration query.
+		using Query = std::function<Calibration()>;
+
+	public:
+
+		/// Constructor.
+		/// \param[in]	maxPanDegrees	Pan maximum number of degrees.
+		/// \param[in]	maxTiltDegrees	Tilt maximum number of degrees.
+		StepCalibration(std::uint16_t maxPanDegrees,
+		                std::uint16_t maxTiltDegrees) noexcept;
+
+		StepCalibration(const StepCalibration&) = delete;
+		StepCalibration& operator=(const StepCalibration&) = delete;
+
+	public:
+
+		/// Checks whether the device is calibrated.
+		/// \return True if the device is calibrated.
+		bool isCalibrated() const noexcept;
+
+		/// Checks whether a calibration is plausible.
+		/// \param[in]	calibration	Device calibration.
+		/// \return True if every axis has at least one step per degree.
+		bool isPlausible(const Calibration& calibration) const noexcept;
+
+		/// Applies a calibration.
+		/// \param[in]	calibration	Device calibration.
+		/// \return True if the calibration is plausible and applied.
+		bool apply(const Calibration& calibration) noexcept;
+
+		/// Calibrates the device once.
+		/// \param[in]	query	Query of the device calibration.
+		void calibrate(const Query& query);
+
+		/// Gets number of pan steps per degree.
+		/// \return Number of pan steps per degree of rotation.
+		std::uint16_t getPanStepsPerDegree() const noexcept;
+
+		/// Gets number of tilt steps per degree.
+		/// \return Number of tilt steps per degree of rotation.
+		std::uint16_t getTiltStepsPerDegree() const noexcept;
+
+	private:
+
+		/// Pan maximum number of degrees.
+		std::uint16_t maxPanDegrees_;
+
+		/// Tilt maximum number of degrees.
+		std::uint16_t maxTiltDegrees_;
+
+		/// Number of pan steps per degree of rotation.
+		std::uint16_t panStepsPerDegree_;
+
+		/// Number of tilt steps per degree of rotation.
+		std::uint16_t tiltStepsPerDegree_;
+
+		/// Whether the device is calibrated.
+		std::atomic<bool> calibrated_;
+
+		/// Calibration mutex.
+		std::mutex mutex_;
+	};
+}
+
+#endif
@@ -0,0 +1,228 @@
+/// \file BasicPelcoDDeviceTest.cpp
+/// \brief Contains tests of policy-based Pelco-D device.
+/// \bug No known bugs.
+
+#include "BasicPelcoDDevice.hpp"
+#include "PelcoDTransportUDP.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Exchanges recorded by a scripted transport.
+	struct Script {
+
+		/// Request frames.
+		std::vector<Codec::Frame> requests;
+
+		/// Expected response commands.
+		std::vector<std::uint8_t> responses;
+
+		/// Response value.
+		std::uint16_t value;
+
+		/// Error code.
+		boost::system::error_code error;
+	};
+
+	/// Transport that records requests and answers from a script.
+	class ScriptedTransport {
+	public:
+
+		/// Constructor.
+		/// \param[in]	script	Script.
+		explicit ScriptedTransport(Script& script)
+			: script_(script) {
+		}
+
+		/// Exchanges a request and its response.
+		/// \param[in]	request		Request frame.
+		/// \param[in]	response	Expected response command.
+		/// \param[out]	value		Response value.
+		/// \return Error code.
+		boost::system::error_code exchange(const Codec::Frame& request,
+		                                   std::uint8_t response,
+		                                   std::uint16_t& value) noexcept {
+			script_.requests.push_back(request);
+			script_.responses.push_back(response);
+			value = script_.value;
+			return script_.error;
+		}
+
+	private:
+
+		/// Script.
+		Script& script_;
+	};
+
+	/// Pelco-DE device with a scripted transport.
+	using ScriptedDevice = BasicPelcoDDevice<ScriptedTransport>;
+
+	/// Standard Pelco-D device with a scripted transport.
+	using ScriptedStandardDevice =
+		BasicPelcoDDevice<ScriptedTransport, PelcoDProtocol>;
+
+	/// Creates a device socket on an ephemeral loopback port.
+	/// \param[in]	context	I/O context.
+	/// \return Socket.
+	boost::asio::ip::udp::socket createSocket(
+		boost::asio::io_context& context) {
+
+		return boost::asio::ip::udp::socket(
+			context, boost::asio::ip::udp::endpoint(
+				boost::asio::ip::address_v4::loopback(), 0));
+	}
+}
+
+TEST(BasicPelcoDDeviceTest, EncodesRequestsOfProtocol) {
+	Script script {};
+	ScriptedDevice device(5, script);
+
+	EXPECT_FALSE(device.setPanSteps(1234));
+
+	ASSERT_EQ(1u, script.requests.size());
+
+	Codec::FrameView frame(script.requests.front());
+
+	EXPECT_EQ(Codec::FrameError::None, frame.validate());
+	EXPECT_EQ(5, frame.getAddress());
+	EXPECT_EQ(Codec::COMMAND_REQUEST_SET_PAN_STEPS, frame.getCommand());
+	EXPECT_EQ(1234, frame.getValue());
+	EXPECT_EQ(Codec::COMMAND_RESPONSE_SET_PAN_STEPS, script.responses.front());
+}
+
+TEST(BasicPelcoDDeviceTest, StandardSetsAreNotAcknowledged) {
+	Script script {};
+	ScriptedStandardDevice device(1, script);
+
+	EXPECT_FALSE(device.setTiltSteps(100));
+
+	ASSERT_EQ(1u, script.responses.size());
+	EXPECT_EQ(0, script.responses.front());
+}
+
+TEST(BasicPelcoDDeviceTest, StopsAtFirstError) {
+	Script script {};
+	script.error = boost::asio::error::timed_out;
+
+	ScriptedDevice device(1, script);
+	Position position {};
+
+	EXPECT_EQ(boost::asio::error::timed_out, device.getPosition(position));
+	EXPECT_EQ(1u, script.requests.size());
+}
+
+TEST(BasicPelcoDDeviceTest, AdapterConvertsDegrees) {
+	Script script {};
+	script.value = 3600;
+
+	PelcoDDeviceAdapter<ScriptedDevice> adapter(360, 90, 1, script);
+
+	EXPECT_EQ(360, adapter.getPanDegrees());
+
+	script.requests.clear();
+	adapter.setTiltDegrees(45);
+
+	ASSERT_EQ(1u, script.requests.size());
+	EXPECT_EQ(45 * 40, Codec::FrameView(script.requests.front()).getValue());
+}
+
+TEST(BasicPelcoDDeviceTest, AdapterRejectsInvalidCalibration) {
+	Script script {};
+	script.value = 200;
+
+	PelcoDDeviceAdapter<ScriptedDevice> adapter(360, 90, 1, script);
+
+	EXPECT_THROW(adapter.getPanDegrees(), std::runtime_error);
+	EXPECT_THROW(adapter.setTiltDegrees(10), std::runtime_error);
+
+	using Adapter = PelcoDDeviceAdapter<ScriptedDevice>;
+	EXPECT_THROW(Adapter(0, 90, 1, script), std::invalid_argument);
+}
+
+TEST(BasicPelcoDDeviceTest, AdapterThrowsErrors) {
+	Script script {};
+	script.error = boost::asio::error::timed_out;
+
+	PelcoDDeviceAdapter<ScriptedDevice> adapter(360, 90, 1, script);
+	PelcoDDeviceAdapter<ScriptedStandardDevice> standard(360, 90, 1, script);
+
+	EXPECT_THROW(adapter.setPanSteps(1), boost::system::system_error);
+	EXPECT_THROW(standard.getTemperature(), std::logic_error);
+	EXPECT_THROW(standard.getPanDegrees(), std::logic_error);
+}
+
+TEST(BasicPelcoDDeviceTest, TransportDiscardsLateResponses) {
+	boost::asio::io_context context;
+	auto socket = createSocket(context);
+
+	PelcoDTransportUDP transport(socket.local_endpoint());
+	auto local = transport.getSocket().local_endpoint();
+
+	auto late = Codec::createFrame(
+		1, Codec::COMMAND_RESPONSE_GET_PAN_STEPS, 1);
+	socket.send_to(boost::asio::buffer(late), local);
+
+	while (transport.getSocket().available() == 0) {
+		std::this_thread::yield();
+	}
+
+	std::thread responder([&socket]() {
+		Codec::Frame request;
+		boost::asio::ip::udp::endpoint sender;
+
+		socket.receive_from(boost::asio::buffer(request), sender);
+
+		auto response = Codec::createFrame(
+			1, Codec::COMMAND_RESPONSE_GET_PAN_STEPS, 2);
+		socket.send_to(boost::asio::buffer(response), sender);
+	});
+
+	std::uint16_t value = 0;
+	auto error = transport.exchange(
+		Codec::createFrame(1, Codec::COMMAND_REQUEST_GET_PAN_STEPS, 0),
+		Codec::COMMAND_RESPONSE_GET_PAN_STEPS, value);
+
+	responder.join();
+
+	EXPECT_FALSE(error);
+	EXPECT_EQ(2, value);
+}
+
+TEST(BasicPelcoDDeviceTest, TransportRetransmitsAndTimesOut) {
+	boost::asio::io_context context;
+	auto socket = createSocket(context);
+
+	PelcoDTransportUDP transport(socket.local_endpoint(),
+	                             std::chrono::milliseconds(10), 2);
+
+	std::uint16_t value = 0;
+	auto error = transport.exchange(
+		Codec::createFrame(1, Codec::COMMAND_REQUEST_GET_PAN_STEPS, 0),
+		Codec::COMMAND_RESPONSE_GET_PAN_STEPS, value);
+
+	EXPECT_EQ(boost::asio::error::timed_out, error);
+
+	Codec::Frame request;
+	std::size_t requests = 0;
+
+	socket.non_blocking(true);
+
+	for (;;) {
+		socket.receive(boost::asio::buffer(request), 0, error);
+
+		if (error) {
+			break;
+		}
+
+		++requests;
+	}
+
+	EXPECT_EQ(3u, requests);
+}
@@ -0,0 +1,194 @@
+/// \file CachedPelcoDDeviceTest.cpp
+/// \brief Contains tests of cached Pelco-D device.
+/// \bug No known bugs.
+
+#include "CachedPelcoDDevice.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Number of concurrent callers.
+	constexpr std::size_t CALLER_COUNT { 8 };
+
+	/// Device that counts calls and answers when released.
+	class FakeDevice : public AbstractPelcoDDevice {
+	public:
+
+		/// Constructor.
+		FakeDevice()
+			: gets(0),
+			  sets(0),
+			  failing(false),
+			  gate_(release_.get_future().share()) {
+
+			release_.set_value();
+		}
+
+		/// Holds queries until release() is called.
+		void hold() {
+			release_ = std::promise<void>();
+			gate_ = release_.get_future().share();
+		}
+
+		/// Releases held queries.
+		void release() {
+			release_.set_value();
+		}
+
+		/// Gets pan steps.
+		/// \return Number of the query.
+		std::uint16_t getPanSteps() const override {
+			auto count = ++gets;
+			gate_.wait();
+
+			if (failing) {
+				throw std::runtime_error("The query failed!");
+			}
+
+			return static_cast<std::uint16_t>(count);
+		}
+
+		/// Sets pan steps.
+		void setPanSteps(std::uint16_t) override {
+			++sets;
+
+			if (failing) {
+				throw std::runtime_error("The command failed!");
+			}
+		}
+
+		/// Number of queries.
+		mutable std::atomic<std::size_t> gets;
+
+		/// Number of commands.
+		std::atomic<std::size_t> sets;
+
+		/// Whether calls fail.
+		std::atomic<bool> failing;
+
+	private:
+
+		/// Promise that releases held queries.
+		std::promise<void> release_;
+
+		/// Future that held queries wait for.
+		std::shared_future<void> gate_;
+	};
+
+	/// Creates a cache policy.
+	/// \param[in]	ttl	Time during which position values are fresh.
+	/// \return Cache policy.
+	CachePolicy createPolicy(std::chrono::milliseconds ttl) {
+		CachePolicy policy;
+		policy.position = ttl;
+		return policy;
+	}
+
+	/// Waits until a number of queries has reached the device.
+	/// \param[in]	device	Device.
+	/// \param[in]	count	Number of queries.
+	void waitForQueries(const FakeDevice& device, std::size_t count) {
+		while (device.gets < count) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+}
+
+TEST(CachedPelcoDDeviceTest, RefreshesValueAfterExpiry) {
+	FakeDevice device;
+	CachedPelcoDDevice cached(device,
+	                          createPolicy(std::chrono::milliseconds(50)));
+
+	EXPECT_EQ(1, cached.getPanSteps());
+	EXPECT_EQ(1, cached.getPanSteps());
+	EXPECT_EQ(1u, device.gets);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(80));
+
+	EXPECT_EQ(2, cached.getPanSteps());
+	EXPECT_EQ(2u, device.gets);
+}
+
+TEST(CachedPelcoDDeviceTest, SharesQueryOfConcurrentCallers) {
+	FakeDevice device;
+	CachedPelcoDDevice cached(device, createPolicy(std::chrono::hours(1)));
+
+	device.hold();
+
+	std::vector<std::future<std::uint16_t>> results;
+
+	for (std::size_t i = 0; i < CALLER_COUNT; ++i) {
+		results.push_back(std::async(std::launch::async, [&cached]() {
+			return cached.getPanSteps();
+		}));
+	}
+
+	waitForQueries(device, 1);
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	device.release();
+
+	for (auto& result : results) {
+		EXPECT_EQ(1, result.get());
+	}
+
+	EXPECT_EQ(1u, device.gets);
+}
+
+TEST(CachedPelcoDDeviceTest, DeliversErrorToJoinedCallers) {
+	FakeDevice device;
+	CachedPelcoDDevice cached(device, createPolicy(std::chrono::hours(1)));
+
+	device.failing = true;
+	device.hold();
+
+	std::vector<std::future<std::uint16_t>> results;
+
+	for (std::size_t i = 0; i < CALLER_COUNT; ++i) {
+		results.push_back(std::async(std::launch::async, [&cached]() {
+			return cached.getPanSteps();
+		}));
+	}
+
+	waitForQueries(device, 1);
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	device.release();
+
+	for (auto& result : results) {
+		EXPECT_THROW(result.get(), std::runtime_error);
+	}
+
+	EXPECT_EQ(1u, device.gets);
+
+	device.failing = false;
+
+	EXPECT_EQ(2, cached.getPanSteps());
+}
+
+TEST(CachedPelcoDDeviceTest, InvalidatesValueOnSet) {
+	FakeDevice device;
+	CachedPelcoDDevice cached(device, createPolicy(std::chrono::hours(1)));
+
+	EXPECT_EQ(1, cached.getPanSteps());
+
+	cached.setPanSteps(100);
+
+	EXPECT_EQ(2, cached.getPanSteps());
+
+	device.failing = true;
+	EXPECT_THROW(cached.setPanSteps(200), std::runtime_error);
+	device.failing = false;
+
+	EXPECT_EQ(3, cached.getPanSteps());
+	EXPECT_EQ(2u, device.sets);
+}
@@ -0,0 +1,88 @@
+/// \file MpscQueueTest.cpp
+/// \brief Contains tests of multiple-producer single-consumer queue.
+/// \bug No known bugs.
+
+#include "MpscQueue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Number of producer threads.
+	constexpr std::size_t PRODUCER_COUNT { 4 };
+
+	/// Number of values pushed by each producer.
+	constexpr std::uint32_t VALUE_COUNT { 100000 };
+}
+
+TEST(MpscQueueTest, PopsEveryValueOnceInProducerOrder) {
+	MpscQueue<std::uint64_t> queue;
+	std::vector<std::thread> producers;
+
+	for (std::size_t producer = 0; producer < PRODUCER_COUNT; ++producer) {
+		producers.emplace_back([&queue, producer]() {
+			for (std::uint32_t i = 0; i < VALUE_COUNT; ++i) {
+				queue.push(static_cast<std::uint64_t>(producer) << 32 | i);
+			}
+		});
+	}
+
+	std::vector<std::uint32_t> next(PRODUCER_COUNT, 0);
+	std::size_t popped = 0;
+
+	while (popped < PRODUCER_COUNT * VALUE_COUNT) {
+		std::uint64_t value = 0;
+
+		if (!queue.pop(value)) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		auto producer = static_cast<std::size_t>(value >> 32);
+		auto sequence = static_cast<std::uint32_t>(value);
+
+		if (producer >= PRODUCER_COUNT || next[producer] != sequence) {
+			ADD_FAILURE() << "Value " << sequence << " of producer "
+			              << producer << " is out of order.";
+			break;
+		}
+
+		++next[producer];
+		++popped;
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	std::uint64_t value = 0;
+	EXPECT_FALSE(queue.pop(value));
+
+	for (auto count : next) {
+		EXPECT_EQ(VALUE_COUNT, count);
+	}
+}
+
+TEST(MpscQueueTest, DestroysValuesNotPopped) {
+	auto value = std::make_shared<int>(0);
+
+	{
+		MpscQueue<std::shared_ptr<int>> queue;
+		queue.push(value);
+		queue.push(value);
+
+		std::shared_ptr<int> popped;
+		ASSERT_TRUE(queue.pop(popped));
+		EXPECT_EQ(value, popped);
+	}
+
+	EXPECT_EQ(1, value.use_count());
+}
@@ -0,0 +1,175 @@
+/// \file PelcoDEBulkCodecTest.cpp
+/// \brief Contains tests of Pelco-DE bulk frame decoding.
+/// \bug No known bugs.
+
+#include "PelcoDEBulkCodec.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Decoded frames with owned storage.
+	struct Decoded {
+
+		/// Constructor.
+		/// \param[in]	count	Number of frames.
+		explicit Decoded(std::size_t count)
+			: addresses(count, 0xAA),
+			  commands(count, 0xAA),
+			  values(count, 0xAAAA),
+			  valid(count, 0xAA),
+			  result(0) {
+		}
+
+		/// Gets output arrays.
+		/// \return Output arrays.
+		Codec::DecodedFrames get() {
+			return Codec::DecodedFrames {
+				addresses.data(), commands.data(), values.data(), valid.data()
+			};
+		}
+
+		/// Device addresses.
+		std::vector<std::uint8_t> addresses;
+
+		/// Second command bytes.
+		std::vector<std::uint8_t> commands;
+
+		/// Values.
+		std::vector<std::uint16_t> values;
+
+		/// Validity flags.
+		std::vector<std::uint8_t> valid;
+
+		/// Number of valid frames.
+		std::size_t result;
+	};
+
+	/// Creates a batch of frames.
+	/// \details Frames are valid with random fields, then a share of them is
+	/// corrupted in a random byte.
+	/// \param[in]	random		Random generator.
+	/// \param[in]	count		Number of frames.
+	/// \param[in]	corruption	Probability of a corrupted frame.
+	/// \return Frames.
+	std::vector<Codec::Frame> createFrames(std::mt19937& random,
+	                                       std::size_t count,
+	                                       double corruption) {
+		std::uniform_int_distribution<int> byte(0, 0xFF);
+		std::uniform_int_distribution<int> index(0, Codec::MESSAGE_LENGTH - 1);
+		std::bernoulli_distribution corrupt(corruption);
+
+		std::vector<Codec::Frame> frames;
+
+		for (std::size_t i = 0; i < count; ++i) {
+			auto frame = Codec::createFrame(
+				static_cast<std::uint8_t>(byte(random)),
+				static_cast<std::uint8_t>(byte(random)),
+				static_cast<std::uint8_t>(byte(random)),
+				static_cast<std::uint8_t>(byte(random)),
+				static_cast<std::uint8_t>(byte(random)));
+
+			if (corrupt(random)) {
+				frame[index(random)] ^=
+					static_cast<std::uint8_t>(1 + byte(random) % 0xFF);
+			}
+
+			frames.push_back(frame);
+		}
+
+		return frames;
+	}
+
+	/// Decodes frames with an instruction set.
+	/// \param[in]	frames	Frames.
+	/// \param[in]	set		Instruction set.
+	/// \return Decoded frames.
+	Decoded decode(const std::vector<Codec::Frame>& frames,
+	               Codec::InstructionSet set) {
+		Decoded decoded(frames.size());
+		decoded.result = Codec::decodeFrames(frames.data(), frames.size(),
+		                                     decoded.get(), set);
+		return decoded;
+	}
+
+	/// Checks that an instruction set decodes like the scalar code.
+	/// \param[in]	set	Instruction set.
+	void checkEquivalence(Codec::InstructionSet set) {
+		std::mt19937 random(42);
+
+		for (std::size_t count = 0; count <= 130; ++count) {
+			for (auto corruption : { 0.0, 0.3, 1.0 }) {
+				auto frames = createFrames(random, count, corruption);
+				auto expected = decode(frames, Codec::InstructionSet::Scalar);
+				auto actual = decode(frames, set);
+
+				SCOPED_TRACE(::testing::Message()
+					<< "count " << count << ", corruption " << corruption);
+
+				EXPECT_EQ(expected.result, actual.result);
+				EXPECT_EQ(expected.addresses, actual.addresses);
+				EXPECT_EQ(expected.commands, actual.commands);
+				EXPECT_EQ(expected.values, actual.values);
+				EXPECT_EQ(expected.valid, actual.valid);
+			}
+		}
+	}
+}
+
+TEST(PelcoDEBulkCodecTest, ScalarMatchesFrameView) {
+	std::mt19937 random(7);
+	auto frames = createFrames(random, 257, 0.5);
+	auto decoded = decode(frames, Codec::InstructionSet::Scalar);
+
+	std::size_t valid = 0;
+
+	for (std::size_t i = 0; i < frames.size(); ++i) {
+		Codec::FrameView frame(frames[i]);
+
+		EXPECT_EQ(frame.getAddress(), decoded.addresses[i]);
+		EXPECT_EQ(frame.getCommand(), decoded.commands[i]);
+		EXPECT_EQ(frame.getValue(), decoded.values[i]);
+		EXPECT_EQ(frame.validate() == Codec::FrameError::None,
+		          decoded.valid[i] == 1);
+
+		valid += decoded.valid[i];
+	}
+
+	EXPECT_EQ(valid, decoded.result);
+}
+
+TEST(PelcoDEBulkCodecTest, Ssse3MatchesScalar) {
+	if (Codec::getInstructionSet() < Codec::InstructionSet::SSSE3) {
+		GTEST_SKIP() << "SSSE3 is not supported";
+	}
+
+	checkEquivalence(Codec::InstructionSet::SSSE3);
+}
+
+TEST(PelcoDEBulkCodecTest, Avx2MatchesScalar) {
+	if (Codec::getInstructionSet() < Codec::InstructionSet::AVX2) {
+		GTEST_SKIP() << "AVX2 is not supported";
+	}
+
+	checkEquivalence(Codec::InstructionSet::AVX2);
+}
+
+TEST(PelcoDEBulkCodecTest, UnsupportedSetIsRejected) {
+	if (Codec::getInstructionSet() == Codec::InstructionSet::AVX2) {
+		GTEST_SKIP() << "Every instruction set is supported";
+	}
+
+	std::vector<Codec::Frame> frames(1);
+	Decoded decoded(1);
+
+	EXPECT_THROW(Codec::decodeFrames(frames.data(), frames.size(),
+	                                 decoded.get(),
+	                                 Codec::InstructionSet::AVX2),
+	             std::invalid_argument);
+}
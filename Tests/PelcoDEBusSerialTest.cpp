@@ -0,0 +1,259 @@
+/// \file PelcoDEBusSerialTest.cpp
+/// \brief Contains tests of Pelco-DE serial bus.
+/// \bug No known bugs.
+
+#include "PelcoDEBusSerial.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Pseudo terminal that stands in for a serial line.
+	class PseudoTerminal {
+	public:
+
+		/// Constructor.
+		/// \details Opens the master side, the bus opens the slave side.
+		PseudoTerminal()
+			: master_(posix_openpt(O_RDWR | O_NOCTTY)) {
+
+			if (master_ < 0 || grantpt(master_) != 0 ||
+			    unlockpt(master_) != 0) {
+				throw std::runtime_error("The pseudo terminal is unavailable!");
+			}
+
+			slave_ = ptsname(master_);
+		}
+
+		/// Destructor.
+		~PseudoTerminal() {
+			hangUp();
+		}
+
+		PseudoTerminal(const PseudoTerminal&) = delete;
+		PseudoTerminal& operator=(const PseudoTerminal&) = delete;
+
+		/// Gets slave device name.
+		/// \return Slave device name.
+		const std::string& getSlave() const noexcept {
+			return slave_;
+		}
+
+		/// Reads a frame written by the bus.
+		/// \return Frame.
+		Codec::Frame read() {
+			Codec::Frame frame;
+			std::size_t size = 0;
+
+			while (size < frame.size()) {
+				auto count = ::read(master_, frame.data() + size,
+				                    frame.size() - size);
+
+				if (count <= 0) {
+					throw std::runtime_error("The frame cannot be read!");
+				}
+
+				size += static_cast<std::size_t>(count);
+			}
+
+			return frame;
+		}
+
+		/// Closes the master side, so that reads of the bus fail.
+		void hangUp() {
+			if (master_ >= 0) {
+				close(master_);
+				master_ = -1;
+			}
+		}
+
+		/// Writes bytes to the bus.
+		/// \param[in]	data	Bytes.
+		void write(const std::vector<std::uint8_t>& data) {
+			if (::write(master_, data.data(), data.size()) !=
+			    static_cast<ssize_t>(data.size())) {
+				throw std::runtime_error("The frame cannot be written!");
+			}
+		}
+
+	private:
+
+		/// Master side descriptor.
+		int master_;
+
+		/// Slave device name.
+		std::string slave_;
+	};
+
+	/// Result of a request.
+	struct Result {
+
+		/// Error code.
+		boost::system::error_code error;
+
+		/// Response value.
+		std::uint16_t value;
+	};
+}
+
+TEST(PelcoDEBusSerialTest, ExchangesRequests) {
+	PseudoTerminal terminal;
+	PelcoDEBusSerial bus(terminal.getSlave());
+
+	std::promise<Result> promise;
+
+	bus.asyncRequest(3, Codec::COMMAND_REQUEST_GET_PAN_STEPS, 0,
+		[&promise](const boost::system::error_code& error,
+		           std::uint16_t value) {
+			promise.set_value(Result { error, value });
+		});
+
+	auto request = terminal.read();
+	Codec::FrameView frame(request);
+
+	EXPECT_EQ(Codec::FrameError::None, frame.validate());
+	EXPECT_EQ(3, frame.getAddress());
+	EXPECT_EQ(Codec::COMMAND_REQUEST_GET_PAN_STEPS, frame.getCommand());
+
+	auto response = Codec::createFrame(
+		3, Codec::COMMAND_RESPONSE_GET_PAN_STEPS, 1234);
+
+	std::vector<std::uint8_t> data { 0x00, 0x13 };
+	data.insert(data.end(), response.begin(), response.end());
+	terminal.write(data);
+
+	auto result = promise.get_future().get();
+
+	EXPECT_FALSE(result.error);
+	EXPECT_EQ(1234, result.value);
+}
+
+TEST(PelcoDEBusSerialTest, DestructorAbortsRequests) {
+	PseudoTerminal terminal;
+	std::vector<boost::system::error_code> errors;
+
+	{
+		PelcoDEBusSerial bus(terminal.getSlave());
+
+		RetransmissionPolicy policy;
+		policy.initialTimeout = std::chrono::milliseconds(60000);
+		policy.minTimeout = policy.initialTimeout;
+		policy.maxTimeout = policy.initialTimeout;
+		policy.deadline = policy.initialTimeout;
+		bus.setRetransmissionPolicy(policy);
+
+		for (std::uint8_t address = 1; address <= 3; ++address) {
+			bus.asyncRequest(address, Codec::COMMAND_REQUEST_GET_VOLTAGE, 0,
+				[&errors](const boost::system::error_code& error,
+				          std::uint16_t) {
+					errors.push_back(error);
+				});
+		}
+
+		terminal.read();
+	}
+
+	ASSERT_EQ(3u, errors.size());
+
+	for (const auto& error : errors) {
+		EXPECT_EQ(boost::asio::error::operation_aborted, error);
+	}
+}
+
+TEST(PelcoDEBusSerialTest, CoalescesOnlyWithLastQueuedRequest) {
+	PseudoTerminal terminal;
+	PelcoDEBusSerial bus(terminal.getSlave());
+
+	const std::uint8_t commands[] {
+		Codec::COMMAND_REQUEST_GET_VOLTAGE,
+		Codec::COMMAND_REQUEST_GET_PAN_STEPS,
+		Codec::COMMAND_REQUEST_GET_TILT_STEPS,
+		Codec::COMMAND_REQUEST_GET_PAN_STEPS,
+		Codec::COMMAND_REQUEST_GET_PAN_STEPS
+	};
+
+	std::vector<std::uint8_t> completed;
+	std::promise<void> promise;
+
+	for (auto command : commands) {
+		bus.asyncRequest(1, command, 0,
+			[&completed, &promise, command](
+				const boost::system::error_code& error, std::uint16_t) {
+
+				EXPECT_FALSE(error);
+				completed.push_back(command);
+
+				if (completed.size() == sizeof(commands)) {
+					promise.set_value();
+				}
+			});
+	}
+
+	std::vector<std::uint8_t> sent;
+
+	for (std::size_t i = 0; i < 4; ++i) {
+		auto request = terminal.read();
+		Codec::FrameView frame(request);
+		sent.push_back(frame.getCommand());
+
+		auto response = Codec::createFrame(
+			1, Codec::getResponseCommand(frame.getCommand()), 0);
+		terminal.write(std::vector<std::uint8_t>(
+			response.begin(), response.end()));
+	}
+
+	promise.get_future().get();
+
+	EXPECT_EQ((std::vector<std::uint8_t> {
+		Codec::COMMAND_REQUEST_GET_VOLTAGE,
+		Codec::COMMAND_REQUEST_GET_PAN_STEPS,
+		Codec::COMMAND_REQUEST_GET_TILT_STEPS,
+		Codec::COMMAND_REQUEST_GET_PAN_STEPS }), sent);
+	EXPECT_EQ((std::vector<std::uint8_t>(commands, commands + 5)), completed);
+}
+
+TEST(PelcoDEBusSerialTest, CountsReadErrorsAfterHangUp) {
+	PseudoTerminal terminal;
+	PelcoDEBusSerial bus(terminal.getSlave());
+
+	terminal.hangUp();
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+	while (bus.getReadErrorCount() == 0 &&
+	       std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	EXPECT_LE(1u, bus.getReadErrorCount());
+
+	RetransmissionPolicy policy;
+	policy.initialTimeout = std::chrono::milliseconds(50);
+	policy.minTimeout = policy.initialTimeout;
+	policy.maxTimeout = std::chrono::milliseconds(100);
+	policy.deadline = std::chrono::milliseconds(300);
+	bus.setRetransmissionPolicy(policy);
+
+	std::promise<boost::system::error_code> promise;
+
+	bus.asyncRequest(1, Codec::COMMAND_REQUEST_GET_VOLTAGE, 0,
+		[&promise](const boost::system::error_code& error, std::uint16_t) {
+			promise.set_value(error);
+		});
+
+	EXPECT_EQ(boost::asio::error::timed_out, promise.get_future().get());
+}
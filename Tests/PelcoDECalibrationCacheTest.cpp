@@ -0,0 +1,130 @@
+/// \file PelcoDECalibrationCacheTest.cpp
+/// \brief Contains tests of Pelco-DE calibration cache.
+/// \bug No known bugs.
+
+#include "PelcoDECalibrationCache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Temporary file that is removed on destruction.
+	class TemporaryFile {
+	public:
+
+		/// Constructor.
+		/// \details Creates an empty file with a unique name.
+		TemporaryFile() {
+			char name[] = "/tmp/PelcoDECalibrationCacheTest.XXXXXX";
+			auto descriptor = mkstemp(name);
+
+			if (descriptor < 0) {
+				throw std::runtime_error("The file cannot be created!");
+			}
+
+			close(descriptor);
+			path_ = name;
+		}
+
+		/// Destructor.
+		~TemporaryFile() {
+			std::remove(path_.c_str());
+			std::remove((path_ + ".tmp").c_str());
+		}
+
+		TemporaryFile(const TemporaryFile&) = delete;
+		TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+		/// Gets file path.
+		/// \return File path.
+		const std::string& getPath() const noexcept {
+			return path_;
+		}
+
+	private:
+
+		/// File path.
+		std::string path_;
+	};
+
+	/// Creates an endpoint.
+	/// \param[in]	ip		IP address.
+	/// \param[in]	port	Port.
+	/// \return Endpoint.
+	boost::asio::ip::udp::endpoint createEndpoint(const std::string& ip,
+	                                              std::uint16_t port) {
+		return boost::asio::ip::udp::endpoint(
+			boost::asio::ip::make_address(ip), port);
+	}
+}
+
+TEST(PelcoDECalibrationCacheTest, ReloadsSavedCalibrations) {
+	TemporaryFile file;
+
+	{
+		PelcoDECalibrationCache cache(file.getPath());
+		cache.insert(createEndpoint("192.168.0.10", 4000), 1, { 36000, 13500 });
+		cache.insert(createEndpoint("fe80::1", 4001), 2, { 18000, 9000 });
+		cache.save();
+	}
+
+	PelcoDECalibrationCache cache(file.getPath());
+	Calibration calibration {};
+
+	ASSERT_TRUE(cache.find(createEndpoint("192.168.0.10", 4000), 1,
+	                       calibration));
+	EXPECT_EQ(36000, calibration.panMaxSteps);
+	EXPECT_EQ(13500, calibration.tiltMaxSteps);
+
+	ASSERT_TRUE(cache.find(createEndpoint("fe80::1", 4001), 2, calibration));
+	EXPECT_EQ(18000, calibration.panMaxSteps);
+	EXPECT_EQ(9000, calibration.tiltMaxSteps);
+
+	EXPECT_FALSE(cache.find(createEndpoint("192.168.0.10", 4000), 2,
+	                        calibration));
+}
+
+TEST(PelcoDECalibrationCacheTest, SkipsMalformedLines) {
+	TemporaryFile file;
+
+	{
+		std::ofstream stream(file.getPath());
+		stream << "10.0.0.1 4000 1 36000 13500\n"
+		       << "garbage\n"
+		       << "10.0.0.2 4000 1 0 13500\n"
+		       << "10.0.0.3 4000 1 36000 0\n"
+		       << "10.0.0.4 70000 1 36000 13500\n"
+		       << "10.0.0.5 4000 1 36000\n"
+		       << "10.0.0.6 4000 1 36000 13500\n";
+	}
+
+	PelcoDECalibrationCache cache(file.getPath());
+	Calibration calibration {};
+
+	EXPECT_TRUE(cache.find(createEndpoint("10.0.0.1", 4000), 1, calibration));
+	EXPECT_FALSE(cache.find(createEndpoint("10.0.0.2", 4000), 1, calibration));
+	EXPECT_FALSE(cache.find(createEndpoint("10.0.0.3", 4000), 1, calibration));
+	EXPECT_FALSE(cache.find(createEndpoint("10.0.0.4", 70000 & 0xFFFF), 1,
+	                        calibration));
+	EXPECT_FALSE(cache.find(createEndpoint("10.0.0.5", 4000), 1, calibration));
+	EXPECT_TRUE(cache.find(createEndpoint("10.0.0.6", 4000), 1, calibration));
+}
+
+TEST(PelcoDECalibrationCacheTest, RejectsZeroSteps) {
+	TemporaryFile file;
+	PelcoDECalibrationCache cache(file.getPath());
+
+	EXPECT_THROW(cache.insert(createEndpoint("10.0.0.1", 4000), 1,
+	                          { 0, 13500 }),
+	             std::invalid_argument);
+}
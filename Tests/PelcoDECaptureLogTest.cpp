@@ -0,0 +1,185 @@
+/// \file PelcoDECaptureLogTest.cpp
+/// \brief Contains tests of Pelco-DE capture log.
+/// \bug No known bugs.
+
+#include "PelcoDECaptureLog.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Size of the capture file header.
+	constexpr std::streamoff HEADER_SIZE { 64 };
+
+	/// Size of a record.
+	constexpr std::streamoff RECORD_SIZE { 40 };
+
+	/// Offset of the flag that is set when the record is complete.
+	constexpr std::streamoff COMMITTED_OFFSET { 27 };
+
+	/// Temporary file that is removed on destruction.
+	class TemporaryFile {
+	public:
+
+		/// Constructor.
+		/// \details Creates an empty file with a unique name.
+		TemporaryFile() {
+			char name[] = "/tmp/PelcoDECaptureLogTest.XXXXXX";
+			auto descriptor = mkstemp(name);
+
+			if (descriptor < 0) {
+				throw std::runtime_error("The file cannot be created!");
+			}
+
+			close(descriptor);
+			path_ = name;
+		}
+
+		/// Destructor.
+		~TemporaryFile() {
+			std::remove(path_.c_str());
+		}
+
+		TemporaryFile(const TemporaryFile&) = delete;
+		TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+		/// Gets file path.
+		/// \return File path.
+		const std::string& getPath() const noexcept {
+			return path_;
+		}
+
+	private:
+
+		/// File path.
+		std::string path_;
+	};
+
+	/// Creates an endpoint.
+	/// \param[in]	ip		IP address.
+	/// \param[in]	port	Port.
+	/// \return Endpoint.
+	boost::asio::ip::udp::endpoint createEndpoint(const std::string& ip,
+	                                              std::uint16_t port) {
+		return boost::asio::ip::udp::endpoint(
+			boost::asio::ip::make_address(ip), port);
+	}
+
+	/// Records frames with distinct values.
+	/// \param[in]	log		Capture log.
+	/// \param[in]	count	Number of frames.
+	void recordFrames(PelcoDECaptureLog& log, std::uint16_t count) {
+		for (std::uint16_t i = 0; i < count; ++i) {
+			log.record(PelcoDECaptureLog::Direction::Sent,
+			           createEndpoint("10.0.0.1", 4000),
+			           Codec::createFrame(
+			               1, Codec::COMMAND_REQUEST_SET_PAN_STEPS, i),
+			           std::chrono::steady_clock::now());
+		}
+	}
+}
+
+TEST(PelcoDECaptureLogTest, ReadsWrittenRecords) {
+	TemporaryFile file;
+
+	auto sent = Codec::createFrame(1, Codec::COMMAND_REQUEST_GET_PAN_STEPS, 0);
+	auto received = Codec::createFrame(
+		2, Codec::COMMAND_RESPONSE_GET_TILT_STEPS, 1234);
+	auto time = std::chrono::steady_clock::now();
+
+	{
+		PelcoDECaptureLog log(file.getPath(), 8);
+
+		log.record(PelcoDECaptureLog::Direction::Sent,
+		           createEndpoint("192.168.0.10", 4000), sent,
+		           time + std::chrono::milliseconds(1));
+		log.record(PelcoDECaptureLog::Direction::Received,
+		           createEndpoint("fe80::1", 4001), received,
+		           time + std::chrono::milliseconds(2));
+
+		EXPECT_EQ(2u, log.getCount());
+		log.flush();
+	}
+
+	auto records = PelcoDECaptureLog::read(file.getPath());
+
+	ASSERT_EQ(2u, records.size());
+
+	EXPECT_EQ(PelcoDECaptureLog::Direction::Sent, records[0].direction);
+	EXPECT_EQ(createEndpoint("192.168.0.10", 4000), records[0].endpoint);
+	EXPECT_TRUE(records[0].endpoint.address().is_v4());
+	EXPECT_EQ(sent, records[0].frame);
+
+	EXPECT_EQ(PelcoDECaptureLog::Direction::Received, records[1].direction);
+	EXPECT_EQ(createEndpoint("fe80::1", 4001), records[1].endpoint);
+	EXPECT_EQ(received, records[1].frame);
+
+	EXPECT_LT(records[0].time, records[1].time);
+}
+
+TEST(PelcoDECaptureLogTest, SkipsUncommittedRecords) {
+	TemporaryFile file;
+
+	{
+		PelcoDECaptureLog log(file.getPath(), 4);
+		recordFrames(log, 3);
+	}
+
+	{
+		std::fstream stream(file.getPath(), std::ios::in | std::ios::out |
+		                                    std::ios::binary);
+		stream.seekp(HEADER_SIZE + RECORD_SIZE + COMMITTED_OFFSET);
+		stream.put(0);
+		ASSERT_TRUE(stream.good());
+	}
+
+	auto records = PelcoDECaptureLog::read(file.getPath());
+
+	ASSERT_EQ(2u, records.size());
+	EXPECT_EQ(0, Codec::FrameView(records[0].frame).getValue());
+	EXPECT_EQ(2, Codec::FrameView(records[1].frame).getValue());
+}
+
+TEST(PelcoDECaptureLogTest, CountsRecordsDroppedAtCapacity) {
+	TemporaryFile file;
+
+	{
+		PelcoDECaptureLog log(file.getPath(), 4);
+		recordFrames(log, 7);
+
+		EXPECT_EQ(4u, log.getCount());
+		EXPECT_EQ(3u, log.getDropped());
+		EXPECT_EQ(4u, log.getCapacity());
+	}
+
+	auto records = PelcoDECaptureLog::read(file.getPath());
+
+	ASSERT_EQ(4u, records.size());
+	EXPECT_EQ(3, Codec::FrameView(records[3].frame).getValue());
+}
+
+TEST(PelcoDECaptureLogTest, RejectsInvalidFiles) {
+	TemporaryFile file;
+
+	EXPECT_THROW(PelcoDECaptureLog(file.getPath(), 0), std::invalid_argument);
+	EXPECT_THROW(PelcoDECaptureLog::read(file.getPath()), std::runtime_error);
+
+	{
+		std::ofstream stream(file.getPath());
+		stream << std::string(HEADER_SIZE, 'x');
+	}
+
+	EXPECT_THROW(PelcoDECaptureLog::read(file.getPath()), std::runtime_error);
+}
@@ -0,0 +1,137 @@
+/// \file PelcoDEDeviceTCPTest.cpp
+/// \brief Contains tests of Pelco-DE TCP device.
+/// \bug No known bugs.
+
+#include "PelcoDEDeviceTCP.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Creates a listening socket on an ephemeral loopback port.
+	/// \param[in]	context	I/O context.
+	/// \return Listening socket.
+	boost::asio::ip::tcp::acceptor createAcceptor(
+		boost::asio::io_context& context) {
+
+		return boost::asio::ip::tcp::acceptor(
+			context, boost::asio::ip::tcp::endpoint(
+				boost::asio::ip::address_v4::loopback(), 0));
+	}
+
+	/// Creates a retransmission policy with short timeouts.
+	/// \return Retransmission policy.
+	RetransmissionPolicy createPolicy() {
+		RetransmissionPolicy policy;
+		policy.initialTimeout = std::chrono::milliseconds(50);
+		policy.minTimeout = policy.initialTimeout;
+		policy.maxTimeout = std::chrono::milliseconds(1000);
+		policy.deadline = std::chrono::milliseconds(5000);
+		return policy;
+	}
+
+	/// Answers a request.
+	/// \param[in]	socket	Connected socket.
+	/// \param[in]	delay	Delay before the response.
+	void respond(boost::asio::ip::tcp::socket& socket,
+	             std::chrono::milliseconds delay) {
+
+		Codec::Frame request;
+		boost::asio::read(socket, boost::asio::buffer(request));
+
+		std::this_thread::sleep_for(delay);
+
+		Codec::FrameView frame(request);
+		auto response = Codec::createFrame(
+			frame.getAddress(),
+			Codec::getResponseCommand(frame.getCommand()), 1234);
+
+		boost::asio::write(socket, boost::asio::buffer(response));
+	}
+}
+
+TEST(PelcoDEDeviceTCPTest, KeepsConnectionAfterLateResponse) {
+	boost::asio::io_context context;
+	auto acceptor = createAcceptor(context);
+
+	PelcoDEDeviceTCP device("127.0.0.1", acceptor.local_endpoint().port());
+	device.setRetransmissionPolicy(createPolicy());
+
+	boost::asio::ip::tcp::socket socket(context);
+
+	std::thread server([&acceptor, &socket]() {
+		acceptor.accept(socket);
+		respond(socket, std::chrono::milliseconds(120));
+		respond(socket, std::chrono::milliseconds(0));
+	});
+
+	EXPECT_EQ(1234, device.getPanSteps());
+	EXPECT_EQ(1234, device.getTiltSteps());
+
+	server.join();
+
+	boost::system::error_code error;
+	acceptor.non_blocking(true);
+	acceptor.accept(error);
+
+	EXPECT_EQ(boost::asio::error::would_block, error);
+	EXPECT_TRUE(device.isConnected());
+}
+
+TEST(PelcoDEDeviceTCPTest, ReconnectsAfterRepeatedMisses) {
+	boost::asio::io_context context;
+	auto acceptor = createAcceptor(context);
+
+	PelcoDEDeviceTCP device("127.0.0.1", acceptor.local_endpoint().port());
+	device.setRetransmissionPolicy(createPolicy());
+
+	std::thread server([&acceptor]() {
+		auto silent = acceptor.accept();
+		Codec::Frame request;
+		boost::asio::read(silent, boost::asio::buffer(request));
+
+		auto socket = acceptor.accept();
+		respond(socket, std::chrono::milliseconds(0));
+	});
+
+	EXPECT_EQ(1234, device.getPanSteps());
+
+	server.join();
+}
+
+TEST(PelcoDEDeviceTCPTest, DestructorAbortsRequests) {
+	boost::asio::io_context context;
+	std::uint16_t port = 0;
+
+	{
+		auto acceptor = createAcceptor(context);
+		port = acceptor.local_endpoint().port();
+	}
+
+	std::vector<boost::system::error_code> errors;
+
+	{
+		PelcoDEDeviceTCP device("127.0.0.1", port);
+
+		for (int i = 0; i < 3; ++i) {
+			device.asyncRequest(Codec::COMMAND_REQUEST_GET_VOLTAGE, 0,
+				[&errors](const boost::system::error_code& error,
+				          std::uint16_t) {
+					errors.push_back(error);
+				});
+		}
+	}
+
+	ASSERT_EQ(3u, errors.size());
+
+	for (const auto& error : errors) {
+		EXPECT_EQ(boost::asio::error::operation_aborted, error);
+	}
+}
@@ -0,0 +1,299 @@
+/// \file PelcoDEDeviceUDPTest.cpp
+/// \brief Contains tests of Pelco-DE UDP device.
+/// \bug No known bugs.
+
+#include "PelcoDEDeviceUDP.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Loopback peer that stands in for a device.
+	class Peer {
+	public:
+
+		/// Constructor.
+		/// \details Binds to an ephemeral loopback port.
+		Peer()
+			: socket_(context_, boost::asio::ip::udp::endpoint(
+				  boost::asio::ip::address_v4::loopback(), 0)) {
+
+			socket_.non_blocking(true);
+		}
+
+		/// Gets peer port.
+		/// \return Port.
+		std::uint16_t getPort() const {
+			return socket_.local_endpoint().port();
+		}
+
+		/// Receives a request.
+		/// \return Request frame.
+		Codec::Frame receive() {
+			auto deadline =
+				std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+			Codec::Frame frame;
+
+			while (std::chrono::steady_clock::now() < deadline) {
+				boost::system::error_code error;
+				socket_.receive_from(boost::asio::buffer(frame), sender_, 0,
+				                     error);
+
+				if (!error) {
+					return frame;
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			throw std::runtime_error("The request is not received!");
+		}
+
+		/// Answers a request.
+		/// \param[in]	request	Request frame.
+		/// \param[in]	value	Response value.
+		void respond(const Codec::Frame& request, std::uint16_t value) {
+			Codec::FrameView frame(request);
+
+			auto response = Codec::createFrame(
+				frame.getAddress(),
+				Codec::getResponseCommand(frame.getCommand()), value);
+
+			socket_.send_to(boost::asio::buffer(response), sender_);
+		}
+
+	private:
+
+		/// I/O context.
+		boost::asio::io_context context_;
+
+		/// Socket.
+		boost::asio::ip::udp::socket socket_;
+
+		/// Endpoint of the device.
+		boost::asio::ip::udp::endpoint sender_;
+	};
+
+	/// Creates a retransmission policy with short timeouts.
+	/// \return Retransmission policy.
+	RetransmissionPolicy createPolicy() {
+		RetransmissionPolicy policy;
+		policy.initialTimeout = std::chrono::milliseconds(50);
+		policy.minTimeout = policy.initialTimeout;
+		policy.maxTimeout = std::chrono::milliseconds(200);
+		policy.deadline = std::chrono::milliseconds(5000);
+		return policy;
+	}
+
+	/// Gets the command of a frame.
+	/// \param[in]	frame	Frame.
+	/// \return Frame command.
+	std::uint8_t getCommand(const Codec::Frame& frame) {
+		return Codec::FrameView(frame).getCommand();
+	}
+
+	/// Gets the value of a frame.
+	/// \param[in]	frame	Frame.
+	/// \return Frame value.
+	std::uint16_t getValue(const Codec::Frame& frame) {
+		return Codec::FrameView(frame).getValue();
+	}
+
+	/// Standard command sent by a device.
+	struct StandardCase {
+
+		/// Operation whose command bytes the frame carries.
+		Codec::StandardOperation operation;
+
+		/// Sends the command.
+		std::function<void(PelcoDEDeviceUDP&)> send;
+
+		/// Expected frame.
+		Codec::Frame frame;
+	};
+}
+
+TEST(PelcoDEDeviceUDPTest, MatchesResponsesOutOfOrder) {
+	Peer peer;
+	PelcoDEDeviceUDP device("127.0.0.1", peer.getPort());
+	device.setRetransmissionPolicy(createPolicy());
+
+	auto pan = device.getPanStepsAsync();
+	auto tilt = device.getTiltStepsAsync();
+
+	auto first = peer.receive();
+	auto second = peer.receive();
+
+	peer.respond(second, 567);
+	peer.respond(first, 1234);
+
+	EXPECT_EQ(1234, pan.get());
+	EXPECT_EQ(567, tilt.get());
+}
+
+TEST(PelcoDEDeviceUDPTest, RetransmitsAfterDroppedResponse) {
+	Peer peer;
+	PelcoDEDeviceUDP device("127.0.0.1", peer.getPort());
+	device.setRetransmissionPolicy(createPolicy());
+
+	auto pan = device.getPanStepsAsync();
+
+	auto dropped = peer.receive();
+	auto retransmitted = peer.receive();
+
+	EXPECT_EQ(dropped, retransmitted);
+
+	peer.respond(retransmitted, 1234);
+
+	EXPECT_EQ(1234, pan.get());
+}
+
+TEST(PelcoDEDeviceUDPTest, SendsPositionAsOneExchange) {
+	Peer peer;
+	PelcoDEDeviceUDP device("127.0.0.1", peer.getPort());
+	device.setRetransmissionPolicy(createPolicy());
+
+	auto position = device.setPositionAsync(10, 20);
+	auto pan = device.setPanStepsAsync(30);
+
+	auto first = peer.receive();
+	auto second = peer.receive();
+
+	EXPECT_EQ(Codec::COMMAND_REQUEST_SET_PAN_STEPS, getCommand(first));
+	EXPECT_EQ(10, getValue(first));
+	EXPECT_EQ(Codec::COMMAND_REQUEST_SET_TILT_STEPS, getCommand(second));
+	EXPECT_EQ(20, getValue(second));
+
+	peer.respond(second, 20);
+
+	auto pair = std::vector<Codec::Frame> { peer.receive(), peer.receive() };
+
+	EXPECT_EQ((std::vector<Codec::Frame> { first, second }), pair);
+
+	peer.respond(pair[0], 10);
+	peer.respond(pair[1], 20);
+
+	EXPECT_NO_THROW(position.get());
+
+	auto deferred = peer.receive();
+
+	EXPECT_EQ(Codec::COMMAND_REQUEST_SET_PAN_STEPS, getCommand(deferred));
+	EXPECT_EQ(30, getValue(deferred));
+
+	peer.respond(deferred, 30);
+
+	EXPECT_NO_THROW(pan.get());
+}
+
+TEST(PelcoDEDeviceUDPTest, FailsAfterDeadline) {
+	Peer peer;
+	PelcoDEDeviceUDP device("127.0.0.1", peer.getPort());
+
+	auto policy = createPolicy();
+	policy.deadline = std::chrono::milliseconds(200);
+	device.setRetransmissionPolicy(policy);
+
+	auto pan = device.getPanStepsAsync();
+
+	try {
+		pan.get();
+		FAIL() << "The request is completed without a response.";
+	} catch (const boost::system::system_error& exception) {
+		EXPECT_EQ(boost::asio::error::timed_out, exception.code());
+	}
+}
+
+TEST(PelcoDEDeviceUDPTest, DestructorAbortsRequests) {
+	Peer peer;
+	std::vector<boost::system::error_code> errors;
+
+	{
+		PelcoDEDeviceUDP device("127.0.0.1", peer.getPort());
+
+		for (int i = 0; i < 3; ++i) {
+			device.asyncGetVoltage(
+				[&errors](const boost::system::error_code& error, double) {
+					errors.push_back(error);
+				});
+		}
+
+		peer.receive();
+	}
+
+	ASSERT_EQ(3u, errors.size());
+
+	for (const auto& error : errors) {
+		EXPECT_EQ(boost::asio::error::operation_aborted, error);
+	}
+}
+
+TEST(PelcoDEDeviceUDPTest, SendsStandardCommandFrames) {
+	using Operation = Codec::StandardOperation;
+
+	const StandardCase cases[] {
+		{ Operation::SetPreset,
+		  [](PelcoDEDeviceUDP& device) { device.setPreset(5); },
+		  {{ 0xFF, 0x01, 0x00, 0x03, 0x00, 0x05, 0x09 }} },
+		{ Operation::ClearPreset,
+		  [](PelcoDEDeviceUDP& device) { device.clearPreset(5); },
+		  {{ 0xFF, 0x01, 0x00, 0x05, 0x00, 0x05, 0x0B }} },
+		{ Operation::GoToPreset,
+		  [](PelcoDEDeviceUDP& device) { device.goToPreset(5); },
+		  {{ 0xFF, 0x01, 0x00, 0x07, 0x00, 0x05, 0x0D }} },
+		{ Operation::ZoomTele,
+		  [](PelcoDEDeviceUDP& device) { device.move({ 0, 0, 1, 0 }); },
+		  {{ 0xFF, 0x01, 0x00, 0x20, 0x00, 0x00, 0x21 }} },
+		{ Operation::ZoomWide,
+		  [](PelcoDEDeviceUDP& device) { device.move({ 0, 0, -1, 0 }); },
+		  {{ 0xFF, 0x01, 0x00, 0x40, 0x00, 0x00, 0x41 }} },
+		{ Operation::FocusFar,
+		  [](PelcoDEDeviceUDP& device) { device.move({ 0, 0, 0, 1 }); },
+		  {{ 0xFF, 0x01, 0x00, 0x80, 0x00, 0x00, 0x81 }} },
+		{ Operation::FocusNear,
+		  [](PelcoDEDeviceUDP& device) { device.move({ 0, 0, 0, -1 }); },
+		  {{ 0xFF, 0x01, 0x01, 0x00, 0x00, 0x00, 0x02 }} },
+		{ Operation::SetZoomSpeed,
+		  [](PelcoDEDeviceUDP& device) { device.setZoomSpeed(2); },
+		  {{ 0xFF, 0x01, 0x00, 0x25, 0x00, 0x02, 0x28 }} },
+		{ Operation::SetFocusSpeed,
+		  [](PelcoDEDeviceUDP& device) { device.setFocusSpeed(3); },
+		  {{ 0xFF, 0x01, 0x00, 0x27, 0x00, 0x03, 0x2B }} }
+	};
+
+	Peer peer;
+	PelcoDEDeviceUDP device("127.0.0.1", peer.getPort());
+
+	for (const auto& test : cases) {
+		auto command = Codec::STANDARD_COMMANDS[
+			static_cast<std::size_t>(test.operation)];
+
+		test.send(device);
+
+		auto frame = peer.receive();
+
+		EXPECT_EQ(test.frame, frame);
+		EXPECT_EQ(command.command1, frame[Codec::COMMAND1_BYTE_INDEX]);
+		EXPECT_EQ(command.command2, frame[Codec::COMMAND2_BYTE_INDEX]);
+	}
+
+	device.stop();
+
+	EXPECT_EQ((Codec::Frame {{ 0xFF, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01 }}),
+	          peer.receive());
+
+	EXPECT_THROW(device.goToPreset(0), std::invalid_argument);
+	EXPECT_THROW(device.setZoomSpeed(4), std::invalid_argument);
+}
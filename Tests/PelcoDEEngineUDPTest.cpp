@@ -0,0 +1,245 @@
+/// \file PelcoDEEngineUDPTest.cpp
+/// \brief Contains tests of Pelco-DE UDP engine.
+/// \bug No known bugs.
+
+#include "PelcoDEEngineUDP.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Number of endpoints placed on the hash ring.
+	constexpr std::uint16_t ENDPOINT_COUNT { 400 };
+
+	/// Responder that answers requests on several loopback ports.
+	class Responder {
+	public:
+
+		/// Constructor.
+		/// \details Binds sockets to ephemeral loopback ports and starts
+		/// answering.
+		/// \param[in]	socketCount	Number of sockets.
+		/// \param[in]	addresses	Addresses of devices that answer.
+		Responder(std::size_t socketCount, std::set<std::uint8_t> addresses)
+			: addresses_(std::move(addresses)),
+			  running_(true) {
+
+			for (std::size_t i = 0; i < socketCount; ++i) {
+				sockets_.emplace_back(new boost::asio::ip::udp::socket(
+					context_, boost::asio::ip::udp::endpoint(
+						boost::asio::ip::address_v4::loopback(), 0)));
+				sockets_.back()->non_blocking(true);
+			}
+
+			thread_ = std::thread([this]() { run(); });
+		}
+
+		/// Destructor.
+		~Responder() {
+			running_ = false;
+			thread_.join();
+		}
+
+		Responder(const Responder&) = delete;
+		Responder& operator=(const Responder&) = delete;
+
+		/// Gets port of a socket.
+		/// \param[in]	socket	Socket index.
+		/// \return Port.
+		std::uint16_t getPort(std::size_t socket) const {
+			return sockets_[socket]->local_endpoint().port();
+		}
+
+	private:
+
+		/// Answers requests until stopped.
+		void run() {
+			while (running_) {
+				auto idle = true;
+
+				for (auto& socket : sockets_) {
+					Codec::Frame request;
+					boost::asio::ip::udp::endpoint sender;
+					boost::system::error_code error;
+
+					socket->receive_from(boost::asio::buffer(request), sender,
+					                     0, error);
+
+					if (error) {
+						continue;
+					}
+
+					Codec::FrameView frame(request);
+
+					if (!addresses_.count(frame.getAddress())) {
+						continue;
+					}
+
+					idle = false;
+
+					auto response = Codec::createFrame(
+						frame.getAddress(),
+						Codec::getResponseCommand(frame.getCommand()), 1234);
+
+					socket->send_to(boost::asio::buffer(response), sender, 0,
+					                error);
+				}
+
+				if (idle) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+			}
+		}
+
+	private:
+
+		/// I/O context.
+		boost::asio::io_context context_;
+
+		/// Sockets.
+		std::vector<std::unique_ptr<boost::asio::ip::udp::socket>> sockets_;
+
+		/// Addresses of devices that answer.
+		std::set<std::uint8_t> addresses_;
+
+		/// Whether the responder is running.
+		std::atomic<bool> running_;
+
+		/// Responder thread.
+		std::thread thread_;
+	};
+
+	/// Adds a device and finds its shard.
+	/// \param[in]	engine	Engine.
+	/// \param[in]	port	Device port.
+	/// \param[in]	address	Device address.
+	/// \param[out]	shard	Shard of the device.
+	/// \return Device.
+	PelcoDEDeviceUDP& addDevice(PelcoDEEngineUDP& engine,
+	                            std::uint16_t port,
+	                            std::uint8_t address,
+	                            std::size_t& shard) {
+		std::vector<std::size_t> counts;
+
+		for (std::size_t i = 0; i < engine.getShardCount(); ++i) {
+			counts.push_back(engine.getDeviceCount(i));
+		}
+
+		auto& device = engine.addDevice("127.0.0.1", port, 360, 135, address);
+
+		for (shard = 0; shard < counts.size(); ++shard) {
+			if (engine.getDeviceCount(shard) != counts[shard]) {
+				break;
+			}
+		}
+
+		return device;
+	}
+
+	/// Places endpoints on the hash ring of an engine.
+	/// \param[in]	shardCount	Number of shards.
+	/// \return Shards of endpoints.
+	std::vector<std::size_t> place(std::size_t shardCount) {
+		PelcoDEEngineUDP engine(shardCount);
+		std::vector<std::size_t> shards;
+
+		for (std::uint16_t i = 0; i < ENDPOINT_COUNT; ++i) {
+			std::size_t shard = 0;
+			addDevice(engine, static_cast<std::uint16_t>(10000 + i), 1, shard);
+			shards.push_back(shard);
+		}
+
+		return shards;
+	}
+}
+
+TEST(PelcoDEEngineUDPTest, KeepsOwnershipWhenShardIsAdded) {
+	auto before = place(4);
+
+	EXPECT_EQ(before, place(4));
+
+	auto after = place(5);
+	std::size_t moved = 0;
+
+	for (std::size_t i = 0; i < before.size(); ++i) {
+		if (before[i] != after[i]) {
+			EXPECT_EQ(4u, after[i]) << "Endpoint " << i;
+			++moved;
+		}
+	}
+
+	EXPECT_LT(0u, moved);
+	EXPECT_GT(ENDPOINT_COUNT / 2u, moved);
+}
+
+TEST(PelcoDEEngineUDPTest, ForwardsResponsesToOwningShard) {
+	boost::asio::io_context context;
+	boost::asio::ip::udp::endpoint local;
+
+	{
+		boost::asio::ip::udp::socket socket(
+			context, boost::asio::ip::udp::endpoint(
+				boost::asio::ip::address_v4::loopback(), 0));
+		local = socket.local_endpoint();
+	}
+
+	Responder responder(16, { 1 });
+	PelcoDEEngineUDP engine(4, local, true);
+	std::vector<PelcoDEDeviceUDP*> devices;
+
+	for (std::size_t i = 0; i < 16; ++i) {
+		devices.push_back(
+			&engine.addDevice("127.0.0.1", responder.getPort(i)));
+	}
+
+	for (auto device : devices) {
+		EXPECT_EQ(1234, device->getPanSteps());
+	}
+
+#if defined(PELCOD_ENABLE_METRICS)
+	EXPECT_LT(0u, engine.getMetrics().forwarded);
+#endif
+}
+
+TEST(PelcoDEEngineUDPTest, RebalancesIdleDevicesOnly) {
+	Responder responder(1, { 1, 3 });
+	PelcoDEEngineUDP engine(2);
+
+	std::size_t shard = 0;
+	auto& busy = addDevice(engine, responder.getPort(0), 2, shard);
+	auto& first = addDevice(engine, responder.getPort(0), 1, shard);
+	auto& second = addDevice(engine, responder.getPort(0), 3, shard);
+
+	ASSERT_EQ(3u, engine.getDeviceCount(shard));
+
+	std::vector<std::future<std::uint16_t>> pending;
+
+	for (int i = 0; i < 3; ++i) {
+		pending.push_back(busy.getPanStepsAsync());
+	}
+
+	first.getPanSteps();
+	first.getPanSteps();
+	second.getPanSteps();
+
+	EXPECT_EQ(2u, engine.rebalance(1.0));
+	EXPECT_EQ(1u, engine.getDeviceCount(shard));
+	EXPECT_EQ(2u, engine.getDeviceCount(1 - shard));
+
+	EXPECT_EQ(1234, first.getPanSteps());
+	EXPECT_EQ(1234, second.getPanSteps());
+}
@@ -0,0 +1,146 @@
+/// \file PelcoDEGroupUDPTest.cpp
+/// \brief Contains tests of Pelco-DE UDP group.
+/// \bug No known bugs.
+
+#include "PelcoDEGroupUDP.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Responder that answers requests for several device addresses.
+	class Responder {
+	public:
+
+		/// Constructor.
+		/// \details Binds to an ephemeral loopback port and starts answering.
+		/// \param[in]	addresses	Addresses of devices that answer.
+		explicit Responder(std::set<std::uint8_t> addresses)
+			: socket_(context_, boost::asio::ip::udp::endpoint(
+				  boost::asio::ip::address_v4::loopback(), 0)),
+			  addresses_(std::move(addresses)),
+			  running_(true),
+			  thread_([this]() { run(); }) {
+		}
+
+		/// Destructor.
+		~Responder() {
+			running_ = false;
+			thread_.join();
+		}
+
+		Responder(const Responder&) = delete;
+		Responder& operator=(const Responder&) = delete;
+
+		/// Gets responder endpoint.
+		/// \return Responder endpoint.
+		boost::asio::ip::udp::endpoint getEndpoint() const {
+			return socket_.local_endpoint();
+		}
+
+	private:
+
+		/// Answers requests until stopped. A broadcast request is answered
+		/// for every address.
+		void run() {
+			socket_.non_blocking(true);
+
+			while (running_) {
+				Codec::Frame request;
+				boost::asio::ip::udp::endpoint sender;
+				boost::system::error_code error;
+
+				socket_.receive_from(boost::asio::buffer(request), sender, 0,
+				                     error);
+
+				if (error) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					continue;
+				}
+
+				Codec::FrameView frame(request);
+
+				for (auto address : addresses_) {
+					if (frame.getAddress() != address &&
+					    frame.getAddress() != Codec::ADDRESS_BROADCAST) {
+						continue;
+					}
+
+					auto response = Codec::createFrame(
+						address, Codec::getResponseCommand(frame.getCommand()),
+						frame.getValue());
+
+					socket_.send_to(boost::asio::buffer(response), sender, 0,
+					                error);
+				}
+			}
+		}
+
+	private:
+
+		/// I/O context.
+		boost::asio::io_context context_;
+
+		/// Socket.
+		boost::asio::ip::udp::socket socket_;
+
+		/// Addresses of devices that answer.
+		std::set<std::uint8_t> addresses_;
+
+		/// Whether the responder is running.
+		std::atomic<bool> running_;
+
+		/// Responder thread.
+		std::thread thread_;
+	};
+}
+
+TEST(PelcoDEGroupUDPTest, ReportsSilentDevice) {
+	Responder responder({ 1, 2 });
+
+	PelcoDEFleetUDP fleet;
+	std::thread thread([&fleet]() { fleet.run(); });
+
+	RetransmissionPolicy policy;
+	policy.initialTimeout = std::chrono::milliseconds(50);
+	policy.minTimeout = policy.initialTimeout;
+	policy.maxTimeout = std::chrono::milliseconds(100);
+	policy.deadline = std::chrono::milliseconds(500);
+
+	std::vector<std::unique_ptr<PelcoDEDeviceUDP>> devices;
+	PelcoDEGroupUDP group(fleet, responder.getEndpoint());
+
+	for (std::uint8_t address = 1; address <= 3; ++address) {
+		devices.emplace_back(new PelcoDEDeviceUDP(
+			fleet, responder.getEndpoint(), 360, 135, address));
+		devices.back()->setRetransmissionPolicy(policy);
+		group.addDevice(*devices.back());
+	}
+
+	auto report = group.setPosition(1000, 2000);
+
+	ASSERT_EQ(3u, report.results.size());
+	EXPECT_EQ(2u, report.acknowledged);
+
+	for (const auto& result : report.results) {
+		if (result.device == devices.back().get()) {
+			EXPECT_EQ(boost::asio::error::timed_out, result.error);
+		} else {
+			EXPECT_FALSE(result.error);
+		}
+	}
+
+	devices.clear();
+	fleet.stop();
+	thread.join();
+}
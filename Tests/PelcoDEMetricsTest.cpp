@@ -0,0 +1,72 @@
+/// \file PelcoDEMetricsTest.cpp
+/// \brief Contains tests of Pelco-DE metrics.
+/// \bug No known bugs.
+
+#include "PelcoDEMetrics.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Records values to a histogram and takes a snapshot.
+	/// \param[in]	values	Values in microseconds.
+	/// \return Snapshot.
+	HistogramSnapshot createSnapshot(
+		std::initializer_list<std::int64_t> values) {
+
+		LatencyHistogram histogram;
+
+		for (auto value : values) {
+			histogram.record(std::chrono::microseconds(value));
+		}
+
+		return histogram.getSnapshot();
+	}
+}
+
+TEST(PelcoDEMetricsTest, MapsBoundsOfEveryBucketToItself) {
+	for (std::size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+		auto lower = LatencyHistogram::getLowerBound(i);
+		auto upper = LatencyHistogram::getUpperBound(i);
+
+		ASSERT_LE(lower, upper) << "Bucket " << i;
+		ASSERT_EQ(i, LatencyHistogram::getBucket(lower)) << "Bucket " << i;
+		ASSERT_EQ(i, LatencyHistogram::getBucket(upper)) << "Bucket " << i;
+	}
+}
+
+TEST(PelcoDEMetricsTest, CountsValueExactlyAtBound) {
+	auto snapshot = createSnapshot({ 99, 100, 104 });
+
+	ASSERT_EQ(100u, LatencyHistogram::getLowerBound(
+		LatencyHistogram::getBucket(100)));
+
+	EXPECT_EQ(1u, snapshot.getCountBelow(std::chrono::microseconds(99)));
+	EXPECT_EQ(2u, snapshot.getCountBelow(std::chrono::microseconds(100)));
+	EXPECT_EQ(2u, snapshot.getCountBelow(std::chrono::microseconds(103)));
+	EXPECT_EQ(3u, snapshot.getCountBelow(std::chrono::microseconds(104)));
+	EXPECT_EQ(0u, snapshot.getCountBelow(std::chrono::microseconds(-1)));
+}
+
+TEST(PelcoDEMetricsTest, CountsBucketOfBoundWhole) {
+	auto snapshot = createSnapshot({ 1000, 1001, 1023, 1024 });
+
+	EXPECT_EQ(3u, snapshot.getCountBelow(std::chrono::milliseconds(1)));
+	EXPECT_EQ(4u, snapshot.getCountBelow(std::chrono::microseconds(1024)));
+}
+
+TEST(PelcoDEMetricsTest, ReportsUpperBoundOfPercentileBucket) {
+	auto snapshot = createSnapshot({ 10, 20, 30, 1000 });
+
+	EXPECT_EQ(std::chrono::microseconds(20), snapshot.getPercentile(0.5));
+	EXPECT_EQ(std::chrono::microseconds(1023), snapshot.getPercentile(1.0));
+	EXPECT_EQ(std::chrono::microseconds(0),
+	          HistogramSnapshot().getPercentile(0.5));
+}
@@ -0,0 +1,101 @@
+/// \file PelcoDEPrometheusExporterTest.cpp
+/// \brief Contains tests of Pelco-DE Prometheus exporter.
+/// \bug No known bugs.
+
+#include "PelcoDEPrometheusExporter.hpp"
+#include "PelcoDECodec.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Checks whether a text contains a whole line.
+	/// \param[in]	text	Text.
+	/// \param[in]	line	Line without line feed.
+	/// \return True if the text contains the line.
+	bool hasLine(const std::string& text, const std::string& line) {
+		return ("\n" + text).find("\n" + line + "\n") != std::string::npos;
+	}
+}
+
+TEST(PelcoDEPrometheusExporterTest, FormatsDeviceMetrics) {
+	DeviceMetrics metrics;
+	metrics.requests = 3;
+	metrics.responses = 2;
+	metrics.timeouts = 1;
+	metrics.latency.record(std::chrono::microseconds(100));
+	metrics.latency.record(std::chrono::microseconds(2000));
+
+	PelcoDEPrometheusExporter exporter;
+	exporter.addDevice("cam \"1\"", metrics.getSnapshot());
+
+	auto text = exporter.toString();
+
+	EXPECT_EQ(0u, text.find("# HELP pelcod_device_requests_total "
+	                        "Number of submitted requests.\n"
+	                        "# TYPE pelcod_device_requests_total counter\n"
+	                        "pelcod_device_requests_total"
+	                        "{device=\"cam \\\"1\\\"\"} 3\n"));
+
+	EXPECT_TRUE(hasLine(text, "pelcod_device_responses_total"
+	                          "{device=\"cam \\\"1\\\"\"} 2"));
+	EXPECT_TRUE(hasLine(text, "pelcod_device_timeouts_total"
+	                          "{device=\"cam \\\"1\\\"\"} 1"));
+	EXPECT_TRUE(hasLine(text, "# TYPE pelcod_device_latency_seconds "
+	                          "histogram"));
+	EXPECT_TRUE(hasLine(text, "pelcod_device_latency_seconds_bucket"
+	                          "{device=\"cam \\\"1\\\"\",le=\"0.0001\"} 1"));
+	EXPECT_TRUE(hasLine(text, "pelcod_device_latency_seconds_bucket"
+	                          "{device=\"cam \\\"1\\\"\",le=\"0.001\"} 1"));
+	EXPECT_TRUE(hasLine(text, "pelcod_device_latency_seconds_bucket"
+	                          "{device=\"cam \\\"1\\\"\",le=\"0.0025\"} 2"));
+	EXPECT_TRUE(hasLine(text, "pelcod_device_latency_seconds_bucket"
+	                          "{device=\"cam \\\"1\\\"\",le=\"+Inf\"} 2"));
+	EXPECT_TRUE(hasLine(text, "pelcod_device_latency_seconds_sum"
+	                          "{device=\"cam \\\"1\\\"\"} 0.0021"));
+	EXPECT_TRUE(hasLine(text, "pelcod_device_latency_seconds_count"
+	                          "{device=\"cam \\\"1\\\"\"} 2"));
+
+	EXPECT_EQ(std::string::npos, text.find("pelcod_fleet_"));
+	EXPECT_EQ(std::string::npos, text.find("pelcod_operation_"));
+}
+
+TEST(PelcoDEPrometheusExporterTest, FormatsFleetMetrics) {
+	FleetMetrics metrics;
+	metrics.sent = 5;
+	metrics.received = 4;
+	metrics.record(Codec::COMMAND_REQUEST_GET_PAN_STEPS,
+	               std::chrono::microseconds(250));
+
+	PelcoDEPrometheusExporter exporter;
+	exporter.addFleet("a", metrics.getSnapshot());
+	exporter.addFleet("b", FleetMetricsSnapshot());
+
+	auto text = exporter.toString();
+
+	EXPECT_TRUE(hasLine(text, "pelcod_fleet_sent_messages_total"
+	                          "{fleet=\"a\"} 5\n"
+	                          "pelcod_fleet_sent_messages_total"
+	                          "{fleet=\"b\"} 0"));
+	EXPECT_TRUE(hasLine(text, "pelcod_fleet_received_messages_total"
+	                          "{fleet=\"a\"} 4"));
+	EXPECT_TRUE(hasLine(text, "pelcod_operation_latency_seconds_bucket"
+	                          "{fleet=\"a\",operation=\"get_pan_steps\","
+	                          "le=\"0.00025\"} 1"));
+	EXPECT_TRUE(hasLine(text, "pelcod_operation_latency_seconds_bucket"
+	                          "{fleet=\"a\",operation=\"get_tilt_steps\","
+	                          "le=\"+Inf\"} 0"));
+	EXPECT_TRUE(hasLine(text, "pelcod_operation_latency_seconds_sum"
+	                          "{fleet=\"a\",operation=\"get_pan_steps\"} "
+	                          "0.00025"));
+	EXPECT_EQ(std::string::npos, text.find("pelcod_device_"));
+
+	exporter.clear();
+
+	EXPECT_TRUE(exporter.toString().empty());
+}
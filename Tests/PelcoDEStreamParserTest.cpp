@@ -0,0 +1,136 @@
+/// \file PelcoDEStreamParserTest.cpp
+/// \brief Contains tests of Pelco-DE byte stream parser.
+/// \bug No known bugs.
+
+#include "PelcoDEStreamParser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Parser that collects emitted frames.
+	struct Collector {
+
+		/// Parses bytes.
+		/// \param[in]	data	Bytes.
+		void parse(const std::vector<std::uint8_t>& data) {
+			parser.parse(data.data(), data.size(),
+				[this](const Codec::FrameView& frame) {
+					values.push_back(frame.getValue());
+				});
+		}
+
+		/// Parser.
+		PelcoDEStreamParser parser;
+
+		/// Values of emitted frames.
+		std::vector<std::uint16_t> values;
+	};
+
+	/// Creates frame bytes.
+	/// \param[in]	value	Frame value.
+	/// \return Frame bytes.
+	std::vector<std::uint8_t> createBytes(std::uint16_t value) {
+		auto frame = Codec::createFrame(
+			1, Codec::COMMAND_RESPONSE_GET_PAN_STEPS, value);
+
+		return std::vector<std::uint8_t>(frame.begin(), frame.end());
+	}
+
+	/// Concatenates byte sequences.
+	/// \param[in]	parts	Byte sequences.
+	/// \return Bytes.
+	std::vector<std::uint8_t> join(
+		std::initializer_list<std::vector<std::uint8_t>> parts) {
+
+		std::vector<std::uint8_t> data;
+
+		for (const auto& part : parts) {
+			data.insert(data.end(), part.begin(), part.end());
+		}
+
+		return data;
+	}
+}
+
+TEST(PelcoDEStreamParserTest, ResynchronizesAfterGarbage) {
+	Collector collector;
+
+	collector.parse(join({
+		{ 0x00, 0x13, 0xFF, 0xFF, 0x42 }, createBytes(7), { 0x55 },
+		createBytes(8) }));
+
+	EXPECT_EQ((std::vector<std::uint16_t> { 7, 8 }), collector.values);
+	EXPECT_EQ(2u, collector.parser.getFrameCount());
+	EXPECT_EQ(6u, collector.parser.getDiscardedCount());
+}
+
+TEST(PelcoDEStreamParserTest, JoinsSplitFrames) {
+	auto data = join({ createBytes(1), createBytes(2), createBytes(3) });
+
+	for (std::size_t chunk = 1; chunk <= data.size(); ++chunk) {
+		Collector collector;
+
+		for (std::size_t i = 0; i < data.size(); i += chunk) {
+			auto end = std::min(i + chunk, data.size());
+			collector.parse(std::vector<std::uint8_t>(
+				data.begin() + static_cast<std::ptrdiff_t>(i),
+				data.begin() + static_cast<std::ptrdiff_t>(end)));
+		}
+
+		EXPECT_EQ((std::vector<std::uint16_t> { 1, 2, 3 }), collector.values)
+			<< "Chunk size " << chunk;
+		EXPECT_EQ(0u, collector.parser.getDiscardedCount());
+	}
+}
+
+TEST(PelcoDEStreamParserTest, SkipsBadChecksums) {
+	auto corrupt = createBytes(5);
+	corrupt[Codec::CHECKSUM_BYTE_INDEX] ^= 0x01;
+
+	Collector whole;
+	whole.parse(join({ corrupt, createBytes(6) }));
+
+	EXPECT_EQ((std::vector<std::uint16_t> { 6 }), whole.values);
+	EXPECT_EQ(corrupt.size(), whole.parser.getDiscardedCount());
+
+	Collector split;
+	split.parse(std::vector<std::uint8_t>(corrupt.begin(), corrupt.end() - 1));
+	split.parse(join({ { corrupt.back() }, createBytes(6) }));
+
+	EXPECT_EQ((std::vector<std::uint16_t> { 6 }), split.values);
+	EXPECT_EQ(corrupt.size(), split.parser.getDiscardedCount());
+}
+
+TEST(PelcoDEStreamParserTest, RecoversFrameOverlappingCorruptOne) {
+	auto frame = createBytes(9);
+	std::vector<std::uint8_t> data { Codec::SYNCHRONIZATION_VALUE, 0x01 };
+	data.insert(data.end(), frame.begin(), frame.end());
+
+	Collector collector;
+	collector.parse(std::vector<std::uint8_t>(data.begin(), data.begin() + 4));
+	collector.parse(std::vector<std::uint8_t>(data.begin() + 4, data.end()));
+
+	EXPECT_EQ((std::vector<std::uint16_t> { 9 }), collector.values);
+	EXPECT_EQ(2u, collector.parser.getDiscardedCount());
+}
+
+TEST(PelcoDEStreamParserTest, ResetDiscardsPartialFrame) {
+	auto frame = createBytes(4);
+
+	Collector collector;
+	collector.parse(std::vector<std::uint8_t>(frame.begin(), frame.begin() + 3));
+	collector.parser.reset();
+	collector.parse(createBytes(4));
+
+	EXPECT_EQ((std::vector<std::uint16_t> { 4 }), collector.values);
+	EXPECT_EQ(3u, collector.parser.getDiscardedCount());
+}
@@ -0,0 +1,186 @@
+/// \file PelcoDEStreamingControllerTest.cpp
+/// \brief Contains tests of Pelco-DE streaming controller.
+/// \bug No known bugs.
+
+#include "PelcoDEStreamingController.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Loopback peer that stands in for a device.
+	class Peer {
+	public:
+
+		/// Constructor.
+		/// \details Binds to an ephemeral loopback port.
+		Peer()
+			: socket_(context_, boost::asio::ip::udp::endpoint(
+				  boost::asio::ip::address_v4::loopback(), 0)) {
+
+			socket_.non_blocking(true);
+		}
+
+		/// Gets peer port.
+		/// \return Port.
+		std::uint16_t getPort() const {
+			return socket_.local_endpoint().port();
+		}
+
+		/// Receives a request.
+		/// \param[out]	frame	Request frame.
+		/// \param[in]	timeout	Time to wait for the request.
+		/// \return True if a request is received.
+		bool receive(Codec::Frame& frame, std::chrono::milliseconds timeout) {
+			auto deadline = std::chrono::steady_clock::now() + timeout;
+
+			do {
+				boost::system::error_code error;
+				socket_.receive_from(boost::asio::buffer(frame), sender_, 0,
+				                     error);
+
+				if (!error) {
+					return true;
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			} while (std::chrono::steady_clock::now() < deadline);
+
+			return false;
+		}
+
+		/// Answers a request.
+		/// \param[in]	request	Request frame.
+		void respond(const Codec::Frame& request) {
+			Codec::FrameView frame(request);
+
+			auto response = Codec::createFrame(
+				frame.getAddress(),
+				Codec::getResponseCommand(frame.getCommand()),
+				frame.getValue());
+
+			socket_.send_to(boost::asio::buffer(response), sender_);
+		}
+
+	private:
+
+		/// I/O context.
+		boost::asio::io_context context_;
+
+		/// Socket.
+		boost::asio::ip::udp::socket socket_;
+
+		/// Endpoint of the device.
+		boost::asio::ip::udp::endpoint sender_;
+	};
+
+	/// Gets the value of a frame.
+	/// \param[in]	frame	Frame.
+	/// \return Frame value.
+	std::uint16_t getValue(const Codec::Frame& frame) {
+		return Codec::FrameView(frame).getValue();
+	}
+}
+
+TEST(PelcoDEStreamingControllerTest, SendsNewestTargetOnly) {
+	Peer peer;
+	PelcoDEDeviceUDP device("127.0.0.1", peer.getPort());
+	PelcoDEStreamingController controller(device,
+	                                      std::chrono::microseconds(0));
+
+	controller.setPanTarget(1);
+
+	Codec::Frame frame;
+	ASSERT_TRUE(peer.receive(frame, std::chrono::seconds(5)));
+	EXPECT_EQ(1, getValue(frame));
+
+	controller.setPanTarget(2);
+	controller.setPanTarget(3);
+	controller.setPanTarget(4);
+
+	EXPECT_EQ(2u, controller.getDroppedCount());
+	EXPECT_TRUE(controller.hasPendingTargets());
+
+	Codec::Frame other;
+
+	while (peer.receive(other, std::chrono::milliseconds(50))) {
+		EXPECT_EQ(1, getValue(other));
+	}
+
+	peer.respond(frame);
+
+	do {
+		ASSERT_TRUE(peer.receive(frame, std::chrono::seconds(5)));
+	} while (getValue(frame) == 1);
+
+	EXPECT_EQ(4, getValue(frame));
+	EXPECT_FALSE(controller.hasPendingTargets());
+
+	peer.respond(frame);
+}
+
+TEST(PelcoDEStreamingControllerTest, AdaptsIntervalToAcknowledgementTime) {
+	Peer peer;
+	PelcoDEDeviceUDP device("127.0.0.1", peer.getPort());
+	PelcoDEStreamingController controller(device,
+	                                      std::chrono::milliseconds(1));
+
+	EXPECT_EQ(std::chrono::milliseconds(1), controller.getInterval());
+
+	controller.setTiltTarget(1);
+
+	Codec::Frame frame;
+	ASSERT_TRUE(peer.receive(frame, std::chrono::seconds(5)));
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(40));
+	peer.respond(frame);
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+	while (controller.getInterval() == std::chrono::milliseconds(1) &&
+	       std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	EXPECT_LE(std::chrono::milliseconds(40), controller.getInterval());
+}
+
+TEST(PelcoDEStreamingControllerTest, ResendsFailedTarget) {
+	Peer peer;
+	PelcoDEDeviceUDP device("127.0.0.1", peer.getPort());
+
+	RetransmissionPolicy policy;
+	policy.initialTimeout = std::chrono::milliseconds(50);
+	policy.minTimeout = policy.initialTimeout;
+	policy.maxTimeout = policy.initialTimeout;
+	policy.deadline = std::chrono::milliseconds(150);
+	device.setRetransmissionPolicy(policy);
+
+	PelcoDEStreamingController controller(device);
+
+	auto started = std::chrono::steady_clock::now();
+	controller.setPanTarget(5);
+
+	Codec::Frame frame;
+	auto resent = false;
+
+	while (!resent && peer.receive(frame, std::chrono::seconds(5))) {
+		EXPECT_EQ(5, getValue(frame));
+		resent = std::chrono::steady_clock::now() - started >
+		         std::chrono::milliseconds(300);
+	}
+
+	ASSERT_TRUE(resent);
+
+	do {
+		peer.respond(frame);
+	} while (peer.receive(frame, std::chrono::milliseconds(200)));
+
+	EXPECT_FALSE(controller.hasPendingTargets());
+}
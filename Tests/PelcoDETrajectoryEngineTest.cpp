@@ -0,0 +1,254 @@
+/// \file PelcoDETrajectoryEngineTest.cpp
+/// \brief Contains tests of Pelco-DE trajectory engine.
+/// \bug No known bugs.
+
+#include "PelcoDETrajectoryEngine.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Device that acknowledges every request.
+	class Responder {
+	public:
+
+		/// Constructor.
+		/// \details Opens a socket on an ephemeral port and starts the thread
+		/// that answers requests.
+		Responder()
+			: socket_(context_, boost::asio::ip::udp::endpoint(
+				boost::asio::ip::address_v4::loopback(), 0)) {
+
+			receive();
+			thread_ = std::thread([this]() { context_.run(); });
+		}
+
+		/// Destructor.
+		/// \details Stops the thread.
+		~Responder() {
+			context_.stop();
+			thread_.join();
+		}
+
+		/// Gets port.
+		/// \return Port of the socket.
+		std::uint16_t getPort() const {
+			return socket_.local_endpoint().port();
+		}
+
+	private:
+
+		/// Answers the next request.
+		void receive() {
+			socket_.async_receive_from(
+				boost::asio::buffer(request_), sender_,
+				[this](const boost::system::error_code& error, std::size_t) {
+					if (error) {
+						return;
+					}
+
+					Codec::FrameView frame(request_);
+
+					if (frame.validate() == Codec::FrameError::None) {
+						response_ = Codec::createFrame(
+							frame.getAddress(),
+							Codec::getResponseCommand(frame.getCommand()),
+							frame.getValue());
+
+						boost::system::error_code ignored;
+						socket_.send_to(boost::asio::buffer(response_), sender_,
+						                0, ignored);
+					}
+
+					receive();
+				});
+		}
+
+		/// I/O context.
+		boost::asio::io_context context_;
+
+		/// Socket.
+		boost::asio::ip::udp::socket socket_;
+
+		/// Request.
+		Codec::Frame request_;
+
+		/// Response.
+		Codec::Frame response_;
+
+		/// Request sender.
+		boost::asio::ip::udp::endpoint sender_;
+
+		/// Thread.
+		std::thread thread_;
+	};
+
+	/// Waits until a device finishes its trajectory.
+	/// \param[in]	engine	Engine.
+	/// \param[in]	device	Device.
+	/// \return True if the trajectory is finished in time.
+	bool waitFinished(PelcoDETrajectoryEngine& engine,
+	                  PelcoDEDeviceUDP& device) {
+		auto deadline =
+			std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+		while (engine.isRunning(device)) {
+			if (std::chrono::steady_clock::now() > deadline) {
+				return false;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return true;
+	}
+}
+
+TEST(PelcoDETrajectoryEngineTest, EvaluatesAtDeadlines) {
+	Responder responder;
+	PelcoDEDeviceUDP device("127.0.0.1", responder.getPort());
+
+	std::chrono::microseconds period(std::chrono::milliseconds(5));
+	PelcoDETrajectoryEngine engine(period);
+
+	std::mutex mutex;
+	std::vector<std::chrono::microseconds> times;
+
+	engine.start(device, [&](std::chrono::microseconds elapsed,
+	                         Position& position) {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		times.push_back(elapsed);
+		position = Position { static_cast<std::uint16_t>(times.size()), 0 };
+
+		return times.size() < 20;
+	});
+
+	ASSERT_TRUE(waitFinished(engine, device));
+
+	std::lock_guard<std::mutex> lock(mutex);
+	ASSERT_EQ(20u, times.size());
+
+	for (std::size_t i = 1; i < times.size(); ++i) {
+		EXPECT_GT(times[i], times[i - 1]);
+		EXPECT_EQ(0, (times[i] - times[0]).count() % period.count());
+	}
+
+	auto statistics = engine.getStatistics();
+	auto periods = (times.back() - times.front()) / period;
+
+	EXPECT_LE(static_cast<std::uint64_t>(periods) + 1,
+	          times.size() + statistics.overruns);
+}
+
+TEST(PelcoDETrajectoryEngineTest, SkipsMissedDeadlines) {
+	Responder responder;
+	PelcoDEDeviceUDP device("127.0.0.1", responder.getPort());
+
+	std::chrono::microseconds period(std::chrono::milliseconds(10));
+	PelcoDETrajectoryEngine engine(period);
+
+	std::mutex mutex;
+	std::vector<std::chrono::microseconds> times;
+
+	engine.start(device, [&](std::chrono::microseconds elapsed,
+	                         Position& position) {
+		std::unique_lock<std::mutex> lock(mutex);
+
+		times.push_back(elapsed);
+		position = Position { static_cast<std::uint16_t>(times.size()), 0 };
+
+		if (times.size() == 1) {
+			lock.unlock();
+			std::this_thread::sleep_for(4 * period + period / 2);
+		}
+
+		return times.size() < 3;
+	});
+
+	ASSERT_TRUE(waitFinished(engine, device));
+
+	std::lock_guard<std::mutex> lock(mutex);
+	ASSERT_EQ(3u, times.size());
+
+	auto skipped = (times[1] - times[0]) / period - 1;
+	auto statistics = engine.getStatistics();
+
+	EXPECT_GE(skipped, 4);
+	EXPECT_EQ(0, (times[1] - times[0]).count() % period.count());
+	EXPECT_GE(statistics.overruns, static_cast<std::uint64_t>(skipped));
+}
+
+TEST(PelcoDETrajectoryEngineTest, RecordsJitterOfEveryTick) {
+	Responder responder;
+	PelcoDEDeviceUDP device("127.0.0.1", responder.getPort());
+
+	PelcoDETrajectoryEngine engine(std::chrono::milliseconds(2));
+
+	std::size_t calls = 0;
+
+	engine.start(device, [&calls](std::chrono::microseconds,
+	                              Position& position) {
+		position = Position { static_cast<std::uint16_t>(++calls), 0 };
+		return calls < 50;
+	});
+
+	ASSERT_TRUE(waitFinished(engine, device));
+
+	auto statistics = engine.getStatistics();
+
+	EXPECT_GE(statistics.ticks, 50u);
+	EXPECT_EQ(statistics.ticks, statistics.jitter.count);
+}
+
+TEST(PelcoDETrajectoryEngineTest, TourInterpolatesWaypoints) {
+	auto tour = PelcoDETrajectoryEngine::createTour({
+		{ 0, 0, std::chrono::milliseconds(500), std::chrono::milliseconds(100) },
+		{ 1000, 500, std::chrono::milliseconds(1000),
+		  std::chrono::milliseconds(0) }
+	}, false);
+
+	Position position { 1, 1 };
+
+	EXPECT_TRUE(tour(std::chrono::milliseconds(0), position));
+	EXPECT_EQ(0, position.panSteps);
+	EXPECT_EQ(0, position.tiltSteps);
+
+	EXPECT_TRUE(tour(std::chrono::milliseconds(600), position));
+	EXPECT_EQ(500, position.panSteps);
+	EXPECT_EQ(250, position.tiltSteps);
+
+	EXPECT_FALSE(tour(std::chrono::milliseconds(1100), position));
+	EXPECT_EQ(1000, position.panSteps);
+	EXPECT_EQ(500, position.tiltSteps);
+}
+
+TEST(PelcoDETrajectoryEngineTest, LoopedTourReturnsToStart) {
+	auto tour = PelcoDETrajectoryEngine::createTour({
+		{ 0, 0, std::chrono::milliseconds(500), std::chrono::milliseconds(100) },
+		{ 1000, 500, std::chrono::milliseconds(1000),
+		  std::chrono::milliseconds(0) }
+	});
+
+	Position position { 1, 1 };
+
+	EXPECT_TRUE(tour(std::chrono::milliseconds(1350), position));
+	EXPECT_EQ(500, position.panSteps);
+	EXPECT_EQ(250, position.tiltSteps);
+
+	EXPECT_TRUE(tour(std::chrono::milliseconds(1600 + 600), position));
+	EXPECT_EQ(500, position.panSteps);
+	EXPECT_EQ(250, position.tiltSteps);
+}
+
+TEST(PelcoDETrajectoryEngineTest, EmptyTourIsRejected) {
+	EXPECT_THROW(PelcoDETrajectoryEngine::createTour({ }),
+	             std::invalid_argument);
+}
@@ -0,0 +1,63 @@
+/// \file RoundTripEstimatorTest.cpp
+/// \brief Contains tests of round-trip time estimation.
+/// \bug No known bugs.
+
+#include "RoundTripEstimator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Creates a retransmission policy with wide timeout bounds.
+	/// \return Retransmission policy.
+	RetransmissionPolicy createPolicy() {
+		RetransmissionPolicy policy;
+		policy.initialTimeout = std::chrono::milliseconds(100);
+		policy.minTimeout = std::chrono::milliseconds(10);
+		policy.maxTimeout = std::chrono::milliseconds(10000);
+		return policy;
+	}
+}
+
+TEST(RoundTripEstimatorTest, DerivesTimeoutFromSamples) {
+	RoundTripEstimator estimator(createPolicy());
+
+	estimator.addSample(std::chrono::milliseconds(20));
+
+	EXPECT_EQ(std::chrono::milliseconds(20), estimator.getSmoothedTime());
+	EXPECT_EQ(std::chrono::milliseconds(10), estimator.getTimeVariation());
+	EXPECT_EQ(std::chrono::milliseconds(60), estimator.getTimeout());
+}
+
+TEST(RoundTripEstimatorTest, BacksOffOncePerBurst) {
+	RoundTripEstimator estimator(createPolicy());
+	auto sent = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < 8; ++i) {
+		estimator.backoff(sent);
+	}
+
+	EXPECT_EQ(std::chrono::milliseconds(200), estimator.getTimeout());
+
+	estimator.backoff(std::chrono::steady_clock::now());
+
+	EXPECT_EQ(std::chrono::milliseconds(400), estimator.getTimeout());
+
+	estimator.backoff(sent);
+
+	EXPECT_EQ(std::chrono::milliseconds(400), estimator.getTimeout());
+}
+
+TEST(RoundTripEstimatorTest, ClampsBackoff) {
+	RoundTripEstimator estimator(createPolicy());
+
+	for (int i = 0; i < 16; ++i) {
+		estimator.backoff();
+	}
+
+	EXPECT_EQ(std::chrono::milliseconds(10000), estimator.getTimeout());
+}
@@ -0,0 +1,590 @@
+/// \file PelcoDBenchmark.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// latency and throughput benchmarks.
+/// \bug No known bugs.
+
+#include "PelcoDEBulkCodec.hpp"
+#include "PelcoDECodec.hpp"
+#include "PelcoDEDeviceUDP.hpp"
+#include "PelcoDEEngineUDP.hpp"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Clock of the benchmarks.
+	using Clock = std::chrono::steady_clock;
+
+	/// Number of operations timed together in codec benchmarks.
+	/// \details Codec operations are shorter than the clock resolution, so
+	/// batches are timed and divided.
+	constexpr std::size_t CODEC_BATCH_SIZE { 64 };
+
+	/// Number of device addresses available on one responder port.
+	/// \details Devices of a port take addresses from 1 to 254, as every
+	/// device needs its own address.
+	constexpr std::size_t ADDRESSES_PER_PORT { 254 };
+
+	/// Benchmark options.
+	struct Options {
+
+		/// Number of samples of every latency benchmark.
+		std::size_t iterations { 10000 };
+
+		/// Duration of every throughput benchmark.
+		std::chrono::milliseconds duration { 1000 };
+
+		/// Device counts of throughput benchmarks.
+		std::vector<std::size_t> deviceCounts { 1, 16, 256 };
+
+		/// Thread counts of throughput benchmarks.
+		std::vector<std::size_t> threadCounts { 1, 2, 4, 8 };
+
+		/// Number of responder ports and threads.
+		std::size_t portCount { 4 };
+	};
+
+	/// Latency distribution.
+	struct Latency {
+
+		/// Operation name.
+		std::string name;
+
+		/// Number of samples.
+		std::size_t samples;
+
+		/// Median in nanoseconds.
+		double p50;
+
+		/// 99th percentile in nanoseconds.
+		double p99;
+
+		/// 99.9th percentile in nanoseconds.
+		double p999;
+
+		/// Maximum in nanoseconds.
+		double max;
+	};
+
+	/// Throughput measurement.
+	struct Throughput {
+
+		/// Number of devices.
+		std::size_t devices;
+
+		/// Number of client threads.
+		std::size_t threads;
+
+		/// Number of operations per second.
+		double operations;
+
+		/// Number of failed operations.
+		std::size_t errors;
+	};
+
+	/// Class that provides loopback responder implementation.
+	/// \details Answers requests of any device address on a few loopback
+	/// ports, one thread per port.
+	class Responder {
+	public:
+
+		/// Constructor.
+		/// \param[in]	portCount	Number of ports.
+		explicit Responder(std::size_t portCount)
+			: running_(true) {
+
+			for (std::size_t i = 0; i < portCount; ++i) {
+				sockets_.emplace_back(new boost::asio::ip::udp::socket(
+					context_, boost::asio::ip::udp::endpoint(
+						boost::asio::ip::address_v4::loopback(), 0)));
+				sockets_.back()->set_option(
+					boost::asio::socket_base::receive_buffer_size(4 << 20));
+			}
+
+			for (auto& socket : sockets_) {
+				threads_.emplace_back([this, &socket]() {
+					serve(*socket);
+				});
+			}
+		}
+
+		/// Destructor.
+		/// \details Stops responder threads, each of them is woken by a
+		/// datagram.
+		~Responder() {
+			running_ = false;
+
+			boost::asio::ip::udp::socket waker(context_,
+			                                   boost::asio::ip::udp::v4());
+
+			for (auto& socket : sockets_) {
+				boost::system::error_code ignored;
+				waker.send_to(boost::asio::buffer("", 1),
+				              socket->local_endpoint(), 0, ignored);
+			}
+
+			for (auto& thread : threads_) {
+				thread.join();
+			}
+		}
+
+	public:
+
+		/// Gets responder ports.
+		/// \return Ports.
+		std::vector<std::uint16_t> getPorts() const {
+			std::vector<std::uint16_t> ports;
+
+			for (const auto& socket : sockets_) {
+				ports.push_back(socket->local_endpoint().port());
+			}
+
+			return ports;
+		}
+
+	private:
+
+		/// Serves a port.
+		/// \param[in]	socket	Socket.
+		void serve(boost::asio::ip::udp::socket& socket) {
+			Codec::Frame request;
+			boost::asio::ip::udp::endpoint sender;
+			boost::system::error_code error;
+
+			while (running_) {
+				auto size = socket.receive_from(boost::asio::buffer(request),
+				                                sender, 0, error);
+				Codec::FrameView frame(request.data(), size);
+
+				if (error || frame.validate() != Codec::FrameError::None) {
+					continue;
+				}
+
+				auto command = frame.getCommand();
+				std::uint16_t value = 0;
+
+				switch (command) {
+				case Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS:
+					value = 36000;
+					break;
+				case Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS:
+					value = 13500;
+					break;
+				case Codec::COMMAND_REQUEST_GET_VOLTAGE:
+					value = 1200;
+					break;
+				default:
+					value = frame.getValue();
+					break;
+				}
+
+				auto response = Codec::createFrame(
+					frame.getAddress(), Codec::getResponseCommand(command),
+					value);
+
+				socket.send_to(boost::asio::buffer(response), sender, 0, error);
+			}
+		}
+
+	private:
+
+		/// I/O context of sockets.
+		boost::asio::io_context context_;
+
+		/// Sockets.
+		std::vector<std::unique_ptr<boost::asio::ip::udp::socket>> sockets_;
+
+		/// Threads.
+		std::vector<std::thread> threads_;
+
+		/// Whether responder threads run.
+		std::atomic<bool> running_;
+	};
+
+	/// Calculates a latency distribution.
+	/// \param[in]	name		Operation name.
+	/// \param[in]	samples		Samples in nanoseconds.
+	/// \return Latency distribution.
+	Latency summarize(const std::string& name, std::vector<double> samples) {
+		std::sort(samples.begin(), samples.end());
+
+		auto percentile = [&samples](double rank) {
+			auto index = static_cast<std::size_t>(rank * samples.size());
+			return samples[std::min(index, samples.size() - 1)];
+		};
+
+		return { name, samples.size(), percentile(0.5), percentile(0.99),
+		         percentile(0.999), samples.back() };
+	}
+
+	/// Measures latency of an operation.
+	/// \param[in]	name		Operation name.
+	/// \param[in]	iterations	Number of samples.
+	/// \param[in]	batch		Number of operations per sample.
+	/// \param[in]	operation	Operation.
+	/// \return Latency distribution.
+	template <typename Operation>
+	Latency measure(const std::string& name,
+	                std::size_t iterations,
+	                std::size_t batch,
+	                Operation operation) {
+		std::vector<double> samples;
+		samples.reserve(iterations);
+
+		for (std::size_t i = 0; i < iterations; ++i) {
+			auto start = Clock::now();
+
+			for (std::size_t j = 0; j < batch; ++j) {
+				operation();
+			}
+
+			samples.push_back(std::chrono::duration<double, std::nano>(
+				Clock::now() - start).count() / batch);
+		}
+
+		return summarize(name, std::move(samples));
+	}
+
+	/// Measures codec latencies.
+	/// \param[in]	options	Benchmark options.
+	/// \return Latency distributions.
+	std::vector<Latency> measureCodec(const Options& options) {
+		std::vector<Latency> latencies;
+		std::array<Codec::Frame, 1024> frames;
+		volatile std::uint16_t sink = 0;
+		std::uint16_t value = 0;
+
+		for (auto& frame : frames) {
+			frame = Codec::createFrame(0x01, Codec::COMMAND_RESPONSE_GET_PAN_STEPS,
+			                           value++);
+		}
+
+		latencies.push_back(measure("encode", options.iterations,
+			CODEC_BATCH_SIZE, [&sink, &value]() {
+				auto frame = Codec::createFrame(
+					0x01, Codec::COMMAND_REQUEST_SET_PAN_STEPS, ++value);
+				sink = frame[Codec::CHECKSUM_BYTE_INDEX];
+			}));
+
+		std::size_t index = 0;
+
+		latencies.push_back(measure("decode", options.iterations,
+			CODEC_BATCH_SIZE, [&sink, &frames, &index]() {
+				Codec::FrameView frame(frames[index++ % frames.size()]);
+
+				if (frame.validateResponse() == Codec::FrameError::None) {
+					sink = frame.getValue();
+				}
+			}));
+
+		std::array<std::uint8_t, 1024> addresses;
+		std::array<std::uint8_t, 1024> commands;
+		std::array<std::uint16_t, 1024> values;
+		std::array<std::uint8_t, 1024> valid;
+		Codec::DecodedFrames decoded {
+			addresses.data(), commands.data(), values.data(), valid.data()
+		};
+
+		latencies.push_back(measure("decode-bulk-1024", options.iterations, 1,
+			[&sink, &frames, &decoded]() {
+				sink = static_cast<std::uint16_t>(Codec::decodeFrames(
+					frames.data(), frames.size(), decoded));
+			}));
+
+		return latencies;
+	}
+
+	/// Measures round-trip latencies of device operations.
+	/// \param[in]	options	Benchmark options.
+	/// \param[in]	port	Responder port.
+	/// \return Latency distributions.
+	std::vector<Latency> measureDevice(const Options& options,
+	                                   std::uint16_t port) {
+		PelcoDEDeviceUDP device("127.0.0.1", port);
+		std::vector<Latency> latencies;
+		std::uint16_t value = 0;
+
+		device.calibrate();
+
+		latencies.push_back(measure("getPanSteps", options.iterations, 1,
+			[&device]() { device.getPanSteps(); }));
+		latencies.push_back(measure("setPanSteps", options.iterations, 1,
+			[&device, &value]() { device.setPanSteps(++value % 36000); }));
+		latencies.push_back(measure("getTiltSteps", options.iterations, 1,
+			[&device]() { device.getTiltSteps(); }));
+		latencies.push_back(measure("setTiltSteps", options.iterations, 1,
+			[&device, &value]() { device.setTiltSteps(++value % 13500); }));
+		latencies.push_back(measure("getPosition", options.iterations, 1,
+			[&device]() { device.getPosition(); }));
+		latencies.push_back(measure("setPosition", options.iterations, 1,
+			[&device, &value]() {
+				++value;
+				device.setPosition(value % 36000, value % 13500);
+			}));
+		latencies.push_back(measure("getTemperature", options.iterations, 1,
+			[&device]() { device.getTemperature(); }));
+		latencies.push_back(measure("getVoltage", options.iterations, 1,
+			[&device]() { device.getVoltage(); }));
+		latencies.push_back(measure("getStatus", options.iterations, 1,
+			[&device]() { device.getStatus(); }));
+
+		return latencies;
+	}
+
+	/// Measures throughput of devices of an engine.
+	/// \details Client threads issue synchronous requests to their share of
+	/// devices in turn for the benchmark duration. Devices are spread over
+	/// the ports and numbered from address 1 on every port.
+	/// \param[in]	options	Benchmark options.
+	/// \param[in]	ports	Responder ports.
+	/// \param[in]	devices	Number of devices.
+	/// \param[in]	threads	Number of client threads.
+	/// \return Throughput measurement.
+	Throughput measureThroughput(const Options& options,
+	                             const std::vector<std::uint16_t>& ports,
+	                             std::size_t devices,
+	                             std::size_t threads) {
+		PelcoDEEngineUDP engine(std::min<std::size_t>(
+			threads, std::max(1u, std::thread::hardware_concurrency())));
+		std::vector<PelcoDEDeviceUDP*> fleet;
+
+		for (std::size_t i = 0; i < devices; ++i) {
+			fleet.push_back(&engine.addDevice(
+				"127.0.0.1", ports[i % ports.size()], 360, 135,
+				static_cast<std::uint8_t>(
+					1 + i / ports.size() % ADDRESSES_PER_PORT)));
+		}
+
+		std::atomic<bool> running(true);
+		std::atomic<std::size_t> operations(0);
+		std::atomic<std::size_t> errors(0);
+		std::vector<std::thread> clients;
+
+		for (std::size_t i = 0; i < threads; ++i) {
+			clients.emplace_back([&, i]() {
+				std::size_t done = 0;
+				std::size_t failed = 0;
+
+				for (auto next = i; running; next += threads) {
+					try {
+						fleet[next % fleet.size()]->getPanSteps();
+						++done;
+					} catch (const std::exception&) {
+						++failed;
+					}
+				}
+
+				operations += done;
+				errors += failed;
+			});
+		}
+
+		auto start = Clock::now();
+		std::this_thread::sleep_for(options.duration);
+		running = false;
+
+		for (auto& client : clients) {
+			client.join();
+		}
+
+		auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+
+		return { devices, threads, operations / elapsed.count(), errors };
+	}
+
+	/// Parses a list of numbers.
+	/// \param[in]	value	Comma separated numbers.
+	/// \return Numbers.
+	std::vector<std::size_t> parseList(const std::string& value) {
+		std::vector<std::size_t> numbers;
+		std::istringstream stream(value);
+		std::string item;
+
+		while (std::getline(stream, item, ',')) {
+			numbers.push_back(std::stoul(item));
+		}
+
+		return numbers;
+	}
+
+	/// Prints usage.
+	void printUsage() {
+		std::cerr <<
+			"Usage: pelcod-bench [options]\n"
+			"  --iterations N  samples of every latency benchmark (10000)\n"
+			"  --duration MS   duration of every throughput run (1000)\n"
+			"  --devices LIST  device counts of throughput runs (1,16,256)\n"
+			"  --threads LIST  thread counts of throughput runs (1,2,4,8)\n"
+			"  --ports N       responder ports (4)\n";
+	}
+
+	/// Parses options.
+	/// \param[in]	argc	Number of arguments.
+	/// \param[in]	argv	Arguments.
+	/// \return Options.
+	/// \throw std::invalid_argument if an option is invalid.
+	Options parseOptions(int argc, char* argv[]) {
+		Options options;
+
+		for (int i = 1; i < argc; ++i) {
+			std::string name = argv[i];
+
+			if (i + 1 >= argc) {
+				throw std::invalid_argument("The option has no value: " + name);
+			}
+
+			std::string value = argv[++i];
+
+			if (name == "--iterations") {
+				options.iterations = std::stoul(value);
+			} else if (name == "--duration") {
+				options.duration = std::chrono::milliseconds(std::stoul(value));
+			} else if (name == "--devices") {
+				options.deviceCounts = parseList(value);
+			} else if (name == "--threads") {
+				options.threadCounts = parseList(value);
+			} else if (name == "--ports") {
+				options.portCount = std::stoul(value);
+			} else {
+				throw std::invalid_argument("The option is unknown: " + name);
+			}
+		}
+
+		auto zero = [](const std::vector<std::size_t>& numbers) {
+			return numbers.empty() ||
+			       std::find(numbers.begin(), numbers.end(), 0) !=
+			       numbers.end();
+		};
+
+		if (options.iterations == 0 || options.portCount == 0 ||
+		    zero(options.deviceCounts) || zero(options.threadCounts)) {
+			throw std::invalid_argument("The option value is invalid!");
+		}
+
+		for (auto devices : options.deviceCounts) {
+			if (devices > options.portCount * ADDRESSES_PER_PORT) {
+				throw std::invalid_argument(
+					"The device count exceeds the addresses of the ports!");
+			}
+		}
+
+		return options;
+	}
+
+	/// Prints latency distributions as JSON.
+	/// \param[in]	stream		Output stream.
+	/// \param[in]	latencies	Latency distributions.
+	void printLatencies(std::ostream& stream,
+	                    const std::vector<Latency>& latencies) {
+		stream << "[\n";
+
+		for (std::size_t i = 0; i < latencies.size(); ++i) {
+			const auto& latency = latencies[i];
+
+			stream << "    {\"name\": \"" << latency.name
+			       << "\", \"samples\": " << latency.samples
+			       << ", \"p50_ns\": " << latency.p50
+			       << ", \"p99_ns\": " << latency.p99
+			       << ", \"p999_ns\": " << latency.p999
+			       << ", \"max_ns\": " << latency.max << '}'
+			       << (i + 1 < latencies.size() ? ",\n" : "\n");
+		}
+
+		stream << "  ]";
+	}
+
+	/// Prints throughput measurements as JSON.
+	/// \param[in]	stream		Output stream.
+	/// \param[in]	throughputs	Throughput measurements.
+	void printThroughputs(std::ostream& stream,
+	                      const std::vector<Throughput>& throughputs) {
+		stream << "[\n";
+
+		for (std::size_t i = 0; i < throughputs.size(); ++i) {
+			const auto& throughput = throughputs[i];
+
+			stream << "    {\"devices\": " << throughput.devices
+			       << ", \"threads\": " << throughput.threads
+			       << ", \"ops_per_sec\": " << throughput.operations
+			       << ", \"errors\": " << throughput.errors << '}'
+			       << (i + 1 < throughputs.size() ? ",\n" : "\n");
+		}
+
+		stream << "  ]";
+	}
+}
+
+/// Runs the benchmarks.
+/// \details Prints results as JSON to the standard output and progress to
+/// the standard error.
+/// \param[in]	argc	Number of arguments.
+/// \param[in]	argv	Arguments.
+/// \return Exit code.
+int main(int argc, char* argv[]) {
+	Options options;
+
+	try {
+		options = parseOptions(argc, argv);
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n';
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	try {
+		Responder responder(options.portCount);
+		auto ports = responder.getPorts();
+
+		std::cerr << "Measuring codec latency\n";
+		auto codec = measureCodec(options);
+
+		std::cerr << "Measuring device latency\n";
+		auto device = measureDevice(options, ports.front());
+
+		std::vector<Throughput> throughputs;
+
+		for (auto devices : options.deviceCounts) {
+			for (auto threads : options.threadCounts) {
+				std::cerr << "Measuring throughput of " << devices
+				          << " devices with " << threads << " threads\n";
+				throughputs.push_back(
+					measureThroughput(options, ports, devices, threads));
+			}
+		}
+
+		const char* instructionSets[] = { "scalar", "ssse3", "avx2" };
+
+		std::cout << "{\n"
+		          << "  \"instruction_set\": \""
+		          << instructionSets[static_cast<int>(
+		                 Codec::getInstructionSet())] << "\",\n"
+		          << "  \"codec\": ";
+		printLatencies(std::cout, codec);
+		std::cout << ",\n  \"device\": ";
+		printLatencies(std::cout, device);
+		std::cout << ",\n  \"throughput\": ";
+		printThroughputs(std::cout, throughputs);
+		std::cout << "\n}\n";
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n';
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/// \file PelcoDReplay.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE
+/// capture replay tool.
+/// \bug No known bugs.
+
+#include "PelcoDECaptureReplayer.hpp"
+#include "PelcoDEDeviceUDP.hpp"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Replay options.
+	struct Options {
+
+		/// Capture file path.
+		std::string capture;
+
+		/// Responder IP address or host name.
+		std::string ip { "127.0.0.1" };
+
+		/// Responder UDP port.
+		std::uint16_t port { 9000 };
+
+		/// Speed factor, zero to replay as fast as possible.
+		double speed { 1.0 };
+
+		/// Time to wait for late responses.
+		std::chrono::milliseconds linger { 100 };
+	};
+
+	/// Prints usage.
+	void printUsage() {
+		std::cerr <<
+			"Usage: pelcod-replay --capture FILE [options]\n"
+			"  --capture FILE  capture file to replay\n"
+			"  --ip IP         responder address (127.0.0.1)\n"
+			"  --port N        responder UDP port (9000)\n"
+			"  --speed X       speed factor, 0 as fast as possible (1)\n"
+			"  --linger MS     time to wait for late responses (100)\n";
+	}
+
+	/// Parses options.
+	/// \param[in]	argc	Number of arguments.
+	/// \param[in]	argv	Arguments.
+	/// \return Options.
+	/// \throw std::invalid_argument if an option is invalid.
+	Options parseOptions(int argc, char* argv[]) {
+		Options options;
+
+		for (int i = 1; i < argc; ++i) {
+			std::string name = argv[i];
+
+			if (i + 1 >= argc) {
+				throw std::invalid_argument("The option has no value: " + name);
+			}
+
+			std::string value = argv[++i];
+
+			if (name == "--capture") {
+				options.capture = value;
+			} else if (name == "--ip") {
+				options.ip = value;
+			} else if (name == "--port") {
+				options.port = static_cast<std::uint16_t>(std::stoul(value));
+			} else if (name == "--speed") {
+				options.speed = std::stod(value);
+			} else if (name == "--linger") {
+				options.linger = std::chrono::milliseconds(std::stoul(value));
+			} else {
+				throw std::invalid_argument("The option is unknown: " + name);
+			}
+		}
+
+		if (options.capture.empty() || options.port == 0 ||
+		    !(options.speed >= 0)) {
+			throw std::invalid_argument("The option value is invalid!");
+		}
+
+		return options;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+
+	try {
+		options = parseOptions(argc, argv);
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n';
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	try {
+		PelcoDECaptureReplayer replayer(options.capture);
+		replayer.setSpeed(options.speed);
+
+		auto statistics = replayer.replay(
+			PelcoDEDeviceUDP::resolve(options.ip, options.port),
+			options.linger);
+
+		std::cout << "{\n"
+		          << "  \"frames\": " << statistics.frames << ",\n"
+		          << "  \"responses\": " << statistics.responses << ",\n"
+		          << "  \"duration_us\": " << statistics.duration.count()
+		          << ",\n"
+		          << "  \"lag_us\": " << statistics.lag.count() << "\n"
+		          << "}\n";
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n';
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
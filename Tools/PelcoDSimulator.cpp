@@ -0,0 +1,626 @@
+/// \file PelcoDSimulator.cpp
+/// \brief Contains classes and functions definitions that provide Pelco-DE UDP
+/// device simulator.
+/// \bug No known bugs.
+
+#include "PelcoDECodec.hpp"
+#include "PelcoDEStreamParser.hpp"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace PelcoD;
+
+	/// Clock of the simulator.
+	using Clock = std::chrono::steady_clock;
+
+	/// Simulator options.
+	struct Options {
+
+		/// First UDP port.
+		std::uint16_t port { 9000 };
+
+		/// Number of UDP ports.
+		std::size_t portCount { 1 };
+
+		/// Number of device addresses per port, starting from 1.
+		std::size_t addressCount { 1 };
+
+		/// Number of threads.
+		std::size_t threadCount { 1 };
+
+		/// Mean response delay.
+		std::chrono::microseconds latency { 0 };
+
+		/// Maximum deviation of the response delay from the mean.
+		std::chrono::microseconds jitter { 0 };
+
+		/// Probability that a request or its response is lost.
+		double loss { 0 };
+
+		/// Pan maximum number of steps.
+		std::uint16_t panMaxSteps { 36000 };
+
+		/// Tilt maximum number of steps.
+		std::uint16_t tiltMaxSteps { 13500 };
+
+		/// Motion speed in steps per second.
+		double speed { 6000 };
+
+		/// Multicast group joined by all ports, if any.
+		std::string group;
+	};
+
+	/// Simulator counters.
+	struct Counters {
+
+		/// Number of received frames.
+		std::atomic<std::uint64_t> received { 0 };
+
+		/// Number of sent responses.
+		std::atomic<std::uint64_t> sent { 0 };
+
+		/// Number of dropped requests.
+		std::atomic<std::uint64_t> dropped { 0 };
+	};
+
+	/// Simulated axis.
+	/// \details The axis moves from the position it had when the last target
+	/// was set towards the target at a constant speed.
+	class Axis {
+	public:
+
+		/// Constructor.
+		/// \param[in]	maxSteps	Maximum number of steps.
+		explicit Axis(std::uint16_t maxSteps) noexcept
+			: maxSteps_(maxSteps),
+			  origin_(0),
+			  target_(0),
+			  start_() {
+		}
+
+	public:
+
+		/// Gets position.
+		/// \param[in]	now		Current time.
+		/// \param[in]	speed	Speed in steps per second.
+		/// \return Position in steps.
+		std::uint16_t getPosition(Clock::time_point now,
+		                          double speed) const noexcept {
+			auto elapsed = std::chrono::duration<double>(now - start_).count();
+			auto distance = static_cast<double>(target_) - origin_;
+			auto travel = std::min(std::abs(distance), elapsed * speed);
+
+			return static_cast<std::uint16_t>(
+				origin_ + (distance < 0 ? -travel : travel));
+		}
+
+		/// Sets target.
+		/// \param[in]	target	Target in steps.
+		/// \param[in]	now		Current time.
+		/// \param[in]	speed	Speed in steps per second.
+		void setTarget(std::uint16_t target,
+		               Clock::time_point now,
+		               double speed) noexcept {
+			origin_ = getPosition(now, speed);
+			target_ = std::min(target, maxSteps_);
+			start_ = now;
+		}
+
+		/// Gets maximum number of steps.
+		/// \return Maximum number of steps.
+		std::uint16_t getMaxSteps() const noexcept {
+			return maxSteps_;
+		}
+
+	private:
+
+		/// Maximum number of steps.
+		std::uint16_t maxSteps_;
+
+		/// Position when the target was set.
+		std::uint16_t origin_;
+
+		/// Target.
+		std::uint16_t target_;
+
+		/// Time when the target was set.
+		Clock::time_point start_;
+	};
+
+	/// Simulated camera.
+	struct Camera {
+
+		/// Constructor.
+		/// \param[in]	options	Simulator options.
+		explicit Camera(const Options& options) noexcept
+			: pan(options.panMaxSteps),
+			  tilt(options.tiltMaxSteps) {
+		}
+
+		/// Pan axis.
+		Axis pan;
+
+		/// Tilt axis.
+		Axis tilt;
+
+		/// Stored presets, pan and tilt steps by preset number.
+		std::map<std::uint8_t, std::pair<std::uint16_t, std::uint16_t>> presets;
+	};
+
+	/// Response scheduled for sending.
+	struct Pending {
+
+		/// Time to send.
+		Clock::time_point due;
+
+		/// Response frame.
+		Codec::Frame frame;
+
+		/// Destination endpoint.
+		boost::asio::ip::udp::endpoint endpoint;
+
+		/// Compares responses by time to send, the earliest first.
+		/// \param[in]	other	Other response.
+		/// \return True if the response is due later than the other one.
+		bool operator<(const Pending& other) const noexcept {
+			return due > other.due;
+		}
+	};
+
+	/// Class that serves cameras of one UDP port.
+	class Port {
+	public:
+
+		/// Constructor.
+		/// \param[in]	context		I/O context.
+		/// \param[in]	port		UDP port.
+		/// \param[in]	options		Simulator options.
+		/// \param[in]	counters	Simulator counters.
+		/// \param[in]	seed		Random seed.
+		Port(boost::asio::io_context& context,
+		     std::uint16_t port,
+		     const Options& options,
+		     Counters& counters,
+		     std::uint32_t seed)
+			: socket_(context, boost::asio::ip::udp::endpoint(
+				boost::asio::ip::udp::v4(), port)),
+			  timer_(context),
+			  options_(options),
+			  counters_(counters),
+			  random_(seed),
+			  cameras_(options.addressCount, Camera(options)),
+			  buffer_() {
+
+			socket_.set_option(
+				boost::asio::socket_base::receive_buffer_size(4 << 20));
+			socket_.set_option(
+				boost::asio::socket_base::send_buffer_size(4 << 20));
+
+			if (!options.group.empty()) {
+				socket_.set_option(boost::asio::ip::multicast::join_group(
+					boost::asio::ip::make_address(options.group)));
+			}
+
+			startReceive();
+		}
+
+	private:
+
+		/// Starts receiving datagrams.
+		void startReceive() {
+			socket_.async_receive_from(boost::asio::buffer(buffer_), sender_,
+				[this](const boost::system::error_code& error,
+				       std::size_t size) {
+					if (error == boost::asio::error::operation_aborted) {
+						return;
+					}
+
+					if (!error) {
+						PelcoDEStreamParser parser;
+						auto now = Clock::now();
+
+						parser.parse(buffer_.data(), size,
+							[this, now](const Codec::FrameView& frame) {
+								handleFrame(frame, now);
+							});
+					}
+
+					startReceive();
+				});
+		}
+
+		/// Handles a request frame.
+		/// \details Requests with the broadcast address are handled by all
+		/// cameras of the port, and each of them responds.
+		/// \param[in]	frame	Request frame.
+		/// \param[in]	now		Time of reception.
+		void handleFrame(const Codec::FrameView& frame,
+		                 Clock::time_point now) {
+			++counters_.received;
+
+			auto address = frame.getAddress();
+
+			if (address == Codec::ADDRESS_BROADCAST) {
+				for (std::size_t i = 1; i <= cameras_.size(); ++i) {
+					handleRequest(static_cast<std::uint8_t>(i), frame, now);
+				}
+			} else if (address != 0 && address <= cameras_.size()) {
+				handleRequest(address, frame, now);
+			}
+		}
+
+		/// Handles a request of a camera.
+		/// \param[in]	address	Camera address.
+		/// \param[in]	frame	Request frame.
+		/// \param[in]	now		Time of reception.
+		void handleRequest(std::uint8_t address,
+		                   const Codec::FrameView& frame,
+		                   Clock::time_point now) {
+			if (options_.loss > 0 && chance_(random_) < options_.loss) {
+				++counters_.dropped;
+				return;
+			}
+
+			auto& camera = cameras_[address - 1];
+			std::uint16_t value = 0;
+
+			if (handleStandard(camera, frame, now)) {
+				return;
+			}
+
+			switch (frame.getCommand()) {
+			case Codec::COMMAND_REQUEST_GET_PAN_STEPS:
+				value = camera.pan.getPosition(now, options_.speed);
+				break;
+			case Codec::COMMAND_REQUEST_GET_TILT_STEPS:
+				value = camera.tilt.getPosition(now, options_.speed);
+				break;
+			case Codec::COMMAND_REQUEST_GET_PAN_MAX_STEPS:
+				value = camera.pan.getMaxSteps();
+				break;
+			case Codec::COMMAND_REQUEST_GET_TILT_MAX_STEPS:
+				value = camera.tilt.getMaxSteps();
+				break;
+			case Codec::COMMAND_REQUEST_SET_PAN_STEPS:
+				camera.pan.setTarget(frame.getValue(), now, options_.speed);
+				break;
+			case Codec::COMMAND_REQUEST_SET_TILT_STEPS:
+				camera.tilt.setTarget(frame.getValue(), now, options_.speed);
+				break;
+			case Codec::COMMAND_REQUEST_GET_TEMPERATURE:
+				value = 25;
+				break;
+			case Codec::COMMAND_REQUEST_GET_VOLTAGE:
+				value = 1200;
+				break;
+			default:
+				return;
+			}
+
+			Pending pending {
+				now + getDelay(),
+				Codec::createFrame(address,
+				                   Codec::getResponseCommand(frame.getCommand()),
+				                   value),
+				sender_
+			};
+
+			if (pending.due <= now) {
+				send(pending);
+				return;
+			}
+
+			auto earliest = pending_.empty() || pending.due < pending_.top().due;
+			pending_.push(std::move(pending));
+
+			if (earliest) {
+				startTimer();
+			}
+		}
+
+		/// Handles a standard command of a camera.
+		/// \details Standard commands have no response. Continuous motion
+		/// moves axes towards their limits at the simulator speed regardless
+		/// of the speed bytes.
+		/// \param[in]	camera	Camera.
+		/// \param[in]	frame	Request frame.
+		/// \param[in]	now		Time of reception.
+		/// \return True if the frame is a standard command.
+		bool handleStandard(Camera& camera,
+		                    const Codec::FrameView& frame,
+		                    Clock::time_point now) {
+			auto command = frame.getCommand();
+			auto preset = static_cast<std::uint8_t>(frame.getValue() & 0xFFu);
+
+			auto isCommand = [command](Codec::StandardOperation operation) {
+				return command ==
+					Codec::getStandardCommand(operation).command2;
+			};
+
+			if (isCommand(Codec::StandardOperation::SetPreset)) {
+				camera.presets[preset] = std::make_pair(
+					camera.pan.getPosition(now, options_.speed),
+					camera.tilt.getPosition(now, options_.speed));
+			} else if (isCommand(Codec::StandardOperation::ClearPreset)) {
+				camera.presets.erase(preset);
+			} else if (isCommand(Codec::StandardOperation::GoToPreset)) {
+				auto iterator = camera.presets.find(preset);
+
+				if (iterator != camera.presets.end()) {
+					camera.pan.setTarget(iterator->second.first,
+					                     now, options_.speed);
+					camera.tilt.setTarget(iterator->second.second,
+					                      now, options_.speed);
+				}
+			} else if (isCommand(Codec::StandardOperation::SetZoomSpeed) ||
+			           isCommand(Codec::StandardOperation::SetFocusSpeed)) {
+				return true;
+			} else if (frame.getCommand1() != 0 || (command & 0x01u) == 0) {
+				move(camera.pan, command,
+				     Codec::StandardOperation::PanRight,
+				     Codec::StandardOperation::PanLeft, now);
+				move(camera.tilt, command,
+				     Codec::StandardOperation::TiltUp,
+				     Codec::StandardOperation::TiltDown, now);
+			} else {
+				return false;
+			}
+
+			return true;
+		}
+
+		/// Moves an axis continuously.
+		/// \details The axis moves towards the limit of the set direction bit
+		/// or stops if no direction bit is set.
+		/// \param[in]	axis		Axis.
+		/// \param[in]	command		Second command byte.
+		/// \param[in]	increase	Operation that increases steps.
+		/// \param[in]	decrease	Operation that decreases steps.
+		/// \param[in]	now			Time of reception.
+		void move(Axis& axis,
+		          std::uint8_t command,
+		          Codec::StandardOperation increase,
+		          Codec::StandardOperation decrease,
+		          Clock::time_point now) {
+			if (command & Codec::getStandardCommand(increase).command2) {
+				axis.setTarget(axis.getMaxSteps(), now, options_.speed);
+			} else if (command & Codec::getStandardCommand(decrease).command2) {
+				axis.setTarget(0, now, options_.speed);
+			} else {
+				axis.setTarget(axis.getPosition(now, options_.speed),
+				               now, options_.speed);
+			}
+		}
+
+		/// Gets response delay.
+		/// \return Response delay.
+		std::chrono::microseconds getDelay() {
+			auto delay = options_.latency;
+
+			if (options_.jitter.count() > 0) {
+				std::uniform_int_distribution<std::int64_t> jitter(
+					-options_.jitter.count(), options_.jitter.count());
+				delay += std::chrono::microseconds(jitter(random_));
+			}
+
+			return std::max(delay, std::chrono::microseconds(0));
+		}
+
+		/// Arms the timer for the earliest scheduled response.
+		void startTimer() {
+			timer_.expires_at(pending_.top().due);
+			timer_.async_wait([this](const boost::system::error_code& error) {
+				if (error) {
+					return;
+				}
+
+				auto now = Clock::now();
+
+				while (!pending_.empty() && pending_.top().due <= now) {
+					send(pending_.top());
+					pending_.pop();
+				}
+
+				if (!pending_.empty()) {
+					startTimer();
+				}
+			});
+		}
+
+		/// Sends a response.
+		/// \param[in]	pending	Response.
+		void send(const Pending& pending) {
+			boost::system::error_code error;
+			socket_.send_to(boost::asio::buffer(pending.frame),
+			                pending.endpoint, 0, error);
+
+			if (!error) {
+				++counters_.sent;
+			}
+		}
+
+	private:
+
+		/// UDP socket.
+		boost::asio::ip::udp::socket socket_;
+
+		/// Timer of scheduled responses.
+		boost::asio::steady_timer timer_;
+
+		/// Simulator options.
+		const Options& options_;
+
+		/// Simulator counters.
+		Counters& counters_;
+
+		/// Random generator.
+		std::mt19937 random_;
+
+		/// Loss distribution.
+		std::uniform_real_distribution<double> chance_;
+
+		/// Cameras by address minus one.
+		std::vector<Camera> cameras_;
+
+		/// Scheduled responses.
+		std::priority_queue<Pending> pending_;
+
+		/// Received datagram.
+		std::array<std::uint8_t, 1024> buffer_;
+
+		/// Sender of the received datagram.
+		boost::asio::ip::udp::endpoint sender_;
+	};
+
+	/// Prints usage.
+	void printUsage() {
+		std::cerr <<
+			"Usage: pelcod-sim [options]\n"
+			"  --port N        first UDP port (9000)\n"
+			"  --ports N       number of UDP ports (1)\n"
+			"  --addresses N   device addresses per port, 1 to 254 (1)\n"
+			"  --threads N     number of threads (1)\n"
+			"  --latency US    mean response delay in microseconds (0)\n"
+			"  --jitter US     response delay deviation in microseconds (0)\n"
+			"  --loss P        probability of a lost request, 0 to 1 (0)\n"
+			"  --speed N       motion speed in steps per second (6000)\n"
+			"  --group IP      multicast group joined by all ports (none)\n";
+	}
+
+	/// Parses options.
+	/// \param[in]	argc	Number of arguments.
+	/// \param[in]	argv	Arguments.
+	/// \return Options.
+	/// \throw std::invalid_argument if an option is invalid.
+	Options parseOptions(int argc, char* argv[]) {
+		Options options;
+
+		for (int i = 1; i < argc; ++i) {
+			std::string name = argv[i];
+
+			if (i + 1 >= argc) {
+				throw std::invalid_argument("The option has no value: " + name);
+			}
+
+			std::string value = argv[++i];
+
+			if (name == "--port") {
+				options.port = static_cast<std::uint16_t>(std::stoul(value));
+			} else if (name == "--ports") {
+				options.portCount = std::stoul(value);
+			} else if (name == "--addresses") {
+				options.addressCount = std::stoul(value);
+			} else if (name == "--threads") {
+				options.threadCount = std::stoul(value);
+			} else if (name == "--latency") {
+				options.latency = std::chrono::microseconds(std::stoll(value));
+			} else if (name == "--jitter") {
+				options.jitter = std::chrono::microseconds(std::stoll(value));
+			} else if (name == "--loss") {
+				options.loss = std::stod(value);
+			} else if (name == "--speed") {
+				options.speed = std::stod(value);
+			} else if (name == "--group") {
+				options.group = value;
+			} else {
+				throw std::invalid_argument("The option is unknown: " + name);
+			}
+		}
+
+		if (options.portCount == 0 || options.threadCount == 0 ||
+		    options.addressCount == 0 || options.addressCount > 254 ||
+		    options.port + options.portCount > 65536 ||
+		    options.loss < 0 || options.loss > 1) {
+			throw std::invalid_argument("The option value is invalid!");
+		}
+
+		return options;
+	}
+}
+
+/// Runs the simulator.
+/// \details Serves the cameras until interrupted and prints counters.
+/// \param[in]	argc	Number of arguments.
+/// \param[in]	argv	Arguments.
+/// \return Exit code.
+int main(int argc, char* argv[]) {
+	Options options;
+
+	try {
+		options = parseOptions(argc, argv);
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n';
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	Counters counters;
+	std::vector<std::unique_ptr<boost::asio::io_context>> contexts;
+	std::vector<std::unique_ptr<Port>> ports;
+
+	for (std::size_t i = 0; i < options.threadCount; ++i) {
+		contexts.emplace_back(new boost::asio::io_context(1));
+	}
+
+	try {
+		for (std::size_t i = 0; i < options.portCount; ++i) {
+			ports.emplace_back(new Port(
+				*contexts[i % contexts.size()],
+				static_cast<std::uint16_t>(options.port + i),
+				options, counters, static_cast<std::uint32_t>(i)));
+		}
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n';
+		return EXIT_FAILURE;
+	}
+
+	boost::asio::signal_set signals(*contexts.front(), SIGINT, SIGTERM);
+	signals.async_wait([&contexts](const boost::system::error_code&, int) {
+		for (auto& context : contexts) {
+			context->stop();
+		}
+	});
+
+	std::cerr << "Simulating " << options.portCount * options.addressCount
+	          << " cameras on ports " << options.port << '-'
+	          << options.port + options.portCount - 1 << '\n';
+
+	std::vector<std::thread> threads;
+
+	for (std::size_t i = 1; i < contexts.size(); ++i) {
+		threads.emplace_back([&contexts, i]() {
+			contexts[i]->run();
+		});
+	}
+
+	contexts.front()->run();
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	std::cerr << "Received " << counters.received << ", sent "
+	          << counters.sent << ", dropped " << counters.dropped << '\n';
+
+	return EXIT_SUCCESS;
+}